@@ -0,0 +1,149 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSBlobListingIndex.h" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <Foundation/Foundation.h>
+#import "AZSEnums.h"
+#import "AZSMacros.h"
+
+AZS_ASSUME_NONNULL_BEGIN
+
+@class AZSCloudBlobContainer;
+@class AZSBlobRequestOptions;
+@class AZSBlobResultSegment;
+@class AZSBlobListingInventory;
+
+/** An AZSBlobListingIndex is a local, persistent index of the blobs in a container.
+
+ The index keeps the name, ETag, last modified time, length and Content-MD5 of each blob in an AZSBlobListingInventory,
+ so that questions like "does blob X exist with ETag Y" can be answered locally with a binary search instead of with a
+ HEAD request.  The index can be saved to a file and reloaded; the file is memory-mapped on load.
+
+ The index can be refreshed in full, or incrementally: refreshPrefixes:completionHandler: re-lists only the given
+ prefixes and splices the results into the existing index.  Prefixes can also be marked as possibly changed with
+ invalidatePrefix: (for example, after uploading or deleting a blob) and refreshed later in one batch.
+
+ Lookups and refreshes may be called from any thread.  A refresh builds a new inventory and swaps it in when complete,
+ so lookups are never blocked by a listing in progress.
+ */
+@interface AZSBlobListingIndex : NSObject
+
+/** The container being indexed. */
+@property (strong, readonly) AZSCloudBlobContainer *container;
+
+/** The current contents of the index.  A refresh replaces this object rather than modifying it. */
+@property (strong, readonly) AZSBlobListingInventory *inventory;
+
+/** Any additional data that should be returned when refreshing.  Metadata and copy state are not indexed. */
+@property AZSBlobListingDetails blobListingDetails;
+
+/** Optional.  The request options to use for each listing call made by a refresh. */
+@property (strong, AZSNullable) AZSBlobRequestOptions *requestOptions;
+
+/** The prefixes that have been invalidated since they were last refreshed. */
+@property (strong, readonly) NSArray *invalidatedPrefixes;
+
+/** Initializes a new, empty AZSBlobListingIndex.
+
+ @param container The container to index.
+ @return The newly allocated instance.
+ */
+-(instancetype)initWithContainer:(AZSCloudBlobContainer *)container AZS_DESIGNATED_INITIALIZER;
+
+/** Initializes an AZSBlobListingIndex from a file written by writeToFile:error:.
+
+ @param container The container to index.
+ @param path The path of the file to load.
+ @param error Set if the file could not be read or is not a valid index file.
+ @return The newly allocated instance, or nil on failure.
+ */
+-(AZSNullable instancetype)initWithContainer:(AZSCloudBlobContainer *)container contentsOfFile:(NSString *)path error:(NSError **)error;
+
+/** Writes the index to a file, atomically.  Invalidated prefixes are not saved.
+
+ @param path The path of the file to write.
+ @param error Set if the file could not be written.
+ @return YES if the file was written.
+ */
+-(BOOL)writeToFile:(NSString *)path error:(NSError **)error;
+
+/** Adds the blobs in a result segment from a flat listing to the index.  Directories in the segment are ignored.
+
+ @param resultSegment The result segment to add.
+ */
+-(void)addResultSegment:(AZSBlobResultSegment *)resultSegment;
+
+/** Checks whether the index contains a blob (not a snapshot) with the given name.
+
+ @param name The name of the blob.
+ @return YES if the blob is in the index.
+ */
+-(BOOL)containsBlobWithName:(NSString *)name;
+
+/** Checks whether the index contains a blob (not a snapshot) with the given name and ETag.
+
+ @param name The name of the blob.
+ @param eTag The expected ETag.  Surrounding quotes are ignored.
+ @return YES if the blob is in the index with that ETag.
+ */
+-(BOOL)containsBlobWithName:(NSString *)name eTag:(NSString *)eTag;
+
+/** The ETag of the blob (not a snapshot) with the given name, or nil if the blob is not in the index. */
+-(AZSNullable NSString *)eTagOfBlobWithName:(NSString *)name;
+
+/** Marks a prefix as possibly changed, so that it is re-listed by the next call to refreshInvalidatedPrefixesWithCompletionHandler:.
+
+ @param prefix The prefix to invalidate.  The empty string invalidates the whole container.
+ */
+-(void)invalidatePrefix:(NSString *)prefix;
+
+/** Re-lists the whole container and replaces the contents of the index.
+
+ @param completionHandler The block of code to execute when the refresh is complete.
+
+ | Parameter name | Description |
+ |----------------|-------------|
+ |NSError * | Nil if the operation succeeded without error, error with details about the failure otherwise.|
+ */
+-(void)refreshWithCompletionHandler:(void (^)(NSError * __AZSNullable))completionHandler;
+
+/** Re-lists only the given prefixes, and replaces the entries under those prefixes in the index.
+
+ Entries outside the prefixes are left untouched.  Overlapping prefixes are merged.  If the index is not sorted by
+ name (because unsorted result segments were added to it), the whole container is re-listed instead.
+
+ @param prefixes The prefixes (NSString objects) to re-list.
+ @param completionHandler The block of code to execute when the refresh is complete.
+
+ | Parameter name | Description |
+ |----------------|-------------|
+ |NSError * | Nil if the operation succeeded without error, error with details about the failure otherwise.|
+ */
+-(void)refreshPrefixes:(NSArray *)prefixes completionHandler:(void (^)(NSError * __AZSNullable))completionHandler;
+
+/** Re-lists the prefixes passed to invalidatePrefix: since they were last refreshed.
+
+ @param completionHandler The block of code to execute when the refresh is complete.
+
+ | Parameter name | Description |
+ |----------------|-------------|
+ |NSError * | Nil if the operation succeeded without error, error with details about the failure otherwise.|
+ */
+-(void)refreshInvalidatedPrefixesWithCompletionHandler:(void (^)(NSError * __AZSNullable))completionHandler;
+
+@end
+
+AZS_ASSUME_NONNULL_END
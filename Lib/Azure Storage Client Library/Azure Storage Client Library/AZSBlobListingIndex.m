@@ -0,0 +1,313 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSBlobListingIndex.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import "AZSBlobListingIndex.h"
+#import "AZSBlobListingInventory.h"
+#import "AZSCloudBlobContainer.h"
+#import "AZSContinuationToken.h"
+#import "AZSResultSegment.h"
+
+@interface AZSBlobListingIndex()
+{
+    NSMutableSet *_invalidatedPrefixSet;
+}
+
+@property (strong, readwrite) AZSBlobListingInventory *inventory;
+
+-(instancetype)init AZS_DESIGNATED_INITIALIZER;
+
+@end
+
+@implementation AZSBlobListingIndex
+
+-(instancetype)init
+{
+    return nil;
+}
+
+-(instancetype)initWithContainer:(AZSCloudBlobContainer *)container
+{
+    self = [super init];
+    if (self)
+    {
+        _container = container;
+        _inventory = [[AZSBlobListingInventory alloc] initWithContainer:container];
+        _blobListingDetails = AZSBlobListingDetailsNone;
+        _invalidatedPrefixSet = [NSMutableSet setWithCapacity:0];
+    }
+
+    return self;
+}
+
+-(instancetype)initWithContainer:(AZSCloudBlobContainer *)container contentsOfFile:(NSString *)path error:(NSError **)error
+{
+    AZSBlobListingInventory *inventory = [[AZSBlobListingInventory alloc] initWithContainer:container contentsOfFile:path error:error];
+    if (!inventory)
+    {
+        return nil;
+    }
+
+    self = [self initWithContainer:container];
+    if (self)
+    {
+        _inventory = inventory;
+    }
+
+    return self;
+}
+
+-(BOOL)writeToFile:(NSString *)path error:(NSError **)error
+{
+    @synchronized(self)
+    {
+        return [self.inventory writeToFile:path error:error];
+    }
+}
+
+-(NSArray *)invalidatedPrefixes
+{
+    @synchronized(self)
+    {
+        return [_invalidatedPrefixSet allObjects];
+    }
+}
+
+-(void)addResultSegment:(AZSBlobResultSegment *)resultSegment
+{
+    @synchronized(self)
+    {
+        [self.inventory addBlobs:resultSegment.blobs];
+    }
+}
+
+// Snapshots are listed next to their base blob, so the base blob is found by scanning the run of entries with the same name.
+-(NSUInteger)indexOfBaseBlobWithName:(NSString *)name
+{
+    AZSBlobListingInventory *inventory = self.inventory;
+    NSUInteger index = [inventory indexOfBlobWithName:name];
+    while (index != NSNotFound && index < inventory.count)
+    {
+        if (![inventory snapshotTimeAtIndex:index])
+        {
+            return index;
+        }
+
+        index++;
+        if (index < inventory.count && ![[inventory nameAtIndex:index] isEqualToString:name])
+        {
+            break;
+        }
+    }
+
+    return NSNotFound;
+}
+
+-(BOOL)containsBlobWithName:(NSString *)name
+{
+    @synchronized(self)
+    {
+        return [self indexOfBaseBlobWithName:name] != NSNotFound;
+    }
+}
+
+-(NSString *)eTagOfBlobWithName:(NSString *)name
+{
+    @synchronized(self)
+    {
+        NSUInteger index = [self indexOfBaseBlobWithName:name];
+        return (index == NSNotFound) ? nil : [self.inventory eTagAtIndex:index];
+    }
+}
+
+static NSString *AZSUnquotedETag(NSString *eTag)
+{
+    if (eTag.length >= 2 && [eTag hasPrefix:@"\""] && [eTag hasSuffix:@"\""])
+    {
+        return [eTag substringWithRange:NSMakeRange(1, eTag.length - 2)];
+    }
+    return eTag;
+}
+
+-(BOOL)containsBlobWithName:(NSString *)name eTag:(NSString *)eTag
+{
+    NSString *indexedETag = [self eTagOfBlobWithName:name];
+    return indexedETag && [AZSUnquotedETag(indexedETag) isEqualToString:AZSUnquotedETag(eTag)];
+}
+
+-(void)invalidatePrefix:(NSString *)prefix
+{
+    @synchronized(self)
+    {
+        [_invalidatedPrefixSet addObject:[prefix copy]];
+    }
+}
+
+-(void)refreshWithCompletionHandler:(void (^)(NSError *))completionHandler
+{
+    [self refreshPrefixes:@[@""] completionHandler:completionHandler];
+}
+
+-(void)refreshInvalidatedPrefixesWithCompletionHandler:(void (^)(NSError *))completionHandler
+{
+    NSArray *prefixes;
+    @synchronized(self)
+    {
+        prefixes = [_invalidatedPrefixSet allObjects];
+        [_invalidatedPrefixSet removeAllObjects];
+    }
+
+    [self refreshPrefixes:prefixes completionHandler:^(NSError *error) {
+        if (error)
+        {
+            // Nothing was spliced in, so the prefixes are still stale.
+            @synchronized(self)
+            {
+                [_invalidatedPrefixSet addObjectsFromArray:prefixes];
+            }
+        }
+        completionHandler(error);
+    }];
+}
+
+// Sorts the prefixes in the same (UTF-8 byte) order as the inventory, and drops any prefix covered by an earlier one,
+// so that each prefix maps to its own contiguous, non-overlapping range.
++(NSArray *)normalizedPrefixes:(NSArray *)prefixes
+{
+    NSArray *sortedPrefixes = [prefixes sortedArrayUsingComparator:^NSComparisonResult(NSString *first, NSString *second) {
+        int comparison = strcmp([first UTF8String], [second UTF8String]);
+        return (comparison < 0) ? NSOrderedAscending : ((comparison > 0) ? NSOrderedDescending : NSOrderedSame);
+    }];
+
+    NSMutableArray *normalizedPrefixes = [NSMutableArray arrayWithCapacity:sortedPrefixes.count];
+    for (NSString *prefix in sortedPrefixes)
+    {
+        NSString *previousPrefix = normalizedPrefixes.lastObject;
+        if (!previousPrefix || ![prefix hasPrefix:previousPrefix])
+        {
+            [normalizedPrefixes addObject:prefix];
+        }
+    }
+
+    return normalizedPrefixes;
+}
+
+-(void)refreshPrefixes:(NSArray *)prefixes completionHandler:(void (^)(NSError *))completionHandler
+{
+    NSArray *normalizedPrefixes;
+    @synchronized(self)
+    {
+        normalizedPrefixes = self.inventory.sortedByName ? [AZSBlobListingIndex normalizedPrefixes:prefixes] : @[@""];
+    }
+
+    if (normalizedPrefixes.count == 0)
+    {
+        completionHandler(nil);
+        return;
+    }
+
+    AZSBlobListingInventory *freshInventory = [[AZSBlobListingInventory alloc] initWithContainer:self.container];
+    NSMutableArray *freshRanges = [NSMutableArray arrayWithCapacity:normalizedPrefixes.count];
+    [self listPrefixes:normalizedPrefixes prefixIndex:0 continuationToken:nil intoInventory:freshInventory freshRanges:freshRanges completionHandler:^(NSError *error) {
+        if (!error)
+        {
+            [self spliceInventory:freshInventory ranges:freshRanges forPrefixes:normalizedPrefixes];
+        }
+        completionHandler(error);
+    }];
+}
+
+-(void)listPrefixes:(NSArray *)prefixes prefixIndex:(NSUInteger)prefixIndex continuationToken:(AZSContinuationToken *)token intoInventory:(AZSBlobListingInventory *)inventory freshRanges:(NSMutableArray *)freshRanges completionHandler:(void (^)(NSError *))completionHandler
+{
+    NSString *prefix = prefixes[prefixIndex];
+    NSUInteger rangeStart = (prefixIndex == 0) ? 0 : NSMaxRange([freshRanges.lastObject rangeValue]);
+    [self.container listBlobsSegmentedWithContinuationToken:token prefix:(prefix.length > 0 ? prefix : nil) blobListingDetails:self.blobListingDetails maxResults:-1 inventory:inventory accessCondition:nil requestOptions:self.requestOptions operationContext:nil completionHandler:^(NSError *error, AZSContinuationToken *nextToken) {
+        if (error)
+        {
+            completionHandler(error);
+        }
+        else if (nextToken)
+        {
+            [self listPrefixes:prefixes prefixIndex:prefixIndex continuationToken:nextToken intoInventory:inventory freshRanges:freshRanges completionHandler:completionHandler];
+        }
+        else
+        {
+            [freshRanges addObject:[NSValue valueWithRange:NSMakeRange(rangeStart, inventory.count - rangeStart)]];
+            if (prefixIndex + 1 < prefixes.count)
+            {
+                [self listPrefixes:prefixes prefixIndex:(prefixIndex + 1) continuationToken:nil intoInventory:inventory freshRanges:freshRanges completionHandler:completionHandler];
+            }
+            else
+            {
+                completionHandler(nil);
+            }
+        }
+    }];
+}
+
+// Builds a new inventory from the current one, replacing the range covered by each prefix with the freshly listed entries.
+-(void)spliceInventory:(AZSBlobListingInventory *)freshInventory ranges:(NSArray *)freshRanges forPrefixes:(NSArray *)prefixes
+{
+    @synchronized(self)
+    {
+        AZSBlobListingInventory *currentInventory = self.inventory;
+        if (prefixes.count == 1 && [prefixes[0] length] == 0)
+        {
+            self.inventory = freshInventory;
+            return;
+        }
+
+        AZSBlobListingInventory *mergedInventory = [[AZSBlobListingInventory alloc] initWithContainer:self.container];
+        if (!currentInventory.sortedByName)
+        {
+            // Unsorted segments were added during the refresh, so the stale entries have to be found one at a time.  The
+            // entries between them are copied a run at a time, since each copy walks the sparse values once.
+            NSUInteger runStart = 0;
+            for (NSUInteger i = 0; i < currentInventory.count; i++)
+            {
+                NSString *name = [currentInventory nameAtIndex:i];
+                BOOL stale = NO;
+                for (NSString *prefix in prefixes)
+                {
+                    stale = stale || [name hasPrefix:prefix];
+                }
+                if (stale)
+                {
+                    [mergedInventory addEntriesFromInventory:currentInventory range:NSMakeRange(runStart, i - runStart)];
+                    runStart = i + 1;
+                }
+            }
+            [mergedInventory addEntriesFromInventory:currentInventory range:NSMakeRange(runStart, currentInventory.count - runStart)];
+            [mergedInventory addEntriesFromInventory:freshInventory];
+            self.inventory = mergedInventory;
+            return;
+        }
+
+        NSUInteger position = 0;
+        for (NSUInteger i = 0; i < prefixes.count; i++)
+        {
+            NSRange staleRange = [currentInventory rangeOfBlobsWithPrefix:prefixes[i]];
+            [mergedInventory addEntriesFromInventory:currentInventory range:NSMakeRange(position, staleRange.location - position)];
+            [mergedInventory addEntriesFromInventory:freshInventory range:[freshRanges[i] rangeValue]];
+            position = NSMaxRange(staleRange);
+        }
+        [mergedInventory addEntriesFromInventory:currentInventory range:NSMakeRange(position, currentInventory.count - position)];
+
+        self.inventory = mergedInventory;
+    }
+}
+
+@end
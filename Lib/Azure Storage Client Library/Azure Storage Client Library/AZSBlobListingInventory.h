@@ -0,0 +1,157 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSBlobListingInventory.h" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <Foundation/Foundation.h>
+#import "AZSEnums.h"
+#import "AZSMacros.h"
+
+AZS_ASSUME_NONNULL_BEGIN
+
+@class AZSCloudBlobContainer;
+@class AZSCloudBlob;
+
+/** An AZSBlobListingInventory is a compact, in-memory representation of the results of a flat blob listing.
+
+ A normal listing returns one AZSCloudBlob per blob, each with its own AZSBlobProperties, metadata dictionary and
+ AZSCopyState.  For inventories of millions of blobs this costs several hundred bytes per blob.  The inventory
+ instead stores blob names in a single shared byte arena, and keeps the length, last-modified time, ETag, Content-MD5
+ and blob type of each blob in parallel arrays, for roughly fifty bytes per blob plus the name.
+
+ Only the properties listed above are kept; metadata and copy state are not.  AZSCloudBlob objects are created
+ on demand with blobAtIndex:.
+
+ Entries are kept in the order they were added.  If they were added in lexicographic order (as a single flat listing
+ returns them), indexOfBlobWithName: uses a binary search.
+
+ An AZSBlobListingInventory is not thread-safe.
+ */
+@interface AZSBlobListingInventory : NSObject
+
+/** The container the listed blobs belong to.  Used to create AZSCloudBlob objects in blobAtIndex:. */
+@property (strong, readonly) AZSCloudBlobContainer *container;
+
+/** The number of blobs in the inventory. */
+@property (readonly) NSUInteger count;
+
+/** YES if every blob was added in increasing name order.  Snapshots of one blob may share a name. */
+@property (readonly) BOOL sortedByName;
+
+/** Initializes a new, empty AZSBlobListingInventory.
+
+ @param container The container the listed blobs belong to.
+ @return The newly allocated instance.
+ */
+-(instancetype)initWithContainer:(AZSCloudBlobContainer *)container AZS_DESIGNATED_INITIALIZER;
+
+/** Initializes an AZSBlobListingInventory from a file written by writeToFile:error:.
+
+ The file is memory-mapped, and the columns are read directly from the mapping, so loading is proportional to the
+ number of snapshots and irregular ETags rather than to the number of blobs.  The first append copies the columns.
+
+ @param container The container the listed blobs belong to.
+ @param path The path of the file to load.
+ @param error Set if the file could not be read or is not a valid inventory file.
+ @return The newly allocated instance, or nil on failure.
+ */
+-(AZSNullable instancetype)initWithContainer:(AZSCloudBlobContainer *)container contentsOfFile:(NSString *)path error:(NSError **)error;
+
+/** Writes the inventory to a file, atomically.
+
+ @param path The path of the file to write.
+ @param error Set if the file could not be written.
+ @return YES if the file was written.
+ */
+-(BOOL)writeToFile:(NSString *)path error:(NSError **)error;
+
+/** Adds one blob to the inventory.
+
+ @param name The name of the blob.
+ @param length The length of the blob, in bytes.
+ @param lastModified The last modified time of the blob.
+ @param eTag The ETag of the blob.
+ @param contentMD5 The base64-encoded Content-MD5 of the blob, if it has one.
+ @param blobType The type of the blob.
+ @param snapshotTime The snapshot time, if this entry is a snapshot.
+ */
+-(void)addBlobWithName:(NSString *)name length:(uint64_t)length lastModified:(AZSNullable NSDate *)lastModified eTag:(AZSNullable NSString *)eTag contentMD5:(AZSNullable NSString *)contentMD5 blobType:(AZSBlobType)blobType snapshotTime:(AZSNullable NSString *)snapshotTime;
+
+/** Adds the blobs in an array of AZSCloudBlob objects to the inventory.
+
+ @param blobs The blobs to add.
+ */
+-(void)addBlobs:(NSArray *)blobs;
+
+/** Appends every entry of another inventory to this one.
+
+ @param inventory The inventory whose entries should be appended.
+ */
+-(void)addEntriesFromInventory:(AZSBlobListingInventory *)inventory;
+
+/** Appends a range of entries from another inventory to this one.
+
+ @param inventory The inventory whose entries should be appended.
+ @param range The range of entries to append.
+ */
+-(void)addEntriesFromInventory:(AZSBlobListingInventory *)inventory range:(NSRange)range;
+
+/** The name of the blob at the given index. */
+-(NSString *)nameAtIndex:(NSUInteger)index;
+
+/** The length of the blob at the given index, in bytes. */
+-(uint64_t)lengthAtIndex:(NSUInteger)index;
+
+/** The last modified time of the blob at the given index, in seconds since 1970, or 0 if unknown. */
+-(int64_t)lastModifiedAtIndex:(NSUInteger)index;
+
+/** The ETag of the blob at the given index. */
+-(AZSNullable NSString *)eTagAtIndex:(NSUInteger)index;
+
+/** The base64-encoded Content-MD5 of the blob at the given index. */
+-(AZSNullable NSString *)contentMD5AtIndex:(NSUInteger)index;
+
+/** The raw 16-byte Content-MD5 of the blob at the given index.  Returns NO if the blob has no Content-MD5. */
+-(BOOL)getContentMD5:(uint8_t *)md5Bytes atIndex:(NSUInteger)index;
+
+/** The type of the blob at the given index. */
+-(AZSBlobType)blobTypeAtIndex:(NSUInteger)index;
+
+/** The snapshot time of the blob at the given index, or nil if the entry is not a snapshot. */
+-(AZSNullable NSString *)snapshotTimeAtIndex:(NSUInteger)index;
+
+/** Creates an AZSCloudBlob object (of the appropriate subclass) for the blob at the given index, with its properties populated. */
+-(AZSCloudBlob *)blobAtIndex:(NSUInteger)index;
+
+/** Finds the first entry with the given name.
+
+ @param name The blob name to look for.
+ @return The index of the entry, or NSNotFound.
+ */
+-(NSUInteger)indexOfBlobWithName:(NSString *)name;
+
+/** Finds the entries whose names begin with the given prefix.
+
+ If the inventory is sorted, the matching entries are contiguous and are found with a binary search.  Otherwise only
+ the first contiguous run of matching entries is returned.
+
+ @param prefix The prefix to look for.
+ @return The range of matching entries.  The location is NSNotFound if nothing matches in an unsorted inventory.
+ */
+-(NSRange)rangeOfBlobsWithPrefix:(NSString *)prefix;
+
+@end
+
+AZS_ASSUME_NONNULL_END
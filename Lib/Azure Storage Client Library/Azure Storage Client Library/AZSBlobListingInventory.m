@@ -0,0 +1,623 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSBlobListingInventory.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import "AZSBlobListingInventory.h"
+#import "AZSBlobProperties.h"
+#import "AZSCloudBlob.h"
+#import "AZSCloudBlockBlob.h"
+#import "AZSCloudPageBlob.h"
+#import "AZSCloudAppendBlob.h"
+#import "AZSErrors.h"
+#import "AZSUtil.h"
+
+// On-disk layout: an AZSInventoryFileHeader, then the name offset, length, last-modified, ETag and MD5 columns (all
+// 8-byte aligned), then the name arena, the flags column and finally a binary property list of the sparse values.
+#define AZSInventoryFileMagic           0x49535A41 // "AZSI"
+#define AZSInventoryFileVersion         1
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t count;
+    uint64_t nameArenaLength;
+    uint64_t sparseValuesLength;
+    uint32_t sortedByName;
+    uint32_t reserved;
+} AZSInventoryFileHeader;
+
+// Per-entry flag bits.
+#define AZSInventoryFlagBlobTypeMask    0x03
+#define AZSInventoryFlagHasMD5          0x04
+#define AZSInventoryFlagHasETag         0x08
+#define AZSInventoryFlagETagPacked      0x10
+#define AZSInventoryFlagETagQuoted      0x20
+
+@interface AZSBlobListingInventory()
+{
+    // The columns are NSMutableData, except when loaded from a file, in which case they point into _mappedData
+    // until the first append.
+    NSData *_mappedData;
+    NSData *_nameArena;
+    NSData *_nameOffsets;
+    NSData *_lengths;
+    NSData *_lastModifiedTimes;
+    NSData *_eTags;
+    NSData *_contentMD5s;
+    NSData *_flags;
+
+    // Rare values are kept out of the columns.
+    NSMutableDictionary *_unpackedETags;
+    NSMutableDictionary *_snapshotTimes;
+}
+
+-(instancetype)init AZS_DESIGNATED_INITIALIZER;
+-(int)compareNameAtIndex:(NSUInteger)index withBytes:(const char *)nameBytes length:(size_t)nameLength;
+
+@end
+
+@implementation AZSBlobListingInventory
+
+-(instancetype)init
+{
+    return nil;
+}
+
+-(instancetype)initWithContainer:(AZSCloudBlobContainer *)container
+{
+    self = [super init];
+    if (self)
+    {
+        _container = container;
+        _count = 0;
+        _sortedByName = YES;
+        _nameArena = [NSMutableData dataWithCapacity:4096];
+        _nameOffsets = [NSMutableData dataWithLength:sizeof(uint64_t)];
+        _lengths = [NSMutableData dataWithCapacity:0];
+        _lastModifiedTimes = [NSMutableData dataWithCapacity:0];
+        _eTags = [NSMutableData dataWithCapacity:0];
+        _contentMD5s = [NSMutableData dataWithCapacity:0];
+        _flags = [NSMutableData dataWithCapacity:0];
+        _unpackedETags = [NSMutableDictionary dictionaryWithCapacity:0];
+        _snapshotTimes = [NSMutableDictionary dictionaryWithCapacity:0];
+    }
+
+    return self;
+}
+
+// Service ETags look like 0x8D4BCC2E4835CD0; these fit in 64 bits.  Anything else is stored as a string.
+static BOOL AZSPackETag(NSString *eTag, uint64_t *packed, BOOL *quoted)
+{
+    const char *chars = [eTag UTF8String];
+    size_t length = strlen(chars);
+    *quoted = (length >= 2 && chars[0] == '"' && chars[length - 1] == '"');
+    if (*quoted)
+    {
+        chars++;
+        length -= 2;
+    }
+
+    if (length < 3 || length > 18 || chars[0] != '0' || chars[1] != 'x' || chars[2] == '0')
+    {
+        return NO;
+    }
+
+    uint64_t value = 0;
+    for (size_t i = 2; i < length; i++)
+    {
+        char c = chars[i];
+        if (c >= '0' && c <= '9')
+        {
+            value = (value << 4) | (uint64_t)(c - '0');
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+            value = (value << 4) | (uint64_t)(c - 'A' + 10);
+        }
+        else
+        {
+            return NO;
+        }
+    }
+
+    *packed = value;
+    return YES;
+}
+
+-(void)addBlobWithName:(NSString *)name length:(uint64_t)length lastModified:(NSDate *)lastModified eTag:(NSString *)eTag contentMD5:(NSString *)contentMD5 blobType:(AZSBlobType)blobType snapshotTime:(NSString *)snapshotTime
+{
+    [self prepareForAppend];
+
+    NSUInteger index = self.count;
+    const char *nameBytes = [name UTF8String];
+    size_t nameLength = strlen(nameBytes);
+
+    // Snapshots share their blob's name and are listed next to it (the service lists them before the base blob), so
+    // equal names are in order whichever comes first.
+    if (_sortedByName && index > 0)
+    {
+        _sortedByName = ([self compareNameAtIndex:(index - 1) withBytes:nameBytes length:nameLength] <= 0);
+    }
+
+    [(NSMutableData *)_nameArena appendBytes:nameBytes length:nameLength];
+    uint64_t nextOffset = _nameArena.length;
+    [(NSMutableData *)_nameOffsets appendBytes:&nextOffset length:sizeof(nextOffset)];
+    [(NSMutableData *)_lengths appendBytes:&length length:sizeof(length)];
+
+    int64_t lastModifiedTime = lastModified ? (int64_t)[lastModified timeIntervalSince1970] : 0;
+    [(NSMutableData *)_lastModifiedTimes appendBytes:&lastModifiedTime length:sizeof(lastModifiedTime)];
+
+    uint8_t flags = (uint8_t)(blobType & AZSInventoryFlagBlobTypeMask);
+    uint64_t packedETag = 0;
+    if (eTag)
+    {
+        BOOL quoted = NO;
+        flags |= AZSInventoryFlagHasETag;
+        if (AZSPackETag(eTag, &packedETag, &quoted))
+        {
+            flags |= AZSInventoryFlagETagPacked | (quoted ? AZSInventoryFlagETagQuoted : 0);
+        }
+        else
+        {
+            _unpackedETags[@(index)] = eTag;
+        }
+    }
+    [(NSMutableData *)_eTags appendBytes:&packedETag length:sizeof(packedETag)];
+
+    uint8_t md5Bytes[16] = {0};
+    if (contentMD5 && [AZSUtil decodeBase64String:contentMD5 toBytes:md5Bytes length:sizeof(md5Bytes)])
+    {
+        flags |= AZSInventoryFlagHasMD5;
+    }
+    [(NSMutableData *)_contentMD5s appendBytes:md5Bytes length:sizeof(md5Bytes)];
+    [(NSMutableData *)_flags appendBytes:&flags length:sizeof(flags)];
+
+    if (snapshotTime)
+    {
+        _snapshotTimes[@(index)] = snapshotTime;
+    }
+
+    _count = index + 1;
+}
+
+-(void)addBlobs:(NSArray *)blobs
+{
+    for (AZSCloudBlob *blob in blobs)
+    {
+        [self addBlobWithName:blob.blobName length:blob.properties.length.unsignedLongLongValue lastModified:blob.properties.lastModified eTag:blob.properties.eTag contentMD5:blob.properties.contentMD5 blobType:blob.properties.blobType snapshotTime:blob.snapshotTime];
+    }
+}
+
+-(void)addEntriesFromInventory:(AZSBlobListingInventory *)inventory
+{
+    [self addEntriesFromInventory:inventory range:NSMakeRange(0, inventory.count)];
+}
+
+-(void)addEntriesFromInventory:(AZSBlobListingInventory *)inventory range:(NSRange)range
+{
+    if (range.length == 0)
+    {
+        return;
+    }
+
+    [self prepareForAppend];
+
+    NSUInteger baseIndex = self.count;
+    if (_sortedByName && baseIndex > 0)
+    {
+        NSString *firstName = [inventory nameAtIndex:range.location];
+        const char *firstNameBytes = [firstName UTF8String];
+        _sortedByName = ([self compareNameAtIndex:(baseIndex - 1) withBytes:firstNameBytes length:strlen(firstNameBytes)] <= 0);
+    }
+    _sortedByName = _sortedByName && inventory.sortedByName;
+
+    // Columns can be appended wholesale; only the name offsets and the sparse indices need rebasing.
+    const uint64_t *offsets = inventory->_nameOffsets.bytes;
+    uint64_t firstOffset = offsets[range.location];
+    uint64_t baseOffset = _nameArena.length;
+    [(NSMutableData *)_nameArena appendBytes:(const char *)inventory->_nameArena.bytes + firstOffset length:(NSUInteger)(offsets[NSMaxRange(range)] - firstOffset)];
+    for (NSUInteger i = range.location + 1; i <= NSMaxRange(range); i++)
+    {
+        uint64_t offset = baseOffset + (offsets[i] - firstOffset);
+        [(NSMutableData *)_nameOffsets appendBytes:&offset length:sizeof(offset)];
+    }
+
+    [(NSMutableData *)_lengths appendBytes:(const uint64_t *)inventory->_lengths.bytes + range.location length:range.length * sizeof(uint64_t)];
+    [(NSMutableData *)_lastModifiedTimes appendBytes:(const int64_t *)inventory->_lastModifiedTimes.bytes + range.location length:range.length * sizeof(int64_t)];
+    [(NSMutableData *)_eTags appendBytes:(const uint64_t *)inventory->_eTags.bytes + range.location length:range.length * sizeof(uint64_t)];
+    [(NSMutableData *)_contentMD5s appendBytes:(const uint8_t *)inventory->_contentMD5s.bytes + (range.location * 16) length:range.length * 16];
+    [(NSMutableData *)_flags appendBytes:(const uint8_t *)inventory->_flags.bytes + range.location length:range.length];
+
+    NSMutableDictionary *unpackedETags = _unpackedETags;
+    NSMutableDictionary *snapshotTimes = _snapshotTimes;
+    [inventory->_unpackedETags enumerateKeysAndObjectsUsingBlock:^(NSNumber *index, NSString *eTag, BOOL *stop) {
+        if (NSLocationInRange(index.unsignedIntegerValue, range))
+        {
+            unpackedETags[@(baseIndex + index.unsignedIntegerValue - range.location)] = eTag;
+        }
+    }];
+    [inventory->_snapshotTimes enumerateKeysAndObjectsUsingBlock:^(NSNumber *index, NSString *snapshotTime, BOOL *stop) {
+        if (NSLocationInRange(index.unsignedIntegerValue, range))
+        {
+            snapshotTimes[@(baseIndex + index.unsignedIntegerValue - range.location)] = snapshotTime;
+        }
+    }];
+
+    _count = baseIndex + range.length;
+}
+
+-(void)prepareForAppend
+{
+    if (!_mappedData)
+    {
+        return;
+    }
+
+    _nameArena = [_nameArena mutableCopy];
+    _nameOffsets = [_nameOffsets mutableCopy];
+    _lengths = [_lengths mutableCopy];
+    _lastModifiedTimes = [_lastModifiedTimes mutableCopy];
+    _eTags = [_eTags mutableCopy];
+    _contentMD5s = [_contentMD5s mutableCopy];
+    _flags = [_flags mutableCopy];
+    _mappedData = nil;
+}
+
+-(uint8_t)flagsAtIndex:(NSUInteger)index
+{
+    return ((const uint8_t *)_flags.bytes)[index];
+}
+
+-(NSString *)nameAtIndex:(NSUInteger)index
+{
+    const uint64_t *offsets = _nameOffsets.bytes;
+    return [[NSString alloc] initWithBytes:(const char *)_nameArena.bytes + offsets[index] length:(NSUInteger)(offsets[index + 1] - offsets[index]) encoding:NSUTF8StringEncoding];
+}
+
+-(uint64_t)lengthAtIndex:(NSUInteger)index
+{
+    return ((const uint64_t *)_lengths.bytes)[index];
+}
+
+-(int64_t)lastModifiedAtIndex:(NSUInteger)index
+{
+    return ((const int64_t *)_lastModifiedTimes.bytes)[index];
+}
+
+-(NSString *)eTagAtIndex:(NSUInteger)index
+{
+    uint8_t flags = [self flagsAtIndex:index];
+    if (!(flags & AZSInventoryFlagHasETag))
+    {
+        return nil;
+    }
+
+    if (!(flags & AZSInventoryFlagETagPacked))
+    {
+        return _unpackedETags[@(index)];
+    }
+
+    unsigned long long packedETag = ((const uint64_t *)_eTags.bytes)[index];
+    return (flags & AZSInventoryFlagETagQuoted) ? [NSString stringWithFormat:@"\"0x%llX\"", packedETag] : [NSString stringWithFormat:@"0x%llX", packedETag];
+}
+
+-(BOOL)getContentMD5:(uint8_t *)md5Bytes atIndex:(NSUInteger)index
+{
+    if (!([self flagsAtIndex:index] & AZSInventoryFlagHasMD5))
+    {
+        return NO;
+    }
+
+    memcpy(md5Bytes, (const uint8_t *)_contentMD5s.bytes + (index * 16), 16);
+    return YES;
+}
+
+-(NSString *)contentMD5AtIndex:(NSUInteger)index
+{
+    uint8_t md5Bytes[16];
+    if (![self getContentMD5:md5Bytes atIndex:index])
+    {
+        return nil;
+    }
+
+    return [AZSUtil base64EncodedStringWithBytes:md5Bytes length:sizeof(md5Bytes)];
+}
+
+-(AZSBlobType)blobTypeAtIndex:(NSUInteger)index
+{
+    return (AZSBlobType)([self flagsAtIndex:index] & AZSInventoryFlagBlobTypeMask);
+}
+
+-(NSString *)snapshotTimeAtIndex:(NSUInteger)index
+{
+    return _snapshotTimes[@(index)];
+}
+
+-(AZSCloudBlob *)blobAtIndex:(NSUInteger)index
+{
+    NSString *name = [self nameAtIndex:index];
+    NSString *snapshotTime = [self snapshotTimeAtIndex:index];
+
+    AZSCloudBlob *blob;
+    switch ([self blobTypeAtIndex:index])
+    {
+        case AZSBlobTypeAppendBlob:
+            blob = [[AZSCloudAppendBlob alloc] initWithContainer:self.container name:name snapshotTime:snapshotTime];
+            break;
+        case AZSBlobTypeBlockBlob:
+            blob = [[AZSCloudBlockBlob alloc] initWithContainer:self.container name:name snapshotTime:snapshotTime];
+            break;
+        case AZSBlobTypePageBlob:
+            blob = [[AZSCloudPageBlob alloc] initWithContainer:self.container name:name snapshotTime:snapshotTime];
+            break;
+        case AZSBlobTypeUnspecified:
+        default:
+            blob = [[AZSCloudBlob alloc] initWithContainer:self.container name:name snapshotTime:snapshotTime];
+            break;
+    }
+
+    int64_t lastModified = [self lastModifiedAtIndex:index];
+    blob.properties.blobType = [self blobTypeAtIndex:index];
+    blob.properties.length = [NSNumber numberWithUnsignedLongLong:[self lengthAtIndex:index]];
+    blob.properties.lastModified = lastModified ? [NSDate dateWithTimeIntervalSince1970:lastModified] : nil;
+    blob.properties.eTag = [self eTagAtIndex:index];
+    blob.properties.contentMD5 = [self contentMD5AtIndex:index];
+    return blob;
+}
+
+-(int)compareNameAtIndex:(NSUInteger)index withBytes:(const char *)nameBytes length:(size_t)nameLength
+{
+    const uint64_t *offsets = _nameOffsets.bytes;
+    size_t entryLength = (size_t)(offsets[index + 1] - offsets[index]);
+    int comparison = memcmp((const char *)_nameArena.bytes + offsets[index], nameBytes, MIN(entryLength, nameLength));
+    if (comparison == 0)
+    {
+        comparison = (entryLength < nameLength) ? -1 : ((entryLength > nameLength) ? 1 : 0);
+    }
+    return comparison;
+}
+
+-(NSUInteger)indexOfBlobWithName:(NSString *)name
+{
+    const char *nameBytes = [name UTF8String];
+    size_t nameLength = strlen(nameBytes);
+
+    if (!self.sortedByName)
+    {
+        for (NSUInteger i = 0; i < self.count; i++)
+        {
+            if ([self compareNameAtIndex:i withBytes:nameBytes length:nameLength] == 0)
+            {
+                return i;
+            }
+        }
+        return NSNotFound;
+    }
+
+    // Lower-bound search, so that the first of several snapshots is found.
+    NSUInteger low = 0;
+    NSUInteger high = self.count;
+    while (low < high)
+    {
+        NSUInteger mid = low + ((high - low) / 2);
+        if ([self compareNameAtIndex:mid withBytes:nameBytes length:nameLength] < 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    if (low < self.count && [self compareNameAtIndex:low withBytes:nameBytes length:nameLength] == 0)
+    {
+        return low;
+    }
+    return NSNotFound;
+}
+
+-(NSRange)rangeOfBlobsWithPrefix:(NSString *)prefix
+{
+    const char *prefixBytes = [prefix UTF8String];
+    size_t prefixLength = strlen(prefixBytes);
+    const uint64_t *offsets = _nameOffsets.bytes;
+    const char *arena = _nameArena.bytes;
+
+    if (!self.sortedByName)
+    {
+        // Only a contiguous run can be returned, so the first match and everything after it that matches.
+        NSUInteger first = NSNotFound;
+        for (NSUInteger i = 0; i < self.count; i++)
+        {
+            BOOL hasPrefix = ((offsets[i + 1] - offsets[i]) >= prefixLength) && (memcmp(arena + offsets[i], prefixBytes, prefixLength) == 0);
+            if (hasPrefix && first == NSNotFound)
+            {
+                first = i;
+            }
+            else if (!hasPrefix && first != NSNotFound)
+            {
+                return NSMakeRange(first, i - first);
+            }
+        }
+        return (first == NSNotFound) ? NSMakeRange(NSNotFound, 0) : NSMakeRange(first, self.count - first);
+    }
+
+    // Names with the prefix sort after every name less than the prefix, and before every greater name without it.
+    NSUInteger low = 0;
+    NSUInteger high = self.count;
+    while (low < high)
+    {
+        NSUInteger mid = low + ((high - low) / 2);
+        if ([self compareNameAtIndex:mid withBytes:prefixBytes length:prefixLength] < 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    NSUInteger first = low;
+    high = self.count;
+    while (low < high)
+    {
+        NSUInteger mid = low + ((high - low) / 2);
+        BOOL hasPrefix = ((offsets[mid + 1] - offsets[mid]) >= prefixLength) && (memcmp(arena + offsets[mid], prefixBytes, prefixLength) == 0);
+        if (hasPrefix)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return NSMakeRange(first, low - first);
+}
+
+-(NSData *)sparseValuesData
+{
+    NSMutableDictionary *unpackedETags = [NSMutableDictionary dictionaryWithCapacity:_unpackedETags.count];
+    [_unpackedETags enumerateKeysAndObjectsUsingBlock:^(NSNumber *index, NSString *eTag, BOOL *stop) {
+        unpackedETags[index.stringValue] = eTag;
+    }];
+
+    NSMutableDictionary *snapshotTimes = [NSMutableDictionary dictionaryWithCapacity:_snapshotTimes.count];
+    [_snapshotTimes enumerateKeysAndObjectsUsingBlock:^(NSNumber *index, NSString *snapshotTime, BOOL *stop) {
+        snapshotTimes[index.stringValue] = snapshotTime;
+    }];
+
+    return [NSPropertyListSerialization dataWithPropertyList:@{@"ETags" : unpackedETags, @"Snapshots" : snapshotTimes} format:NSPropertyListBinaryFormat_v1_0 options:0 error:nil];
+}
+
+-(BOOL)writeToFile:(NSString *)path error:(NSError **)error
+{
+    NSData *sparseValues = [self sparseValuesData];
+
+    AZSInventoryFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = AZSInventoryFileMagic;
+    header.version = AZSInventoryFileVersion;
+    header.count = self.count;
+    header.nameArenaLength = _nameArena.length;
+    header.sparseValuesLength = sparseValues.length;
+    header.sortedByName = self.sortedByName ? 1 : 0;
+
+    NSMutableData *fileData = [NSMutableData dataWithCapacity:sizeof(header) + _nameOffsets.length + _lengths.length + _lastModifiedTimes.length + _eTags.length + _contentMD5s.length + _nameArena.length + _flags.length + sparseValues.length];
+    [fileData appendBytes:&header length:sizeof(header)];
+    [fileData appendData:_nameOffsets];
+    [fileData appendData:_lengths];
+    [fileData appendData:_lastModifiedTimes];
+    [fileData appendData:_eTags];
+    [fileData appendData:_contentMD5s];
+    [fileData appendData:_nameArena];
+    [fileData appendData:_flags];
+    [fileData appendData:sparseValues];
+
+    return [fileData writeToFile:path options:NSDataWritingAtomic error:error];
+}
+
+-(instancetype)initWithContainer:(AZSCloudBlobContainer *)container contentsOfFile:(NSString *)path error:(NSError **)error
+{
+    self = [self initWithContainer:container];
+    if (!self)
+    {
+        return nil;
+    }
+
+    NSData *mappedData = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:error];
+    if (!mappedData)
+    {
+        return nil;
+    }
+
+    AZSInventoryFileHeader header;
+    if (mappedData.length < sizeof(header))
+    {
+        if (error)
+        {
+            *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEParseError userInfo:nil];
+        }
+        return nil;
+    }
+    memcpy(&header, mappedData.bytes, sizeof(header));
+
+    uint64_t count = header.count;
+    uint64_t expectedLength = sizeof(header) + ((count + 1) * sizeof(uint64_t)) + (count * (3 * sizeof(uint64_t) + 16 + 1)) + header.nameArenaLength + header.sparseValuesLength;
+    if (header.magic != AZSInventoryFileMagic || header.version != AZSInventoryFileVersion || count > (mappedData.length / 8) || mappedData.length != expectedLength)
+    {
+        if (error)
+        {
+            *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEParseError userInfo:nil];
+        }
+        return nil;
+    }
+
+    // The columns are views into the mapped file; nothing but the sparse values is copied.
+    const uint8_t *bytes = mappedData.bytes;
+    __block NSUInteger position = sizeof(header);
+    NSData *(^nextColumn)(uint64_t) = ^NSData *(uint64_t length) {
+        NSData *column = [NSData dataWithBytesNoCopy:(void *)(bytes + position) length:(NSUInteger)length freeWhenDone:NO];
+        position += (NSUInteger)length;
+        return column;
+    };
+
+    _mappedData = mappedData;
+    _nameOffsets = nextColumn((count + 1) * sizeof(uint64_t));
+    _lengths = nextColumn(count * sizeof(uint64_t));
+    _lastModifiedTimes = nextColumn(count * sizeof(int64_t));
+    _eTags = nextColumn(count * sizeof(uint64_t));
+    _contentMD5s = nextColumn(count * 16);
+    _nameArena = nextColumn(header.nameArenaLength);
+    _flags = nextColumn(count);
+    NSData *sparseValues = nextColumn(header.sparseValuesLength);
+
+    const uint64_t *offsets = _nameOffsets.bytes;
+    if (offsets[0] != 0 || offsets[count] != header.nameArenaLength)
+    {
+        if (error)
+        {
+            *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEParseError userInfo:nil];
+        }
+        return nil;
+    }
+
+    NSDictionary *sparseDictionary = [NSPropertyListSerialization propertyListWithData:sparseValues options:NSPropertyListImmutable format:NULL error:error];
+    if (![sparseDictionary isKindOfClass:[NSDictionary class]])
+    {
+        return nil;
+    }
+
+    NSMutableDictionary *unpackedETags = _unpackedETags;
+    [sparseDictionary[@"ETags"] enumerateKeysAndObjectsUsingBlock:^(NSString *index, NSString *eTag, BOOL *stop) {
+        unpackedETags[@((NSUInteger)index.longLongValue)] = eTag;
+    }];
+
+    NSMutableDictionary *snapshotTimes = _snapshotTimes;
+    [sparseDictionary[@"Snapshots"] enumerateKeysAndObjectsUsingBlock:^(NSString *index, NSString *snapshotTime, BOOL *stop) {
+        snapshotTimes[@((NSUInteger)index.longLongValue)] = snapshotTime;
+    }];
+
+    _count = (NSUInteger)count;
+    _sortedByName = (header.sortedByName != 0);
+    return self;
+}
+
+@end
@@ -20,6 +20,7 @@
 #import "AZSBlockListItem.h"
 #import "AZSBlobUploadHelper.h"
 #import "AZSOperationContext.h"
+#import "AZSLogging.h"
 
 @interface AZSBlobOutputStream()
 
@@ -59,7 +60,7 @@ void AZSBlobOutputStreamRunLoopSourceCancelRoutine (void *info, CFRunLoopRef rl,
 void AZSBlobOutputStreamRunLoopSourcePerformRoutine (void *info)
 {
     AZSBlobOutputStream *stream = (__bridge AZSBlobOutputStream *)info;
-    [stream.blobUploadHelper.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Perform Routine called."];
+    AZSLogDebug(stream.blobUploadHelper.operationContext, @"Perform Routine called.");
     BOOL fireStreamOpenEvent = NO;
     BOOL hasSpaceAvailable = NO;
     BOOL fireStreamErrorEvent = NO;
@@ -222,7 +223,7 @@ void AZSBlobOutputStreamRunLoopSourcePerformRoutine (void *info)
 
 -(void)fireStreamEvent
 {
-    [self.blobUploadHelper.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Fire stream event called."];
+    AZSLogDebug(self.blobUploadHelper.operationContext, @"Fire stream event called.");
 
     CFRunLoopSourceSignal(self.runLoopSource);
     
@@ -234,7 +235,7 @@ void AZSBlobOutputStreamRunLoopSourcePerformRoutine (void *info)
 
 -(void)open
 {
-    [self.blobUploadHelper.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Called open."];
+    AZSLogDebug(self.blobUploadHelper.operationContext, @"Called open.");
     
     [self.blobUploadHelper openWithCompletionHandler:^(BOOL success) {
         self.isStreamOpen = success;
@@ -274,7 +275,7 @@ void AZSBlobOutputStreamRunLoopSourcePerformRoutine (void *info)
 
 -(void)close
 {
-    [self.blobUploadHelper.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Called close."];
+    AZSLogDebug(self.blobUploadHelper.operationContext, @"Called close.");
     self.isStreamClosing = YES;
     self.isStreamOpen = NO;
     if (![self.blobUploadHelper closeWithCompletionHandler:^{
@@ -292,7 +293,7 @@ void AZSBlobOutputStreamRunLoopSourcePerformRoutine (void *info)
 // TODO: NSStreamStatusError
 -(NSStreamStatus) streamStatus
 {
-    [self.blobUploadHelper.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Stream status requested."];
+    AZSLogDebug(self.blobUploadHelper.operationContext, @"Stream status requested.");
     if (self.streamError)
     {
         return NSStreamStatusError;
@@ -324,7 +325,7 @@ void AZSBlobOutputStreamRunLoopSourcePerformRoutine (void *info)
 
 -(void)scheduleInRunLoop:runLoop forMode:(NSString *)mode
 {
-    [self.blobUploadHelper.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Schedule in run loop requested."];
+    AZSLogDebug(self.blobUploadHelper.operationContext, @"Schedule in run loop requested.");
     CFRunLoopRef cfRunLoop = [runLoop getCFRunLoop];
     CFRunLoopAddSource(cfRunLoop, self.runLoopSource, (__bridge CFStringRef)(mode) /*kCFRunLoopDefaultMode*/);
     
@@ -339,7 +340,7 @@ void AZSBlobOutputStreamRunLoopSourcePerformRoutine (void *info)
 
 -(void)removeFromRunLoop:runLoop forMode:(NSString *)mode
 {
-    [self.blobUploadHelper.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Remove from run loop requested."];
+    AZSLogDebug(self.blobUploadHelper.operationContext, @"Remove from run loop requested.");
     // TODO: Call CFBridgingRelease(self).
     CFRunLoopRef cfRunLoop = [runLoop getCFRunLoop];
     CFRunLoopRemoveSource(cfRunLoop, self.runLoopSource, (__bridge CFStringRef)(mode) /*kCFRunLoopDefaultMode*/);
@@ -352,7 +353,7 @@ void AZSBlobOutputStreamRunLoopSourcePerformRoutine (void *info)
 
 -(id)propertyForKey:(NSString *)key
 {
-    [self.blobUploadHelper.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Property for key requested.  Key = %@", key];
+    AZSLogDebug(self.blobUploadHelper.operationContext, @"Property for key requested.  Key = %@", key);
 
     // TODO: Decide if we want to support NSStreamFileCurrentOffsetKey.  (Note that not all blobs are files.)
     return nil;
@@ -360,7 +361,7 @@ void AZSBlobOutputStreamRunLoopSourcePerformRoutine (void *info)
 
 -(BOOL)setProperty:(id)property forKey:(NSString *)key
 {
-    [self.blobUploadHelper.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"SetProperty for key requested.  Key = %@", key];
+    AZSLogDebug(self.blobUploadHelper.operationContext, @"SetProperty for key requested.  Key = %@", key);
 
     // TODO: Decide if we want to support NSStreamFileCurrentOffsetKey.  (Note that not all blobs are files.)
     return NO;
@@ -42,6 +42,10 @@ AZS_ASSUME_NONNULL_BEGIN
 /** The Content-MD5 header for the blob.  Set this, then upload the blob to set it on the service.*/
 @property (copy, AZSNullable) NSString *contentMD5;
 
+/** The CRC64 of the blob's content, as last calculated by the library with useTransactionalCRC64 set: after uploading the
+ blob from data, a stream or an AZSBlobOutputStream, or downloading the whole blob.  This is not stored on the service.*/
+@property (copy, AZSNullable) NSString *contentCRC64;
+
 /** The Content-Type header for the blob.  Set this, then upload the blob to set it on the service.*/
 @property (copy, AZSNullable) NSString *contentType;
 
@@ -198,7 +198,7 @@
     return request;
 }
 
-+(NSMutableURLRequest *) putBlockWithLength:(NSUInteger)length blockID:(NSString *)blockID contentMD5:(NSString *)contentMD5 accessCondition:(AZSAccessCondition *)accessCondition urlComponents:(NSURLComponents *)urlComponents timeout:(NSTimeInterval)timeout operationContext:(AZSOperationContext *)operationContext
++(NSMutableURLRequest *) putBlockWithLength:(NSUInteger)length blockID:(NSString *)blockID contentMD5:(NSString *)contentMD5 contentCRC64:(NSString *)contentCRC64 accessCondition:(AZSAccessCondition *)accessCondition urlComponents:(NSURLComponents *)urlComponents timeout:(NSTimeInterval)timeout operationContext:(AZSOperationContext *)operationContext
 {
     urlComponents.percentEncodedQuery = [AZSRequestFactory appendToQuery:urlComponents.percentEncodedQuery stringToAppend:AZSCQueryCompBlock];
     urlComponents.percentEncodedQuery = [AZSRequestFactory appendToQuery:urlComponents.percentEncodedQuery stringToAppend:[NSString stringWithFormat:AZSCQueryTemplateBlockId,blockID]];
@@ -209,6 +209,7 @@
     
     [AZSRequestFactory applyLeaseIdToRequest:request condition:accessCondition];
     [AZSUtil addOptionalHeaderToRequest:request header:AZSCContentMd5 stringValue:contentMD5];
+    [AZSBlobRequestFactory addContentCRC64ToRequest:request contentCRC64:contentCRC64];
     [AZSRequestFactory applyAccessConditionToRequest:request condition:accessCondition];
     return request;
 }
@@ -260,7 +261,7 @@
 }
 
 
-+(NSMutableURLRequest *) getBlobWithSnapshotTime:(NSString *)snapshotTime range:(AZSULLRange)range getRangeContentMD5:(BOOL)getRangeContentMD5 accessCondition:(AZSAccessCondition *)accessCondition urlComponents:(NSURLComponents *)urlComponents timeout:(NSTimeInterval)timeout operationContext:(AZSOperationContext *)operationContext
++(NSMutableURLRequest *) getBlobWithSnapshotTime:(NSString *)snapshotTime range:(AZSULLRange)range getRangeContentMD5:(BOOL)getRangeContentMD5 getRangeContentCRC64:(BOOL)getRangeContentCRC64 accessCondition:(AZSAccessCondition *)accessCondition urlComponents:(NSURLComponents *)urlComponents timeout:(NSTimeInterval)timeout operationContext:(AZSOperationContext *)operationContext
 {
     if (snapshotTime)
     {
@@ -276,6 +277,11 @@
         {
             [AZSUtil addOptionalHeaderToRequest:request header:AZSCHeaderRangeGetContent stringValue:AZSCTrue];
         }
+        if (getRangeContentCRC64)
+        {
+            [AZSUtil addOptionalHeaderToRequest:request header:AZSCHeaderRangeGetContentCrc64 stringValue:AZSCTrue];
+            [request setValue:AZSCTargetStorageVersionCRC64 forHTTPHeaderField:AZSCHeaderVersion];
+        }
     }
     
     [AZSRequestFactory applyAccessConditionToRequest:request condition:accessCondition];
@@ -485,7 +491,7 @@
     return request;
 }
 
-+(NSMutableURLRequest *) putPagesWithPageRange:(AZSULLRange)pageRange clear:(BOOL)clear contentMD5:(NSString *)contentMD5 accessCondition:(AZSAccessCondition *)accessCondition urlComponents:(NSURLComponents *)urlComponents timeout:(NSTimeInterval)timeout operationContext:(AZSOperationContext *)operationContext
++(NSMutableURLRequest *) putPagesWithPageRange:(AZSULLRange)pageRange clear:(BOOL)clear contentMD5:(NSString *)contentMD5 contentCRC64:(NSString *)contentCRC64 accessCondition:(AZSAccessCondition *)accessCondition urlComponents:(NSURLComponents *)urlComponents timeout:(NSTimeInterval)timeout operationContext:(AZSOperationContext *)operationContext
 {
     urlComponents.percentEncodedQuery = [AZSRequestFactory appendToQuery:urlComponents.percentEncodedQuery stringToAppend:AZSCQueryCompPage];
     
@@ -515,6 +521,7 @@
         [request setValue:[NSString stringWithFormat:@"%lu", (unsigned long)pageRange.length] forHTTPHeaderField:AZSCContentLength];
         [request setValue:AZSCHeaderValueUpdate forHTTPHeaderField:AZSCHeaderPageWrite];
         [AZSUtil addOptionalHeaderToRequest:request header:AZSCContentMd5 stringValue:contentMD5];
+        [AZSBlobRequestFactory addContentCRC64ToRequest:request contentCRC64:contentCRC64];
     }
     [AZSRequestFactory applyAccessConditionToRequest:request condition:accessCondition];
     [AZSBlobRequestFactory applySequenceNumberConditionToRequest:request condition:accessCondition];
@@ -587,7 +594,7 @@
     return request;
 }
 
-+(NSMutableURLRequest *) appendBlockWithLength:(NSUInteger)length contentMD5:(NSString *)contentMD5 accessCondition:(AZSAccessCondition *)accessCondition urlComponents:(NSURLComponents *)urlComponents timeout:(NSTimeInterval)timeout operationContext:(AZSOperationContext *)operationContext
++(NSMutableURLRequest *) appendBlockWithLength:(NSUInteger)length contentMD5:(NSString *)contentMD5 contentCRC64:(NSString *)contentCRC64 accessCondition:(AZSAccessCondition *)accessCondition urlComponents:(NSURLComponents *)urlComponents timeout:(NSTimeInterval)timeout operationContext:(AZSOperationContext *)operationContext
 {
     urlComponents.percentEncodedQuery = [AZSRequestFactory appendToQuery:urlComponents.percentEncodedQuery stringToAppend:AZSCQueryCompAppendBlock];
     
@@ -597,6 +604,7 @@
     
     [AZSRequestFactory applyLeaseIdToRequest:request condition:accessCondition];
     [AZSUtil addOptionalHeaderToRequest:request header:AZSCContentMd5 stringValue:contentMD5];
+    [AZSBlobRequestFactory addContentCRC64ToRequest:request contentCRC64:contentCRC64];
     [AZSRequestFactory applyAccessConditionToRequest:request condition:accessCondition];
     [AZSBlobRequestFactory applyMaxSizeAndAppendPositionToRequest:request condition:accessCondition];
     return request;
@@ -682,6 +690,17 @@
     }
 }
 
+// The service ignores x-ms-content-crc64 on requests older than AZSCTargetStorageVersionCRC64, so requests that carry one
+// are sent with that version instead.
++(void) addContentCRC64ToRequest:(NSMutableURLRequest *)request contentCRC64:(NSString *)contentCRC64
+{
+    if (contentCRC64)
+    {
+        [request setValue:contentCRC64 forHTTPHeaderField:AZSCHeaderContentCrc64];
+        [request setValue:AZSCTargetStorageVersionCRC64 forHTTPHeaderField:AZSCHeaderVersion];
+    }
+}
+
 +(void) applyMaxSizeAndAppendPositionToRequest:(NSMutableURLRequest *)request condition:(AZSAccessCondition *)accessCondition
 {
     if (accessCondition.maxSize)
@@ -31,6 +31,14 @@ AZS_ASSUME_NONNULL_BEGIN
  header stored on a blob.*/
 @property BOOL useTransactionalMD5;
 
+/** If YES, all operations that support it will send or request a CRC64 of the message bodies, in the
+ x-ms-content-crc64 header, for the service and the client to validate.  CRC64 is much cheaper to compute than MD5.
+ The service honours these headers from version 2019-02-02, so requests that carry them are sent with that version.
+ The CRC64 of the whole blob, combined from those of its blocks, is kept in AZSBlobProperties.contentCRC64 after an
+ upload from data, a stream or an AZSBlobOutputStream, or a download of the whole blob.  This has nothing to do with the
+ content-MD5 header stored on a blob.*/
+@property BOOL useTransactionalCRC64;
+
 /** If YES, when uploading a blob, the content-MD5 header will be stored along with the blob.  If one is not supplied,
  the library will calculate one where possible.*/
 @property BOOL storeBlobContentMD5;
@@ -41,6 +49,9 @@ AZS_ASSUME_NONNULL_BEGIN
 /** The number of simultaneous outstanding block uploads to permit when uploading a blob as a series of blocks.*/
 @property NSInteger parallelismFactor;
 
+/** The size of each block when uploading a block blob as a series of blocks.  Defaults to, and is capped at, 4 MB.*/
+@property NSUInteger blockSize;
+
 /** If YES, when uploading an append blob in a streaming fashion, conditional errors should be ignored.
  
  When uploading append blobs in a streaming fashion, an append-offset conditional header is used to avoid duplicate blocks.
@@ -16,13 +16,16 @@
 // -----------------------------------------------------------------------------------------
 
 #import "AZSBlobRequestOptions.h"
+#import "AZSConstants.h"
 
 @interface AZSBlobRequestOptions()
 {
     BOOL _useTransactionalMD5Set;
+    BOOL _useTransactionalCRC64Set;
     BOOL _storeBlobContentMD5Set;
     BOOL _disableContentMD5ValidationSet;
     BOOL _parallelismFactorSet;
+    BOOL _blockSizeSet;
     BOOL _absorbConditionalErrorsOnRetrySet;
 }
 
@@ -31,9 +34,11 @@
 @implementation AZSBlobRequestOptions
 
 @synthesize useTransactionalMD5 = _useTransactionalMD5;
+@synthesize useTransactionalCRC64 = _useTransactionalCRC64;
 @synthesize storeBlobContentMD5 = _storeBlobContentMD5;
 @synthesize disableContentMD5Validation = _disableContentMD5Validation;
 @synthesize parallelismFactor = _parallelismFactor;
+@synthesize blockSize = _blockSize;
 @synthesize absorbConditionalErrorsOnRetry = _absorbConditionalErrorsOnRetry;
 
 -(instancetype)init
@@ -44,12 +49,16 @@
         // Set defaults for blob-specific options
         _useTransactionalMD5 = NO;
         _useTransactionalMD5Set = NO;
+        _useTransactionalCRC64 = NO;
+        _useTransactionalCRC64Set = NO;
         _storeBlobContentMD5 = NO;
         _storeBlobContentMD5Set = NO;
         _disableContentMD5Validation = NO;
         _disableContentMD5ValidationSet = NO;
         _parallelismFactor = 3;
         _parallelismFactorSet = NO;
+        _blockSize = AZSCMaxBlockSize;
+        _blockSizeSet = NO;
         _absorbConditionalErrorsOnRetry = NO;
         _absorbConditionalErrorsOnRetrySet = NO;
     }
@@ -76,6 +85,11 @@
             self.useTransactionalMD5 = sourceOptions.useTransactionalMD5;
         }
         
+        if (sourceOptions->_useTransactionalCRC64Set)
+        {
+            self.useTransactionalCRC64 = sourceOptions.useTransactionalCRC64;
+        }
+        
         if (sourceOptions->_storeBlobContentMD5Set)
         {
             self.storeBlobContentMD5 = sourceOptions.storeBlobContentMD5;
@@ -91,6 +105,11 @@
             self.parallelismFactor = sourceOptions.parallelismFactor;
         }
         
+        if (sourceOptions->_blockSizeSet)
+        {
+            self.blockSize = sourceOptions.blockSize;
+        }
+        
         if (sourceOptions->_absorbConditionalErrorsOnRetrySet)
         {
             self.absorbConditionalErrorsOnRetry = sourceOptions.absorbConditionalErrorsOnRetry;
@@ -124,6 +143,17 @@
     _useTransactionalMD5Set = YES;
 }
 
+-(BOOL)useTransactionalCRC64
+{
+    return _useTransactionalCRC64;
+}
+
+-(void)setUseTransactionalCRC64:(BOOL)useTransactionalCRC64
+{
+    _useTransactionalCRC64 = useTransactionalCRC64;
+    _useTransactionalCRC64Set = YES;
+}
+
 -(BOOL)storeBlobContentMD5
 {
     return _storeBlobContentMD5;
@@ -157,6 +187,17 @@
     _parallelismFactorSet = YES;
 }
 
+-(NSUInteger)blockSize
+{
+    return _blockSize;
+}
+
+-(void)setBlockSize:(NSUInteger)blockSize
+{
+    _blockSize = blockSize;
+    _blockSizeSet = YES;
+}
+
 -(BOOL)absorbConditionalErrorsOnRetry
 {
     return _absorbConditionalErrorsOnRetry;
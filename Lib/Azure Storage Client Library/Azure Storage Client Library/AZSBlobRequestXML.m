@@ -28,6 +28,7 @@
 #import "AZSSharedAccessPolicy.h"
 #import "AZSSharedAccessSignatureHelper.h"
 #import "AZSUtil.h"
+#import "AZSLogging.h"
 
 @interface AZSBlobRequestXML()
 
@@ -48,7 +49,7 @@
     if (!*error && returnCode < 0)
     {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEXMLCreationError userInfo:@{@"xmlReturnCode":@(returnCode)}];
-        [operationContext logAtLevel:AZSLogLevelError withMessage:@"Error in generating XML."];
+        AZSLogError(operationContext, @"Error in generating XML.");
     }
 }
 
@@ -61,7 +62,7 @@
     if (buffer == NULL)
     {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEXMLCreationError userInfo:nil];
-        [operationContext logAtLevel:AZSLogLevelError withMessage:@"Error in generating XML block list."];
+        AZSLogError(operationContext, @"Error in generating XML block list.");
         return nil;
     }
     
@@ -69,7 +70,7 @@
     if (writer == NULL)
     {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEXMLCreationError userInfo:nil];
-        [operationContext logAtLevel:AZSLogLevelError withMessage:@"Error in generating XML block list."];
+        AZSLogError(operationContext, @"Error in generating XML block list.");
         xmlBufferFree(buffer);
         return nil;
     }
@@ -98,7 +99,7 @@
                 break;
             default:
                 *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEXMLCreationError userInfo:nil];
-                [operationContext logAtLevel:AZSLogLevelError withMessage:@"Error in generating XML block list."];
+                AZSLogError(operationContext, @"Error in generating XML block list.");
                 break;
         }
         
@@ -133,7 +134,7 @@
     if (buffer == NULL)
     {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEXMLCreationError userInfo:nil];
-        [operationContext logAtLevel:AZSLogLevelError withMessage:@"Error in generating XML block list."];
+        AZSLogError(operationContext, @"Error in generating XML block list.");
         return nil;
     }
     
@@ -141,7 +142,7 @@
     if (writer == NULL)
     {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEXMLCreationError userInfo:nil];
-        [operationContext logAtLevel:AZSLogLevelError withMessage:@"Error in generating XML block list."];
+        AZSLogError(operationContext, @"Error in generating XML block list.");
         xmlBufferFree(buffer);
         return nil;
     }
@@ -230,7 +231,7 @@
     if (buffer == NULL)
     {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEXMLCreationError userInfo:nil];
-        [operationContext logAtLevel:AZSLogLevelError withMessage:@"Error in generating service properties XML."];
+        AZSLogError(operationContext, @"Error in generating service properties XML.");
         return nil;
     }
 
@@ -238,7 +239,7 @@
     if (writer == NULL)
     {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEXMLCreationError userInfo:nil];
-        [operationContext logAtLevel:AZSLogLevelError withMessage:@"Error in generating service propertes XML."];
+        AZSLogError(operationContext, @"Error in generating service propertes XML.");
         xmlBufferFree(buffer);
         return nil;
     }
@@ -19,6 +19,7 @@
 #import "AZSEnums.h"
 @class AZSBlobContainerPermissions;
 @class AZSBlobContainerProperties;
+@class AZSBlobListingInventory;
 @class AZSBlobProperties;
 @class AZSCopyState;
 @class AZSOperationContext;
@@ -55,6 +56,9 @@
 @property (strong) NSString *nextMarker;
 +(instancetype)parseListBlobsResponseWithData:(NSData *)data operationContext:(AZSOperationContext *)operationContext error:(NSError **)error;
 
+// Appends the listed blobs straight into the inventory instead of building AZSBlobListItems; blobListItems is left nil.
++(instancetype)parseListBlobsResponseWithData:(NSData *)data inventory:(AZSBlobListingInventory *)inventory operationContext:(AZSOperationContext *)operationContext error:(NSError **)error;
+
 @end
 
 @interface AZSDownloadContainerPermissions : NSObject
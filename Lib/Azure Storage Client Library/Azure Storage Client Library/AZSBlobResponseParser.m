@@ -22,6 +22,7 @@
 #import "AZSUtil.h"
 #import "AZSEnums.h"
 #import "AZSBlobProperties.h"
+#import "AZSBlobListingInventory.h"
 #import "AZSCopyState.h"
 #import "AZSCorsRule.h"
 #import "AZSResponseParser.h"
@@ -33,6 +34,7 @@
 #import "AZSSharedAccessSignatureHelper.h"
 #import "AZSErrors.h"
 #import "AZSULLRange.h"
+#import "AZSLogging.h"
 
 @implementation AZSContainerListItem
 
@@ -84,7 +86,7 @@
     
     parserDelegate.parseBeginElement = ^(NSXMLParser *parser, NSString *elementName,NSDictionary *attributeDict)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Beginning to parse element with name = %@", elementName];
+        AZSLogDebug(operationContext, @"Beginning to parse element with name = %@", elementName);
         [elementStack addObject:elementName];
         if ([currentXmlText length] > 0)
         {
@@ -94,7 +96,7 @@
     
     parserDelegate.parseEndElement = ^(NSXMLParser *parser, NSString *elementName)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Ending to parse element with name = %@", elementName];
+        AZSLogDebug(operationContext, @"Ending to parse element with name = %@", elementName);
         NSString *currentNode = elementStack.lastObject;
         [elementStack removeLastObject];
         
@@ -138,7 +140,7 @@
         {
             if ([currentNode isEqualToString:AZSCXmlLastModified])
             {
-                currentContainer.properties.lastModified = [[AZSUtil dateFormatterWithRFCFormat] dateFromString:currentXmlText];
+                currentContainer.properties.lastModified = [AZSUtil dateFromHttpString:currentXmlText];
             }
             else if ([currentNode isEqualToString:[AZSCXmlETag capitalizedString]])
             {
@@ -202,7 +204,7 @@
     
     parserDelegate.foundCharacters = ^(NSXMLParser *parser, NSString *characters)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Found characters = %@", characters];
+        AZSLogDebug(operationContext, @"Found characters = %@", characters);
         [currentXmlText appendString:characters];
     };
 
@@ -212,7 +214,7 @@
     if (!parseSuccessful)
     {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEParseError userInfo:nil];
-        [operationContext logAtLevel:AZSLogLevelError withMessage:@"Parse unsuccessful for list containers response."];
+        AZSLogError(operationContext, @"Parse unsuccessful for list containers response.");
         return nil;
     }
     
@@ -243,7 +245,7 @@
 
     parserDelegate.parseBeginElement = ^(NSXMLParser *parser, NSString *elementName,NSDictionary *attributeDict)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Beginning to parse element with name = %@", elementName];
+        AZSLogDebug(operationContext, @"Beginning to parse element with name = %@", elementName);
         [elementStack addObject:elementName];
         if ([currentXmlText length] > 0)
         {
@@ -254,7 +256,7 @@
 
     parserDelegate.parseEndElement = ^(NSXMLParser *parser, NSString *elementName)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Ending to parse element with name = %@", elementName];
+        AZSLogDebug(operationContext, @"Ending to parse element with name = %@", elementName);
         NSString *currentNode = elementStack.lastObject;
         [elementStack removeLastObject];
         
@@ -306,7 +308,7 @@
         {
             if ([currentNode isEqualToString:AZSCXmlLastModified])
             {
-                currentBlobItem.properties.lastModified = [[AZSUtil dateFormatterWithRFCFormat] dateFromString:currentXmlText];
+                currentBlobItem.properties.lastModified = [AZSUtil dateFromHttpString:currentXmlText];
             }
             else if ([currentNode isEqualToString:[AZSCXmlETag capitalizedString]])
             {
@@ -435,7 +437,7 @@
             }
             else if ([currentNode isEqualToString:AZSCXmlCopyCompletionTime])
             {
-                currentBlobItem.blobCopyState.completionTime = [[AZSUtil dateFormatterWithRFCFormat] dateFromString:currentXmlText];
+                currentBlobItem.blobCopyState.completionTime = [AZSUtil dateFromHttpString:currentXmlText];
             }
             else if ([currentNode isEqualToString:AZSCXmlCopyStatusDescription])
             {
@@ -466,7 +468,7 @@
     
     parserDelegate.foundCharacters = ^(NSXMLParser *parser, NSString *characters)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Found characters = %@", characters];
+        AZSLogDebug(operationContext, @"Found characters = %@", characters);
         [currentXmlText appendString:characters];
     };
     
@@ -476,7 +478,7 @@
     if (!parseSuccessful)
     {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEParseError userInfo:nil];
-        [operationContext logAtLevel:AZSLogLevelError withMessage:@"Parse unsuccessful for list blobs response."];
+        AZSLogError(operationContext, @"Parse unsuccessful for list blobs response.");
         return nil;
     }
     
@@ -485,6 +487,150 @@
     listBlobsResponse.nextMarker = nextMarker;
     return listBlobsResponse;
 }
+
++(instancetype)parseListBlobsResponseWithData:(NSData *)data inventory:(AZSBlobListingInventory *)inventory operationContext:(AZSOperationContext *)operationContext error:(NSError **)error
+{
+    AZSStorageXMLParserDelegate *parserDelegate = [[AZSStorageXMLParserDelegate alloc] init];
+    
+    NSXMLParser *parser = [[NSXMLParser alloc] initWithData:data];
+    parser.shouldProcessNamespaces = NO;
+    
+    // Only the columns kept by the inventory are parsed, and per-entry state is held in locals rather than in an
+    // AZSBlobListItem, so that nothing but the inventory entry is allocated per blob.
+    NSString *eTagElementName = [AZSCXmlETag capitalizedString];
+    __block NSMutableArray *elementStack = [NSMutableArray arrayWithCapacity:10];
+    __block NSMutableString *currentXmlText = [[NSMutableString alloc] init];
+    __block NSString *nextMarker = nil;
+    __block NSString *currentName = nil;
+    __block NSString *currentSnapshotTime = nil;
+    __block NSString *currentETag = nil;
+    __block NSString *currentContentMD5 = nil;
+    __block NSDate *currentLastModified = nil;
+    __block uint64_t currentLength = 0;
+    __block AZSBlobType currentBlobType = AZSBlobTypeUnspecified;
+    
+    parserDelegate.parseBeginElement = ^(NSXMLParser *parser, NSString *elementName,NSDictionary *attributeDict)
+    {
+        [elementStack addObject:elementName];
+        if ([currentXmlText length] > 0)
+        {
+            currentXmlText = [[NSMutableString alloc] init];
+        }
+    };
+    
+    parserDelegate.parseEndElement = ^(NSXMLParser *parser, NSString *elementName)
+    {
+        NSString *currentNode = elementStack.lastObject;
+        [elementStack removeLastObject];
+        
+        if (![elementName isEqualToString:currentNode])
+        {
+            // Malformed XML
+            [parser abortParsing];
+        }
+        
+        NSString *parentNode = elementStack.lastObject;
+        if ([parentNode isEqualToString:AZSCXmlBlobs])
+        {
+            if ([currentNode isEqualToString:AZSCXmlBlob])
+            {
+                [inventory addBlobWithName:currentName length:currentLength lastModified:currentLastModified eTag:currentETag contentMD5:currentContentMD5 blobType:currentBlobType snapshotTime:currentSnapshotTime];
+            }
+            
+            currentName = nil;
+            currentSnapshotTime = nil;
+            currentETag = nil;
+            currentContentMD5 = nil;
+            currentLastModified = nil;
+            currentLength = 0;
+            currentBlobType = AZSBlobTypeUnspecified;
+        }
+        else if ([parentNode isEqualToString:AZSCXmlBlob])
+        {
+            if ([currentNode isEqualToString:AZSCXmlName])
+            {
+                currentName = currentXmlText;
+            }
+            else if ([currentNode isEqualToString:AZSCXmlSnapshot])
+            {
+                currentSnapshotTime = currentXmlText;
+            }
+            
+            currentXmlText = [[NSMutableString alloc] init];
+        }
+        else if ([parentNode isEqualToString:AZSCXmlProperties])
+        {
+            if ([currentNode isEqualToString:AZSCXmlLastModified])
+            {
+                currentLastModified = [AZSUtil dateFromHttpString:currentXmlText];
+            }
+            else if ([currentNode isEqualToString:eTagElementName])
+            {
+                currentETag = currentXmlText;
+            }
+            else if ([currentNode isEqualToString:AZSCContentLength])
+            {
+                currentLength = strtoull([currentXmlText UTF8String], NULL, 10);
+            }
+            else if ([currentNode isEqualToString:AZSCContentMd5])
+            {
+                currentContentMD5 = currentXmlText;
+            }
+            else if ([currentNode isEqualToString:AZSCXmlBlobType])
+            {
+                if ([currentXmlText isEqualToString:AZSCBlobBlockBlob])
+                {
+                    currentBlobType = AZSBlobTypeBlockBlob;
+                }
+                else if ([currentXmlText isEqualToString:AZSCBlobPageBlob])
+                {
+                    currentBlobType = AZSBlobTypePageBlob;
+                }
+                else if ([currentXmlText isEqualToString:AZSCBlobAppendBlob])
+                {
+                    currentBlobType = AZSBlobTypeAppendBlob;
+                }
+            }
+            
+            currentXmlText = [[NSMutableString alloc] init];
+        }
+        else if ([parentNode isEqualToString:AZSCXmlEnumerationResults])
+        {
+            if ([currentNode isEqualToString:AZSCXmlNextMarker])
+            {
+                if (currentXmlText.length > 0)
+                {
+                    nextMarker = currentXmlText;
+                }
+            }
+            
+            currentXmlText = [[NSMutableString alloc] init];
+        }
+        else
+        {
+            currentXmlText = [[NSMutableString alloc] init];
+        }
+    };
+    
+    parserDelegate.foundCharacters = ^(NSXMLParser *parser, NSString *characters)
+    {
+        [currentXmlText appendString:characters];
+    };
+    
+    parser.delegate = parserDelegate;
+    
+    BOOL parseSuccessful = [parser parse];
+    if (!parseSuccessful)
+    {
+        *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEParseError userInfo:nil];
+        AZSLogError(operationContext, @"Parse unsuccessful for list blobs response.");
+        return nil;
+    }
+    
+    AZSListBlobsResponse *listBlobsResponse = [[AZSListBlobsResponse alloc] init];
+    listBlobsResponse.nextMarker = nextMarker;
+    return listBlobsResponse;
+}
 @end
 
 @implementation AZSDownloadContainerPermissions
@@ -506,7 +652,7 @@
     
     parserDelegate.parseBeginElement = ^(NSXMLParser *parser, NSString *elementName,NSDictionary *attributeDict)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Beginning to parse element with name = %@", elementName];
+        AZSLogDebug(operationContext, @"Beginning to parse element with name = %@", elementName);
         [elementStack addObject:elementName];
         if ([currentXmlText length] > 0)
         {
@@ -517,7 +663,7 @@
     
     parserDelegate.parseEndElement = ^(NSXMLParser *parser, NSString *elementName)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Ending to parse element with name = %@", elementName];
+        AZSLogDebug(operationContext, @"Ending to parse element with name = %@", elementName);
         NSString *currentNode = elementStack.lastObject;
         [elementStack removeLastObject];
         
@@ -549,11 +695,11 @@
         {
             if ([currentNode isEqualToString:AZSCXmlStart])
             {
-                currentStoredPolicy.sharedAccessStartTime = [[AZSUtil dateFormatterWithRoundtripFormat] dateFromString:currentXmlText];
+                currentStoredPolicy.sharedAccessStartTime = [AZSUtil dateFromRoundtripString:currentXmlText];
             }
             else if ([currentNode isEqualToString:AZSCXmlExpiry])
             {
-                NSDate *date = [[AZSUtil dateFormatterWithRoundtripFormat] dateFromString:currentXmlText];
+                NSDate *date = [AZSUtil dateFromRoundtripString:currentXmlText];
                 currentStoredPolicy.sharedAccessExpiryTime = date;
             }
             else if ([currentNode isEqualToString:AZSCXmlPermission])
@@ -566,7 +712,7 @@
     
     parserDelegate.foundCharacters = ^(NSXMLParser *parser, NSString *characters)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Found characters = %@", characters];
+        AZSLogDebug(operationContext, @"Found characters = %@", characters);
         [currentXmlText appendString:characters];
     };
     
@@ -575,7 +721,7 @@
     if (![parser parse])
     {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEParseError userInfo:nil];
-        [operationContext logAtLevel:AZSLogLevelError withMessage:@"Parse unsuccessful for fetch stored policies response."];
+        AZSLogError(operationContext, @"Parse unsuccessful for fetch stored policies response.");
         return nil;
     }
     
@@ -623,7 +769,7 @@
 
     parserDelegate.parseBeginElement = ^(NSXMLParser *parser, NSString *elementName,NSDictionary *attributeDict)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Beginning to parse element with name = %@", elementName];
+        AZSLogDebug(operationContext, @"Beginning to parse element with name = %@", elementName);
         [elementStack addObject:elementName];
         if ([currentXmlText length] > 0)
         {
@@ -633,7 +779,7 @@
     
     parserDelegate.parseEndElement = ^(NSXMLParser *parser, NSString *elementName)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Ending to parse element with name = %@", elementName];
+        AZSLogDebug(operationContext, @"Ending to parse element with name = %@", elementName);
         NSString *currentNode = elementStack.lastObject;
         [elementStack removeLastObject];
         
@@ -674,7 +820,7 @@
     
     parserDelegate.foundCharacters = ^(NSXMLParser *parser, NSString *characters)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Found characters = %@", characters];
+        AZSLogDebug(operationContext, @"Found characters = %@", characters);
         [currentXmlText appendString:characters];
     };
 
@@ -684,7 +830,7 @@
     if (!parseSuccessful)
     {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEParseError userInfo:nil];
-        [operationContext logAtLevel:AZSLogLevelError withMessage:@"Parse unsuccessful for get block list operation."];
+        AZSLogError(operationContext, @"Parse unsuccessful for get block list operation.");
     }
     return blockList;
 }
@@ -708,7 +854,7 @@
 
     parserDelegate.parseBeginElement = ^(NSXMLParser *parser, NSString *elementName,NSDictionary *attributeDict)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Beginning to parse element with name = %@", elementName];
+        AZSLogDebug(operationContext, @"Beginning to parse element with name = %@", elementName);
         [elementStack addObject:elementName];
         if ([builder length] > 0)
         {
@@ -718,7 +864,7 @@
     
     parserDelegate.parseEndElement = ^(NSXMLParser *parser, NSString *elementName)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Ending to parse element with name = %@", elementName];
+        AZSLogDebug(operationContext, @"Ending to parse element with name = %@", elementName);
         NSString *currentNode = elementStack.lastObject;
         [elementStack removeLastObject];
         
@@ -752,7 +898,7 @@
 
     parserDelegate.foundCharacters = ^(NSXMLParser *parser, NSString *characters)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Found characters = %@", characters];
+        AZSLogDebug(operationContext, @"Found characters = %@", characters);
         [builder appendString:characters];
     };
     
@@ -762,7 +908,7 @@
     if (!parseSuccessful)
     {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEParseError userInfo:nil];
-        [operationContext logAtLevel:AZSLogLevelError withMessage:@"Parse unsuccessful for get block list operation."];
+        AZSLogError(operationContext, @"Parse unsuccessful for get block list operation.");
     }
     return rangeList;
 }
@@ -825,7 +971,7 @@
         
         if (copyCompletionTimeString)
         {
-            result.completionTime = [[AZSUtil dateFormatterWithRoundtripFormat] dateFromString:copyCompletionTimeString];
+            result.completionTime = [AZSUtil dateFromRoundtripString:copyCompletionTimeString];
         }
     }
     
@@ -837,7 +983,7 @@
     AZSBlobProperties *result = [[AZSBlobProperties alloc] init];
     
     result.eTag = response.allHeaderFields[AZSCXmlETag];
-    result.lastModified = [[AZSUtil dateFormatterWithRFCFormat] dateFromString:response.allHeaderFields[AZSCXmlLastModified]];
+    result.lastModified = [AZSUtil dateFromHttpString:response.allHeaderFields[AZSCXmlLastModified]];
     
     result.leaseState = [AZSBlobResponseParser getLeaseStateWithResponse:response operationContext:operationContext error:error];
     if (*error)
@@ -924,7 +1070,7 @@
     AZSBlobContainerProperties *result = [[AZSBlobContainerProperties alloc] init];
     
     result.eTag = response.allHeaderFields[AZSCXmlETag];
-    result.lastModified = [[AZSUtil dateFormatterWithRFCFormat] dateFromString:response.allHeaderFields[AZSCXmlLastModified]];
+    result.lastModified = [AZSUtil dateFromHttpString:response.allHeaderFields[AZSCXmlLastModified]];
     result.leaseState = [AZSBlobResponseParser getLeaseStateWithResponse:response operationContext:operationContext error:error];
     result.leaseStatus = [AZSBlobResponseParser getLeaseStatusWithResponse:response operationContext:operationContext error:error];
     result.leaseDuration = [AZSBlobResponseParser getLeaseDurationWithResponse:response operationContext:operationContext error:error];
@@ -961,7 +1107,7 @@
         else
         {
             *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEParseError userInfo:nil];
-            [operationContext logAtLevel:AZSLogLevelError withMessage:@"Parse unsuccessful for get lease state."];
+            AZSLogError(operationContext, @"Parse unsuccessful for get lease state.");
             return AZSLeaseStateUnspecified;
         }
     }
@@ -986,7 +1132,7 @@
         else
         {
             *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEParseError userInfo:nil];
-            [operationContext logAtLevel:AZSLogLevelError withMessage:@"Parse unsuccessful for get lease status."];
+            AZSLogError(operationContext, @"Parse unsuccessful for get lease status.");
             return AZSLeaseStatusUnspecified;
         }
     }
@@ -1011,7 +1157,7 @@
         else
         {
             *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEParseError userInfo:nil];
-            [operationContext logAtLevel:AZSLogLevelError withMessage:@"Parse unsuccessful for get lease duration."];
+            AZSLogError(operationContext, @"Parse unsuccessful for get lease duration.");
             return AZSLeaseDurationUnspecified;
         }
     }
@@ -1105,7 +1251,7 @@
 
     parserDelegate.parseBeginElement = ^(NSXMLParser *parser, NSString *elementName, NSDictionary *attributeDict)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Beginning to parse element with name = %@", elementName];
+        AZSLogDebug(operationContext, @"Beginning to parse element with name = %@", elementName);
         [elementStack addObject:elementName];
         if ([currentXmlText length] > 0)
         {
@@ -1115,7 +1261,7 @@
 
     parserDelegate.parseEndElement = ^(NSXMLParser *parser, NSString *elementName)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Ending to parse element with name = %@", elementName];
+        AZSLogDebug(operationContext, @"Ending to parse element with name = %@", elementName);
         NSString *currentNode = elementStack.lastObject;
         [elementStack removeLastObject];
 
@@ -1302,7 +1448,7 @@
 
     parserDelegate.foundCharacters = ^(NSXMLParser *parser, NSString *characters)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Found characters = %@", characters];
+        AZSLogDebug(operationContext, @"Found characters = %@", characters);
         [currentXmlText appendString:characters];
     };
 
@@ -1311,7 +1457,7 @@
     if (![parser parse])
     {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEParseError userInfo:nil];
-        [operationContext logAtLevel:AZSLogLevelError withMessage:@"Parse unsuccessful for fetch stored policies response."];
+        AZSLogError(operationContext, @"Parse unsuccessful for fetch stored policies response.");
         return nil;
     }
 
@@ -27,12 +27,34 @@
 #import "AZSOperationContext.h"
 #import "AZSBlobProperties.h"
 #import "AZSAccessCondition.h"
+#import "AZSUtil.h"
+#import "AZSLogging.h"
+#import "AZSTracer.h"
+#import "AZSCryptoProvider.h"
 
-@interface AZSBlobUploadHelper()
+// Block IDs are the Base64 of "blockid" followed by a random UUID in lowercase hex, without dashes.
+static NSString *AZSCreateBlockID(void)
 {
-    CC_MD5_CTX _md5Context;
+    static const char blockIDPrefix[] = "blockid";
+    uint8_t rawBlockID[sizeof(blockIDPrefix) - 1 + AZSHexEncodedLength(sizeof(uuid_t))];
+    memcpy(rawBlockID, blockIDPrefix, sizeof(blockIDPrefix) - 1);
+
+    uuid_t uuid;
+    [[NSUUID UUID] getUUIDBytes:uuid];
+    AZSHexEncode(uuid, sizeof(uuid), (char *)rawBlockID + sizeof(blockIDPrefix) - 1, NO);
+
+    return [AZSUtil base64EncodedStringWithBytes:rawBlockID length:sizeof(rawBlockID)];
 }
 
+// The transactional CRC64 of one uploaded block, kept so the whole blob's CRC64 can be combined from them at close.
+typedef struct AZSBlockCRC64
+{
+    uint64_t crc64;
+    uint64_t length;
+} AZSBlockCRC64;
+
+@interface AZSBlobUploadHelper()
+
 @property (strong) AZSCloudBlob *underlyingBlob;
 @property (strong) NSMutableData *dataBuffer;
 @property dispatch_semaphore_t blockUploadSemaphore;
@@ -41,6 +63,7 @@
 @property NSUInteger chunksUploaded;
 @property NSUInteger blobOffset;
 @property NSInteger maxOpenUploads;
+@property NSUInteger maxBlockSize;
 @property BOOL streamWaiting;
 @property (strong) NSObject *uploadLock;
 @property (strong) AZSAccessCondition *accessCondition;
@@ -49,6 +72,16 @@
 @property BOOL createNew;
 @property NSNumber *totalPageBlobSize;
 @property NSNumber *initialPageBlobSequenceNumber;
+@property uint64_t traceBufferFillStart;
+@property (strong) id<AZSDigest> md5Digest;
+@property (strong) dispatch_queue_t md5Queue;
+@property (strong) dispatch_queue_t blockQueue;
+@property (strong) NSMutableData *blockCRC64s;
+@property (strong) id cancellationRegistration;
+
+-(NSString *)transactionalMD5ForBlock:(NSData *)blockData;
+-(NSString *)transactionalCRC64ForBlock:(NSData *)blockData index:(NSUInteger)blockIndex;
+-(NSString *)wholeBlobCRC64;
 
 @end
 
@@ -65,6 +98,28 @@
     return nil;
 }
 
+-(void)dealloc
+{
+    if (_cancellationRegistration)
+    {
+        [_operationContext removeCancellationHandler:_cancellationRegistration];
+    }
+}
+
+// Once the operation is cancelled, writes fail and no more blocks are sent.  Blocks already in flight are cancelled by
+// their own requests.
+-(void)stopOnCancellation
+{
+    __weak AZSBlobUploadHelper *weakSelf = self;
+    self.cancellationRegistration = [self.operationContext addCancellationHandler:^{
+        AZSBlobUploadHelper *strongSelf = weakSelf;
+        if (strongSelf && !strongSelf.streamingError)
+        {
+            strongSelf.streamingError = [NSError errorWithDomain:AZSErrorDomain code:AZSEOperationCancelled userInfo:@{NSLocalizedDescriptionKey:@"The operation was cancelled."}];
+        }
+    }];
+}
+
 -(instancetype)initToBlockBlob:(AZSCloudBlockBlob *)blockBlob accessCondition:(AZSAccessCondition *)accessCondition requestOptions:(AZSBlobRequestOptions *)requestOptions operationContext:(AZSOperationContext *)operationContext completionHandler:(void (^  __AZSNullable)(NSError*))completionHandler
 {
     self = [super init];
@@ -72,10 +127,12 @@
     {
         _underlyingBlob = blockBlob;
         _blobType = AZSBlobTypeBlockBlob;
-        _dataBuffer = [NSMutableData dataWithCapacity:AZSCMaxBlockSize];  //TODO: This should be user-settable.
+        _maxBlockSize = MIN(MAX(requestOptions.blockSize, (NSUInteger)1), (NSUInteger)AZSCMaxBlockSize);
+        _dataBuffer = [NSMutableData dataWithCapacity:_maxBlockSize];
         _blockIDs = [NSMutableArray arrayWithCapacity:10];
         _maxOpenUploads = requestOptions.parallelismFactor;
         _blockUploadSemaphore = dispatch_semaphore_create(self.maxOpenUploads);
+        _blockQueue = dispatch_queue_create("com.microsoft.azure.storage.uploadblocks", DISPATCH_QUEUE_CONCURRENT);
         _streamWaiting = NO;
         _uploadLock = [[NSObject alloc] init];
         _accessCondition = accessCondition ?: [[AZSAccessCondition alloc] init];
@@ -84,10 +141,13 @@
         _completionHandler = completionHandler;
         if (requestOptions.storeBlobContentMD5)
         {
-            CC_MD5_Init(&_md5Context);
+            _md5Digest = [[AZSCrypto provider] md5Digest];
+            _md5Queue = dispatch_queue_create("com.microsoft.azure.storage.uploadmd5", DISPATCH_QUEUE_SERIAL);
         }
         _streamingError = nil;
+        _blockCRC64s = [NSMutableData data];
         _createNew = NO;
+        [self stopOnCancellation];
     }
     return self;
 }
@@ -99,9 +159,11 @@
     {
         _underlyingBlob = pageBlob;
         _blobType = AZSBlobTypePageBlob;
+        _maxBlockSize = AZSCMaxBlockSize;
         _dataBuffer = [NSMutableData dataWithCapacity:AZSCMaxBlockSize];  //TODO: This should be user-settable.
         _maxOpenUploads = requestOptions.parallelismFactor;
         _blockUploadSemaphore = dispatch_semaphore_create(self.maxOpenUploads);
+        _blockQueue = dispatch_queue_create("com.microsoft.azure.storage.uploadblocks", DISPATCH_QUEUE_CONCURRENT);
         _streamWaiting = NO;
         _uploadLock = [[NSObject alloc] init];
         _accessCondition = accessCondition ?: [[AZSAccessCondition alloc] init];
@@ -110,15 +172,18 @@
         _completionHandler = completionHandler;
         if (requestOptions.storeBlobContentMD5)
         {
-            CC_MD5_Init(&_md5Context);
+            _md5Digest = [[AZSCrypto provider] md5Digest];
+            _md5Queue = dispatch_queue_create("com.microsoft.azure.storage.uploadmd5", DISPATCH_QUEUE_SERIAL);
         }
         _streamingError = nil;
+        _blockCRC64s = [NSMutableData data];
         if (totalBlobSize)
         {
             _createNew = YES;
             _totalPageBlobSize = totalBlobSize;
             _initialPageBlobSequenceNumber = initialSequenceNumber;
         }
+        [self stopOnCancellation];
     }
     return self;
 }
@@ -130,6 +195,7 @@
     {
         _underlyingBlob = appendBlob;
         _blobType = AZSBlobTypeAppendBlob;
+        _maxBlockSize = AZSCMaxBlockSize;
         _dataBuffer = [NSMutableData dataWithCapacity:AZSCMaxBlockSize];  //TODO: This should be the user-settable.
         _maxOpenUploads = 1; //TODO: Investigate if this should always be 1, or if we should use the value in requestOptions.parallelismFactor.
         _blockUploadSemaphore = dispatch_semaphore_create(self.maxOpenUploads);
@@ -141,10 +207,13 @@
         _completionHandler = completionHandler;
         if (requestOptions.storeBlobContentMD5)
         {
-            CC_MD5_Init(&_md5Context);
+            _md5Digest = [[AZSCrypto provider] md5Digest];
+            _md5Queue = dispatch_queue_create("com.microsoft.azure.storage.uploadmd5", DISPATCH_QUEUE_SERIAL);
         }
         _streamingError = nil;
+        _blockCRC64s = [NSMutableData data];
         _createNew = createNew;
+        [self stopOnCancellation];
     }
     return self;
 }
@@ -176,19 +245,22 @@
         return -1;
     }
     
-    // TODO: Make this configurable.
-    NSUInteger maxSizePerBlock = AZSCMaxBlockSize;
+    NSUInteger maxSizePerBlock = self.maxBlockSize;
     int bytesCopied = 0;
     
     while (bytesCopied < maxLength)
     {
+        if ([self.dataBuffer length] == 0)
+        {
+            self.traceBufferFillStart = AZSTraceTimestamp();
+        }
         NSUInteger bytesToAppend = MIN(maxLength - bytesCopied, maxSizePerBlock - [self.dataBuffer length]);
         [self.dataBuffer appendBytes:(buffer + bytesCopied) length:bytesToAppend];
         bytesCopied += bytesToAppend;
         
-        if (maxSizePerBlock == [self.dataBuffer length])
+        if ((maxSizePerBlock == [self.dataBuffer length]) && ![self uploadBufferWithCompletionHandler:completionHandler])
         {
-            [self uploadBufferWithCompletionHandler:completionHandler];
+            return -1;
         }
     }
     
@@ -198,42 +270,70 @@
 // TODO: Consider having this method fail, rather than block, in the cannot-acquire-semaphore case.
 -(BOOL) uploadBufferWithCompletionHandler:(void(^)())completionHandler
 {
-    [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Uploading buffer, buffer size = %ld", (unsigned long)[self.dataBuffer length]];
+    AZSLogDebug(self.operationContext, @"Uploading buffer, buffer size = %ld", (unsigned long)[self.dataBuffer length]);
+    AZSTraceSpan("buffer fill", self.traceBufferFillStart, self.operationContext);
+    uint64_t traceWaitStart = AZSTraceTimestamp();
     dispatch_semaphore_wait(self.blockUploadSemaphore, DISPATCH_TIME_FOREVER);
+    AZSTraceSpan("upload slot wait", traceWaitStart, self.operationContext);
+    if (self.operationContext.cancelled)
+    {
+        // Drop the buffered data rather than send it.
+        [self.dataBuffer setLength:0];
+        dispatch_semaphore_signal(self.blockUploadSemaphore);
+        return NO;
+    }
+    NSData *blockData = self.dataBuffer;
+    self.dataBuffer = [NSMutableData dataWithCapacity:self.maxBlockSize];
+    
+    NSUInteger blockIndex = 0;
     @synchronized(self)
     {
+        blockIndex = self.chunksTotal;
         self.chunksTotal++;
+        if (self.requestOptions.useTransactionalCRC64)
+        {
+            [self.blockCRC64s increaseLengthBy:sizeof(AZSBlockCRC64)];
+            ((AZSBlockCRC64 *)self.blockCRC64s.mutableBytes)[blockIndex].length = blockData.length;
+        }
     }
     
-    NSData *blockData = self.dataBuffer;
-    self.dataBuffer = [NSMutableData dataWithCapacity:AZSCMaxBlockSize];
-    
     if (self.requestOptions.storeBlobContentMD5)
     {
-        CC_MD5_Update(&_md5Context, blockData.bytes, (unsigned int) blockData.length);
+        // The whole-blob MD5 must see the blocks in order, so it is fed from a serial queue of its own, while the block
+        // uploads and the writer fills the next buffer.  The block is not modified after this point.
+        id<AZSDigest> md5Digest = self.md5Digest;
+        dispatch_async(self.md5Queue, ^{
+            [md5Digest updateWithBytes:blockData.bytes length:blockData.length];
+        });
     }
     
+    uint64_t traceSendStart = AZSTraceTimestamp();
     switch (self.blobType)
     {
         case AZSBlobTypeBlockBlob:
         {
-            NSString *blockID = [[[[NSString stringWithFormat:@"blockid%@",[[[NSUUID UUID] UUIDString] stringByReplacingOccurrencesOfString:@"-" withString:AZSCEmptyString]] lowercaseString] dataUsingEncoding:NSUTF8StringEncoding] base64EncodedStringWithOptions:0];
+            NSString *blockID = AZSCreateBlockID();
             [self.blockIDs addObject:[[AZSBlockListItem alloc] initWithBlockID:blockID blockListMode:AZSBlockListModeLatest size:blockData.length]];
             
+            // The block's transactional hashes are computed, and its request sent, on the worker queue, so blocks are
+            // hashed in parallel and the writer goes straight back to filling the next buffer.
             AZSCloudBlockBlob *blob = (AZSCloudBlockBlob *)self.underlyingBlob;
-            [blob uploadBlockFromData:blockData blockID:blockID contentMD5:nil accessCondition:self.accessCondition requestOptions:self.requestOptions operationContext:self.operationContext completionHandler:^(NSError * error)
-             {
-                 if (error)
-                 {
-                     self.streamingError = error;
-                 }
-                 @synchronized(self)
+            dispatch_async(self.blockQueue, ^{
+                [blob uploadBlockFromData:blockData blockID:blockID contentMD5:[self transactionalMD5ForBlock:blockData] contentCRC64:[self transactionalCRC64ForBlock:blockData index:blockIndex] accessCondition:self.accessCondition requestOptions:self.requestOptions operationContext:self.operationContext completionHandler:^(NSError * error)
                  {
-                     self.chunksUploaded++;
-                 }
-                 dispatch_semaphore_signal(self.blockUploadSemaphore);
-                 completionHandler();
-             }];
+                     if (error)
+                     {
+                         self.streamingError = error;
+                     }
+                     AZSTraceSpan("block send", traceSendStart, self.operationContext);
+                     @synchronized(self)
+                     {
+                         self.chunksUploaded++;
+                     }
+                     dispatch_semaphore_signal(self.blockUploadSemaphore);
+                     completionHandler();
+                 }];
+            });
             break;
         }
         case AZSBlobTypePageBlob:
@@ -245,18 +345,21 @@
             }
             
             AZSCloudPageBlob *blob = (AZSCloudPageBlob *)self.underlyingBlob;
-            [blob uploadPagesWithData:blockData startOffset:[NSNumber numberWithUnsignedInteger:currentOffset] contentMD5:nil accessCondition:self.accessCondition requestOptions:self.requestOptions operationContext:self.operationContext completionHandler:^(NSError * _Nullable error) {
-                if (error)
-                {
-                    self.streamingError = error;
-                }
-                @synchronized(self)
-                {
-                    self.chunksUploaded++;
-                }
-                dispatch_semaphore_signal(self.blockUploadSemaphore);
-                completionHandler();
-            }];
+            dispatch_async(self.blockQueue, ^{
+                [blob uploadPagesWithData:blockData startOffset:[NSNumber numberWithUnsignedInteger:currentOffset] contentMD5:[self transactionalMD5ForBlock:blockData] contentCRC64:[self transactionalCRC64ForBlock:blockData index:blockIndex] accessCondition:self.accessCondition requestOptions:self.requestOptions operationContext:self.operationContext completionHandler:^(NSError * _Nullable error) {
+                    if (error)
+                    {
+                        self.streamingError = error;
+                    }
+                    AZSTraceSpan("block send", traceSendStart, self.operationContext);
+                    @synchronized(self)
+                    {
+                        self.chunksUploaded++;
+                    }
+                    dispatch_semaphore_signal(self.blockUploadSemaphore);
+                    completionHandler();
+                }];
+            });
             break;
         }
         case AZSBlobTypeAppendBlob:
@@ -284,20 +387,21 @@
                 
                 NSUInteger currentResultsCount = self.operationContext.requestResults.count;
                 
-                [blob appendBlockWithData:blockData contentMD5:nil accessCondition:self.accessCondition requestOptions:self.requestOptions operationContext:self.operationContext completionHandler:^(NSError * _Nullable error, NSNumber * _Nonnull appendOffset) {
+                [blob appendBlockWithData:blockData contentMD5:nil contentCRC64:[self transactionalCRC64ForBlock:blockData index:blockIndex] accessCondition:self.accessCondition requestOptions:self.requestOptions operationContext:self.operationContext completionHandler:^(NSError * _Nullable error, NSNumber * _Nonnull appendOffset) {
                     if (error)
                     {
                         // check for stuff
                         
                         if (self.requestOptions.absorbConditionalErrorsOnRetry && (error.userInfo[AZSCHttpStatusCode] == [NSNumber numberWithInt:412]) && ([error.userInfo[AZSCXmlCode] isEqualToString:@"AppendPositionConditionNotMet"] || [error.userInfo[AZSCXmlCode] isEqualToString:@"MaxBlobSizeConditionNotMet"]) && (self.operationContext.requestResults.count - currentResultsCount > 1))
                         {
-                            [self.operationContext logAtLevel:AZSLogLevelWarning withMessage:@"Pre-condition failure on a retry is being ignored as the request should have succeeded in the first attempt."];
+                            AZSLogWarning(self.operationContext, @"Pre-condition failure on a retry is being ignored as the request should have succeeded in the first attempt.");
                         }
                         else
                         {
                             self.streamingError = error;
                         }
                     }
+                    AZSTraceSpan("block send", traceSendStart, self.operationContext);
                     @synchronized(self)
                     {
                         self.chunksUploaded++;
@@ -317,6 +421,51 @@
     return YES;
 }
 
+-(NSString *)transactionalMD5ForBlock:(NSData *)blockData
+{
+    if (!self.requestOptions.useTransactionalMD5)
+    {
+        return nil;
+    }
+    
+    uint64_t traceHashStart = AZSTraceTimestamp();
+    NSString *contentMD5 = [AZSUtil calculateMD5FromData:blockData];
+    AZSTraceSpan("block hash", traceHashStart, self.operationContext);
+    return contentMD5;
+}
+
+// Called on the worker queue, like transactionalMD5ForBlock, so blocks are checksummed in parallel.  The CRC64 is also
+// recorded against the block, for closeWithCompletionHandler to combine into the whole blob's.
+-(NSString *)transactionalCRC64ForBlock:(NSData *)blockData index:(NSUInteger)blockIndex
+{
+    if (!self.requestOptions.useTransactionalCRC64)
+    {
+        return nil;
+    }
+    
+    uint64_t crc64 = AZSCRC64Update(0, blockData.bytes, blockData.length);
+    @synchronized(self)
+    {
+        ((AZSBlockCRC64 *)self.blockCRC64s.mutableBytes)[blockIndex].crc64 = crc64;
+    }
+    return [AZSUtil base64StringFromCRC64:crc64];
+}
+
+-(NSString *)wholeBlobCRC64
+{
+    uint64_t crc64 = 0;
+    @synchronized(self)
+    {
+        const AZSBlockCRC64 *blockCRC64s = self.blockCRC64s.bytes;
+        NSUInteger blockCount = self.blockCRC64s.length / sizeof(AZSBlockCRC64);
+        for (NSUInteger blockIndex = 0; blockIndex < blockCount; blockIndex++)
+        {
+            crc64 = AZSCRC64Combine(crc64, blockCRC64s[blockIndex].crc64, blockCRC64s[blockIndex].length);
+        }
+    }
+    return [AZSUtil base64StringFromCRC64:crc64];
+}
+
 -(BOOL)allDataUploaded
 {
     BOOL allDataUploaded = NO;
@@ -344,6 +493,7 @@
         finished = self.chunksTotal == self.chunksUploaded;
     }
     
+    uint64_t traceWaitStart = AZSTraceTimestamp();
     while (!finished)
     {
         // Spin until all blocks have been uploaded.
@@ -353,12 +503,26 @@
             finished = self.chunksTotal == self.chunksUploaded;
         }
     }
+    AZSTraceSpan("close wait", traceWaitStart, self.operationContext);
+    
+    if (self.operationContext.cancelled)
+    {
+        return NO;
+    }
     
     if (self.requestOptions.storeBlobContentMD5)
     {
         unsigned char md5Bytes[CC_MD5_DIGEST_LENGTH];
-        CC_MD5_Final(md5Bytes, &_md5Context);
-        self.underlyingBlob.properties.contentMD5 = [[[NSData alloc] initWithBytes:md5Bytes length:CC_MD5_DIGEST_LENGTH] base64EncodedStringWithOptions:0];
+        unsigned char *md5Output = md5Bytes;
+        dispatch_sync(self.md5Queue, ^{
+            [self.md5Digest finishWithDigest:md5Output];
+        });
+        self.underlyingBlob.properties.contentMD5 = [AZSUtil base64EncodedStringWithBytes:md5Bytes length:CC_MD5_DIGEST_LENGTH];
+    }
+    
+    if (self.requestOptions.useTransactionalCRC64 && !self.streamingError)
+    {
+        self.underlyingBlob.properties.contentCRC64 = [self wholeBlobCRC64];
     }
     
     switch (self.blobType) {
@@ -486,7 +650,7 @@
         case NSStreamEventErrorOccurred:
         {
             NSError *error = inputStream.streamError;
-            [self.operationContext logAtLevel:AZSLogLevelError withMessage:@"Error in stream callback.  Error code = %ld, error domain = %@, error userinfo = %@", (long)error.code, error.domain, error.userInfo];
+            AZSLogError(self.operationContext, @"Error in stream callback.  Error code = %ld, error domain = %@, error userinfo = %@", (long)error.code, error.domain, error.userInfo);
             // Note that the below method is syncronous for the time being.
             [self closeWithCompletionHandler:^{
                 ;
@@ -0,0 +1,79 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSBulkSharedAccessSignatureGenerator.h" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <Foundation/Foundation.h>
+#import "AZSMacros.h"
+
+AZS_ASSUME_NONNULL_BEGIN
+
+@class AZSCloudBlobContainer;
+@class AZSSharedAccessBlobParameters;
+
+/** The AZSBulkSharedAccessSignatureGenerator creates signed blob URLs for many blobs in one container, all with the same
+ shared access parameters.
+
+ Everything that does not depend on the blob name (the permissions, start and expiry times, IP range, protocols,
+ service version, response headers and the keyed HMAC state) is formatted once, when the generator is created.  Each
+ URL then only costs one HMAC-SHA256 over the precomputed string-to-sign with the blob name spliced in, plus escaping
+ the name and the signature into the output.
+
+ The parameters are copied when the generator is created; later changes to the AZSSharedAccessBlobParameters object
+ have no effect.  A generator is immutable, and may be used from several threads at once.
+ */
+@interface AZSBulkSharedAccessSignatureGenerator : NSObject
+
+/** The container whose blobs are signed. */
+@property (strong, readonly) AZSCloudBlobContainer *container;
+
+/** Initializes a new AZSBulkSharedAccessSignatureGenerator.
+ Note that logging in this method uses the global logger configured statically on the AZSOperationContext as there is no operation being performed to provide a local operation context.
+
+ @param container The container whose blobs will be signed.  The container's client must have account key credentials.
+ @param parameters The shared access blob parameters to use for every SAS token.
+ @param error A pointer to a NSError*, to be set in the event of failure.
+ @return The newly allocated instance, or nil if the credentials or parameters are not valid.
+ */
+-(AZSNullable instancetype)initWithContainer:(AZSCloudBlobContainer *)container parameters:(AZSSharedAccessBlobParameters *)parameters error:(NSError **)error AZS_DESIGNATED_INITIALIZER;
+
+/** Creates a Shared Access Signature (SAS) token for a blob, in the same form as AZSCloudBlob's createSharedAccessSignatureWithParameters:error:.
+
+ @param blobName The name of the blob.
+ @return The SAS token.
+ */
+-(NSString *)sharedAccessSignatureForBlobName:(NSString *)blobName;
+
+/** Creates the full signed URL (primary location, with SAS token) for a blob.
+
+ @param blobName The name of the blob.
+ @return The signed URL.
+ */
+-(NSURL *)sharedAccessURLForBlobName:(NSString *)blobName;
+
+/** Appends the full signed URL for a blob to a buffer, as UTF-8 with no terminator.
+
+ This is the fastest way to generate many URLs: reuse one buffer (for example, by setting its length back to zero
+ between batches) and no objects are allocated per URL.
+
+ @param blobName The name of the blob.
+ @param data The buffer to append to.
+ @return The number of bytes appended.
+ */
+-(NSUInteger)appendSharedAccessURLForBlobName:(NSString *)blobName toData:(NSMutableData *)data;
+
+@end
+
+AZS_ASSUME_NONNULL_END
@@ -0,0 +1,244 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSBulkSharedAccessSignatureGenerator.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <CommonCrypto/CommonHMAC.h>
+#import "AZSBulkSharedAccessSignatureGenerator.h"
+#import "AZSCloudBlobClient.h"
+#import "AZSCloudBlobContainer.h"
+#import "AZSConstants.h"
+#import "AZSErrors.h"
+#import "AZSIPRange.h"
+#import "AZSLogging.h"
+#import "AZSOperationContext.h"
+#import "AZSSharedAccessBlobParameters.h"
+#import "AZSSharedAccessHeaders.h"
+#import "AZSSharedAccessSignatureHelper.h"
+#import "AZSStorageCredentials.h"
+#import "AZSStorageUri.h"
+#import "AZSUtil.h"
+
+// Strings to sign for names up to roughly 1KB of UTF-8 are built on the stack.
+#define AZSBulkSasStackBufferLength 2048
+
+// The Base64 encoding of a SHA-256 digest.
+#define AZSBulkSasSignatureLength AZSBase64EncodedLength(CC_SHA256_DIGEST_LENGTH)
+
+static const char AZSBulkSasHexDigits[] = "0123456789ABCDEF";
+
+// The characters NSURLComponents leaves unescaped in a path (URLPathAllowedCharacterSet).
+static inline BOOL AZSIsPathCharacter(uint8_t c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '&' && c <= '/') || (c >= '0' && c <= ':') ||
+           c == '!' || c == '$' || c == '=' || c == '@' || c == '_' || c == '~';
+}
+
+static inline uint8_t *AZSAppendPercentEscaped(uint8_t *output, uint8_t c)
+{
+    output[0] = '%';
+    output[1] = AZSBulkSasHexDigits[c >> 4];
+    output[2] = AZSBulkSasHexDigits[c & 0x0F];
+    return output + 3;
+}
+
+static uint8_t *AZSAppendEscapedPath(uint8_t *output, const uint8_t *bytes, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        if (AZSIsPathCharacter(bytes[i]))
+        {
+            *output++ = bytes[i];
+        }
+        else
+        {
+            output = AZSAppendPercentEscaped(output, bytes[i]);
+        }
+    }
+    return output;
+}
+
+// Base64-encodes the digest and escapes it for the query, as URLEncodedStringWithString: would.
+static uint8_t *AZSAppendEscapedSignature(uint8_t *output, const unsigned char *digest)
+{
+    char encoded[AZSBase64EncodedLength(CC_SHA256_DIGEST_LENGTH)];
+    size_t encodedLength = AZSBase64Encode(digest, CC_SHA256_DIGEST_LENGTH, encoded);
+    return output + AZSPercentEncode((const uint8_t *)encoded, encodedLength, (char *)output);
+}
+
+@interface AZSBulkSharedAccessSignatureGenerator()
+{
+    AZSStorageCredentials *_credentials;
+
+    // The string-to-sign is _stringToSignPrefix + blob name + _stringToSignSuffix.
+    NSData *_stringToSignPrefix;
+    NSData *_stringToSignSuffix;
+
+    // The URL is _urlPrefix + escaped blob name + _queryPrefix + escaped signature; _queryPrefix ends with "sig=".
+    NSData *_urlPrefix;
+    NSData *_queryPrefix;
+}
+
+-(instancetype)init AZS_DESIGNATED_INITIALIZER;
+
+@end
+
+@implementation AZSBulkSharedAccessSignatureGenerator
+
+-(instancetype)init
+{
+    return nil;
+}
+
+-(instancetype)initWithContainer:(AZSCloudBlobContainer *)container parameters:(AZSSharedAccessBlobParameters *)parameters error:(NSError **)error
+{
+    self = [super init];
+    if (self)
+    {
+        AZSStorageCredentials *credentials = container.client.credentials;
+        if (![credentials isSharedKey])
+        {
+            *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
+            AZSLogError([AZSUtil operationlessContext], @"Cannot create SAS without account key.");
+            return nil;
+        }
+
+        NSError *parameterError = nil;
+        NSString *permissions = [AZSSharedAccessSignatureHelper stringFromPermissions:parameters.permissions error:&parameterError];
+        NSString *protocols = [AZSSharedAccessSignatureHelper stringFromProtocols:parameters.protocols error:&parameterError];
+        if (parameterError)
+        {
+            *error = parameterError;
+            return nil;
+        }
+
+        _container = container;
+        _credentials = credentials;
+
+        NSString *startTime = [AZSUtil utcTimeOrEmptyWithDate:parameters.sharedAccessStartTime];
+        NSString *expiryTime = [AZSUtil utcTimeOrEmptyWithDate:parameters.sharedAccessExpiryTime];
+        NSString *identifier = parameters.storedPolicyIdentifier ?: AZSCEmptyString;
+        NSString *ipRange = parameters.ipAddressOrRange.rangeString ?: AZSCEmptyString;
+        AZSSharedAccessHeaders *headers = parameters.headers;
+
+        // Format the whole string-to-sign with an empty blob name, then split it where the name goes: right after the
+        // canonical resource, which is the fourth line.
+        NSString *canonicalPrefix = [NSString stringWithFormat:AZSCSasTemplateBlobCanonicalName, AZSCBlob, credentials.accountName, container.name, AZSCEmptyString];
+        NSString *stringToSign = [NSString stringWithFormat:AZSCSasTemplateBlobStringToSign, permissions, startTime, expiryTime, canonicalPrefix, identifier, ipRange, protocols, AZSCTargetStorageVersion];
+        stringToSign = [NSString stringWithFormat:AZSCSasTemplateBlobParameters, stringToSign, headers.cacheControl ?: AZSCEmptyString, headers.contentDisposition ?: AZSCEmptyString, headers.contentEncoding ?: AZSCEmptyString, headers.contentLanguage ?: AZSCEmptyString, headers.contentType ?: AZSCEmptyString];
+        NSUInteger splitIndex = permissions.length + startTime.length + expiryTime.length + canonicalPrefix.length + 3;
+        _stringToSignPrefix = [[stringToSign substringToIndex:splitIndex] dataUsingEncoding:NSUTF8StringEncoding];
+        _stringToSignSuffix = [[stringToSign substringFromIndex:splitIndex] dataUsingEncoding:NSUTF8StringEncoding];
+
+        NSString *containerUrl = container.storageUri.primaryUri.absoluteString;
+        _urlPrefix = [([containerUrl hasSuffix:@"/"] ? containerUrl : [containerUrl stringByAppendingString:@"/"]) dataUsingEncoding:NSUTF8StringEncoding];
+
+        // The same parameters AZSSharedAccessSignatureHelper adds for a blob, in a fixed order.
+        NSMutableString *query = [NSMutableString stringWithCapacity:256];
+        void (^addParameter)(NSString *, NSString *) = ^(NSString *key, NSString *value) {
+            if (value.length > 0)
+            {
+                [query appendString:(query.length == 0) ? @"?" : @"&"];
+                [query appendString:key];
+                [query appendString:@"="];
+                [query appendString:[AZSUtil URLEncodedStringWithString:value]];
+            }
+        };
+        addParameter(AZSCSasServiceVersion, AZSCTargetStorageVersion);
+        addParameter(AZSCSasResource, @"b");
+        addParameter(AZSCSasPermissions, permissions);
+        addParameter(AZSCSasStartTime, startTime);
+        addParameter(AZSCSasExpiryTime, expiryTime);
+        addParameter(AZSCSasStoredIdentifier, identifier);
+        addParameter(AZSCSasIpAddressOrRange, ipRange);
+        addParameter(AZSCSasProtocolRestriction, protocols);
+        addParameter(AZSCSasCacheControl, headers.cacheControl);
+        addParameter(AZSCSasContentType, headers.contentType);
+        addParameter(AZSCSasContentEncoding, headers.contentEncoding);
+        addParameter(AZSCSasContentLanguage, headers.contentLanguage);
+        addParameter(AZSCSasContentDisposition, headers.contentDisposition);
+        [query appendFormat:@"&%@=", AZSCQuerySig];
+        _queryPrefix = [query dataUsingEncoding:NSUTF8StringEncoding];
+    }
+
+    return self;
+}
+
+// Signs the blob name and appends the signed URL (or, if includeUrl is NO, just the SAS token) to the buffer.
+-(NSUInteger)appendBlobName:(NSString *)blobName includeUrl:(BOOL)includeUrl toData:(NSMutableData *)data
+{
+    CFStringRef name = (__bridge CFStringRef)blobName;
+    CFIndex nameLength = CFStringGetLength(name);
+    CFIndex maximumNameBytes = CFStringGetMaximumSizeForEncoding(nameLength, kCFStringEncodingUTF8);
+    size_t prefixLength = _stringToSignPrefix.length;
+    size_t suffixLength = _stringToSignSuffix.length;
+    size_t capacity = prefixLength + maximumNameBytes + suffixLength;
+
+    uint8_t stackBuffer[AZSBulkSasStackBufferLength];
+    uint8_t *stringToSign = (capacity <= sizeof(stackBuffer)) ? stackBuffer : malloc(capacity);
+
+    CFIndex nameBytes = 0;
+    memcpy(stringToSign, _stringToSignPrefix.bytes, prefixLength);
+    CFStringGetBytes(name, CFRangeMake(0, nameLength), kCFStringEncodingUTF8, 0, false, stringToSign + prefixLength, maximumNameBytes, &nameBytes);
+    memcpy(stringToSign + prefixLength + nameBytes, _stringToSignSuffix.bytes, suffixLength);
+
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    [_credentials computeHmacSha256WithBytes:stringToSign length:(prefixLength + nameBytes + suffixLength) digest:digest];
+
+    // Reserve room for the worst case, where every byte of the name and of the signature is escaped.
+    NSUInteger start = data.length;
+    NSUInteger maximumLength = _queryPrefix.length + 3 * AZSBulkSasSignatureLength + (includeUrl ? (_urlPrefix.length + 3 * nameBytes) : 0);
+    [data increaseLengthBy:maximumLength];
+    uint8_t *output = (uint8_t *)data.mutableBytes + start;
+    uint8_t *position = output;
+
+    if (includeUrl)
+    {
+        memcpy(position, _urlPrefix.bytes, _urlPrefix.length);
+        position = AZSAppendEscapedPath(position + _urlPrefix.length, stringToSign + prefixLength, nameBytes);
+    }
+    memcpy(position, _queryPrefix.bytes, _queryPrefix.length);
+    position = AZSAppendEscapedSignature(position + _queryPrefix.length, digest);
+
+    NSUInteger appendedLength = position - output;
+    data.length = start + appendedLength;
+
+    if (stringToSign != stackBuffer)
+    {
+        free(stringToSign);
+    }
+    return appendedLength;
+}
+
+-(NSUInteger)appendSharedAccessURLForBlobName:(NSString *)blobName toData:(NSMutableData *)data
+{
+    return [self appendBlobName:blobName includeUrl:YES toData:data];
+}
+
+-(NSString *)sharedAccessSignatureForBlobName:(NSString *)blobName
+{
+    NSMutableData *data = [NSMutableData dataWithCapacity:(_queryPrefix.length + 3 * AZSBulkSasSignatureLength)];
+    [self appendBlobName:blobName includeUrl:NO toData:data];
+    return [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+}
+
+-(NSURL *)sharedAccessURLForBlobName:(NSString *)blobName
+{
+    NSMutableData *data = [NSMutableData dataWithCapacity:(_urlPrefix.length + _queryPrefix.length + 3 * (blobName.length + AZSBulkSasSignatureLength))];
+    [self appendBlobName:blobName includeUrl:YES toData:data];
+    return (__bridge_transfer NSURL *)CFURLCreateWithBytes(kCFAllocatorDefault, data.bytes, data.length, kCFStringEncodingUTF8, NULL);
+}
+
+@end
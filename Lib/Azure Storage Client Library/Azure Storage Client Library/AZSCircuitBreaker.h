@@ -0,0 +1,102 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSCircuitBreaker.h" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+
+#import <Foundation/Foundation.h>
+#import "AZSEnums.h"
+#import "AZSMacros.h"
+
+AZS_ASSUME_NONNULL_BEGIN
+
+@class AZSRequestResult;
+
+/** An AZSCircuitBreaker tracks the health of the primary and secondary locations, and keeps requests away from a
+ location that is failing.
+
+ Without one, every new operation tries its first location even if it has just failed for every other operation, and
+ may spend a whole timeout finding out.  Assign a breaker to the circuitBreaker property of an AZSCloudBlobClient, and
+ each request will check it first:
+
+ - While a location is closed (healthy), requests go to it as usual.
+ - A location opens when, over the last windowDuration, at least minimumRequests were sent to it and failureRatio of them
+ failed.  A request fails if it gets no response or a 5xx response, or, if slowRequestThreshold is set, takes longer than
+ that.  A request for a location that is open goes to the other location instead, if its location mode allows
+ (AZSStorageLocationModePrimaryThenSecondary or AZSStorageLocationModeSecondaryThenPrimary) and the operation can be
+ sent to either.  Otherwise it fails at once with AZSECircuitOpen.
+ - After openDuration, the location becomes half-open, and lets a single trial request through.  If it succeeds, the
+ location closes; if it fails, it opens again.
+
+ A breaker may be shared between clients for the same account, and is safe to use from any thread.  Change its
+ settings before it is used.
+ */
+@interface AZSCircuitBreaker : NSObject
+
+/** The period over which failures are counted, in seconds.  Defaults to 10.*/
+@property NSTimeInterval windowDuration;
+
+/** The fewest requests in the window that can open a location.  Defaults to 10.*/
+@property NSUInteger minimumRequests;
+
+/** The fraction of requests in the window that must fail to open a location.  Defaults to 0.5.*/
+@property double failureRatio;
+
+/** The time after which a request counts as failed even if it succeeded, in seconds.  The latency of a request is its
+ time to first byte when network metrics are available, otherwise its whole duration.  Defaults to 0, which disables
+ the check.*/
+@property NSTimeInterval slowRequestThreshold;
+
+/** How long a location stays open before a trial request is let through, in seconds.  Defaults to 30.*/
+@property NSTimeInterval openDuration;
+
+/** The number of times a location has opened.*/
+@property (readonly) uint64_t tripCount;
+
+/** Initializes a new AZSCircuitBreaker with the default settings, and both locations closed.
+
+ @return The new breaker.
+ */
+-(instancetype)init AZS_DESIGNATED_INITIALIZER;
+
+/** The current state of a location.
+
+ @param location The location.
+ @returns The state of its circuit.
+ */
+-(AZSCircuitState)stateForLocation:(AZSStorageLocation)location;
+
+/** Closes both locations and forgets their history.*/
+-(void)reset;
+
+// The methods below are used by the library to route requests.
+
+/** Checks whether a request may be sent to a location.  In the half-open state, a YES takes the trial slot, and must be
+ followed by a call to recordResult:.
+
+ @param location The location.
+ @returns YES if the request may be sent.
+ */
+-(BOOL)allowRequestToLocation:(AZSStorageLocation)location;
+
+/** Records the outcome of a request to the location in its targetLocation.
+
+ @param result The result of the request.
+ */
+-(void)recordResult:(AZSRequestResult *)result;
+
+@end
+
+AZS_ASSUME_NONNULL_END
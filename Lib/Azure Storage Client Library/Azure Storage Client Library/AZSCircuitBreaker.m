@@ -0,0 +1,264 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSCircuitBreaker.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+
+#import "AZSCircuitBreaker.h"
+#import "AZSErrors.h"
+#import "AZSRequestResult.h"
+
+// The window is kept as a ring of buckets, each covering this fraction of windowDuration.
+#define AZSCircuitBucketCount 10
+
+// The history and state of one location.  Guarded by the breaker's lock.
+@interface AZSLocationCircuit : NSObject
+{
+@public
+    int64_t _bucketNumbers[AZSCircuitBucketCount];
+    NSUInteger _requests[AZSCircuitBucketCount];
+    NSUInteger _failures[AZSCircuitBucketCount];
+}
+
+@property AZSCircuitState state;
+@property NSTimeInterval openedTime;
+@property BOOL trialInFlight;
+@property NSTimeInterval trialStartTime;
+
+@end
+
+@implementation AZSLocationCircuit
+
+-(void)clearWindow
+{
+    for (NSUInteger i = 0; i < AZSCircuitBucketCount; i++)
+    {
+        _bucketNumbers[i] = -1;
+        _requests[i] = 0;
+        _failures[i] = 0;
+    }
+}
+
+@end
+
+@interface AZSCircuitBreaker()
+
+// Indexed by AZSStorageLocation.
+@property (strong) NSArray *circuits;
+@property (readwrite) uint64_t tripCount;
+
+@end
+
+@implementation AZSCircuitBreaker
+
+-(instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        _windowDuration = 10;
+        _minimumRequests = 10;
+        _failureRatio = 0.5;
+        _slowRequestThreshold = 0;
+        _openDuration = 30;
+        _circuits = @[[[AZSLocationCircuit alloc] init], [[AZSLocationCircuit alloc] init], [[AZSLocationCircuit alloc] init]];
+        for (AZSLocationCircuit *circuit in _circuits)
+        {
+            [circuit clearWindow];
+        }
+    }
+
+    return self;
+}
+
+-(AZSLocationCircuit *)circuitForLocation:(AZSStorageLocation)location
+{
+    return (location >= 0 && location < (AZSStorageLocation)self.circuits.count) ? self.circuits[location] : nil;
+}
+
+// Must be called with the lock held.  Moves an open circuit to half-open once openDuration has passed.
+-(void)updateState:(AZSLocationCircuit *)circuit now:(NSTimeInterval)now
+{
+    if (circuit.state == AZSCircuitStateOpen && now - circuit.openedTime >= self.openDuration)
+    {
+        circuit.state = AZSCircuitStateHalfOpen;
+        circuit.trialInFlight = NO;
+    }
+}
+
+-(AZSCircuitState)stateForLocation:(AZSStorageLocation)location
+{
+    @synchronized(self)
+    {
+        AZSLocationCircuit *circuit = [self circuitForLocation:location];
+        if (!circuit)
+        {
+            return AZSCircuitStateClosed;
+        }
+        [self updateState:circuit now:[NSDate timeIntervalSinceReferenceDate]];
+        return circuit.state;
+    }
+}
+
+-(void)reset
+{
+    @synchronized(self)
+    {
+        for (AZSLocationCircuit *circuit in self.circuits)
+        {
+            circuit.state = AZSCircuitStateClosed;
+            circuit.trialInFlight = NO;
+            [circuit clearWindow];
+        }
+    }
+}
+
+-(BOOL)allowRequestToLocation:(AZSStorageLocation)location
+{
+    @synchronized(self)
+    {
+        AZSLocationCircuit *circuit = [self circuitForLocation:location];
+        if (!circuit)
+        {
+            return YES;
+        }
+
+        NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+        [self updateState:circuit now:now];
+        switch (circuit.state)
+        {
+            case AZSCircuitStateClosed:
+            {
+                return YES;
+            }
+            case AZSCircuitStateOpen:
+            {
+                return NO;
+            }
+            case AZSCircuitStateHalfOpen:
+            {
+                // A trial that never reported back (for example, because its operation timed out before sending it)
+                // must not hold the location half-open forever.
+                if (circuit.trialInFlight && now - circuit.trialStartTime < self.openDuration)
+                {
+                    return NO;
+                }
+                circuit.trialInFlight = YES;
+                circuit.trialStartTime = now;
+                return YES;
+            }
+        }
+    }
+}
+
+// Must be called with the lock held.
+-(void)openCircuit:(AZSLocationCircuit *)circuit now:(NSTimeInterval)now
+{
+    circuit.state = AZSCircuitStateOpen;
+    circuit.openedTime = now;
+    circuit.trialInFlight = NO;
+    [circuit clearWindow];
+    self.tripCount++;
+}
+
+-(void)recordResult:(AZSRequestResult *)result
+{
+    // A cancelled request says nothing about the health of the location.  The executor wraps transport errors, so the
+    // cancellation is usually found underneath.
+    NSError *transportError = result.error.userInfo[AZSInnerErrorString] ?: result.error.userInfo[NSUnderlyingErrorKey] ?: result.error;
+    if ([transportError.domain isEqualToString:NSURLErrorDomain] && transportError.code == NSURLErrorCancelled)
+    {
+        return;
+    }
+
+    NSInteger statusCode = result.response.statusCode;
+    BOOL failed = (statusCode == 0) || (statusCode >= 500);
+    if (!failed && self.slowRequestThreshold > 0)
+    {
+        NSTimeInterval latency = result.networkMetricsAvailable ? result.timeToFirstByte : [result.endTime timeIntervalSinceDate:result.startTime];
+        failed = latency > self.slowRequestThreshold;
+    }
+
+    @synchronized(self)
+    {
+        AZSLocationCircuit *circuit = [self circuitForLocation:result.targetLocation];
+        if (!circuit)
+        {
+            return;
+        }
+
+        NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+        [self updateState:circuit now:now];
+        switch (circuit.state)
+        {
+            case AZSCircuitStateHalfOpen:
+            {
+                if (failed)
+                {
+                    [self openCircuit:circuit now:now];
+                }
+                else
+                {
+                    circuit.state = AZSCircuitStateClosed;
+                    circuit.trialInFlight = NO;
+                    [circuit clearWindow];
+                }
+                return;
+            }
+            case AZSCircuitStateOpen:
+            {
+                // Stragglers sent before the location opened.
+                return;
+            }
+            case AZSCircuitStateClosed:
+            {
+                break;
+            }
+        }
+
+        double bucketDuration = MAX(self.windowDuration, 0.001) / AZSCircuitBucketCount;
+        int64_t bucketNumber = (int64_t)(now / bucketDuration);
+        NSUInteger index = (NSUInteger)(bucketNumber % AZSCircuitBucketCount);
+        if (circuit->_bucketNumbers[index] != bucketNumber)
+        {
+            circuit->_bucketNumbers[index] = bucketNumber;
+            circuit->_requests[index] = 0;
+            circuit->_failures[index] = 0;
+        }
+        circuit->_requests[index]++;
+        if (failed)
+        {
+            circuit->_failures[index]++;
+        }
+
+        NSUInteger requests = 0;
+        NSUInteger failures = 0;
+        for (NSUInteger i = 0; i < AZSCircuitBucketCount; i++)
+        {
+            if (bucketNumber - circuit->_bucketNumbers[i] < AZSCircuitBucketCount)
+            {
+                requests += circuit->_requests[i];
+                failures += circuit->_failures[i];
+            }
+        }
+
+        if (failed && requests >= MAX(self.minimumRequests, (NSUInteger)1) && failures >= self.failureRatio * requests)
+        {
+            [self openCircuit:circuit now:now];
+        }
+    }
+}
+
+@end
@@ -32,6 +32,7 @@
 #import "AZSRetryInfo.h"
 #import "AZSRetryContext.h"
 #import "AZSRetryPolicy.h"
+#import "AZSRetryBudget.h"
 #import "AZSCloudBlockBlob.h"
 #import "AZSCloudPageBlob.h"
 #import "AZSCloudAppendBlob.h"
@@ -42,6 +43,20 @@
 #import "AZSCopyState.h"
 #import "AZSBlobOutputStream.h"
 #import "AZSCloudBlobDirectory.h"
+#import "AZSParallelBlobLister.h"
+#import "AZSBlobListingInventory.h"
+#import "AZSBlobListingIndex.h"
+#import "AZSBulkSharedAccessSignatureGenerator.h"
+#import "AZSClientMetrics.h"
+#import "AZSTracer.h"
+#import "AZSHttpTransport.h"
+#import "AZSURLSessionTransport.h"
+#import "AZSLoopbackTransport.h"
+#import "AZSCryptoProvider.h"
+#import "AZSCommonCryptoProvider.h"
+#import "AZSRequestGovernor.h"
+#import "AZSCircuitBreaker.h"
+#import "AZSHedgingPolicy.h"
 #import "AZSServiceProperties.h"
 #import "AZSLoggingProperties.h"
 #import "AZSMetricsProperties.h"
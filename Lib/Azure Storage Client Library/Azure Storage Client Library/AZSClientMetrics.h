@@ -0,0 +1,104 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSClientMetrics.h" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <Foundation/Foundation.h>
+#import "AZSEnums.h"
+#import "AZSMacros.h"
+
+AZS_ASSUME_NONNULL_BEGIN
+
+/** An AZSClientMetrics object aggregates request metrics across every operation made through a client.
+
+ Assign one to the metrics property of an AZSCloudBlobClient to start collecting.  Each HTTP request (including each
+ retry) is recorded in a latency histogram keyed by operation, status class and location, along with the bytes it
+ transferred.  Operations are named by HTTP method and the comp and restype query parameters, for example
+ "PUT comp=block" or "GET restype=container&comp=list".
+
+ Recording is safe from any thread and costs a few atomic additions per request.  Latencies are kept in log-linear
+ buckets with a relative error of at most 1/16, covering 1 microsecond to about 12 days.
+ */
+@interface AZSClientMetrics : NSObject
+
+/** The number of requests recorded, including retries.*/
+@property (readonly) int64_t requestCount;
+
+/** The number of requests that were retried.*/
+@property (readonly) int64_t retryCount;
+
+/** The number of responses with status 500 (Internal Server Error / Operation Timed Out) or 503 (Server Busy), the
+ codes the service uses when throttling.*/
+@property (readonly) int64_t throttledCount;
+
+/** The total request body bytes sent.*/
+@property (readonly) int64_t bytesSent;
+
+/** The total response body bytes received.*/
+@property (readonly) int64_t bytesReceived;
+
+/** The number of requests currently on the network.*/
+@property (readonly) int64_t inFlightRequests;
+
+/** The number of downloaded bytes currently held in download buffers, waiting to be written to the destination streams.*/
+@property (readonly) int64_t bufferedBytes;
+
+/** Computes a latency percentile for one operation, across all status classes and locations.
+
+ @param percentile The percentile to compute, from 0 to 100.
+ @param operation The operation name, as it appears in the textSnapshot.
+ @returns The latency at the given percentile, in seconds, or 0 if no requests were recorded for the operation.
+ */
+-(NSTimeInterval)percentile:(double)percentile ofLatencyForOperation:(NSString *)operation;
+
+/** Formats every metric in the Prometheus text exposition format, suitable for serving to a scraper.
+
+ Histograms are reported against fixed bounds from 1 ms to 60 s, and also as 50th, 90th and 99th percentiles.
+
+ @returns The snapshot.
+ */
+-(NSString *)textSnapshot;
+
+/** Clears the counters and histograms.  The in-flight and buffered gauges are not affected.*/
+-(void)reset;
+
+// The methods below are used by the library to record requests.
+
+/** Records that a request has been sent.*/
+-(void)requestStarted;
+
+/** Records a completed request.  Must follow a call to requestStarted.
+
+ @param operation The operation name.
+ @param statusCode The HTTP status code, or 0 if no response was received.
+ @param location The location the request was sent to.
+ @param duration The time from the start of the request to its completion, in seconds.
+ @param bytesSent The request body bytes sent.
+ @param bytesReceived The response body bytes received.
+ */
+-(void)requestFinishedWithOperation:(NSString *)operation statusCode:(NSInteger)statusCode location:(AZSStorageLocation)location duration:(NSTimeInterval)duration bytesSent:(int64_t)bytesSent bytesReceived:(int64_t)bytesReceived;
+
+/** Records that a request will be retried.*/
+-(void)recordRetry;
+
+/** Adjusts the buffered bytes gauge.
+
+ @param delta The number of bytes added to (or, if negative, removed from) a download buffer.
+ */
+-(void)addBufferedBytes:(int64_t)delta;
+
+@end
+
+AZS_ASSUME_NONNULL_END
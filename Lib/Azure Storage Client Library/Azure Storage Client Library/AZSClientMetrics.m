@@ -0,0 +1,373 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSClientMetrics.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <stdatomic.h>
+#import "AZSClientMetrics.h"
+
+// Latencies are recorded in microseconds.  Values below 16 get a bucket each; above that, each power of two is split
+// into 16 linear sub-buckets, so a bucket is never wider than 1/16 of its lower bound.
+#define AZSLatencySubBucketBits 4
+#define AZSLatencySubBucketCount (1 << AZSLatencySubBucketBits)
+#define AZSLatencyMaxExponent 39
+#define AZSLatencyBucketCount ((AZSLatencyMaxExponent - AZSLatencySubBucketBits + 2) * AZSLatencySubBucketCount)
+
+// Status classes are indexed by the first digit of the status code, with 0 for requests that got no response.
+#define AZSStatusClassCount 6
+#define AZSLocationCount 3
+
+typedef struct
+{
+    _Atomic int64_t requests;
+    _Atomic int64_t bytesSent;
+    _Atomic int64_t bytesReceived;
+    _Atomic int64_t latencySumMicroseconds;
+    _Atomic int64_t latencyBuckets[AZSLatencyBucketCount];
+} AZSMetricsSeries;
+
+static inline NSUInteger AZSLatencyBucketIndex(uint64_t microseconds)
+{
+    if (microseconds < AZSLatencySubBucketCount)
+    {
+        return (NSUInteger)microseconds;
+    }
+
+    int exponent = MIN(63 - __builtin_clzll(microseconds), AZSLatencyMaxExponent);
+    uint64_t subBucket = MIN(microseconds >> (exponent - AZSLatencySubBucketBits), (uint64_t)(2 * AZSLatencySubBucketCount - 1)) - AZSLatencySubBucketCount;
+    return (NSUInteger)((exponent - AZSLatencySubBucketBits + 1) * AZSLatencySubBucketCount + subBucket);
+}
+
+// The exclusive upper bound of a bucket, in microseconds.
+static inline uint64_t AZSLatencyBucketLimit(NSUInteger index)
+{
+    if (index < AZSLatencySubBucketCount)
+    {
+        return index + 1;
+    }
+
+    int shift = (int)(index / AZSLatencySubBucketCount) - 1;
+    uint64_t subBucket = AZSLatencySubBucketCount + (index % AZSLatencySubBucketCount);
+    return (subBucket + 1) << shift;
+}
+
+static const char *AZSStatusClassLabels[AZSStatusClassCount] = {"none", "1xx", "2xx", "3xx", "4xx", "5xx"};
+static const char *AZSLocationLabels[AZSLocationCount] = {"unspecified", "primary", "secondary"};
+
+// Upper bounds, in seconds, of the cumulative buckets in the text snapshot.
+static const double AZSSnapshotBounds[] = {0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30, 60};
+
+// Sums the latency buckets of several series into counts.
+static int64_t AZSMergeLatencyBuckets(AZSMetricsSeries * const *series, NSUInteger seriesCount, int64_t *counts)
+{
+    int64_t total = 0;
+    memset(counts, 0, AZSLatencyBucketCount * sizeof(int64_t));
+    for (NSUInteger i = 0; i < seriesCount; i++)
+    {
+        for (NSUInteger bucket = 0; bucket < AZSLatencyBucketCount; bucket++)
+        {
+            int64_t count = atomic_load_explicit(&series[i]->latencyBuckets[bucket], memory_order_relaxed);
+            counts[bucket] += count;
+            total += count;
+        }
+    }
+    return total;
+}
+
+// Nearest-rank percentile over merged bucket counts, reported as the upper bound of the bucket it falls in.
+static NSTimeInterval AZSLatencyPercentile(const int64_t *counts, int64_t total, double percentile)
+{
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    int64_t rank = MAX((int64_t)ceil(MIN(MAX(percentile, 0.0), 100.0) / 100.0 * total), 1);
+    int64_t seen = 0;
+    for (NSUInteger bucket = 0; bucket < AZSLatencyBucketCount; bucket++)
+    {
+        seen += counts[bucket];
+        if (seen >= rank)
+        {
+            return AZSLatencyBucketLimit(bucket) / 1000000.0;
+        }
+    }
+    return AZSLatencyBucketLimit(AZSLatencyBucketCount - 1) / 1000000.0;
+}
+
+// All the series for one operation, created as they are first needed.
+@interface AZSOperationMetrics : NSObject
+{
+    @public
+    AZSMetricsSeries *_series[AZSStatusClassCount][AZSLocationCount];
+}
+@end
+
+@implementation AZSOperationMetrics
+
+-(void)dealloc
+{
+    for (NSUInteger statusClass = 0; statusClass < AZSStatusClassCount; statusClass++)
+    {
+        for (NSUInteger location = 0; location < AZSLocationCount; location++)
+        {
+            free(_series[statusClass][location]);
+        }
+    }
+}
+
+@end
+
+@interface AZSClientMetrics()
+{
+    NSMutableDictionary *_operations;
+    _Atomic int64_t _retryCount;
+    _Atomic int64_t _throttledCount;
+    _Atomic int64_t _inFlightRequests;
+    _Atomic int64_t _bufferedBytes;
+}
+
+@end
+
+@implementation AZSClientMetrics
+
+-(instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        _operations = [NSMutableDictionary dictionaryWithCapacity:16];
+    }
+
+    return self;
+}
+
+// Series are never freed before the registry is, so the pointer can be used outside the lock.
+-(AZSMetricsSeries *)seriesForOperation:(NSString *)operation statusClass:(NSUInteger)statusClass location:(NSUInteger)location
+{
+    @synchronized(self)
+    {
+        AZSOperationMetrics *operationMetrics = _operations[operation];
+        if (!operationMetrics)
+        {
+            operationMetrics = [[AZSOperationMetrics alloc] init];
+            _operations[operation] = operationMetrics;
+        }
+
+        AZSMetricsSeries *series = operationMetrics->_series[statusClass][location];
+        if (!series)
+        {
+            series = calloc(1, sizeof(AZSMetricsSeries));
+            operationMetrics->_series[statusClass][location] = series;
+        }
+        return series;
+    }
+}
+
+// Calls the block for every series created so far, in a stable order.
+-(void)enumerateSeriesUsingBlock:(void (^)(NSString *operation, NSUInteger statusClass, NSUInteger location, AZSMetricsSeries *series))block
+{
+    @synchronized(self)
+    {
+        for (NSString *operation in [_operations.allKeys sortedArrayUsingSelector:@selector(compare:)])
+        {
+            AZSOperationMetrics *operationMetrics = _operations[operation];
+            for (NSUInteger statusClass = 0; statusClass < AZSStatusClassCount; statusClass++)
+            {
+                for (NSUInteger location = 0; location < AZSLocationCount; location++)
+                {
+                    AZSMetricsSeries *series = operationMetrics->_series[statusClass][location];
+                    if (series)
+                    {
+                        block(operation, statusClass, location, series);
+                    }
+                }
+            }
+        }
+    }
+}
+
+-(void)requestStarted
+{
+    atomic_fetch_add_explicit(&_inFlightRequests, 1, memory_order_relaxed);
+}
+
+-(void)requestFinishedWithOperation:(NSString *)operation statusCode:(NSInteger)statusCode location:(AZSStorageLocation)location duration:(NSTimeInterval)duration bytesSent:(int64_t)bytesSent bytesReceived:(int64_t)bytesReceived
+{
+    atomic_fetch_sub_explicit(&_inFlightRequests, 1, memory_order_relaxed);
+    if (statusCode == 500 || statusCode == 503)
+    {
+        atomic_fetch_add_explicit(&_throttledCount, 1, memory_order_relaxed);
+    }
+
+    NSUInteger statusClass = (statusCode >= 100 && statusCode < 600) ? (NSUInteger)(statusCode / 100) : 0;
+    NSUInteger locationIndex = (location >= 0 && location < AZSLocationCount) ? (NSUInteger)location : 0;
+    AZSMetricsSeries *series = [self seriesForOperation:operation statusClass:statusClass location:locationIndex];
+
+    uint64_t microseconds = (duration > 0) ? (uint64_t)(duration * 1000000.0) : 0;
+    atomic_fetch_add_explicit(&series->requests, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&series->bytesSent, bytesSent, memory_order_relaxed);
+    atomic_fetch_add_explicit(&series->bytesReceived, bytesReceived, memory_order_relaxed);
+    atomic_fetch_add_explicit(&series->latencySumMicroseconds, (int64_t)microseconds, memory_order_relaxed);
+    atomic_fetch_add_explicit(&series->latencyBuckets[AZSLatencyBucketIndex(microseconds)], 1, memory_order_relaxed);
+}
+
+-(void)recordRetry
+{
+    atomic_fetch_add_explicit(&_retryCount, 1, memory_order_relaxed);
+}
+
+-(void)addBufferedBytes:(int64_t)delta
+{
+    atomic_fetch_add_explicit(&_bufferedBytes, delta, memory_order_relaxed);
+}
+
+-(int64_t)retryCount
+{
+    return atomic_load_explicit(&_retryCount, memory_order_relaxed);
+}
+
+-(int64_t)throttledCount
+{
+    return atomic_load_explicit(&_throttledCount, memory_order_relaxed);
+}
+
+-(int64_t)inFlightRequests
+{
+    return atomic_load_explicit(&_inFlightRequests, memory_order_relaxed);
+}
+
+-(int64_t)bufferedBytes
+{
+    return atomic_load_explicit(&_bufferedBytes, memory_order_relaxed);
+}
+
+-(int64_t)sumOfSeriesField:(size_t)offset
+{
+    __block int64_t sum = 0;
+    [self enumerateSeriesUsingBlock:^(NSString *operation, NSUInteger statusClass, NSUInteger location, AZSMetricsSeries *series) {
+        sum += atomic_load_explicit((_Atomic int64_t *)((uint8_t *)series + offset), memory_order_relaxed);
+    }];
+    return sum;
+}
+
+-(int64_t)requestCount
+{
+    return [self sumOfSeriesField:offsetof(AZSMetricsSeries, requests)];
+}
+
+-(int64_t)bytesSent
+{
+    return [self sumOfSeriesField:offsetof(AZSMetricsSeries, bytesSent)];
+}
+
+-(int64_t)bytesReceived
+{
+    return [self sumOfSeriesField:offsetof(AZSMetricsSeries, bytesReceived)];
+}
+
+-(NSTimeInterval)percentile:(double)percentile ofLatencyForOperation:(NSString *)operation
+{
+    AZSMetricsSeries *series[AZSStatusClassCount * AZSLocationCount];
+    NSUInteger seriesCount = 0;
+    @synchronized(self)
+    {
+        AZSOperationMetrics *operationMetrics = _operations[operation];
+        for (NSUInteger statusClass = 0; operationMetrics && statusClass < AZSStatusClassCount; statusClass++)
+        {
+            for (NSUInteger location = 0; location < AZSLocationCount; location++)
+            {
+                if (operationMetrics->_series[statusClass][location])
+                {
+                    series[seriesCount++] = operationMetrics->_series[statusClass][location];
+                }
+            }
+        }
+    }
+
+    int64_t counts[AZSLatencyBucketCount];
+    int64_t total = AZSMergeLatencyBuckets(series, seriesCount, counts);
+    return AZSLatencyPercentile(counts, total, percentile);
+}
+
+-(NSString *)textSnapshot
+{
+    NSMutableString *requests = [NSMutableString stringWithString:@"# TYPE azs_requests_total counter\n"];
+    NSMutableString *sent = [NSMutableString stringWithString:@"# TYPE azs_sent_bytes_total counter\n"];
+    NSMutableString *received = [NSMutableString stringWithString:@"# TYPE azs_received_bytes_total counter\n"];
+    NSMutableString *histogram = [NSMutableString stringWithString:@"# TYPE azs_request_duration_seconds histogram\n"];
+    NSMutableString *quantiles = [NSMutableString stringWithString:@"# TYPE azs_request_duration_quantile_seconds gauge\n"];
+
+    [self enumerateSeriesUsingBlock:^(NSString *operation, NSUInteger statusClass, NSUInteger location, AZSMetricsSeries *series) {
+        NSString *labels = [NSString stringWithFormat:@"operation=\"%@\",status=\"%s\",location=\"%s\"", operation, AZSStatusClassLabels[statusClass], AZSLocationLabels[location]];
+        [requests appendFormat:@"azs_requests_total{%@} %lld\n", labels, (long long)atomic_load_explicit(&series->requests, memory_order_relaxed)];
+        [sent appendFormat:@"azs_sent_bytes_total{%@} %lld\n", labels, (long long)atomic_load_explicit(&series->bytesSent, memory_order_relaxed)];
+        [received appendFormat:@"azs_received_bytes_total{%@} %lld\n", labels, (long long)atomic_load_explicit(&series->bytesReceived, memory_order_relaxed)];
+
+        int64_t counts[AZSLatencyBucketCount];
+        int64_t total = AZSMergeLatencyBuckets(&series, 1, counts);
+
+        // A latency bucket is counted under a bound once its upper limit is within it.
+        int64_t cumulative = 0;
+        NSUInteger bucket = 0;
+        for (NSUInteger i = 0; i < sizeof(AZSSnapshotBounds) / sizeof(AZSSnapshotBounds[0]); i++)
+        {
+            uint64_t boundMicroseconds = (uint64_t)(AZSSnapshotBounds[i] * 1000000.0);
+            while (bucket < AZSLatencyBucketCount && AZSLatencyBucketLimit(bucket) <= boundMicroseconds + 1)
+            {
+                cumulative += counts[bucket++];
+            }
+            [histogram appendFormat:@"azs_request_duration_seconds_bucket{%@,le=\"%g\"} %lld\n", labels, AZSSnapshotBounds[i], (long long)cumulative];
+        }
+        [histogram appendFormat:@"azs_request_duration_seconds_bucket{%@,le=\"+Inf\"} %lld\n", labels, (long long)total];
+        [histogram appendFormat:@"azs_request_duration_seconds_sum{%@} %.6f\n", labels, atomic_load_explicit(&series->latencySumMicroseconds, memory_order_relaxed) / 1000000.0];
+        [histogram appendFormat:@"azs_request_duration_seconds_count{%@} %lld\n", labels, (long long)total];
+
+        for (NSNumber *quantile in @[@0.5, @0.9, @0.99])
+        {
+            [quantiles appendFormat:@"azs_request_duration_quantile_seconds{%@,quantile=\"%g\"} %.6f\n", labels, quantile.doubleValue, AZSLatencyPercentile(counts, total, quantile.doubleValue * 100)];
+        }
+    }];
+
+    NSMutableString *snapshot = [NSMutableString stringWithCapacity:(requests.length + sent.length + received.length + histogram.length + quantiles.length + 512)];
+    [snapshot appendString:requests];
+    [snapshot appendString:sent];
+    [snapshot appendString:received];
+    [snapshot appendString:histogram];
+    [snapshot appendString:quantiles];
+    [snapshot appendFormat:@"# TYPE azs_retries_total counter\nazs_retries_total %lld\n", (long long)self.retryCount];
+    [snapshot appendFormat:@"# TYPE azs_throttled_total counter\nazs_throttled_total %lld\n", (long long)self.throttledCount];
+    [snapshot appendFormat:@"# TYPE azs_in_flight_requests gauge\nazs_in_flight_requests %lld\n", (long long)self.inFlightRequests];
+    [snapshot appendFormat:@"# TYPE azs_buffered_bytes gauge\nazs_buffered_bytes %lld\n", (long long)self.bufferedBytes];
+    return snapshot;
+}
+
+-(void)reset
+{
+    [self enumerateSeriesUsingBlock:^(NSString *operation, NSUInteger statusClass, NSUInteger location, AZSMetricsSeries *series) {
+        atomic_store_explicit(&series->requests, 0, memory_order_relaxed);
+        atomic_store_explicit(&series->bytesSent, 0, memory_order_relaxed);
+        atomic_store_explicit(&series->bytesReceived, 0, memory_order_relaxed);
+        atomic_store_explicit(&series->latencySumMicroseconds, 0, memory_order_relaxed);
+        for (NSUInteger bucket = 0; bucket < AZSLatencyBucketCount; bucket++)
+        {
+            atomic_store_explicit(&series->latencyBuckets[bucket], 0, memory_order_relaxed);
+        }
+    }];
+    atomic_store_explicit(&_retryCount, 0, memory_order_relaxed);
+    atomic_store_explicit(&_throttledCount, 0, memory_order_relaxed);
+}
+
+@end
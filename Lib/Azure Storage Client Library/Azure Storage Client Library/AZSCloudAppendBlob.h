@@ -160,6 +160,25 @@ AZS_ASSUME_NONNULL_BEGIN
  */
 -(void)appendBlockWithData:(NSData *)blockData contentMD5:(AZSNullable NSString *)contentMD5 accessCondition:(AZSNullable AZSAccessCondition *)accessCondition requestOptions:(AZSNullable AZSBlobRequestOptions *)requestOptions operationContext:(AZSNullable AZSOperationContext *)operationContext completionHandler:(void (^)(NSError * __AZSNullable, NSNumber *appendOffset))completionHandler;
 
+/** Appends a block of data to the append blob.
+ 
+ @param blockData The data to append.  Must be less than 4 MB.
+ @param contentMD5 Optional.  The content-MD5 to use for transactional integrety for the appendBlock request.
+ If contentMD5 is nil, and requestOptions.useTransactionalMD5 is set to YES, the library will calculate the MD5 of the block for you.
+ This value is not stored on the service.
+ @param contentCRC64 Optional.  The CRC64 to use for transactional integrity for the appendBlock request, in the x-ms-content-crc64 header.
+ If contentCRC64 is nil, and requestOptions.useTransactionalCRC64 is set to YES, the library will calculate the CRC64 of the block for you.
+ @param accessCondition The access condition for the request.
+ @param requestOptions The options to use for the request.
+ @param operationContext The operation context to use for the call.
+ @param completionHandler The block of code to execute when the append call completes.
+ | Parameter name | Description |
+ |----------------|-------------|
+ |NSError * | Nil if the operation succeeded without error, error with details about the failure otherwise.|
+ |NSNumber * | The append offset for this append operation - the offset where this block was committed|
+ */
+-(void)appendBlockWithData:(NSData *)blockData contentMD5:(AZSNullable NSString *)contentMD5 contentCRC64:(AZSNullable NSString *)contentCRC64 accessCondition:(AZSNullable AZSAccessCondition *)accessCondition requestOptions:(AZSNullable AZSBlobRequestOptions *)requestOptions operationContext:(AZSNullable AZSOperationContext *)operationContext completionHandler:(void (^)(NSError * __AZSNullable, NSNumber *appendOffset))completionHandler;
+
 /** Creates an output stream that is capable of writing to the blob.
  
  This method returns an instance of AZSBlobOutputStream.  The caller can then assign a delegate and schedule the stream in a runloop
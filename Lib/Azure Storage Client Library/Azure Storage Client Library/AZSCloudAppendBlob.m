@@ -108,6 +108,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse *urlResponse, AZSRequestResult *requestResult, AZSOperationContext *operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
@@ -163,6 +165,11 @@
 }
 
 -(void)appendBlockWithData:(NSData *)blockData contentMD5:(NSString *)contentMD5 accessCondition:(AZSNullable AZSAccessCondition *)accessCondition requestOptions:(AZSNullable AZSBlobRequestOptions *)requestOptions operationContext:(AZSNullable AZSOperationContext *)operationContext completionHandler:(void (^)(NSError * __AZSNullable, NSNumber *appendOffset))completionHandler
+{
+    [self appendBlockWithData:blockData contentMD5:contentMD5 contentCRC64:nil accessCondition:accessCondition requestOptions:requestOptions operationContext:operationContext completionHandler:completionHandler];
+}
+
+-(void)appendBlockWithData:(NSData *)blockData contentMD5:(NSString *)contentMD5 contentCRC64:(NSString *)contentCRC64 accessCondition:(AZSNullable AZSAccessCondition *)accessCondition requestOptions:(AZSNullable AZSBlobRequestOptions *)requestOptions operationContext:(AZSNullable AZSOperationContext *)operationContext completionHandler:(void (^)(NSError * __AZSNullable, NSNumber *appendOffset))completionHandler
 {
     if (!operationContext)
     {
@@ -175,14 +182,21 @@
     {
         contentMD5 = [AZSUtil calculateMD5FromData:blockData];
     }
+    
+    if (modifiedOptions.useTransactionalCRC64 && !(contentCRC64))
+    {
+        contentCRC64 = [AZSUtil calculateCRC64FromData:blockData];
+    }
 
     [command setBuildRequest:^ NSMutableURLRequest * (NSURLComponents *urlComponents, NSTimeInterval timeout, AZSOperationContext *operationContext)
     {
-        return [AZSBlobRequestFactory appendBlockWithLength:blockData.length contentMD5:contentMD5 accessCondition:accessCondition urlComponents:urlComponents timeout:timeout operationContext:operationContext];
+        return [AZSBlobRequestFactory appendBlockWithLength:blockData.length contentMD5:contentMD5 contentCRC64:contentCRC64 accessCondition:accessCondition urlComponents:urlComponents timeout:timeout operationContext:operationContext];
     }];
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     __block NSNumber *appendPosition;
     [command setPreProcessResponse:^id(NSHTTPURLResponse *urlResponse, AZSRequestResult *requestResult, AZSOperationContext *operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
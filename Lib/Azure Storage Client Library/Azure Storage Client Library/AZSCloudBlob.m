@@ -38,6 +38,7 @@
 #import "AZSSharedAccessSignatureHelper.h"
 #import "AZSStorageCredentials.h"
 #import "AZSBlobResponseParser.h"
+#import "AZSLogging.h"
 
 @interface AZSCloudBlob()
 
@@ -73,13 +74,13 @@
         
         if (([credentials isSAS] || [credentials isSharedKey]) && ![parseQueryResults[1] isKindOfClass:[NSNull class]]) {
             *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-            [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Multiple credentials provided."];
+            AZSLogError([AZSUtil operationlessContext], @"Multiple credentials provided.");
             return nil;
         }
         
         if (snapshotTime && ![parseQueryResults[AZSCSnapshotIndex] isKindOfClass:[NSNull class]]) {
             *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-            [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Multiple snapshot times provided."];
+            AZSLogError([AZSUtil operationlessContext], @"Multiple snapshot times provided.");
             return nil;
         }
         
@@ -148,14 +149,18 @@
     AZSBlobRequestOptions *modifiedOptions = [[AZSBlobRequestOptions copyOptions:requestOptions] applyDefaultsFromOptions:self.client.defaultRequestOptions];
     AZSStorageCommand * command = [[AZSStorageCommand alloc] initWithStorageCredentials:self.client.credentials storageUri:self.storageUri calculateResponseMD5:!(modifiedOptions.disableContentMD5Validation) operationContext:operationContext];
     command.allowedStorageLocation = AZSAllowedStorageLocationPrimaryOrSecondary;
+    command.calculateResponseCRC64 = modifiedOptions.useTransactionalCRC64;
     [command setBuildRequest:^ NSMutableURLRequest * (NSURLComponents *urlComponents, NSTimeInterval timeout, AZSOperationContext *operationContext)
      {
-         return [AZSBlobRequestFactory getBlobWithSnapshotTime:self.snapshotTime range:range getRangeContentMD5:modifiedOptions.useTransactionalMD5 accessCondition:accessCondition urlComponents:urlComponents timeout:timeout operationContext:operationContext];
+         return [AZSBlobRequestFactory getBlobWithSnapshotTime:self.snapshotTime range:range getRangeContentMD5:modifiedOptions.useTransactionalMD5 getRangeContentCRC64:modifiedOptions.useTransactionalCRC64 accessCondition:accessCondition urlComponents:urlComponents timeout:timeout operationContext:operationContext];
      }];
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     __block NSString *desiredContentMD5 = nil;
+    __block NSString *desiredContentCRC64 = nil;
         
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
@@ -182,12 +187,20 @@
             return storageError;
         }
         
+        // The service only returns a CRC64 for ranged reads.
+        if (modifiedOptions.useTransactionalCRC64 && (range.length > 0) && !requestResult.contentReceivedCRC64)
+        {
+            return [NSError errorWithDomain:AZSErrorDomain code:AZSECRC64Mismatch userInfo:nil];
+        }
+        
         desiredContentMD5 = parsedProperties.contentMD5;
+        desiredContentCRC64 = requestResult.contentReceivedCRC64;
         
         if (range.length > 0)
         {
-            // If it's a range get, don't update the contentMD5 on the blob's properties.
+            // If it's a range get, don't update the contentMD5 or contentCRC64 on the blob's properties.
             parsedProperties.contentMD5 = self.properties.contentMD5;
+            parsedProperties.contentCRC64 = self.properties.contentCRC64;
         }
         
         self.properties = parsedProperties;
@@ -207,6 +220,18 @@
                 *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEMD5Mismatch userInfo:nil];
             }
         }
+        if (desiredContentCRC64 && modifiedOptions.useTransactionalCRC64)
+        {
+            if ([desiredContentCRC64 compare:requestResult.calculatedResponseCRC64 options:NSLiteralSearch] != NSOrderedSame)
+            {
+                *error = [NSError errorWithDomain:AZSErrorDomain code:AZSECRC64Mismatch userInfo:nil];
+            }
+        }
+        if (modifiedOptions.useTransactionalCRC64 && (range.length == 0))
+        {
+            // The service returns no CRC64 for the whole blob, but the one calculated on the way in is still worth keeping.
+            self.properties.contentCRC64 = requestResult.calculatedResponseCRC64;
+        }
         return nil;
     }];
     
@@ -244,6 +269,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         return [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
     }];
@@ -276,6 +303,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
@@ -315,6 +344,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
@@ -349,6 +380,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
@@ -412,6 +445,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         return [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
     }];
@@ -475,7 +510,7 @@
 {
     if (![self.client.credentials isSharedKey]) {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-        [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Cannot create SAS without account key."];
+        AZSLogError([AZSUtil operationlessContext], @"Cannot create SAS without account key.");
         return nil;
     }
     
@@ -522,6 +557,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
@@ -572,6 +609,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
@@ -623,6 +662,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
@@ -673,6 +714,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
@@ -718,6 +761,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
@@ -740,7 +785,7 @@
 +(void)updateEtagAndLastModifiedWithResponse:(NSHTTPURLResponse *)response properties:(AZSBlobProperties *)properties updateLength:(BOOL)updateLength
 {
     NSString *parsedEtag = response.allHeaderFields[AZSCXmlETag];
-    NSDate *parsedLastModified = [[AZSUtil dateFormatterWithRFCFormat] dateFromString:response.allHeaderFields[AZSCXmlLastModified]];
+    NSDate *parsedLastModified = [AZSUtil dateFromHttpString:response.allHeaderFields[AZSCXmlLastModified]];
     NSString *parsedSequenceNumberString = response.allHeaderFields[AZSCHeaderBlobSequenceNumber];
 
     if (parsedEtag)
@@ -872,6 +917,8 @@
      }];
 
     [command setAuthenticationHandler:self.client.authenticationHandler];
+
+    [self.client configureCommand:command];
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext)
     {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
@@ -920,6 +967,8 @@
      }];
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
+    
+    [self.client configureCommand:command];
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext)
      {
          NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
@@ -83,6 +83,8 @@
     
     [command setAuthenticationHandler:self.authenticationHandler];
     
+    [self configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         return [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
     }];
@@ -173,6 +175,8 @@
 
     [command setAuthenticationHandler:self.authenticationHandler];
 
+    [self configureCommand:command];
+
     [command setPreProcessResponse:^ NSError * (NSHTTPURLResponse *urlResponse, AZSRequestResult *requestResult, AZSOperationContext *operationContext) {
         return [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
     }];
@@ -201,6 +205,8 @@
 
     [command setAuthenticationHandler:self.authenticationHandler];
 
+    [self configureCommand:command];
+
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         return [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
     }];
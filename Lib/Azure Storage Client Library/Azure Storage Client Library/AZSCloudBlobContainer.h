@@ -38,6 +38,7 @@ AZS_ASSUME_NONNULL_BEGIN
 @class AZSSharedAccessPolicy;
 @class AZSStorageCredentials;
 @class AZSCloudBlobDirectory;
+@class AZSBlobListingInventory;
 
 // TODO: Figure out if we should combine all these into one generic 'Null response completion handler' or something.
 // TODO: Figure out how to get this typedef to work with Appledocs.
@@ -277,6 +278,31 @@ AZS_ASSUME_NONNULL_BEGIN
  */
 - (void)listBlobsSegmentedWithContinuationToken:(AZSNullable AZSContinuationToken *)token prefix:(AZSNullable NSString *)prefix useFlatBlobListing:(BOOL)useFlatBlobListing blobListingDetails:(AZSBlobListingDetails)blobListingDetails maxResults:(NSInteger)maxResults accessCondition:(AZSNullable AZSAccessCondition *)accessCondition requestOptions:(AZSNullable AZSBlobRequestOptions *)requestOptions operationContext:(AZSNullable AZSOperationContext *)operationContext completionHandler:(void (^)(NSError * __AZSNullable, AZSBlobResultSegment * __AZSNullable))completionHandler;
 
+/** Performs one segmented, flat blob listing operation, appending the results to an AZSBlobListingInventory.
+ 
+ This behaves like listBlobsSegmentedWithContinuationToken:prefix:useFlatBlobListing:blobListingDetails:maxResults:accessCondition:requestOptions:operationContext:completionHandler:
+ with a flat listing, but no AZSCloudBlob objects are created.  Only the properties kept by the inventory are parsed, so
+ AZSBlobListingDetailsMetadata and AZSBlobListingDetailsCopy are ignored.
+ 
+ The inventory is not thread-safe; do not list into the same inventory from more than one call at a time.
+ 
+ @param token The token representing where the listing operation should start.
+ @param prefix The prefix to use for blob listing.  Only blobs that begin with the input prefix will be listed.
+ @param blobListingDetails Details about how to list blobs.  See AZSBlobListingDetails for the possible options.
+ @param maxResults The maximum number of results to return for this operation.  Use -1 to not set a limit.
+ @param inventory The inventory to add the listed blobs to.
+ @param accessCondition The access condition for the request.
+ @param requestOptions The options to use for the request.
+ @param operationContext The operation context to use for the call.
+ @param completionHandler The block of code to execute with the results of the listing operation.
+ 
+ | Parameter name | Description |
+ |----------------|-------------|
+ |NSError * | Nil if the operation succeeded without error, error with details about the failure otherwise.|
+ |AZSContinuationToken * | The token to continue the listing with, or nil if there are no more blobs.|
+ */
+- (void)listBlobsSegmentedWithContinuationToken:(AZSNullable AZSContinuationToken *)token prefix:(AZSNullable NSString *)prefix blobListingDetails:(AZSBlobListingDetails)blobListingDetails maxResults:(NSInteger)maxResults inventory:(AZSBlobListingInventory *)inventory accessCondition:(AZSNullable AZSAccessCondition *)accessCondition requestOptions:(AZSNullable AZSBlobRequestOptions *)requestOptions operationContext:(AZSNullable AZSOperationContext *)operationContext completionHandler:(void (^)(NSError * __AZSNullable, AZSContinuationToken * __AZSNullable))completionHandler;
+
 /** Initialize a local AZSCloudBlockBlob object
  
  This creates an AZSCloudBlockBlob object with the input name.
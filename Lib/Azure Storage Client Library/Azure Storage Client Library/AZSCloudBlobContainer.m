@@ -34,6 +34,7 @@
 #import "AZSRequestResult.h"
 #import "AZSContinuationToken.h"
 #import "AZSResultSegment.h"
+#import "AZSBlobListingInventory.h"
 #import "AZSBlobContainerProperties.h"
 #import "AZSBlobRequestXML.h"
 #import "AZSSharedAccessBlobParameters.h"
@@ -47,6 +48,7 @@
 #import "AZSCloudPageBlob.h"
 #import "AZSCloudAppendBlob.h"
 #import "AZSBlobProperties.h"
+#import "AZSLogging.h"
 
 @interface AZSCloudBlobContainer()
 
@@ -85,7 +87,7 @@
         
         if (([credentials isSAS] || [credentials isSharedKey]) && (![parseQueryResults[1] isKindOfClass:[NSNull class]] && ([parseQueryResults[1] isSAS] || [parseQueryResults[1] isSharedKey]))) {
             *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-            [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Multiple credentials provided."];
+            AZSLogError([AZSUtil operationlessContext], @"Multiple credentials provided.");
             return nil;
         }
         
@@ -140,6 +142,8 @@
      }];
 
     [command setAuthenticationHandler:self.client.authenticationHandler];
+
+    [self.client configureCommand:command];
     
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         [self updateEtagAndLastModifiedWithResponse:urlResponse];
@@ -175,6 +179,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         return [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
     }];
@@ -215,6 +221,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         return [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
     }];
@@ -275,6 +283,63 @@
     return;
 }
 
+- (void)listBlobsSegmentedWithContinuationToken:(AZSContinuationToken *)token prefix:(NSString *)prefix blobListingDetails:(AZSBlobListingDetails)blobListingDetails maxResults:(NSInteger)maxResults inventory:(AZSBlobListingInventory *)inventory accessCondition:(AZSAccessCondition *)accessCondition requestOptions:(AZSBlobRequestOptions *)requestOptions operationContext:(AZSOperationContext *)operationContext completionHandler:(void (^)(NSError *, AZSContinuationToken *))completionHandler
+{
+    if (!operationContext)
+    {
+        operationContext = [[AZSOperationContext alloc] init];
+    }
+    AZSBlobRequestOptions *modifiedOptions = [[AZSBlobRequestOptions copyOptions:requestOptions] applyDefaultsFromOptions:self.client.defaultRequestOptions];
+    AZSStorageCommand * command = [[AZSStorageCommand alloc] initWithStorageCredentials:self.client.credentials storageUri:self.storageUri operationContext:operationContext];
+    NSError *locationError;
+    [command setAllowedStorageLocation:AZSAllowedStorageLocationPrimaryOrSecondary withLockLocation:(token ? token.storageLocation : AZSStorageLocationUnspecified) error:&locationError];
+    
+    if (locationError)
+    {
+        completionHandler(locationError, nil);
+        return;
+    }
+    
+    // The inventory does not keep metadata or copy state, so don't ask the service for them.
+    AZSBlobListingDetails inventoryListingDetails = blobListingDetails & ~(AZSBlobListingDetailsMetadata | AZSBlobListingDetailsCopy);
+    
+    [command setBuildRequest:^ NSMutableURLRequest * (NSURLComponents *urlComponents, NSTimeInterval timeout, AZSOperationContext *operationContext)
+     {
+         return [AZSBlobRequestFactory listBlobsWithPrefix:prefix delimiter:nil blobListingDetails:inventoryListingDetails maxResults:maxResults continuationToken:token urlComponents:urlComponents timeout:timeout operationContext:operationContext];
+     }];
+    
+    [command setAuthenticationHandler:self.client.authenticationHandler];
+    
+    [self.client configureCommand:command];
+    
+    [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
+        return [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
+    }];
+    
+    [command setPostProcessResponse:^id(NSHTTPURLResponse *urlResponse, AZSRequestResult *requestResult, NSOutputStream *outputStream, AZSOperationContext *operationContext, NSError **error) {
+        // Parse into a scratch inventory, so that a response that fails partway through (and may be retried) doesn't leave partial results behind.
+        AZSBlobListingInventory *segmentInventory = [[AZSBlobListingInventory alloc] initWithContainer:self];
+        AZSListBlobsResponse *listBlobsResponse = [AZSListBlobsResponse parseListBlobsResponseWithData:[outputStream propertyForKey:NSStreamDataWrittenToMemoryStreamKey] inventory:segmentInventory operationContext:operationContext error:error];
+        
+        if (*error)
+        {
+            return nil;
+        }
+        
+        [inventory addEntriesFromInventory:segmentInventory];
+        
+        AZSContinuationToken *continuationToken = nil;
+        if (listBlobsResponse.nextMarker != nil && listBlobsResponse.nextMarker.length > 0)
+        {
+            continuationToken = [AZSContinuationToken tokenFromString:listBlobsResponse.nextMarker withLocation:requestResult.targetLocation];
+        }
+        return continuationToken;
+    }];
+    
+    [AZSExecutor ExecuteWithStorageCommand:command requestOptions:modifiedOptions operationContext:operationContext completionHandler:completionHandler];
+    return;
+}
+
 - (void)uploadMetadataWithCompletionHandler:(void (^)(NSError *))completionHandler
 {
     return [self uploadMetadataWithAccessCondition:nil requestOptions:nil operationContext:nil completionHandler:completionHandler];
@@ -296,6 +361,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         [self updateEtagAndLastModifiedWithResponse:urlResponse];
         return [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
@@ -336,6 +403,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^ NSError * (NSHTTPURLResponse *urlResponse, AZSRequestResult *requestResult, AZSOperationContext *operationContext) {
         [self updateEtagAndLastModifiedWithResponse:urlResponse];
         return [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
@@ -362,6 +431,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         [self updateEtagAndLastModifiedWithResponse:urlResponse];
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
@@ -416,6 +487,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         [self updateEtagAndLastModifiedWithResponse:urlResponse];
         return [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
@@ -465,6 +538,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         [self updateEtagAndLastModifiedWithResponse:urlResponse];
         return [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
@@ -508,6 +583,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         [self updateEtagAndLastModifiedWithResponse:urlResponse];
         return [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
@@ -554,6 +631,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         [self updateEtagAndLastModifiedWithResponse:urlResponse];
         return [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
@@ -598,6 +677,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         [self updateEtagAndLastModifiedWithResponse:urlResponse];
         return [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
@@ -642,6 +723,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         [self updateEtagAndLastModifiedWithResponse:urlResponse];
         return [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
@@ -657,7 +740,7 @@
 -(void)updateEtagAndLastModifiedWithResponse:(NSHTTPURLResponse *)response
 {
     NSString *parsedEtag = response.allHeaderFields[AZSCXmlETag];
-    NSDate *parsedLastModified = [[AZSUtil dateFormatterWithRFCFormat] dateFromString:response.allHeaderFields[AZSCXmlLastModified]];
+    NSDate *parsedLastModified = [AZSUtil dateFromHttpString:response.allHeaderFields[AZSCXmlLastModified]];
     
     if (parsedEtag)
     {
@@ -810,7 +893,7 @@
 {
     if (![self.client.credentials isSharedKey]) {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-        [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Cannot create SAS without account key."];
+        AZSLogError([AZSUtil operationlessContext], @"Cannot create SAS without account key.");
         return nil;
     }
     
@@ -196,6 +196,31 @@ AZS_ASSUME_NONNULL_BEGIN
  */
 -(void)uploadBlockFromData:(NSData *)sourceData blockID:(NSString *)blockID contentMD5:(AZSNullable NSString *)contentMD5 accessCondition:(AZSNullable AZSAccessCondition *)accessCondition requestOptions:(AZSNullable AZSBlobRequestOptions *)requestOptions operationContext:(AZSNullable AZSOperationContext *)operationContext completionHandler:(void (^)(NSError* __AZSNullable))completionHandler;
 
+/** Uploads a single block from given source data.
+ 
+ This operation uploads one block of data to the blob in the Storage Service.  The block will remain uncommitted (meaning the data will not 
+ be considered part of the blob) until a corresponding uploadBlockList call.
+ 
+ Note that all blocks in a given blob must have the same length Block ID.
+ 
+ @param sourceData The data that the blob should contain.
+ @param blockID The base64-encoded string identifying the block.
+ @param contentMD5 Optional.  The content-MD5 to use for transactional integrety for the uploadBlock request. 
+ If contentMD5 is nil, and requestOptions.useTransactionalMD5 is set to YES, the library will calculate the MD5 of the block for you.
+ This value is not stored on the service.
+ @param contentCRC64 Optional.  The CRC64 to use for transactional integrity for the uploadBlock request, in the x-ms-content-crc64 header.
+ If contentCRC64 is nil, and requestOptions.useTransactionalCRC64 is set to YES, the library will calculate the CRC64 of the block for you.
+ @param accessCondition The access condition for the request.
+ @param requestOptions The options to use for the request.
+ @param operationContext The operation context to use for the call.
+ @param completionHandler The block of code to execute when the upload call completes.
+ 
+ | Parameter name | Description |
+ |----------------|-------------|
+ |NSError * | Nil if the operation succeeded without error, error with details about the failure otherwise.|
+ */
+-(void)uploadBlockFromData:(NSData *)sourceData blockID:(NSString *)blockID contentMD5:(AZSNullable NSString *)contentMD5 contentCRC64:(AZSNullable NSString *)contentCRC64 accessCondition:(AZSNullable AZSAccessCondition *)accessCondition requestOptions:(AZSNullable AZSBlobRequestOptions *)requestOptions operationContext:(AZSNullable AZSOperationContext *)operationContext completionHandler:(void (^)(NSError* __AZSNullable))completionHandler;
+
 /** Uploads a block list, committing the blocks in the list to the blob.
  
  This operation commits a block list to the blob, which causes the blob to be committed.  The blocks included in the list will be
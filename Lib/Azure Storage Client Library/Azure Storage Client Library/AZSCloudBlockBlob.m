@@ -206,7 +206,7 @@
     {
         unsigned char md5Bytes[CC_MD5_DIGEST_LENGTH];
         CC_MD5(sourceData.bytes, sourceData.length, md5Bytes);
-        NSString *contentMD5String = [[[NSData alloc] initWithBytes:md5Bytes length:CC_MD5_DIGEST_LENGTH] base64EncodedStringWithOptions:0];
+        NSString *contentMD5String = [AZSUtil base64EncodedStringWithBytes:md5Bytes length:CC_MD5_DIGEST_LENGTH];
         
         if (requestOptions.useTransactionalMD5)
         {
@@ -226,6 +226,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
@@ -258,6 +260,11 @@
 }
 
 -(void)uploadBlockFromData:(NSData *)sourceData blockID:(NSString *)blockID contentMD5:(NSString *)contentMD5 accessCondition:(AZSAccessCondition *)accessCondition requestOptions:(AZSBlobRequestOptions *)requestOptions operationContext:(AZSOperationContext *)operationContext completionHandler:(void (^)(NSError*))completionHandler
+{
+    [self uploadBlockFromData:sourceData blockID:blockID contentMD5:contentMD5 contentCRC64:nil accessCondition:accessCondition requestOptions:requestOptions operationContext:operationContext completionHandler:completionHandler];
+}
+
+-(void)uploadBlockFromData:(NSData *)sourceData blockID:(NSString *)blockID contentMD5:(NSString *)contentMD5 contentCRC64:(NSString *)contentCRC64 accessCondition:(AZSAccessCondition *)accessCondition requestOptions:(AZSBlobRequestOptions *)requestOptions operationContext:(AZSOperationContext *)operationContext completionHandler:(void (^)(NSError*))completionHandler
 {
     if (!operationContext)
     {
@@ -270,14 +277,21 @@
     {
         contentMD5 = [AZSUtil calculateMD5FromData:sourceData];
     }
+    
+    if (modifiedOptions.useTransactionalCRC64 && !(contentCRC64))
+    {
+        contentCRC64 = [AZSUtil calculateCRC64FromData:sourceData];
+    }
 
     [command setBuildRequest:^ NSMutableURLRequest * (NSURLComponents *urlComponents, NSTimeInterval timeout, AZSOperationContext *operationContext)
      {
-         return [AZSBlobRequestFactory putBlockWithLength:[sourceData length] blockID:blockID contentMD5:contentMD5 accessCondition:accessCondition urlComponents:urlComponents timeout:timeout operationContext:operationContext];
+         return [AZSBlobRequestFactory putBlockWithLength:[sourceData length] blockID:blockID contentMD5:contentMD5 contentCRC64:contentCRC64 accessCondition:accessCondition urlComponents:urlComponents timeout:timeout operationContext:operationContext];
      }];
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         return [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
     }];
@@ -334,6 +348,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
@@ -376,6 +392,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse * urlResponse, AZSRequestResult * requestResult, AZSOperationContext * operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
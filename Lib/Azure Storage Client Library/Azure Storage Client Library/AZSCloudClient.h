@@ -23,6 +23,13 @@ AZS_ASSUME_NONNULL_BEGIN
 @class AZSStorageUri;
 @class AZSStorageCredentials;
 @class AZSRequestOptions;
+@class AZSClientMetrics;
+@class AZSRequestGovernor;
+@class AZSRetryBudget;
+@class AZSCircuitBreaker;
+@class AZSHedgingPolicy;
+@class AZSStorageCommand;
+@protocol AZSHttpTransport;
 @protocol AZSAuthenticationHandler;
 
 /** AZSCloudClient is the base class for all service clients.
@@ -42,10 +49,40 @@ AZS_ASSUME_NONNULL_BEGIN
 /** The AZSStorageCredentials that this client will use to authenticate requests. */
 @property (strong, readonly, nonatomic) AZSStorageCredentials * credentials;
 
+/** The AZSClientMetrics that records every request made through this client, including requests made with
+ AZSCloudBlobContainer and AZSCloudBlob objects created from it.  nil (the default) disables collection.*/
+@property (strong, AZSNullable) AZSClientMetrics *metrics;
+
+/** The AZSHttpTransport that sends this client's requests.  nil (the default) uses AZSURLSessionTransport.*/
+@property (strong, AZSNullable) id<AZSHttpTransport> httpTransport;
+
+/** The AZSRequestGovernor that limits how many of this client's requests are in flight at once, across all operations.
+ nil (the default) leaves requests unlimited.  A governor may be shared between clients.*/
+@property (strong, AZSNullable) AZSRequestGovernor *requestGovernor;
+
+/** The AZSRetryBudget that caps how many of this client's failed requests are retried.  nil (the default) leaves
+ retries to each operation's retry policy alone.*/
+@property (strong, AZSNullable) AZSRetryBudget *retryBudget;
+
+/** The AZSCircuitBreaker that keeps this client's requests away from a failing location.  nil (the default) sends every
+ request to the location its location mode picks.*/
+@property (strong, AZSNullable) AZSCircuitBreaker *circuitBreaker;
+
+/** The AZSHedgingPolicy that sends slow reads to both locations of a read-access geo-redundant account.  nil (the
+ default) disables hedging.*/
+@property (strong, AZSNullable) AZSHedgingPolicy *hedgingPolicy;
+
 - (instancetype)initWithStorageUri:(AZSStorageUri *) storageUri credentials:(AZSStorageCredentials *) credentials AZS_DESIGNATED_INITIALIZER;
 
 -(void)setAuthenticationHandlerWithCredentials:(AZSStorageCredentials *)credentials;
 
+/** Hands the client-wide settings (metrics, transport, governor, retry budget, circuit breaker and hedging policy) to a
+ command about to be executed on behalf of this client.
+ 
+ @param command The command to configure.
+ */
+-(void)configureCommand:(AZSStorageCommand *)command;
+
 @end
 
 AZS_ASSUME_NONNULL_END
\ No newline at end of file
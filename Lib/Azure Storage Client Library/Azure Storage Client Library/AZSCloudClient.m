@@ -19,6 +19,7 @@
 #import "AZSStorageCredentials.h"
 #import "AZSSharedKeyBlobAuthenticationHandler.h"
 #import "AZSNoOpAuthenticationHandler.h"
+#import "AZSStorageCommand.h"
 
 @interface AZSCloudClient()
 {
@@ -65,6 +66,17 @@
     [self setAuthenticationHandlerWithCredentials:credentials];
 }
 
+-(void)configureCommand:(AZSStorageCommand *)command
+{
+    [command setMetrics:self.metrics];
+    
+    [command setTransport:self.httpTransport];
+    [command setGovernor:self.requestGovernor];
+    [command setRetryBudget:self.retryBudget];
+    [command setCircuitBreaker:self.circuitBreaker];
+    [command setHedgingPolicy:self.hedgingPolicy];
+}
+
 
 
 @end
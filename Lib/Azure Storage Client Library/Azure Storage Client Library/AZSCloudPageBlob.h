@@ -230,6 +230,25 @@ AZS_ASSUME_NONNULL_BEGIN
  */
 -(void)uploadPagesWithData:(NSData *)data startOffset:(NSNumber *)startOffset contentMD5:(AZSNullable NSString *)contentMD5 accessCondition:(AZSNullable AZSAccessCondition *)accessCondition requestOptions:(AZSNullable AZSBlobRequestOptions *)requestOptions operationContext:(AZSNullable AZSOperationContext *)operationContext completionHandler:(void (^)(NSError * __AZSNullable))completionHandler;
 
+/* Upload data to the page blob.
+ 
+ @param data The data to upload.  Size must be less than 4MB, and a multiple of 512 bytes.
+ @param startOffset The start offset at which to upload the data.  Must be a multiple of 512.
+ @param contentMD5 Optional.  The content-MD5 to use for transactional integrety for the upload pages request.
+ If contentMD5 is nil, and requestOptions.useTransactionalMD5 is set to YES, the library will calculate the MD5 of the block for you.
+ This value is not stored on the service.
+ @param contentCRC64 Optional.  The CRC64 to use for transactional integrity for the upload pages request, in the x-ms-content-crc64 header.
+ If contentCRC64 is nil, and requestOptions.useTransactionalCRC64 is set to YES, the library will calculate the CRC64 of the pages for you.
+ @param accessCondition The access condition for the request.
+ @param requestOptions The options to use for the request.
+ @param operationContext The operation context to use for the call.
+ @param completionHandler The block of code to execute when the upload pages call completes.
+ | Parameter name | Description |
+ |----------------|-------------|
+ |NSError * | Nil if the operation succeeded without error, error with details about the failure otherwise.|
+ */
+-(void)uploadPagesWithData:(NSData *)data startOffset:(NSNumber *)startOffset contentMD5:(AZSNullable NSString *)contentMD5 contentCRC64:(AZSNullable NSString *)contentCRC64 accessCondition:(AZSNullable AZSAccessCondition *)accessCondition requestOptions:(AZSNullable AZSBlobRequestOptions *)requestOptions operationContext:(AZSNullable AZSOperationContext *)operationContext completionHandler:(void (^)(NSError * __AZSNullable))completionHandler;
+
 /** Creates the page blob on the service.
  
  Unlike block blobs, page and append blobs must be explicitly created on the service before data can be written.
@@ -114,6 +114,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse *urlResponse, AZSRequestResult *requestResult, AZSOperationContext *operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
@@ -176,6 +178,11 @@
 }
 
 -(void)uploadPagesWithData:(NSData *)data startOffset:(NSNumber *)startOffset contentMD5:(NSString *)contentMD5 accessCondition:(AZSAccessCondition *)accessCondition requestOptions:(AZSBlobRequestOptions *)requestOptions operationContext:(AZSOperationContext *)operationContext completionHandler:(void (^)(NSError *))completionHandler
+{
+    [self uploadPagesWithData:data startOffset:startOffset contentMD5:contentMD5 contentCRC64:nil accessCondition:accessCondition requestOptions:requestOptions operationContext:operationContext completionHandler:completionHandler];
+}
+
+-(void)uploadPagesWithData:(NSData *)data startOffset:(NSNumber *)startOffset contentMD5:(NSString *)contentMD5 contentCRC64:(NSString *)contentCRC64 accessCondition:(AZSAccessCondition *)accessCondition requestOptions:(AZSBlobRequestOptions *)requestOptions operationContext:(AZSOperationContext *)operationContext completionHandler:(void (^)(NSError *))completionHandler
 {
     if (!operationContext)
     {
@@ -189,13 +196,20 @@
         contentMD5 = [AZSUtil calculateMD5FromData:data];
     }
     
+    if (modifiedOptions.useTransactionalCRC64 && !(contentCRC64))
+    {
+        contentCRC64 = [AZSUtil calculateCRC64FromData:data];
+    }
+    
     [command setBuildRequest:^ NSMutableURLRequest * (NSURLComponents *urlComponents, NSTimeInterval timeout, AZSOperationContext *operationContext)
     {
-        return [AZSBlobRequestFactory putPagesWithPageRange:(AZSULLMakeRange(startOffset.unsignedLongLongValue, data.length)) clear:NO contentMD5:contentMD5 accessCondition:accessCondition urlComponents:urlComponents timeout:timeout operationContext:operationContext];
+        return [AZSBlobRequestFactory putPagesWithPageRange:(AZSULLMakeRange(startOffset.unsignedLongLongValue, data.length)) clear:NO contentMD5:contentMD5 contentCRC64:contentCRC64 accessCondition:accessCondition urlComponents:urlComponents timeout:timeout operationContext:operationContext];
     }];
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse *urlResponse, AZSRequestResult *requestResult, AZSOperationContext *operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
@@ -243,11 +257,13 @@
     
     [command setBuildRequest:^ NSMutableURLRequest * (NSURLComponents *urlComponents, NSTimeInterval timeout, AZSOperationContext *operationContext)
     {
-        return [AZSBlobRequestFactory putPagesWithPageRange:range clear:YES contentMD5:nil accessCondition:accessCondition urlComponents:urlComponents timeout:timeout operationContext:operationContext];
+        return [AZSBlobRequestFactory putPagesWithPageRange:range clear:YES contentMD5:nil contentCRC64:nil accessCondition:accessCondition urlComponents:urlComponents timeout:timeout operationContext:operationContext];
     }];
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse *urlResponse, AZSRequestResult *requestResult, AZSOperationContext *operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
@@ -303,6 +319,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse *urlResponse, AZSRequestResult *requestResult, AZSOperationContext *operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
@@ -349,6 +367,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse *urlResponse, AZSRequestResult *requestResult, AZSOperationContext *operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
@@ -401,6 +421,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse *urlResponse, AZSRequestResult *requestResult, AZSOperationContext *operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
@@ -451,6 +473,8 @@
     
     [command setAuthenticationHandler:self.client.authenticationHandler];
     
+    [self.client configureCommand:command];
+    
     [command setPreProcessResponse:^id(NSHTTPURLResponse *urlResponse, AZSRequestResult *requestResult, AZSOperationContext *operationContext) {
         NSError *error = [AZSResponseParser preprocessResponseWithResponse:urlResponse requestResult:requestResult operationContext:operationContext];
         if (error)
@@ -26,6 +26,7 @@
 #import "AZSStorageCredentials.h"
 #import "AZSUriQueryBuilder.h"
 #import "AZSUtil.h"
+#import "AZSLogging.h"
 
 @interface AZSCloudStorageAccount()
 
@@ -54,7 +55,7 @@
         NSUInteger equalsIndex = [setting rangeOfString:@"="].location;
         if (equalsIndex > connectionString.length) {
             *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-            [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Invalid connection string."];
+            AZSLogError([AZSUtil operationlessContext], @"Invalid connection string.");
             return nil;
         }
         
@@ -189,7 +190,7 @@
     
     if (!storageCredentials.accountName) {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-        [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Storage credentials are missing an account name."];
+        AZSLogError([AZSUtil operationlessContext], @"Storage credentials are missing an account name.");
         return nil;
     }
     
@@ -214,7 +215,7 @@
 {
     if (![self.storageCredentials isSharedKey]) {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-        [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Cannot create SAS without account key."];
+        AZSLogError([AZSUtil operationlessContext], @"Cannot create SAS without account key.");
         return nil;
     }
     
@@ -0,0 +1,128 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSCommonCryptoProvider.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+
+#import <CommonCrypto/CommonDigest.h>
+#import <CommonCrypto/CommonHMAC.h>
+#import "AZSCommonCryptoProvider.h"
+
+@interface AZSCommonCryptoMD5Digest : NSObject <AZSDigest>
+{
+    CC_MD5_CTX _context;
+}
+
+@end
+
+@implementation AZSCommonCryptoMD5Digest
+
+-(instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        CC_MD5_Init(&_context);
+    }
+
+    return self;
+}
+
+-(NSUInteger)digestLength
+{
+    return CC_MD5_DIGEST_LENGTH;
+}
+
+-(void)updateWithBytes:(const void *)bytes length:(size_t)length
+{
+    // CC_MD5_Update takes a 32-bit length.
+    const uint8_t *position = bytes;
+    while (length > 0)
+    {
+        CC_LONG chunkLength = (CC_LONG) MIN(length, (size_t)UINT32_MAX);
+        CC_MD5_Update(&_context, position, chunkLength);
+        position += chunkLength;
+        length -= chunkLength;
+    }
+}
+
+-(void)finishWithDigest:(unsigned char *)digest
+{
+    CC_MD5_Final(digest, &_context);
+}
+
+@end
+
+@interface AZSCommonCryptoHmacSigner : NSObject <AZSHmacSigner>
+{
+    CCHmacContext _keyedContext;
+}
+
+-(instancetype)init AZS_DESIGNATED_INITIALIZER;
+-(instancetype)initWithKey:(NSData *)key AZS_DESIGNATED_INITIALIZER;
+
+@end
+
+@implementation AZSCommonCryptoHmacSigner
+
+-(instancetype)init
+{
+    return nil;
+}
+
+-(instancetype)initWithKey:(NSData *)key
+{
+    self = [super init];
+    if (self)
+    {
+        CCHmacInit(&_keyedContext, kCCHmacAlgSHA256, key.bytes, key.length);
+    }
+
+    return self;
+}
+
+-(void)signBytes:(const void *)bytes length:(size_t)length digest:(unsigned char *)digest
+{
+    // The context holds no pointers, so a copy of the keyed context can be finished independently on any thread.
+    CCHmacContext context = _keyedContext;
+    CCHmacUpdate(&context, bytes, length);
+    CCHmacFinal(&context, digest);
+}
+
+@end
+
+@implementation AZSCommonCryptoProvider
+
++(instancetype)sharedProvider
+{
+    static AZSCommonCryptoProvider *sharedProvider = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedProvider = [[AZSCommonCryptoProvider alloc] init];
+    });
+    return sharedProvider;
+}
+
+-(id<AZSDigest>)md5Digest
+{
+    return [[AZSCommonCryptoMD5Digest alloc] init];
+}
+
+-(id<AZSHmacSigner>)hmacSha256SignerWithKey:(NSData *)key
+{
+    return [[AZSCommonCryptoHmacSigner alloc] initWithKey:key];
+}
+
+@end
@@ -36,6 +36,7 @@ FOUNDATION_EXPORT NSString *const AZSCHttpStatusCode;
 FOUNDATION_EXPORT NSString *const AZSCPosix;
 FOUNDATION_EXPORT NSString *const AZSCRawErrorData;
 FOUNDATION_EXPORT NSString *const AZSCTargetStorageVersion;
+FOUNDATION_EXPORT NSString *const AZSCTargetStorageVersionCRC64;
 FOUNDATION_EXPORT NSString *const AZSCTrue;
 FOUNDATION_EXPORT NSString *const AZSCUtc;
 FOUNDATION_EXPORT NSString *const AZSCBlobAppendBlob;
@@ -95,6 +96,7 @@ FOUNDATION_EXPORT NSString *const AZSCHeaderCopySource;
 FOUNDATION_EXPORT NSString *const AZSCHeaderCopyProgress;
 FOUNDATION_EXPORT NSString *const AZSCHeaderCopyCompletionTime;
 FOUNDATION_EXPORT NSString *const AZSCHeaderCopyStatusDescription;
+FOUNDATION_EXPORT NSString *const AZSCHeaderContentCrc64;
 FOUNDATION_EXPORT NSString *const AZSCHeaderDate;
 FOUNDATION_EXPORT NSString *const AZSCHeaderDeleteSnapshots;
 FOUNDATION_EXPORT NSString *const AZSCHeaderIfSequenceNumberEQ;
@@ -111,7 +113,9 @@ FOUNDATION_EXPORT NSString *const AZSCHeaderPageWrite;
 FOUNDATION_EXPORT NSString *const AZSCHeaderProposedLeaseId;
 FOUNDATION_EXPORT NSString *const AZSCHeaderRange;
 FOUNDATION_EXPORT NSString *const AZSCHeaderRangeGetContent;
+FOUNDATION_EXPORT NSString *const AZSCHeaderRangeGetContentCrc64;
 FOUNDATION_EXPORT NSString *const AZSCHeaderRequestId;
+FOUNDATION_EXPORT NSString *const AZSCHeaderRetryAfter;
 FOUNDATION_EXPORT NSString *const AZSCHeaderSequenceNumberAction;
 FOUNDATION_EXPORT NSString *const AZSCHeaderSnapshot;
 FOUNDATION_EXPORT NSString *const AZSCHeaderSourceIfMatch;
@@ -36,6 +36,7 @@ NSString *const AZSCHttpStatusCode = @"HTTP Status Code";
 NSString *const AZSCPosix = @"en_US_POSIX";
 NSString *const AZSCRawErrorData = @"rawErrorData";
 NSString *const AZSCTargetStorageVersion = @"2015-04-05";
+NSString *const AZSCTargetStorageVersionCRC64 = @"2019-02-02";
 NSString *const AZSCTrue = @"true";
 NSString *const AZSCUtc = @"UTC";
 NSString *const AZSCBlobAppendBlob = @"AppendBlob";
@@ -95,6 +96,7 @@ NSString *const AZSCHeaderCopySource = @"x-ms-copy-source";
 NSString *const AZSCHeaderCopyProgress = @"x-ms-copy-progress";
 NSString *const AZSCHeaderCopyCompletionTime = @"x-ms-copy-completion-time";
 NSString *const AZSCHeaderCopyStatusDescription = @"x-ms-copy-status-description";
+NSString *const AZSCHeaderContentCrc64 = @"x-ms-content-crc64";
 NSString *const AZSCHeaderDate = @"x-ms-date";
 NSString *const AZSCHeaderDeleteSnapshots = @"x-ms-delete-snapshots";
 NSString *const AZSCHeaderIfSequenceNumberEQ = @"x-ms-if-sequence-number-eq";
@@ -111,7 +113,9 @@ NSString *const AZSCHeaderPageWrite = @"x-ms-page-write";
 NSString *const AZSCHeaderProposedLeaseId = @"x-ms-proposed-lease-id";
 NSString *const AZSCHeaderRange = @"x-ms-range";
 NSString *const AZSCHeaderRangeGetContent = @"x-ms-range-get-content-md5";
+NSString *const AZSCHeaderRangeGetContentCrc64 = @"x-ms-range-get-content-crc64";
 NSString *const AZSCHeaderRequestId = @"x-ms-request-id";
+NSString *const AZSCHeaderRetryAfter = @"Retry-After";
 NSString *const AZSCHeaderSequenceNumberAction = @"x-ms-sequence-number-action";
 NSString *const AZSCHeaderSnapshot = @"x-ms-snapshot";
 NSString *const AZSCHeaderUserAgent = @"User-Agent";
@@ -0,0 +1,102 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSCryptoProvider.h" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+
+#import <Foundation/Foundation.h>
+#import "AZSMacros.h"
+
+AZS_ASSUME_NONNULL_BEGIN
+
+/** An incremental hash computation, such as MD5.
+
+ A digest is used from one thread at a time, but successive calls may come from different threads.
+ */
+@protocol AZSDigest <NSObject>
+
+/** The length of the finished digest, in bytes.*/
+@property (readonly) NSUInteger digestLength;
+
+/** Adds bytes to the hash.
+
+ @param bytes The bytes to add.
+ @param length The number of bytes to add.
+ */
+-(void)updateWithBytes:(const void *)bytes length:(size_t)length;
+
+/** Finishes the hash.  The digest must not be used afterwards.
+
+ @param digest A buffer of at least digestLength bytes to receive the hash.
+ */
+-(void)finishWithDigest:(unsigned char *)digest;
+
+@end
+
+/** Computes HMAC-SHA256 signatures with a fixed key.
+
+ The library signs concurrent requests with the same signer, so signBytes:length:digest: must be safe to call from
+ several threads at once.
+ */
+@protocol AZSHmacSigner <NSObject>
+
+/** Computes the HMAC-SHA256 of the given bytes.
+
+ @param bytes The bytes to sign.
+ @param length The number of bytes to sign.
+ @param digest A buffer of at least 32 bytes to receive the signature.
+ */
+-(void)signBytes:(const void *)bytes length:(size_t)length digest:(unsigned char *)digest;
+
+@end
+
+/** AZSCryptoProvider supplies the MD5 and HMAC-SHA256 implementations the library uses for content MD5 calculation,
+ validation, and request signing.
+
+ The default provider, AZSCommonCryptoProvider, uses CommonCrypto.  An application that links a different crypto
+ library (for example, one with multi-buffer MD5) can supply its own provider with [AZSCrypto setProvider:].
+ */
+@protocol AZSCryptoProvider <NSObject>
+
+/** Creates a new MD5 digest.*/
+-(id<AZSDigest>)md5Digest;
+
+/** Creates a signer for the given key.  The key schedule should be computed here, once, rather than per signature.
+
+ @param key The HMAC key.
+ @returns The signer.
+ */
+-(id<AZSHmacSigner>)hmacSha256SignerWithKey:(NSData *)key;
+
+@end
+
+/** AZSCrypto holds the crypto provider used throughout the library.*/
+@interface AZSCrypto : NSObject
+
+/** The current provider.  This is an AZSCommonCryptoProvider unless another one has been set.*/
++(id<AZSCryptoProvider>)provider;
+
+/** Sets the provider the library uses.
+
+ Set the provider before creating credentials or starting operations; AZSStorageCredentials creates its signer when it
+ is initialized, and operations already running keep the digests they were given.
+
+ @param provider The provider to use, or nil to go back to AZSCommonCryptoProvider.
+ */
++(void)setProvider:(id<AZSCryptoProvider> __AZSNullable)provider;
+
+@end
+
+AZS_ASSUME_NONNULL_END
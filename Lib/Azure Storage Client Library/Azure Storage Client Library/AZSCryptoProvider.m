@@ -0,0 +1,42 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSCryptoProvider.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+
+#import "AZSCryptoProvider.h"
+#import "AZSCommonCryptoProvider.h"
+
+static id<AZSCryptoProvider> AZSCurrentCryptoProvider = nil;
+
+@implementation AZSCrypto
+
++(id<AZSCryptoProvider>)provider
+{
+    @synchronized(self)
+    {
+        return AZSCurrentCryptoProvider ?: [AZSCommonCryptoProvider sharedProvider];
+    }
+}
+
++(void)setProvider:(id<AZSCryptoProvider>)provider
+{
+    @synchronized(self)
+    {
+        AZSCurrentCryptoProvider = provider;
+    }
+}
+
+@end
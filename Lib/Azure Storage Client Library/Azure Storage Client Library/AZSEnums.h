@@ -441,6 +441,68 @@ typedef NS_OPTIONS(NSUInteger, AZSSharedAccessResourceTypes)
             AZSSharedAccessResourceTypesService | AZSSharedAccessResourceTypesContainer | AZSSharedAccessResourceTypesObject
 };
 
+/** The phases of a single HTTP request, as timed in an AZSRequestResult.*/
+typedef NS_ENUM(NSInteger, AZSRequestPhase)
+{
+    /** The DNS lookup.*/
+    AZSRequestPhaseDomainLookup,
+    
+    /** Establishing the TCP connection, not including the TLS handshake.*/
+    AZSRequestPhaseConnect,
+    
+    /** The TLS handshake.*/
+    AZSRequestPhaseSecureConnection,
+    
+    /** Sending the request headers and body.*/
+    AZSRequestPhaseRequestSend,
+    
+    /** Waiting for the service, from the end of the request to the first byte of the response.*/
+    AZSRequestPhaseTimeToFirstByte,
+    
+    /** Receiving the response, from its first byte to its last.*/
+    AZSRequestPhaseResponseTransfer,
+    
+    /** The whole request, from startTime to endTime.*/
+    AZSRequestPhaseTotal
+};
+
+/** The state of an AZSCircuitBreaker for one storage location.*/
+typedef NS_ENUM(NSInteger, AZSCircuitState)
+{
+    /** The location is healthy, and requests go to it as usual.*/
+    AZSCircuitStateClosed,
+    
+    /** The location has failed too often, and requests are kept away from it.*/
+    AZSCircuitStateOpen,
+    
+    /** The location has been open for a while, and a trial request is allowed through to see if it has recovered.*/
+    AZSCircuitStateHalfOpen
+};
+
+/** How AZSRetryPolicyJittered randomizes the wait before each retry.*/
+typedef NS_ENUM(NSInteger, AZSRetryJitterMode)
+{
+    /** Wait a uniformly random time between 0 and the exponential backoff for the retry count.*/
+    AZSRetryJitterModeFull,
+    
+    /** Wait a uniformly random time between the base delay and three times the previous wait.*/
+    AZSRetryJitterModeDecorrelated
+};
+
+/** The order in which requests waiting for an AZSRequestGovernor are admitted.  Waiting requests are admitted highest
+ priority first, and in arrival order within a priority.*/
+typedef NS_ENUM(NSInteger, AZSRequestPriority)
+{
+    /** Admitted only when no normal or high priority request is waiting, for background work such as bulk transfers.*/
+    AZSRequestPriorityLow,
+    
+    /** The default priority.*/
+    AZSRequestPriorityNormal,
+    
+    /** Admitted ahead of all other waiting requests, for latency-sensitive work.*/
+    AZSRequestPriorityHigh
+};
+
 /** Specifies the sequence number operator to use in a sequence number access condition.*/
 typedef NS_ENUM(NSInteger, AZSSequenceNumberOperator)
 {
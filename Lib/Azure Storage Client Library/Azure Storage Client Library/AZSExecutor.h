@@ -16,6 +16,7 @@
 // -----------------------------------------------------------------------------------------
 
 #import <Foundation/Foundation.h>
+#import "AZSHttpTransport.h"
 
 @class AZSStorageCommand;
 @class AZSRequestOptions;
@@ -24,6 +25,6 @@
 // This class is reserved for internal use.
 // The executor contains all the business logic of actually making/executing HTTP requests.
 // Funneling all requests through this one class allows us to implement retry policies, error handling, etc.
-@interface AZSExecutor : NSObject <NSURLSessionDelegate, NSURLSessionTaskDelegate, NSURLSessionDataDelegate>
+@interface AZSExecutor : NSObject <AZSHttpTransportDelegate>
 +(void)ExecuteWithStorageCommand:(AZSStorageCommand *)storageCommand requestOptions:(AZSRequestOptions *)requestOptions operationContext:(AZSOperationContext *)operationContext completionHandler:(void (^)(NSError*, id))completionHandler;
 @end
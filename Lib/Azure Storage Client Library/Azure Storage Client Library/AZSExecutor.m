@@ -16,6 +16,7 @@
 // -----------------------------------------------------------------------------------------
 
 #import <CommonCrypto/CommonDigest.h>
+#import "AZSClientMetrics.h"
 #import "AZSConstants.h"
 #import "AZSExecutor.h"
 #import "AZSOperationContext.h"
@@ -29,12 +30,19 @@
 #import "AZSRetryInfo.h"
 #import "AZSUtil.h"
 #import "AZSStorageCredentials.h"
+#import "AZSLogging.h"
+#import "AZSTracer.h"
+#import "AZSURLSessionTransport.h"
+#import "AZSCryptoProvider.h"
+#import "AZSRequestGovernor.h"
+#import "AZSRetryBudget.h"
+#import "AZSCircuitBreaker.h"
+#import "AZSHedgingPolicy.h"
+
+// The number of received chunks that may be waiting to be hashed before the receive thread waits for the hash queue.
+static const long AZSMaxChunksPendingDigest = 16;
 
 @interface AZSStreamDownloadBuffer : NSObject <NSStreamDelegate>
-{
-    @public
-    CC_MD5_CTX _md5Context;
-}
 
 @property (strong, readonly) NSOutputStream *stream;
 @property (strong, readonly) NSMutableArray *queue;
@@ -45,13 +53,23 @@
 @property uint64_t totalSizeStreamed;
 @property (strong, readonly) NSCondition *dataDownloadCondition;
 @property BOOL calculateMD5;
+@property BOOL calculateCRC64;
 @property (strong, readonly) AZSOperationContext *operationContext;
 @property (strong) NSError *streamError;
+@property (strong) AZSClientMetrics *metrics;
+@property (strong) id<AZSDigest> md5Digest;
+@property uint64_t crc64;
+@property (strong) dispatch_queue_t digestQueue;
+@property (strong) dispatch_semaphore_t digestPendingChunks;
+@property (weak) id<AZSHttpTransportTask> transportTask;
+@property BOOL receivingSuspended;
 
 -(instancetype)init AZS_DESIGNATED_INITIALIZER;
--(instancetype)initWithStream:(NSOutputStream *)stream maxSizeToBuffer:(NSUInteger)maxSizeToBuffer calculateMD5:(BOOL)calculateMD5 operationContext:(AZSOperationContext *)operationContext AZS_DESIGNATED_INITIALIZER;
+-(instancetype)initWithStream:(NSOutputStream *)stream maxSizeToBuffer:(NSUInteger)maxSizeToBuffer calculateMD5:(BOOL)calculateMD5 calculateCRC64:(BOOL)calculateCRC64 operationContext:(AZSOperationContext *)operationContext AZS_DESIGNATED_INITIALIZER;
 -(void)stream:(NSStream *)stream handleEvent:(NSStreamEvent)eventCode;
 -(void)writeData:(NSData *)data;
+-(NSString *)finishMD5;
+-(NSString *)finishCRC64;
 
 @end
 
@@ -62,7 +80,7 @@
     return nil;
 }
 
--(instancetype)initWithStream:(NSOutputStream *)stream maxSizeToBuffer:(NSUInteger)maxSizeToBuffer calculateMD5:(BOOL)calculateMD5 operationContext:(AZSOperationContext *)operationContext
+-(instancetype)initWithStream:(NSOutputStream *)stream maxSizeToBuffer:(NSUInteger)maxSizeToBuffer calculateMD5:(BOOL)calculateMD5 calculateCRC64:(BOOL)calculateCRC64 operationContext:(AZSOperationContext *)operationContext
 {
     self = [super init];
     if (self)
@@ -72,43 +90,77 @@
         _currentLength = 0;
         _streamWaiting = NO;
         _operationContext = operationContext;
-        [_operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Stream not waiting (init)"];
+        AZSLogDebug(_operationContext, @"Stream not waiting (init)");
         _maxSizeToBuffer = maxSizeToBuffer;
         _currentDataToStream = nil;
         _totalSizeStreamed = 0;
         _dataDownloadCondition = [[NSCondition alloc] init];
         _calculateMD5 = calculateMD5;
+        _calculateCRC64 = calculateCRC64;
         if (_calculateMD5)
         {
-            CC_MD5_Init(&_md5Context);
+            _md5Digest = [[AZSCrypto provider] md5Digest];
+        }
+        if (_calculateMD5 || _calculateCRC64)
+        {
+            _crc64 = 0;
+            _digestQueue = dispatch_queue_create("com.microsoft.azure.storage.downloaddigest", DISPATCH_QUEUE_SERIAL);
+            _digestPendingChunks = dispatch_semaphore_create(AZSMaxChunksPendingDigest);
         }
     }
     
     return self;
 }
 
+-(void)dealloc
+{
+    // Data still queued when a download fails is dropped with the buffer.
+    [_metrics addBufferedBytes:-(int64_t)_currentLength];
+}
+
 -(void)writeData:(NSData *)data
 {
-    if (self.calculateMD5)
+    if (self.calculateMD5 || self.calculateCRC64)
     {
-        CC_MD5_Update(&_md5Context, data.bytes, (unsigned int) data.length);
+        // Hash on a serial queue of its own rather than on the receive thread, so hashing does not limit how fast a
+        // single response can be read.  The semaphore bounds how much received data the queue can hold on to.
+        id<AZSDigest> md5Digest = self.md5Digest;
+        dispatch_semaphore_t digestPendingChunks = self.digestPendingChunks;
+        dispatch_semaphore_wait(digestPendingChunks, DISPATCH_TIME_FOREVER);
+        
+        // Unlike MD5, each chunk's CRC64 can be computed on its own, in parallel with the others, and only combined
+        // into the running value in order on the digest queue.
+        dispatch_group_t chunkCRC64Group = nil;
+        __block uint64_t chunkCRC64 = 0;
+        if (self.calculateCRC64)
+        {
+            chunkCRC64Group = dispatch_group_create();
+            dispatch_group_async(chunkCRC64Group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                chunkCRC64 = AZSCRC64Update(0, data.bytes, data.length);
+            });
+        }
+        
+        dispatch_async(self.digestQueue, ^{
+            [md5Digest updateWithBytes:data.bytes length:data.length];
+            if (chunkCRC64Group)
+            {
+                dispatch_group_wait(chunkCRC64Group, DISPATCH_TIME_FOREVER);
+                self.crc64 = AZSCRC64Combine(self.crc64, chunkCRC64, data.length);
+            }
+            dispatch_semaphore_signal(digestPendingChunks);
+        });
     }
     
-    [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"About to grab lock from data pushing"];
+    AZSLogDebug(self.operationContext, @"About to grab lock from data pushing");
     
     // TODO: Optimize to remove the need for the lock (or at least, for locking the whole thing.)
     // To do this, we need to ensure that all data is written to the stream in the correct order (even if some writes are sync),
     // and that the current length and total size are consistent.
     
+    // This never waits for the stream.  Once the buffer passes maxSizeToBuffer, the transport task is suspended instead,
+    // and the stream callback resumes it when the buffer has drained to half that.
     [self.dataDownloadCondition lock];
     
-    // TODO: self.streamWaiting should be set only if there is nothing in the buffer.  Make sure this is true, then simplify this condition.
-    while (!(self.streamWaiting || (self.currentLength <= self.maxSizeToBuffer)))
-    {
-        [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Waiting on datadownloadcondition in writeData."];
-        [self.dataDownloadCondition wait];
-    }
-    
     if (self.streamError)
     {
         // If there's an error, return.
@@ -119,23 +171,31 @@
     
     if (self.streamWaiting)
     {
-        [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"StreamWaiting = YES"];
+        AZSLogDebug(self.operationContext, @"StreamWaiting = YES");
     }
     else
     {
-        [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"StreamWaiting = NO"];
+        AZSLogDebug(self.operationContext, @"StreamWaiting = NO");
     }
     
     if (!self.streamWaiting)
     {
         [self.queue addObject:data];
         self.currentLength = self.currentLength + [data length];
-        [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Adding to queue.  Current length = %ld, total amount streamed = %ld", (unsigned long)self.currentLength, (unsigned long)self.totalSizeStreamed];
+        [self.metrics addBufferedBytes:[data length]];
+        AZSLogDebug(self.operationContext, @"Adding to queue.  Current length = %ld, total amount streamed = %ld", (unsigned long)self.currentLength, (unsigned long)self.totalSizeStreamed);
+        
+        if (!self.receivingSuspended && (self.currentLength > self.maxSizeToBuffer))
+        {
+            AZSLogDebug(self.operationContext, @"Buffer full, suspending the transport task.");
+            self.receivingSuspended = YES;
+            [self.transportTask suspend];
+        }
     }
     else
     {
         NSUInteger lengthWritten = [self.stream write:(const uint8_t *)[data bytes] maxLength:[data length]];
-        [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Wrote syncronously.  LengthWritten = %ld, desired write size = %ld.", (unsigned long)lengthWritten, (unsigned long)[data length]];
+        AZSLogDebug(self.operationContext, @"Wrote syncronously.  LengthWritten = %ld, desired write size = %ld.", (unsigned long)lengthWritten, (unsigned long)[data length]);
         
         if (lengthWritten == -1)
         {
@@ -143,7 +203,7 @@
             userInfo[AZSInnerErrorString] = self.stream.streamError;
             NSError *streamError = [NSError errorWithDomain:AZSErrorDomain code:AZSEOutputStreamError userInfo:userInfo];
             self.streamError = streamError;
-            [self.operationContext logAtLevel:AZSLogLevelError withMessage:@"Error in writing to download stream, aborting download."];
+            AZSLogError(self.operationContext, @"Error in writing to download stream, aborting download.");
         }
         else if (lengthWritten == 0)
         {
@@ -151,13 +211,13 @@
             userInfo[AZSInnerErrorString] = self.stream.streamError;
             NSError *streamError = [NSError errorWithDomain:AZSErrorDomain code:AZSEOutputStreamFull userInfo:userInfo];
             self.streamError = streamError;
-            [self.operationContext logAtLevel:AZSLogLevelError withMessage:@"DownloadStream is full but there is more pending data, aborting download."];
+            AZSLogError(self.operationContext, @"DownloadStream is full but there is more pending data, aborting download.");
         }
         else
         {
             self.totalSizeStreamed += lengthWritten;
             self.streamWaiting = NO;
-            [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Stream not waiting."];
+            AZSLogDebug(self.operationContext, @"Stream not waiting.");
             // TODO: Handle 0 and -1 case;
             if (lengthWritten < [data length])
             {
@@ -166,9 +226,10 @@
                 memcpy(buf, [data bytes] + lengthWritten, lengthRemaining);
                 [self.queue addObject:[NSData dataWithBytes:buf length:lengthRemaining]];
                 self.currentLength = self.currentLength + [data length];
+                [self.metrics addBufferedBytes:[data length]];
             }
             
-            [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Current length (wrote sync) = %ld, total amount streamed = %ld", (unsigned long)self.currentLength, (unsigned long)self.totalSizeStreamed];
+            AZSLogDebug(self.operationContext, @"Current length (wrote sync) = %ld, total amount streamed = %ld", (unsigned long)self.currentLength, (unsigned long)self.totalSizeStreamed);
         }
         // The following broadcast should never actually wake up anything, because the condition is only waited on in two cases:
         // - If the thread is done downloading and waiting for the buffer to clear (can't happen due to sync nature of didReceiveData and didCompleteWithError.)
@@ -180,6 +241,37 @@
 }
 
 
+// Must be called with dataDownloadCondition held.
+-(void)resumeReceivingIfDrained
+{
+    // After a stream error, the rest of the response is read and dropped so that the task completes.
+    if (self.receivingSuspended && (self.streamError || (self.currentLength <= self.maxSizeToBuffer / 2)))
+    {
+        AZSLogDebug(self.operationContext, @"Buffer drained, resuming the transport task.");
+        self.receivingSuspended = NO;
+        [self.transportTask resume];
+    }
+}
+
+-(NSString *)finishMD5
+{
+    unsigned char md5Bytes[CC_MD5_DIGEST_LENGTH];
+    unsigned char *md5Output = md5Bytes;
+    dispatch_sync(self.digestQueue, ^{
+        [self.md5Digest finishWithDigest:md5Output];
+    });
+    return [AZSUtil base64EncodedStringWithBytes:md5Bytes length:CC_MD5_DIGEST_LENGTH];
+}
+
+-(NSString *)finishCRC64
+{
+    __block uint64_t crc64 = 0;
+    dispatch_sync(self.digestQueue, ^{
+        crc64 = self.crc64;
+    });
+    return [AZSUtil base64StringFromCRC64:crc64];
+}
+
 -(void)stream:(NSStream *)stream handleEvent:(NSStreamEvent)eventCode
 {
     if (![AZSUtil streamAvailable:stream])
@@ -190,20 +282,21 @@
     switch(eventCode) {
         case NSStreamEventHasSpaceAvailable:
         {
-            [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"NSStreamEventHasSpaceAvailable"];
+            AZSLogDebug(self.operationContext, @"NSStreamEventHasSpaceAvailable");
             [self.dataDownloadCondition lock];
             if (self.streamError)
             {
                 // If there's already an error, return.
+                [self resumeReceivingIfDrained];
                 [self.dataDownloadCondition broadcast];
                 [self.dataDownloadCondition unlock];
                 return;
             }
             
-            [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Just grabbed lock from stream callback"];
-            [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Current thread name = %@",[NSThread currentThread]];
+            AZSLogDebug(self.operationContext, @"Just grabbed lock from stream callback");
+            AZSLogDebug(self.operationContext, @"Current thread name = %@",[NSThread currentThread]);
             
-            [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"HasSpaceAvailable"];
+            AZSLogDebug(self.operationContext, @"HasSpaceAvailable");
             if ((self.currentDataToStream != nil) || ([self.queue count] > 0))
             {
                 if (self.currentDataToStream == nil)
@@ -219,7 +312,7 @@
                     userInfo[AZSInnerErrorString] = self.stream.streamError;
                     NSError *streamError = [NSError errorWithDomain:AZSErrorDomain code:AZSEOutputStreamError userInfo:userInfo];
                     self.streamError = streamError;
-                    [self.operationContext logAtLevel:AZSLogLevelError withMessage:@"Error in writing to download stream, aborting download."];
+                    AZSLogError(self.operationContext, @"Error in writing to download stream, aborting download.");
                 }
                 else if (lengthWritten == 0)
                 {
@@ -227,14 +320,15 @@
                     userInfo[AZSInnerErrorString] = self.stream.streamError;
                     NSError *streamError = [NSError errorWithDomain:AZSErrorDomain code:AZSEOutputStreamFull userInfo:userInfo];
                     self.streamError = streamError;
-                    [self.operationContext logAtLevel:AZSLogLevelError withMessage:@"DownloadStream is full but there is more pending data, aborting download."];
+                    AZSLogError(self.operationContext, @"DownloadStream is full but there is more pending data, aborting download.");
                 }
                 else
                 {
                     self.currentLength = self.currentLength - lengthWritten;
+                    [self.metrics addBufferedBytes:-(int64_t)lengthWritten];
                     self.totalSizeStreamed += lengthWritten;
-                    [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Wrote async.  LengthWritten = %ld, desired write size = %ld.", (unsigned long)lengthWritten, (unsigned long)[self.currentDataToStream length]];
-                    [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Current length (wrote async) = %ld, total amount streamed = %ld", (unsigned long)self.currentLength, (unsigned long)self.totalSizeStreamed];
+                    AZSLogDebug(self.operationContext, @"Wrote async.  LengthWritten = %ld, desired write size = %ld.", (unsigned long)lengthWritten, (unsigned long)[self.currentDataToStream length]);
+                    AZSLogDebug(self.operationContext, @"Current length (wrote async) = %ld, total amount streamed = %ld", (unsigned long)self.currentLength, (unsigned long)self.totalSizeStreamed);
                     
                     if (lengthWritten < [self.currentDataToStream length])
                     {
@@ -252,9 +346,10 @@
             else
             {
                 self.streamWaiting = YES;
-                [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Stream waiting."];
+                AZSLogDebug(self.operationContext, @"Stream waiting.");
             }
-            [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"About to signal and release lock from stream callback"];
+            [self resumeReceivingIfDrained];
+            AZSLogDebug(self.operationContext, @"About to signal and release lock from stream callback");
             [self.dataDownloadCondition broadcast];
             [self.dataDownloadCondition unlock];
             
@@ -262,37 +357,41 @@
         }
         case NSStreamEventEndEncountered:
         {
-            [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"NSStreamEventEndEncountered"];
+            AZSLogDebug(self.operationContext, @"NSStreamEventEndEncountered");
             break;
         }
         case NSStreamEventErrorOccurred:
         {
-            [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"NSStreamEventErrorOccurred"];
+            AZSLogDebug(self.operationContext, @"NSStreamEventErrorOccurred");
             NSMutableDictionary *userInfo = [NSMutableDictionary dictionary];
             userInfo[AZSInnerErrorString] = self.stream.streamError;
             NSError *streamError = [NSError errorWithDomain:AZSErrorDomain code:AZSEOutputStreamError userInfo:userInfo];
+            [self.dataDownloadCondition lock];
             self.streamError = streamError;
-            [self.operationContext logAtLevel:AZSLogLevelError withMessage:@"Error in writing to download stream, aborting download."];
+            [self resumeReceivingIfDrained];
+            [self.dataDownloadCondition broadcast];
+            [self.dataDownloadCondition unlock];
+            AZSLogError(self.operationContext, @"Error in writing to download stream, aborting download.");
         }
         case NSStreamEventOpenCompleted:
         {
-            [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"NSStreamEventOpenCompleted"];
+            AZSLogDebug(self.operationContext, @"NSStreamEventOpenCompleted");
             break;
         }
         case NSStreamEventNone:
         {
-            [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"NSStreamEventNone"];
+            AZSLogDebug(self.operationContext, @"NSStreamEventNone");
             break;
         }
         case NSStreamEventHasBytesAvailable:
         {
-            [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"NSStreamEventHasBytesAvailable"];
+            AZSLogDebug(self.operationContext, @"NSStreamEventHasBytesAvailable");
             // Should never happen.
             break;
         }
         default:
         {
-            [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"NSStreamEventdefault"];
+            AZSLogDebug(self.operationContext, @"NSStreamEventdefault");
             NSLog(@"Default switch occurred.");
             break;
         }
@@ -320,6 +419,25 @@
 @property NSUInteger retryCount;
 @property AZSStorageLocation currentStorageLocation;
 @property AZSStorageLocationMode currentStorageLocationMode;
+@property (strong) NSURLSessionTaskMetrics *taskMetrics;
+@property int64_t countOfBytesSent;
+@property int64_t countOfBytesReceived;
+@property uint64_t traceRequestStart;
+@property (strong) id<AZSHttpTransportTask> transportTask;
+@property (copy) NSString *governedHost;
+@property (strong) id governorWaiter;
+@property BOOL hedgeEligible;
+@property BOOL responseStarted;
+@property (strong) id<AZSHttpTransportTask> hedgeTask;
+@property (strong) NSMutableURLRequest *hedgeRequest;
+@property (copy) NSString *hedgeGovernedHost;
+@property AZSStorageLocation hedgeLocation;
+@property NSUInteger attemptNumber;
+@property BOOL attemptTimedOut;
+@property NSTimeInterval lastProgressTime;
+@property (strong) id cancellationRegistration;
+@property (strong) dispatch_semaphore_t retryWaitSemaphore;
+@property (strong) NSRunLoop *retryWaitRunLoop;
 
 -(instancetype)init AZS_DESIGNATED_INITIALIZER;
 -(instancetype)initWithCommand:(AZSStorageCommand *)storageCommand requestOptions:(AZSRequestOptions *)requestOptions operationContext:(AZSOperationContext *) operationContext completionHandler:(void (^)(NSError *, id))completionHandler AZS_DESIGNATED_INITIALIZER;
@@ -405,109 +523,505 @@
         self.operationContext.startTime = [NSDate date];
     }
     
+    if (!self.cancellationRegistration)
+    {
+        __weak AZSExecutor *weakSelf = self;
+        self.cancellationRegistration = [self.operationContext addCancellationHandler:^{
+            [weakSelf cancelInFlightWork];
+        }];
+    }
+    
     // do-while (to allow for retries)
     {
+        if (self.operationContext.cancelled)
+        {
+            [self completeOperationWithError:[self cancellationError] retval:nil];
+            return;
+        }
+        
         // 0. Begin the request
         NSString *locationModeError = [self validateLocationMode];
         if (locationModeError)
         {
             NSError *storageError = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:@{NSLocalizedDescriptionKey:locationModeError}];
             
-            self.completionHandler(storageError, nil);
+            [self completeOperationWithError:storageError retval:nil];
             return;
         }
         
-        // 1. Build the request
-        // Build request by setting a start time, creating a uri(builder?), calling storageCommand.buildRequest(), and initializing a RequestResult.
-        AZSStorageUri *transformedUri = [self.storageCommand.credentials transformWithStorageUri:self.storageCommand.storageUri];
-        [self setStartTime:[NSDate date]];  //UTC
-        [self setUrlComponents:[NSURLComponents componentsWithURL: [transformedUri urlWithLocation:self.currentStorageLocation] resolvingAgainstBaseURL:NO]];
-        [self setRequest:self.storageCommand.buildRequest(self.urlComponents, self.requestOptions.serverTimeout, self.operationContext)];
-        [self setRequestResult:[[AZSRequestResult alloc] initWithStartTime:self.startTime location:self.currentStorageLocation]];
-        
-        
-        // Log that we're starting the request
-        
-        // 2. Set the headers on the request
-        // Request ID header
-        NSString *clientRequestId = self.operationContext.clientRequestId;
-        if ([clientRequestId length] != 0)
+        NSError *circuitError = [self applyCircuitBreaker];
+        if (circuitError)
         {
-            [self.request setValue:clientRequestId forHTTPHeaderField:AZSCHeaderClientRequestId];
+            [self completeOperationWithError:circuitError retval:nil];
+            return;
         }
         
-        // User headers from op context
-        // Set the request body on the request object
-        // Potentially set the destination stream
-        // Inform that we're ready to send by calling SendingRequest()
-        // Note: We may want to just set all headers here, or we could set some (like the user-agent string) in the NSURLSessionConfiguration.
-
-        // TODO: make this static, so that we're not querying the OS each time
-        NSString *operationSystemVersionString = [NSProcessInfo processInfo].operatingSystemVersionString;
-        [self.request setValue:[NSString stringWithFormat:AZSCHeaderValueUserAgent,operationSystemVersionString] forHTTPHeaderField:AZSCHeaderUserAgent];
+        // Wait for the client's governor, if any, to admit the request.  This comes before the request is built so that
+        // a long wait cannot leave the request with a stale date header.
+        AZSRequestGovernor *governor = self.storageCommand.governor;
+        if (governor)
+        {
+            NSString *host = [self.storageCommand.storageUri urlWithLocation:self.currentStorageLocation].host ?: @"";
+            uint64_t traceStart = AZSTraceTimestamp();
+            id waiter = [governor acquireSlotForHost:host priority:self.requestOptions.requestPriority handler:^{
+                @synchronized(self)
+                {
+                    self.governorWaiter = nil;
+                }
+                self.governedHost = host;
+                AZSTraceSpan("admission wait", traceStart, self.operationContext);
+                [self sendRequest];
+            }];
+            if (waiter)
+            {
+                @synchronized(self)
+                {
+                    self.governorWaiter = waiter;
+                }
+                
+                // A cancel that landed before the waiter was recorded could not take it out of the queue.
+                if (self.operationContext.cancelled)
+                {
+                    [self abandonGovernorWait];
+                }
+            }
+        }
+        else
+        {
+            [self sendRequest];
+        }
+    }
+}
+
+// Steers the request away from a location whose circuit is open, if the location mode allows.  Returns an error if
+// neither allowed location will take the request.
+-(NSError *)applyCircuitBreaker
+{
+    AZSCircuitBreaker *circuitBreaker = self.storageCommand.circuitBreaker;
+    if (!circuitBreaker || [circuitBreaker allowRequestToLocation:self.currentStorageLocation])
+    {
+        return nil;
+    }
+    
+    BOOL canSwitchLocation = (self.storageCommand.allowedStorageLocation == AZSAllowedStorageLocationPrimaryOrSecondary) && ((self.currentStorageLocationMode == AZSStorageLocationModePrimaryThenSecondary) || (self.currentStorageLocationMode == AZSStorageLocationModeSecondaryThenPrimary));
+    AZSStorageLocation otherLocation = (self.currentStorageLocation == AZSStorageLocationPrimary) ? AZSStorageLocationSecondary : AZSStorageLocationPrimary;
+    if (canSwitchLocation && [circuitBreaker allowRequestToLocation:otherLocation])
+    {
+        AZSLogInfo(self.operationContext, @"The circuit for location %ld is open; sending the request to location %ld instead.", (long)self.currentStorageLocation, (long)otherLocation);
+        self.currentStorageLocation = otherLocation;
+        return nil;
+    }
+    
+    return [NSError errorWithDomain:AZSErrorDomain code:AZSECircuitOpen userInfo:@{NSLocalizedDescriptionKey:@"The circuit breaker is open for every location this request may be sent to."}];
+}
+
+// Takes the request out of the governor's queue if it is still waiting there, and fails the operation with a
+// cancellation error.  A request that has already been admitted is left to notice the cancellation in sendRequest.
+-(void)abandonGovernorWait
+{
+    id waiter = nil;
+    @synchronized(self)
+    {
+        waiter = self.governorWaiter;
+        self.governorWaiter = nil;
+    }
+    if (waiter && [self.storageCommand.governor cancelWaiter:waiter])
+    {
+        [self completeOperationWithError:[self cancellationError] retval:nil];
+    }
+}
+
+-(void)sendRequest
+{
+    // The operation may have been cancelled while the request waited for the governor.
+    if (self.operationContext.cancelled)
+    {
+        [self releaseGovernorSlotWithResult:nil];
+        [self completeOperationWithError:[self cancellationError] retval:nil];
+        return;
+    }
+    
+    // 1. Build the request
+    // Build request by setting a start time, creating a uri(builder?), calling storageCommand.buildRequest(), and initializing a RequestResult.
+    AZSStorageUri *transformedUri = [self.storageCommand.credentials transformWithStorageUri:self.storageCommand.storageUri];
+    [self setStartTime:[NSDate date]];  //UTC
+    self.traceRequestStart = AZSTraceTimestamp();
+    [self setUrlComponents:[NSURLComponents componentsWithURL: [transformedUri urlWithLocation:self.currentStorageLocation] resolvingAgainstBaseURL:NO]];
+    [self setRequest:[self signedRequestWithUrlComponents:self.urlComponents]];
+    [self setRequestResult:[[AZSRequestResult alloc] initWithStartTime:self.startTime location:self.currentStorageLocation]];
+    self.httpResponse = nil;
+    self.taskMetrics = nil;
+    self.countOfBytesSent = 0;
+    self.countOfBytesReceived = 0;
+    self.responseStarted = NO;
+    self.hedgeEligible = NO;
+    self.attemptTimedOut = NO;
+    self.attemptNumber++;
+    
+    // 4. Configure http client
+    NSTimeInterval clientTimeout = [self remainingTime];
+    if (clientTimeout <= 0)
+    {
+        NSDictionary *userInfo = @{};
+        NSError *storageError = [NSError errorWithDomain:AZSErrorDomain code:AZSEClientTimeout userInfo:userInfo];
         
-        // Add the user headers, if they exist.
-        if (self.operationContext.userHeaders)
+        [self releaseGovernorSlotWithResult:nil];
+        [self completeOperationWithError:storageError retval:nil];
+        return;
+    }
+    
+    AZSLogInfo(self.operationContext, @"Sending Request with URL:%@", [self.request.URL absoluteString]);
+    if (AZSLogEnabled(self.operationContext, AZSLogLevelInfo))
+    {
+        NSDictionary *headers = [self.request allHTTPHeaderFields];
+        for (NSString *headerName in headers)
+        {
+            AZSLogInfo(self.operationContext, @"Sending header name = %@; value = %@", headerName, headers[headerName]);
+        }
+    }
+    
+    // 5. Initiate request, possibly uploading data
+    id<AZSHttpTransport> transport = self.storageCommand.transport ?: [AZSURLSessionTransport defaultTransport];
+    id<AZSHttpTransportTask> task = [transport taskWithRequest:self.request body:self.storageCommand.source timeout:clientTimeout delegate:self];
+    
+    // cancelInFlightWork reads the task under the lock, so a cancel either lands here and the task is never started,
+    // or lands afterwards and finds the task to cancel.
+    BOOL cancelled = NO;
+    @synchronized(self)
+    {
+        cancelled = self.operationContext.cancelled;
+        if (!cancelled)
         {
-           [self.operationContext.userHeaders enumerateKeysAndObjectsUsingBlock:^(id key, id obj, BOOL *stop) {
-               [self.request setValue:obj forHTTPHeaderField:key];
-           }];
+            self.transportTask = task;
+        }
+    }
+    if (cancelled)
+    {
+        [self releaseGovernorSlotWithResult:nil];
+        [self completeOperationWithError:[self cancellationError] retval:nil];
+        return;
+    }
+    
+    [self.storageCommand.metrics requestStarted];
+    if (self.retryCount == 0)
+    {
+        [self.storageCommand.retryBudget recordRequest];
+    }
+    AZSTraceSpan("build request", self.traceRequestStart, self.operationContext);
+    [self scheduleHedgeForTask:task];
+    if (self.requestOptions.responseTimeout > 0)
+    {
+        [self scheduleTimeoutCheckForAttempt:self.attemptNumber waitingForResponse:YES after:self.requestOptions.responseTimeout];
+    }
+    [task resume];
+}
+
+-(void)scheduleTimeoutCheckForAttempt:(NSUInteger)attemptNumber waitingForResponse:(BOOL)waitingForResponse after:(NSTimeInterval)delay
+{
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [self checkTimeoutForAttempt:attemptNumber waitingForResponse:waitingForResponse];
+    });
+}
+
+// Abandons the current attempt if it has gone past its response timeout, or past its idle timeout once the response
+// has started.  The cancelled request then completes with a timeout error, which the retry policy treats like any other
+// failed request.
+-(void)checkTimeoutForAttempt:(NSUInteger)attemptNumber waitingForResponse:(BOOL)waitingForResponse
+{
+    id<AZSHttpTransportTask> timedOutTask = nil;
+    NSTimeInterval remaining = 0;
+    @synchronized(self)
+    {
+        if ((attemptNumber != self.attemptNumber) || !self.transportTask || self.attemptTimedOut || (waitingForResponse && self.responseStarted))
+        {
+            return;
         }
         
-        // Inform the caller of the request being sent.
-        if (self.operationContext.sendingRequest)
+        NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+        if (waitingForResponse)
         {
-            self.operationContext.sendingRequest(self.request, self.operationContext);
+            remaining = self.startTime.timeIntervalSinceReferenceDate + self.requestOptions.responseTimeout - now;
+        }
+        else
+        {
+            // While the download buffer has the transport suspended, the request is waiting on the caller's stream,
+            // not on the service.
+            if (self.downloadBuffer.receivingSuspended)
+            {
+                self.lastProgressTime = now;
+            }
+            remaining = self.lastProgressTime + self.requestOptions.idleTimeout - now;
         }
         
-        // 3. Sign request
-        self.storageCommand.signRequest(self.request, self.operationContext);
+        if (remaining <= 0)
+        {
+            self.attemptTimedOut = YES;
+            timedOutTask = self.transportTask;
+            [self dropHedgeWithResult:nil];
+        }
+    }
+    
+    if (timedOutTask)
+    {
+        AZSLogInfo(self.operationContext, @"Abandoning the request to location %ld; it timed out %@.", (long)self.currentStorageLocation, waitingForResponse ? @"waiting for a response" : @"receiving the response");
+        [timedOutTask cancel];
+    }
+    else
+    {
+        [self scheduleTimeoutCheckForAttempt:attemptNumber waitingForResponse:waitingForResponse after:remaining];
+    }
+}
+
+// Builds the request for the given URL and sets its headers, then signs it.
+-(NSMutableURLRequest *)signedRequestWithUrlComponents:(NSURLComponents *)urlComponents
+{
+    // A request is never given longer than the operation has left.
+    NSTimeInterval serverTimeout = MIN(self.requestOptions.serverTimeout, MAX(ceil([self remainingTime]), 1));
+    NSMutableURLRequest *request = self.storageCommand.buildRequest(urlComponents, serverTimeout, self.operationContext);
+    
+    // 2. Set the headers on the request
+    // Request ID header
+    NSString *clientRequestId = self.operationContext.clientRequestId;
+    if ([clientRequestId length] != 0)
+    {
+        [request setValue:clientRequestId forHTTPHeaderField:AZSCHeaderClientRequestId];
+    }
+    
+    // User headers from op context
+    // Set the request body on the request object
+    // Potentially set the destination stream
+    // Inform that we're ready to send by calling SendingRequest()
+    // Note: We may want to just set all headers here, or we could set some (like the user-agent string) in the NSURLSessionConfiguration.
+
+    // TODO: make this static, so that we're not querying the OS each time
+    NSString *operationSystemVersionString = [NSProcessInfo processInfo].operatingSystemVersionString;
+    [request setValue:[NSString stringWithFormat:AZSCHeaderValueUserAgent,operationSystemVersionString] forHTTPHeaderField:AZSCHeaderUserAgent];
+    
+    // Add the user headers, if they exist.
+    if (self.operationContext.userHeaders)
+    {
+       [self.operationContext.userHeaders enumerateKeysAndObjectsUsingBlock:^(id key, id obj, BOOL *stop) {
+           [request setValue:obj forHTTPHeaderField:key];
+       }];
+    }
+    
+    // Inform the caller of the request being sent.
+    if (self.operationContext.sendingRequest)
+    {
+        self.operationContext.sendingRequest(request, self.operationContext);
+    }
+    
+    // 3. Sign request
+    self.storageCommand.signRequest(request, self.operationContext);
+    return request;
+}
+
+-(AZSStorageLocation)otherLocation
+{
+    return (self.currentStorageLocation == AZSStorageLocationPrimary) ? AZSStorageLocationSecondary : AZSStorageLocationPrimary;
+}
+
+// Arranges for a read that may be served by either location to be sent to the other location too, if the first has not
+// responded by the hedging policy's delay.
+-(void)scheduleHedgeForTask:(id<AZSHttpTransportTask>)task
+{
+    AZSHedgingPolicy *hedgingPolicy = self.storageCommand.hedgingPolicy;
+    if (!hedgingPolicy || self.storageCommand.source || (self.storageCommand.allowedStorageLocation != AZSAllowedStorageLocationPrimaryOrSecondary) || ((self.currentStorageLocationMode != AZSStorageLocationModePrimaryThenSecondary) && (self.currentStorageLocationMode != AZSStorageLocationModeSecondaryThenPrimary)))
+    {
+        return;
+    }
+    
+    // Only idempotent reads are hedged.
+    NSString *method = self.request.HTTPMethod ?: AZSCHttpGet;
+    if (![method isEqualToString:AZSCHttpGet] && ![method isEqualToString:AZSCHttpHead])
+    {
+        return;
+    }
+    
+    self.hedgeEligible = YES;
+    [hedgingPolicy recordEligibleRequest];
+    NSTimeInterval delay = hedgingPolicy.currentDelay;
+    if (delay <= 0)
+    {
+        return;
+    }
+    
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [self startHedgeForTask:task];
+    });
+}
+
+// Must be called with the lock held.  Whether a hedge for the given request would still be of use.
+-(BOOL)hedgeWantedForTask:(id<AZSHttpTransportTask>)task
+{
+    return (task == self.transportTask) && !self.responseStarted && !self.hedgeTask && !self.attemptTimedOut && !self.operationContext.cancelled;
+}
+
+-(void)startHedgeForTask:(id<AZSHttpTransportTask>)task
+{
+    AZSStorageLocation hedgeLocation;
+    NSURLComponents *urlComponents = nil;
+    NSString *governedHost = nil;
+    @synchronized(self)
+    {
+        if (![self hedgeWantedForTask:task])
+        {
+            return;
+        }
         
-        // 4. Configure http client
-        // Set timeout
-        // Set http buffer size
-        // Set chunksize
+        // A hedge is an extra request, so it is only sent where it will not add to an outage or to a queue.
+        hedgeLocation = [self otherLocation];
+        if (self.storageCommand.circuitBreaker && ([self.storageCommand.circuitBreaker stateForLocation:hedgeLocation] != AZSCircuitStateClosed))
+        {
+            return;
+        }
         
-        NSURLSessionConfiguration *sessionConfiguration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
-        sessionConfiguration.URLCache = nil;
-        sessionConfiguration.requestCachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+        if ([self remainingTime] <= 0)
+        {
+            return;
+        }
         
+        AZSStorageUri *transformedUri = [self.storageCommand.credentials transformWithStorageUri:self.storageCommand.storageUri];
+        urlComponents = [NSURLComponents componentsWithURL:[transformedUri urlWithLocation:hedgeLocation] resolvingAgainstBaseURL:NO];
+        if (self.storageCommand.governor)
+        {
+            NSString *host = urlComponents.host ?: @"";
+            if (![self.storageCommand.governor tryAcquireSlotForHost:host])
+            {
+                return;
+            }
+            governedHost = host;
+        }
+    }
+    
+    // Built outside the lock, as signing runs the caller's sendingRequest callback.
+    NSMutableURLRequest *hedgeRequest = [self signedRequestWithUrlComponents:urlComponents];
+    
+    id<AZSHttpTransportTask> hedgeTask = nil;
+    @synchronized(self)
+    {
+        // The race may have been decided while the hedge was built.
         NSTimeInterval clientTimeout = [self remainingTime];
-        if (clientTimeout <= 0)
+        if (![self hedgeWantedForTask:task] || (clientTimeout <= 0))
         {
-            NSDictionary *userInfo = @{};
-            NSError *storageError = [NSError errorWithDomain:AZSErrorDomain code:AZSEClientTimeout userInfo:userInfo];
-            
-            self.completionHandler(storageError, nil);
+            if (governedHost)
+            {
+                [self.storageCommand.governor releaseSlotForHost:governedHost result:nil];
+            }
             return;
         }
         
-        sessionConfiguration.timeoutIntervalForResource = clientTimeout;
-        
-        [self.operationContext logAtLevel:AZSLogLevelInfo withMessage:@"Sending Request with URL:%@", [self.request.URL absoluteString]];
-        for (NSString *headerName in [self.request allHTTPHeaderFields])
+        self.hedgeRequest = hedgeRequest;
+        self.hedgeLocation = hedgeLocation;
+        self.hedgeGovernedHost = governedHost;
+        id<AZSHttpTransport> transport = self.storageCommand.transport ?: [AZSURLSessionTransport defaultTransport];
+        self.hedgeTask = [transport taskWithRequest:self.hedgeRequest body:nil timeout:clientTimeout delegate:self];
+        hedgeTask = self.hedgeTask;
+        [self.storageCommand.hedgingPolicy recordHedge];
+    }
+    
+    AZSLogInfo(self.operationContext, @"No response yet; hedging the request to location %ld.", (long)hedgeLocation);
+    AZSTraceInstant("hedge", self.operationContext);
+    [hedgeTask resume];
+}
+
+// Must be called with the lock held.  Makes the hedge the request this executor is waiting on.  The request it replaces
+// has already been cancelled or has failed, and its governor slot is given back with the given result.
+-(void)promoteHedgeReleasingSlotWithResult:(AZSRequestResult *)result
+{
+    [self releaseGovernorSlotWithResult:result];
+    self.transportTask = self.hedgeTask;
+    self.request = self.hedgeRequest;
+    self.currentStorageLocation = self.hedgeLocation;
+    self.governedHost = self.hedgeGovernedHost;
+    self.hedgeTask = nil;
+    self.hedgeRequest = nil;
+    self.hedgeGovernedHost = nil;
+}
+
+// Must be called with the lock held.  Forgets the hedge, cancelling it if it is still running.
+-(void)dropHedgeWithResult:(AZSRequestResult *)result
+{
+    [self.hedgeTask cancel];
+    if (self.hedgeGovernedHost)
+    {
+        [self.storageCommand.governor releaseSlotForHost:self.hedgeGovernedHost result:result];
+    }
+    self.hedgeTask = nil;
+    self.hedgeRequest = nil;
+    self.hedgeGovernedHost = nil;
+}
+
+// Decides whether a response is the one this executor reads.  The first response from either the request or its hedge
+// wins, and the other is cancelled.
+-(BOOL)acceptResponseFromTask:(id<AZSHttpTransportTask>)task
+{
+    @synchronized(self)
+    {
+        if (self.responseStarted)
         {
-            [self.operationContext logAtLevel:AZSLogLevelInfo withMessage:@"Sending header name = %@; value = %@", headerName, [[self.request allHTTPHeaderFields] objectForKey:headerName]];
+            return NO;
         }
         
-        // TODO: Set this if necessary (if we use a session for more than one request at once).
-        // sessionConfiguration.HTTPMaximumConnectionsPerHost = ?
-        // Do we need to set min/max TLS protocol version?
-        
-        // 5. Initiate request, possibly uploading data
-        // TODO: Decide what to do about the delegate queue - should we have greater control over this?  Should we allow users to pass in a delegate queue?
-        // Passing in nil will allow the NSURLSession to create a default serial delegate queue.
-        NSURLSession *session = [NSURLSession sessionWithConfiguration:sessionConfiguration delegate:self delegateQueue:nil];
-        NSURLSessionDataTask *task;
-        if (self.storageCommand.source != nil)
+        if (self.hedgeTask && (task == self.hedgeTask))
         {
-            task = [session uploadTaskWithRequest:self.request fromData:self.storageCommand.source];
+            AZSLogInfo(self.operationContext, @"The hedge to location %ld responded first; cancelling the request to location %ld.", (long)self.hedgeLocation, (long)self.currentStorageLocation);
+            id<AZSHttpTransportTask> loser = self.transportTask;
+            [self promoteHedgeReleasingSlotWithResult:nil];
+            [loser cancel];
+            [self.storageCommand.hedgingPolicy recordHedgeWin];
+            
+            // The request that lost took at least this long.  Leaving it out would keep exactly the slow responses out
+            // of the percentile, and the delay would drift down.
+            [self.storageCommand.hedgingPolicy recordResponseLatency:[[NSDate date] timeIntervalSinceDate:self.startTime]];
+        }
+        else if (task == self.transportTask)
+        {
+            if (self.hedgeEligible)
+            {
+                [self.storageCommand.hedgingPolicy recordResponseLatency:[[NSDate date] timeIntervalSinceDate:self.startTime]];
+            }
+            [self dropHedgeWithResult:nil];
         }
         else
         {
-            task = [session dataTaskWithRequest:self.request];
+            return NO;
+        }
+        
+        self.responseStarted = YES;
+        return YES;
+    }
+}
+
+// Decides what to do with a request or hedge that finished.  Returns YES if the executor should process the completion
+// as the end of this attempt.
+-(BOOL)acceptCompletionFromTask:(id<AZSHttpTransportTask>)task error:(NSError *)error
+{
+    @synchronized(self)
+    {
+        if (task != self.transportTask)
+        {
+            if (self.hedgeTask && (task == self.hedgeTask))
+            {
+                // The hedge failed before it responded; the request it was racing carries on alone.
+                AZSRequestResult *hedgeResult = [[AZSRequestResult alloc] initWithStartTime:self.startTime location:self.hedgeLocation response:nil error:error];
+                [self.storageCommand.circuitBreaker recordResult:hedgeResult];
+                [self dropHedgeWithResult:hedgeResult];
+            }
+            return NO;
         }
-        [task resume];
+        
+        if (error && !self.responseStarted && self.hedgeTask)
+        {
+            // The request failed before it responded, but its hedge may still succeed.
+            AZSLogInfo(self.operationContext, @"The request to location %ld failed; waiting on the hedge to location %ld.", (long)self.currentStorageLocation, (long)self.hedgeLocation);
+            AZSRequestResult *failedResult = [[AZSRequestResult alloc] initWithStartTime:self.startTime location:self.currentStorageLocation response:nil error:error];
+            [self.storageCommand.circuitBreaker recordResult:failedResult];
+            [self promoteHedgeReleasingSlotWithResult:failedResult];
+            return NO;
+        }
+        
+        return YES;
     }
 }
 
@@ -538,30 +1052,41 @@
             @autoreleasepool {
                 NSDate *loopUntil = [NSDate dateWithTimeIntervalSinceNow:2.0];//[NSDate distantFuture];
                 [self.runLoopForDownload runMode:NSDefaultRunLoopMode beforeDate:loopUntil];
-                [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"(Waking up) Current thread name = %@",[NSThread currentThread]];
+                AZSLogDebug(self.operationContext, @"(Waking up) Current thread name = %@",[NSThread currentThread]);
                 if ([outputStream streamError])
                 {
                     NSError *error = [outputStream streamError];
-                    [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"StreamError.  Error code = %ld, error domain = %@, error userinfo = %@", (long)error.code, error.domain, error.userInfo];
+                    AZSLogDebug(self.operationContext, @"StreamError.  Error code = %ld, error domain = %@, error userinfo = %@", (long)error.code, error.domain, error.userInfo);
                 }
                 else
                 {
-                    [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"No stream error while in runloop."];
+                    AZSLogDebug(self.operationContext, @"No stream error while in runloop.");
                 }
             }
         }
-        [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Exiting spin."];
+        AZSLogDebug(self.operationContext, @"Exiting spin.");
     }
 }
 
--(void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveResponse:(NSURLResponse *)response completionHandler:(void (^)(NSURLSessionResponseDisposition))completionHandler
+-(void)transportTask:(id<AZSHttpTransportTask>)task didReceiveResponse:(NSHTTPURLResponse *)response
 {
-    self.httpResponse = (NSHTTPURLResponse *) response;
+    if (![self acceptResponseFromTask:task])
+    {
+        return;
+    }
+    
+    uint64_t traceStart = AZSTraceTimestamp();
+    self.lastProgressTime = [NSDate timeIntervalSinceReferenceDate];
+    self.httpResponse = response;
 
-    [self.operationContext logAtLevel:AZSLogLevelInfo withMessage:@"Response HTTP status code = %ld", (long)self.httpResponse.statusCode];
-    for (id headerkey in self.httpResponse.allHeaderFields)
+    AZSLogInfo(self.operationContext, @"Response HTTP status code = %ld", (long)self.httpResponse.statusCode);
+    if (AZSLogEnabled(self.operationContext, AZSLogLevelInfo))
     {
-        [self.operationContext logAtLevel:AZSLogLevelInfo withMessage:@"Response header name = %@; value = %@",headerkey, self.httpResponse.allHeaderFields[headerkey]];
+        NSDictionary *headers = self.httpResponse.allHeaderFields;
+        for (id headerkey in headers)
+        {
+            AZSLogInfo(self.operationContext, @"Response header name = %@; value = %@",headerkey, headers[headerkey]);
+        }
     }
 
     if (self.operationContext.responseReceived)
@@ -589,7 +1114,9 @@
         }
     }
     
-    self.downloadBuffer = [[AZSStreamDownloadBuffer alloc]initWithStream:self.outputStream maxSizeToBuffer:self.requestOptions.maximumDownloadBufferSize calculateMD5:(self.storageCommand.calculateResponseMD5 && (self.requestResult.contentReceivedMD5 != nil)) operationContext:self.operationContext];
+    self.downloadBuffer = [[AZSStreamDownloadBuffer alloc]initWithStream:self.outputStream maxSizeToBuffer:self.requestOptions.maximumDownloadBufferSize calculateMD5:(self.storageCommand.calculateResponseMD5 && (self.requestResult.contentReceivedMD5 != nil)) calculateCRC64:self.storageCommand.calculateResponseCRC64 operationContext:self.operationContext];
+    self.downloadBuffer.metrics = self.storageCommand.metrics;
+    self.downloadBuffer.transportTask = task;
     
     [self.outputStream setDelegate:self.downloadBuffer];
     
@@ -609,41 +1136,68 @@
         [self.outputStream open];
     }
     
+    if (self.requestOptions.idleTimeout > 0)
+    {
+        [self scheduleTimeoutCheckForAttempt:self.attemptNumber waitingForResponse:NO after:self.requestOptions.idleTimeout];
+    }
     
-
-    completionHandler(NSURLSessionResponseAllow);
+    AZSTraceSpan("response", traceStart, self.operationContext);
 }
 
--(void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data
+-(void)transportTask:(id<AZSHttpTransportTask>)task didReceiveData:(NSData *)data
 {
-    // Note that the following call will block if the buffer is full.  This is by design.
+    if (task != self.transportTask)
+    {
+        return;
+    }
+    
+    uint64_t traceStart = AZSTraceTimestamp();
+    self.lastProgressTime = [NSDate timeIntervalSinceReferenceDate];
     if (!self.downloadBuffer.streamError)
     {
         [self.downloadBuffer writeData:data];
     }
+    AZSTraceSpan("data", traceStart, self.operationContext);
 }
 
--(void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error
+-(void)transportTask:(id<AZSHttpTransportTask>)task didCompleteWithError:(NSError *)error
 {
     // This is called upon task completion.  If there were no error, *error will be nil.
+    if (![self acceptCompletionFromTask:task error:error])
+    {
+        return;
+    }
+    
+    if (error && self.attemptTimedOut)
+    {
+        error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:@{NSLocalizedDescriptionKey:@"The request timed out."}];
+    }
+    
+    self.countOfBytesSent = task.countOfBytesSent;
+    self.countOfBytesReceived = task.countOfBytesReceived;
+    AZSTraceInstant("complete", self.operationContext);
 
     if (self.downloadBuffer.calculateMD5)
     {
-        unsigned char md5Bytes[CC_MD5_DIGEST_LENGTH];
-        CC_MD5_Final(md5Bytes, &(self.downloadBuffer->_md5Context));
-        self.requestResult.calculatedResponseMD5 = [[[NSData alloc] initWithBytes:md5Bytes length:CC_MD5_DIGEST_LENGTH] base64EncodedStringWithOptions:0];
+        self.requestResult.calculatedResponseMD5 = [self.downloadBuffer finishMD5];
+    }
+    if (self.downloadBuffer.calculateCRC64)
+    {
+        self.requestResult.calculatedResponseCRC64 = [self.downloadBuffer finishCRC64];
     }
     
+    uint64_t traceDrainStart = AZSTraceTimestamp();
     [self.downloadBuffer.dataDownloadCondition lock];
-    [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Grabbed lock in didComplete."];
+    AZSLogDebug(self.operationContext, @"Grabbed lock in didComplete.");
     
     while ((self.downloadBuffer.currentLength > 0) && !self.downloadBuffer.streamError)
     {
-        [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Waiting on condition in didComplete.  CurrentLength = %ld.", (unsigned long)self.downloadBuffer.currentLength];
+        AZSLogDebug(self.operationContext, @"Waiting on condition in didComplete.  CurrentLength = %ld.", (unsigned long)self.downloadBuffer.currentLength);
         [self.downloadBuffer.dataDownloadCondition wait];
     }
     [self.downloadBuffer.dataDownloadCondition unlock];
-    [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Released lock in didComplete."];
+    AZSLogDebug(self.operationContext, @"Released lock in didComplete.");
+    AZSTraceSpan("drain download buffer", traceDrainStart, self.operationContext);
     
     [self.outputStream close];
     [self.outputStream removeFromRunLoop:self.runLoopForDownload forMode:NSDefaultRunLoopMode];
@@ -654,25 +1208,27 @@
         NSMutableDictionary *userInfo = [NSMutableDictionary dictionary];
         userInfo[AZSInnerErrorString] = error;
         NSError *clientError = [NSError errorWithDomain:AZSErrorDomain code:AZSEURLSessionClientError userInfo:userInfo];
-        [self finishRequestWithSession:session error:clientError retval:nil];
+        [self finishRequestWithError:clientError retval:nil];
     }
     else if (self.downloadBuffer.streamError) // If there was an error in streaming
     {
-        [self finishRequestWithSession:session error:self.downloadBuffer.streamError retval:nil];
+        [self finishRequestWithError:self.downloadBuffer.streamError retval:nil];
     }
     else if (self.preProcessError) // If there was a server error, we can parse the XML from the service.
     {
         NSError *serverError = self.preProcessError;
         NSError *parsingError;
+        uint64_t traceStart = AZSTraceTimestamp();
         self.storageCommand.processError(self.outputStream, &serverError, &parsingError);
+        AZSTraceSpan("parse error", traceStart, self.operationContext);
         self.preProcessError = serverError;
         if (parsingError)
         {
-            [self finishRequestWithSession:session error:parsingError retval:nil];
+            [self finishRequestWithError:parsingError retval:nil];
         }
         else
         {
-            [self finishRequestWithSession:session error:self.preProcessError retval:nil];
+            [self finishRequestWithError:self.preProcessError retval:nil];
         }
     }
     else if (!self.httpResponse)
@@ -682,7 +1238,7 @@
         // TODO: Make this error retryable, and have more information with it.
         NSMutableDictionary *userInfo = [NSMutableDictionary dictionary];
         self.preProcessError = [NSError errorWithDomain:AZSErrorDomain code:AZSEServerError userInfo:userInfo];
-        [self finishRequestWithSession:session error:self.preProcessError retval:nil];
+        [self finishRequestWithError:self.preProcessError retval:nil];
     }
     else // No errors
     {
@@ -690,22 +1246,22 @@
         NSError *error = nil;
         if (self.storageCommand.postProcessResponse)
         {
+            uint64_t traceStart = AZSTraceTimestamp();
             retval = self.storageCommand.postProcessResponse(self.httpResponse, self.requestResult, self.outputStream, self.operationContext, &error);
+            AZSTraceSpan("parse response", traceStart, self.operationContext);
         }
         
-        [self finishRequestWithSession:session error:error retval:retval];
+        [self finishRequestWithError:error retval:retval];
     }
 }
 
--(void)URLSession:(NSURLSession *)session didBecomeInvalidWithError:(NSError *)error
+-(void)transportTask:(id<AZSHttpTransportTask>)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics
 {
-    // This is called if/when the session becomes invalid for some reason on the client.
-    // This is not called for server errors.
-    if (error)
+    // This is called just before didCompleteWithError by the NSURLSession transport.  The metrics are applied to
+    // the request result once it is created in finishRequestWithError.
+    if (task == self.transportTask)
     {
-        NSDictionary *userInfo = @{AZSInnerErrorString: error};
-        NSError *storageError = [NSError errorWithDomain:AZSErrorDomain code:AZSEURLSessionClientError userInfo:userInfo];
-        [self finishRequestWithSession:session error:storageError retval:nil];
+        self.taskMetrics = metrics;
     }
 }
 
@@ -732,20 +1288,102 @@
     }
 }
 
--(void)finishRequestWithSession:(NSURLSession *)session error:(NSError *)error retval:(id)retval
+static NSTimeInterval AZSIntervalBetween(NSDate *start, NSDate *end)
 {
-    // Required to release memory related to the session, etc:
-    [self.operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Finishing session."];
-    [session finishTasksAndInvalidate];
+    return (start && end) ? [end timeIntervalSinceDate:start] : 0;
+}
+
+-(void)applyNetworkMetricsToRequestResult:(AZSRequestResult *)requestResult
+{
+    requestResult.bytesSent = self.countOfBytesSent;
+    requestResult.bytesReceived = self.countOfBytesReceived;
+
+    // Redirects produce one transaction per hop; the last one is the request whose response we processed.
+    NSURLSessionTaskTransactionMetrics *transaction = self.taskMetrics.transactionMetrics.lastObject;
+    if (!transaction)
+    {
+        return;
+    }
+
+    requestResult.networkMetricsAvailable = YES;
+    requestResult.reusedConnection = transaction.reusedConnection;
+    requestResult.domainLookupDuration = AZSIntervalBetween(transaction.domainLookupStartDate, transaction.domainLookupEndDate);
+    requestResult.connectDuration = AZSIntervalBetween(transaction.connectStartDate, transaction.secureConnectionStartDate ?: transaction.connectEndDate);
+    requestResult.secureConnectionDuration = AZSIntervalBetween(transaction.secureConnectionStartDate, transaction.secureConnectionEndDate);
+    requestResult.requestSendDuration = AZSIntervalBetween(transaction.requestStartDate, transaction.requestEndDate);
+    requestResult.timeToFirstByte = AZSIntervalBetween(transaction.requestEndDate, transaction.responseStartDate);
+    requestResult.responseTransferDuration = AZSIntervalBetween(transaction.responseStartDate, transaction.responseEndDate);
+}
+
+// Names the operation for AZSClientMetrics by its method and the query parameters that select the REST API.
+-(NSString *)metricsOperationName
+{
+    NSString *restype = nil;
+    NSString *comp = nil;
+    for (NSURLQueryItem *queryItem in self.urlComponents.queryItems)
+    {
+        if ([queryItem.name isEqualToString:AZSCQueryRestype])
+        {
+            restype = queryItem.value;
+        }
+        else if ([queryItem.name isEqualToString:AZSCQueryComp])
+        {
+            comp = queryItem.value;
+        }
+    }
+
+    NSMutableString *operationName = [NSMutableString stringWithString:self.request.HTTPMethod ?: AZSCHttpGet];
+    if (restype)
+    {
+        [operationName appendFormat:@" %@=%@", AZSCQueryRestype, restype];
+    }
+    if (comp)
+    {
+        [operationName appendFormat:@"%@%@=%@", restype ? @"&" : @" ", AZSCQueryComp, comp];
+    }
+    return operationName;
+}
+
+-(void)releaseGovernorSlotWithResult:(AZSRequestResult *)result
+{
+    if (self.governedHost)
+    {
+        [self.storageCommand.governor releaseSlotForHost:self.governedHost result:result];
+        self.governedHost = nil;
+    }
+}
+
+-(void)finishRequestWithError:(NSError *)error retval:(id)retval
+{
+    AZSLogDebug(self.operationContext, @"Finishing request.");
+    self.transportTask = nil;
+    
+    // A request that failed because the operation was cancelled says nothing about the service.
+    BOOL cancelled = error && self.operationContext.cancelled;
+    if (cancelled)
+    {
+        error = [self cancellationError];
+    }
     
     self.requestResult = [[AZSRequestResult alloc] initWithStartTime:self.startTime location:self.currentStorageLocation response:self.httpResponse error:error];
+    [self applyNetworkMetricsToRequestResult:self.requestResult];
+    [self releaseGovernorSlotWithResult:cancelled ? nil : self.requestResult];
+    if (!cancelled)
+    {
+        [self.storageCommand.circuitBreaker recordResult:self.requestResult];
+    }
     [self.operationContext addRequestResult:self.requestResult];
+    AZSTraceSpan("request", self.traceRequestStart, self.operationContext);
+    if (self.storageCommand.metrics)
+    {
+        [self.storageCommand.metrics requestFinishedWithOperation:[self metricsOperationName] statusCode:self.httpResponse.statusCode location:self.currentStorageLocation duration:[self.requestResult.endTime timeIntervalSinceDate:self.startTime] bytesSent:self.countOfBytesSent bytesReceived:self.countOfBytesReceived];
+    }
     self.retryCount++;
     
     BOOL retry = YES;
     
-    // Don't retry if there wasn't an error.
-    if (retry && !error)
+    // Don't retry if there wasn't an error, or if the operation was cancelled.
+    if (retry && (!error || cancelled))
     {
         retry = NO;
     }
@@ -768,26 +1406,40 @@
         }
     }
     
+    // The client's retry budget has the last word, so that retries cannot add to the load on a failing service.
+    if (retry && self.storageCommand.retryBudget && ![self.storageCommand.retryBudget tryAcquireRetry])
+    {
+        AZSLogInfo(self.operationContext, @"Not retrying on HTTP status code %ld; the client's retry budget is spent.", (long)self.requestResult.response.statusCode);
+        retry = NO;
+    }
+    
     if (retry)
     {
-        [self.operationContext logAtLevel:AZSLogLevelInfo withMessage:[NSString stringWithFormat:@"Retrying on HTTP status code %ld.", (long)self.requestResult.response.statusCode]];
+        AZSLogInfo(self.operationContext, @"Retrying on HTTP status code %ld.", (long)self.requestResult.response.statusCode);
+        [self.storageCommand.metrics recordRetry];
         
         self.currentStorageLocation = retryInfo.targetLocation;
         self.currentStorageLocationMode = retryInfo.updatedLocationMode;
         NSDate *retryTime = [NSDate dateWithTimeIntervalSinceNow:retryInfo.retryInterval];
+        uint64_t traceStart = AZSTraceTimestamp();
         
+        // Cancelling the operation stops the run loop or signals the semaphore, whichever this is waiting on.
+        self.retryWaitRunLoop = [NSRunLoop currentRunLoop];
         NSDate *loopUntil = [NSDate dateWithTimeIntervalSinceNow:0.1];
-        while ([[NSDate date] compare:retryTime] == NSOrderedAscending)
+        while (([[NSDate date] compare:retryTime] == NSOrderedAscending) && !self.operationContext.cancelled)
         {
-            BOOL runloopSuccess = [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:loopUntil];
+            BOOL runloopSuccess = [self.retryWaitRunLoop runMode:NSDefaultRunLoopMode beforeDate:loopUntil];
             
             if (!runloopSuccess)
             {
-                [NSThread sleepForTimeInterval:MIN(1.0, [retryTime timeIntervalSinceDate:[NSDate date]])];
+                NSTimeInterval wait = MIN(1.0, [retryTime timeIntervalSinceDate:[NSDate date]]);
+                dispatch_semaphore_wait(self.retryWaitSemaphore, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(MAX(wait, 0) * NSEC_PER_SEC)));
             }
             
             loopUntil = [NSDate dateWithTimeIntervalSinceNow:0.1];
         }
+        self.retryWaitRunLoop = nil;
+        AZSTraceSpan("retry wait", traceStart, self.operationContext);
         
         [self execute];
         
@@ -796,8 +1448,56 @@
     else
     {
         self.operationContext.endTime = [NSDate date];
-        self.completionHandler(error, retval);
+        [self completeOperationWithError:error retval:retval];
+    }
+}
+
+-(void)completeOperationWithError:(NSError *)error retval:(id)retval
+{
+    if (self.cancellationRegistration)
+    {
+        [self.operationContext removeCancellationHandler:self.cancellationRegistration];
+        self.cancellationRegistration = nil;
+    }
+    self.completionHandler(error, retval);
+}
+
+-(NSError *)cancellationError
+{
+    return [NSError errorWithDomain:AZSErrorDomain code:AZSEOperationCancelled userInfo:@{NSLocalizedDescriptionKey:@"The operation was cancelled."}];
+}
+
+// Called when the operation is cancelled, on the thread that cancelled it.  Everything the executor may be waiting on
+// is woken up, and the request, if any, then fails with a cancellation error that is not retried.
+-(void)cancelInFlightWork
+{
+    id<AZSHttpTransportTask> task = nil;
+    @synchronized(self)
+    {
+        task = self.transportTask;
+        [self dropHedgeWithResult:nil];
+    }
+    [task cancel];
+    
+    // The request may not have been admitted by the governor yet.
+    [self abandonGovernorWait];
+    
+    // The completion callback may be waiting for the caller's stream to take the rest of the download.
+    AZSStreamDownloadBuffer *downloadBuffer = self.downloadBuffer;
+    [downloadBuffer.dataDownloadCondition lock];
+    if (!downloadBuffer.streamError)
+    {
+        downloadBuffer.streamError = [self cancellationError];
+    }
+    [downloadBuffer.dataDownloadCondition broadcast];
+    [downloadBuffer.dataDownloadCondition unlock];
+    
+    NSRunLoop *retryWaitRunLoop = self.retryWaitRunLoop;
+    if (retryWaitRunLoop)
+    {
+        CFRunLoopStop([retryWaitRunLoop getCFRunLoop]);
     }
+    dispatch_semaphore_signal(self.retryWaitSemaphore);
 }
 
 -(instancetype)init
@@ -835,6 +1535,7 @@
         _retryPolicy = [operationContext.retryPolicy clone];
         _currentStorageLocation = [AZSExecutor getFirstLocationWithStorageLocationMode:requestOptions.storageLocationMode];
         _currentStorageLocationMode = requestOptions.storageLocationMode;
+        _retryWaitSemaphore = dispatch_semaphore_create(0);
     }
     
     return self;
@@ -0,0 +1,100 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSHedgingPolicy.h" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+
+#import <Foundation/Foundation.h>
+#import "AZSMacros.h"
+
+AZS_ASSUME_NONNULL_BEGIN
+
+/** An AZSHedgingPolicy sends a second copy of a slow read to the other location of a read-access geo-redundant account,
+ and uses whichever response arrives first.
+
+ One slow response from the primary can dominate a client's tail latency.  With a hedging policy assigned to the
+ hedgingPolicy property of an AZSCloudBlobClient, a read (a GET or HEAD, such as downloadToStream, downloadAttributes or
+ a listing) that may be served by either location, and whose location mode is
+ AZSStorageLocationModePrimaryThenSecondary or AZSStorageLocationModeSecondaryThenPrimary, is hedged: if no response
+ headers have arrived from its first location within the hedge delay, the same request is sent to the other location.
+ The first response to arrive wins, and the other request is cancelled.
+
+ The hedge delay is the given percentile (95th by default) of recent response times from the first location, so about
+ that fraction of reads finish without a hedge.  Hedging starts once minimumSamples responses have been seen, unless
+ fixedDelay is set.  A hedge is not sent if the client's circuit breaker has the other location open, or if the
+ client's request governor has no slot free for it.
+
+ Secondary reads may return data that is slightly behind the primary, so hedge only reads that can tolerate that.  The
+ statistics are safe to read from any thread.
+ */
+@interface AZSHedgingPolicy : NSObject
+
+/** The percentile of response times after which a read is hedged, from 0 to 100.  Defaults to 95.*/
+@property double percentile;
+
+/** The shortest hedge delay, in seconds, so that very fast responses do not lead to hedging on every small delay.
+ Defaults to 0.01.*/
+@property NSTimeInterval minimumDelay;
+
+/** A hedge delay to use instead of the tracked percentile, in seconds.  Defaults to 0, which uses the percentile.*/
+@property NSTimeInterval fixedDelay;
+
+/** The number of response times needed before the percentile is trusted.  Defaults to 20.*/
+@property NSUInteger minimumSamples;
+
+/** The current hedge delay, in seconds, or 0 if there are not yet enough samples to hedge.*/
+@property (readonly) NSTimeInterval currentDelay;
+
+/** The number of reads that could have been hedged.*/
+@property (readonly) uint64_t eligibleRequests;
+
+/** The number of reads that were hedged.*/
+@property (readonly) uint64_t hedgedRequests;
+
+/** The number of hedged reads that were won by the hedge; that is, served by the other location.*/
+@property (readonly) uint64_t hedgeWins;
+
+/** The fraction of eligible reads that were hedged.*/
+@property (readonly) double hedgeRate;
+
+/** Initializes a new AZSHedgingPolicy with the default settings.
+
+ @return The new policy.
+ */
+-(instancetype)init AZS_DESIGNATED_INITIALIZER;
+
+/** Clears the response times and the counts.*/
+-(void)reset;
+
+// The methods below are used by the library to hedge requests.
+
+/** Records the time a read took to get response headers from the location it was first sent to.
+
+ @param latency The time, in seconds.
+ */
+-(void)recordResponseLatency:(NSTimeInterval)latency;
+
+/** Records a read that could be hedged.*/
+-(void)recordEligibleRequest;
+
+/** Records that a read was hedged.*/
+-(void)recordHedge;
+
+/** Records that a hedged read was served by the hedge.*/
+-(void)recordHedgeWin;
+
+@end
+
+AZS_ASSUME_NONNULL_END
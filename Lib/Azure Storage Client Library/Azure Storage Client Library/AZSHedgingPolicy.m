@@ -0,0 +1,154 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSHedgingPolicy.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+
+#import "AZSHedgingPolicy.h"
+
+// The number of recent response times the percentile is taken over.
+#define AZSHedgingSampleCount 256
+
+// The percentile is recomputed after this many new samples, rather than on every read.
+#define AZSHedgingRecomputeInterval 16
+
+@interface AZSHedgingPolicy()
+{
+    NSTimeInterval _samples[AZSHedgingSampleCount];
+    NSUInteger _sampleCount;
+    NSUInteger _nextSample;
+    NSUInteger _samplesSinceRecompute;
+    NSTimeInterval _trackedDelay;
+}
+
+@property (readwrite) uint64_t eligibleRequests;
+@property (readwrite) uint64_t hedgedRequests;
+@property (readwrite) uint64_t hedgeWins;
+
+@end
+
+@implementation AZSHedgingPolicy
+
+-(instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        _percentile = 95;
+        _minimumDelay = 0.01;
+        _fixedDelay = 0;
+        _minimumSamples = 20;
+    }
+
+    return self;
+}
+
+-(void)reset
+{
+    @synchronized(self)
+    {
+        _sampleCount = 0;
+        _nextSample = 0;
+        _samplesSinceRecompute = 0;
+        _trackedDelay = 0;
+        self.eligibleRequests = 0;
+        self.hedgedRequests = 0;
+        self.hedgeWins = 0;
+    }
+}
+
+-(NSTimeInterval)currentDelay
+{
+    if (self.fixedDelay > 0)
+    {
+        return self.fixedDelay;
+    }
+
+    @synchronized(self)
+    {
+        if (_sampleCount < MAX(self.minimumSamples, (NSUInteger)1))
+        {
+            return 0;
+        }
+        return MAX(_trackedDelay, self.minimumDelay);
+    }
+}
+
+-(double)hedgeRate
+{
+    @synchronized(self)
+    {
+        return (self.eligibleRequests == 0) ? 0 : ((double)self.hedgedRequests / self.eligibleRequests);
+    }
+}
+
+// Must be called with the lock held.
+-(void)recomputeTrackedDelay
+{
+    NSTimeInterval sorted[AZSHedgingSampleCount];
+    memcpy(sorted, _samples, _sampleCount * sizeof(NSTimeInterval));
+    qsort_b(sorted, _sampleCount, sizeof(NSTimeInterval), ^int(const void *a, const void *b) {
+        NSTimeInterval x = *(const NSTimeInterval *)a;
+        NSTimeInterval y = *(const NSTimeInterval *)b;
+        return (x > y) - (x < y);
+    });
+
+    double rank = MIN(MAX(self.percentile, 0.0), 100.0) / 100.0 * (_sampleCount - 1);
+    _trackedDelay = sorted[(NSUInteger)ceil(rank)];
+    _samplesSinceRecompute = 0;
+}
+
+-(void)recordResponseLatency:(NSTimeInterval)latency
+{
+    @synchronized(self)
+    {
+        _samples[_nextSample] = latency;
+        _nextSample = (_nextSample + 1) % AZSHedgingSampleCount;
+        _sampleCount = MIN(_sampleCount + 1, (NSUInteger)AZSHedgingSampleCount);
+        _samplesSinceRecompute++;
+
+        // Recompute often while warming up, so hedging can start as soon as there are enough samples.
+        if (_sampleCount <= MAX(self.minimumSamples, (NSUInteger)1) || _samplesSinceRecompute >= AZSHedgingRecomputeInterval)
+        {
+            [self recomputeTrackedDelay];
+        }
+    }
+}
+
+-(void)recordEligibleRequest
+{
+    @synchronized(self)
+    {
+        self.eligibleRequests++;
+    }
+}
+
+-(void)recordHedge
+{
+    @synchronized(self)
+    {
+        self.hedgedRequests++;
+    }
+}
+
+-(void)recordHedgeWin
+{
+    @synchronized(self)
+    {
+        self.hedgeWins++;
+    }
+}
+
+@end
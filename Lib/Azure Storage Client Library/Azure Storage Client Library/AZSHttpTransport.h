@@ -0,0 +1,99 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSHttpTransport.h" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <Foundation/Foundation.h>
+#import "AZSMacros.h"
+
+AZS_ASSUME_NONNULL_BEGIN
+
+@protocol AZSHttpTransportTask;
+
+/** The callbacks a transport makes for one HTTP request.
+
+ For each task, the callbacks are made one at a time, in order: transportTask:didReceiveResponse: once, then
+ transportTask:didReceiveData: for each piece of the body, then transportTask:didCompleteWithError: once.  If the request
+ fails before a response arrives, only transportTask:didCompleteWithError: is called.
+
+ The delegate applies backpressure by suspending the task when it has buffered enough, and resuming it once the data has
+ been consumed.  Callbacks should return promptly, so that other tasks sharing the transport's delegate queue are not held
+ up.
+ */
+@protocol AZSHttpTransportDelegate <NSObject>
+
+/** Called when the response status and headers have been received.*/
+-(void)transportTask:(id<AZSHttpTransportTask>)task didReceiveResponse:(NSHTTPURLResponse *)response;
+
+/** Called with the next piece of the response body.*/
+-(void)transportTask:(id<AZSHttpTransportTask>)task didReceiveData:(NSData *)data;
+
+/** Called when the request has finished.
+
+ @param error nil if the whole response was received; otherwise the transport error.
+ */
+-(void)transportTask:(id<AZSHttpTransportTask>)task didCompleteWithError:(NSError * __AZSNullable)error;
+
+@optional
+
+/** Called just before transportTask:didCompleteWithError: by transports built on NSURLSession, with the task's
+ connection timings.*/
+-(void)transportTask:(id<AZSHttpTransportTask>)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics;
+
+@end
+
+/** A single HTTP request made through an AZSHttpTransport.*/
+@protocol AZSHttpTransportTask <NSObject>
+
+/** Starts the request, or continues it after suspend.*/
+-(void)resume;
+
+/** Temporarily stops delivering response data, until resume is called.  A few callbacks already on their way may still
+ arrive after this returns.*/
+-(void)suspend;
+
+/** Cancels the request.  The delegate is then sent transportTask:didCompleteWithError: with an error, unless the request
+ had already completed.*/
+-(void)cancel;
+
+/** The request body bytes sent so far.*/
+@property (readonly) int64_t countOfBytesSent;
+
+/** The response body bytes received so far.*/
+@property (readonly) int64_t countOfBytesReceived;
+
+@end
+
+/** AZSHttpTransport is the interface the library uses to send HTTP requests.
+
+ By default, requests are sent with AZSURLSessionTransport.  Assign a different transport to the httpTransport property
+ of a client to route its requests elsewhere; for example, AZSLoopbackTransport answers requests in memory, to measure
+ the library's own overhead without a network.
+ */
+@protocol AZSHttpTransport <NSObject>
+
+/** Creates a task for one request.  The task does not start until it is resumed.
+
+ @param request The request to send.  Its headers have already been signed, so the transport must not change them.
+ @param body The request body, or nil if there is none.
+ @param timeout The time the whole request, including the response body, may take.
+ @param delegate The delegate for the task's callbacks.  The task keeps a strong reference to it until the task completes.
+ @returns The task.
+ */
+-(id<AZSHttpTransportTask>)taskWithRequest:(NSURLRequest *)request body:(NSData * __AZSNullable)body timeout:(NSTimeInterval)timeout delegate:(id<AZSHttpTransportDelegate>)delegate;
+
+@end
+
+AZS_ASSUME_NONNULL_END
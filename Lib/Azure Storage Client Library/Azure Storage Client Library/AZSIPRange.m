@@ -19,6 +19,7 @@
 #import "AZSConstants.h"
 #import "AZSErrors.h"
 #import "AZSIPRange.h"
+#import "AZSLogging.h"
 #import "AZSOperationContext.h"
 #import "AZSUtil.h"
 #import "arpa/inet.h"
@@ -40,7 +41,7 @@
     
     if (!inet_aton([ipString UTF8String], &ip)) {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-        [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Invalid IP string."];
+        AZSLogError([AZSUtil operationlessContext], @"Invalid IP string.");
         return nil;
     }
     return [self initWithSingleIP:ip];
@@ -53,13 +54,13 @@
     
     if (!inet_aton([minimumString UTF8String], &ipMin)) {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-        [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Invalid IP string."];
+        AZSLogError([AZSUtil operationlessContext], @"Invalid IP string.");
         return nil;
     }
     
     if (!inet_aton([maximumString UTF8String], &ipMax)) {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-        [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Invalid IP string."];
+        AZSLogError([AZSUtil operationlessContext], @"Invalid IP string.");
         return nil;
     }
     return [self initWithMinIP:ipMin maxIP:ipMax];
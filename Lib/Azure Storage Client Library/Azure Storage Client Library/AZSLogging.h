@@ -0,0 +1,65 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSLogging.h" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <Foundation/Foundation.h>
+#import "AZSEnums.h"
+#import "AZSOperationContext.h"
+
+#ifndef AZSLogging_h
+#define AZSLogging_h
+
+// Logging front end for library code.  Use these macros instead of calling logAtLevel:withMessage: directly: the level
+// checks happen inline, before the message arguments are evaluated, so a disabled log statement costs two integer
+// comparisons and one property read, with no varargs call and no formatting.
+
+// The most verbose level compiled into the library.  Statements above this level are removed entirely by the compiler.
+// Building with -DAZS_LOG_MAX_LEVEL=6 (AZSLogLevelInfo) strips all Debug logging.
+#ifndef AZS_LOG_MAX_LEVEL
+#define AZS_LOG_MAX_LEVEL 7
+#endif
+
+// Mirrors +[AZSOperationContext globalLogLevel], readable without a message send.
+extern AZSLogLevel AZSGlobalLogLevel;
+
+static inline BOOL AZSShouldLog(AZSOperationContext *operationContext, AZSLogLevel logLevel)
+{
+    return (logLevel <= AZSGlobalLogLevel) || (operationContext && logLevel <= operationContext.logLevel);
+}
+
+#define AZSLog(operationContext, level, ...) \
+    do \
+    { \
+        if ((level) <= AZS_LOG_MAX_LEVEL) \
+        { \
+            AZSOperationContext *_azsLogContext = (operationContext); \
+            if (AZSShouldLog(_azsLogContext, (level))) \
+            { \
+                [_azsLogContext logAtLevel:(level) withMessage:__VA_ARGS__]; \
+            } \
+        } \
+    } while (0)
+
+#define AZSLogCritical(operationContext, ...) AZSLog(operationContext, AZSLogLevelCritical, __VA_ARGS__)
+#define AZSLogError(operationContext, ...) AZSLog(operationContext, AZSLogLevelError, __VA_ARGS__)
+#define AZSLogWarning(operationContext, ...) AZSLog(operationContext, AZSLogLevelWarning, __VA_ARGS__)
+#define AZSLogInfo(operationContext, ...) AZSLog(operationContext, AZSLogLevelInfo, __VA_ARGS__)
+#define AZSLogDebug(operationContext, ...) AZSLog(operationContext, AZSLogLevelDebug, __VA_ARGS__)
+
+// For guarding work done only to produce log output, such as loops over headers.
+#define AZSLogEnabled(operationContext, level) ((level) <= AZS_LOG_MAX_LEVEL && AZSShouldLog((operationContext), (level)))
+
+#endif //#ifndef AZSLogging_h
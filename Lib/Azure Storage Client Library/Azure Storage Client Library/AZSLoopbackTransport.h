@@ -0,0 +1,56 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSLoopbackTransport.h" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <Foundation/Foundation.h>
+#import "AZSHttpTransport.h"
+
+AZS_ASSUME_NONNULL_BEGIN
+
+/** The block that answers a request sent through an AZSLoopbackTransport.
+
+ @param request The request, as the library would have sent it.
+ @param body The request body, or nil.
+ @param respond Call this exactly once, from any thread, with the response status code, headers and body.
+ */
+typedef void (^AZSLoopbackHandler)(NSURLRequest *request, NSData * __AZSNullable body, void (^respond)(NSInteger statusCode, NSDictionary * __AZSNullable headers, NSData * __AZSNullable body));
+
+/** AZSLoopbackTransport answers requests in memory with a handler block, without touching the network.
+
+ It is intended for microbenchmarks of the library's own per-request overhead (request building, signing, the executor
+ and response parsing) and for tests that need exact control over responses.  Each task's callbacks are made on a
+ serial queue of its own.
+ */
+@interface AZSLoopbackTransport : NSObject <AZSHttpTransport>
+
+/** The size of the pieces the response body is delivered in.  Defaults to 64 KB.*/
+@property NSUInteger chunkSize;
+
+/** The number of requests sent through this transport.*/
+@property (readonly) NSUInteger requestCount;
+
+-(instancetype)init AZS_DESIGNATED_INITIALIZER;
+
+/** Initializes a new AZSLoopbackTransport.
+
+ @param handler The block that answers each request.
+ @returns The new transport.
+ */
+-(instancetype)initWithHandler:(AZSLoopbackHandler)handler AZS_DESIGNATED_INITIALIZER;
+
+@end
+
+AZS_ASSUME_NONNULL_END
@@ -0,0 +1,212 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSLoopbackTransport.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import "AZSLoopbackTransport.h"
+#import "AZSConstants.h"
+
+@interface AZSLoopbackTransport()
+
+@property (copy) AZSLoopbackHandler handler;
+@property (readwrite) NSUInteger requestCount;
+
+-(void)recordRequest;
+
+@end
+
+@interface AZSLoopbackTransportTask : NSObject <AZSHttpTransportTask>
+
+@property (weak) AZSLoopbackTransport *transport;
+@property (copy) NSURLRequest *request;
+@property (strong) NSData *body;
+@property (strong) id<AZSHttpTransportDelegate> delegate;
+@property (strong) dispatch_queue_t queue;
+@property BOOL started;
+@property BOOL suspended;
+@property BOOL cancelled;
+@property BOOL completed;
+@property (strong) NSData *responseBody;
+@property NSUInteger responseBodyOffset;
+@property NSUInteger chunkSize;
+@property int64_t countOfBytesSent;
+@property int64_t countOfBytesReceived;
+
+-(instancetype)init AZS_DESIGNATED_INITIALIZER;
+-(instancetype)initWithTransport:(AZSLoopbackTransport *)transport request:(NSURLRequest *)request body:(NSData *)body delegate:(id<AZSHttpTransportDelegate>)delegate AZS_DESIGNATED_INITIALIZER;
+
+@end
+
+@implementation AZSLoopbackTransportTask
+
+-(instancetype)init
+{
+    return nil;
+}
+
+-(instancetype)initWithTransport:(AZSLoopbackTransport *)transport request:(NSURLRequest *)request body:(NSData *)body delegate:(id<AZSHttpTransportDelegate>)delegate
+{
+    self = [super init];
+    if (self)
+    {
+        _transport = transport;
+        _request = [request copy];
+        _body = body;
+        _delegate = delegate;
+        _queue = dispatch_queue_create("com.microsoft.azure.storage.loopbacktransport", DISPATCH_QUEUE_SERIAL);
+    }
+
+    return self;
+}
+
+// Must be called on the task's queue.
+-(void)completeWithError:(NSError *)error
+{
+    if (self.completed)
+    {
+        return;
+    }
+    self.completed = YES;
+
+    [self.delegate transportTask:self didCompleteWithError:error];
+    self.delegate = nil;
+}
+
+-(void)deliverResponseWithStatusCode:(NSInteger)statusCode headers:(NSDictionary *)headers body:(NSData *)body chunkSize:(NSUInteger)chunkSize
+{
+    if (self.completed)
+    {
+        return;
+    }
+
+    NSMutableDictionary *responseHeaders = [NSMutableDictionary dictionaryWithDictionary:headers ?: @{}];
+    responseHeaders[AZSCContentLength] = [NSString stringWithFormat:@"%lu", (unsigned long)body.length];
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:self.request.URL statusCode:statusCode HTTPVersion:@"HTTP/1.1" headerFields:responseHeaders];
+    [self.delegate transportTask:self didReceiveResponse:response];
+
+    self.responseBody = body ?: [NSData data];
+    self.responseBodyOffset = 0;
+    self.chunkSize = chunkSize;
+    [self deliverBody];
+}
+
+// Must be called on the task's queue.  Delivers chunks until the body is done or the task is suspended; resume picks up
+// from where this left off.
+-(void)deliverBody
+{
+    if (self.completed || !self.responseBody)
+    {
+        return;
+    }
+
+    NSData *body = self.responseBody;
+    while (self.responseBodyOffset < body.length)
+    {
+        if (self.cancelled || self.suspended)
+        {
+            break;
+        }
+
+        NSData *chunk = [body subdataWithRange:NSMakeRange(self.responseBodyOffset, MIN(self.chunkSize, body.length - self.responseBodyOffset))];
+        self.responseBodyOffset += chunk.length;
+        self.countOfBytesReceived += chunk.length;
+        [self.delegate transportTask:self didReceiveData:chunk];
+    }
+
+    if (self.suspended && !self.cancelled)
+    {
+        return;
+    }
+
+    [self completeWithError:self.cancelled ? [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil] : nil];
+}
+
+-(void)resume
+{
+    self.suspended = NO;
+    if (self.started)
+    {
+        dispatch_async(self.queue, ^{
+            [self deliverBody];
+        });
+        return;
+    }
+    self.started = YES;
+
+    AZSLoopbackTransport *transport = self.transport;
+    AZSLoopbackHandler handler = transport.handler;
+    NSUInteger chunkSize = MAX(transport.chunkSize, (NSUInteger)1);
+    [transport recordRequest];
+
+    dispatch_async(self.queue, ^{
+        self.countOfBytesSent = self.body.length;
+        handler(self.request, self.body, ^(NSInteger statusCode, NSDictionary *headers, NSData *body) {
+            dispatch_async(self.queue, ^{
+                [self deliverResponseWithStatusCode:statusCode headers:headers body:body chunkSize:chunkSize];
+            });
+        });
+    });
+}
+
+-(void)suspend
+{
+    // Takes effect at the next chunk.
+    self.suspended = YES;
+}
+
+-(void)cancel
+{
+    self.cancelled = YES;
+    dispatch_async(self.queue, ^{
+        [self completeWithError:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]];
+    });
+}
+
+@end
+
+@implementation AZSLoopbackTransport
+
+-(instancetype)init
+{
+    return nil;
+}
+
+-(instancetype)initWithHandler:(AZSLoopbackHandler)handler
+{
+    self = [super init];
+    if (self)
+    {
+        _handler = [handler copy];
+        _chunkSize = 64 * AZSCKilobyte;
+        _requestCount = 0;
+    }
+
+    return self;
+}
+
+-(void)recordRequest
+{
+    @synchronized(self)
+    {
+        self.requestCount++;
+    }
+}
+
+-(id<AZSHttpTransportTask>)taskWithRequest:(NSURLRequest *)request body:(NSData *)body timeout:(NSTimeInterval)timeout delegate:(id<AZSHttpTransportDelegate>)delegate
+{
+    return [[AZSLoopbackTransportTask alloc] initWithTransport:self request:request body:body delegate:delegate];
+}
+
+@end
@@ -23,6 +23,7 @@
 #import "AZSUtil.h"
 #import "AZSStorageCredentials.h"
 #import "AZSUriQueryBuilder.h"
+#import "AZSLogging.h"
 
 @implementation AZSNavigationUtil
 
@@ -44,7 +45,7 @@
         
         if (segments.count < 2) {
             *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-            [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"URI is missing account information."];
+            AZSLogError([AZSUtil operationlessContext], @"URI is missing account information.");
             return nil;
         }
         
@@ -82,12 +82,24 @@ AZS_ASSUME_NONNULL_BEGIN
 /** The end time for the operation. */
 @property (copy, AZSNullable) NSDate *endTime;
 
-/** An array of request results objects.  Populated by the library. */
+/** An array of request results objects.  Populated by the library.  Each read returns a snapshot, so it is safe to
+ read while the operation is running. */
 @property (strong, readonly) NSArray *requestResults;
 
 /** The retry policy for the request. */
 @property (strong, AZSNullable) id<AZSRetryPolicy> retryPolicy;
 
+/** YES once cancel has been called.*/
+@property (readonly) BOOL cancelled;
+
+/** Cancels the operation.
+ 
+ Requests in flight are cancelled, requests that have not been sent yet are not sent, and waits before retries are cut
+ short.  An upload sends no more blocks.  The operation's completion handler is then called with an AZSEOperationCancelled
+ error, unless the operation had already finished.  Calling this more than once has no further effect.
+ */
+-(void)cancel;
+
 /** The log level for this OperationContext instance.  Messages will only be logged if their severity is
  equal to or more severe than this. */
 @property AZSLogLevel logLevel;
@@ -174,6 +186,23 @@ AZS_ASSUME_NONNULL_BEGIN
 
 -(void)addRequestResult:(AZSRequestResult *)requestResultToAdd;
 
+// These are used by the library to stop its work when the operation is cancelled.  The handler is called once, on the
+// thread that calls cancel, or right away if the operation has already been cancelled.  The returned object identifies
+// the handler to removeCancellationHandler:.
+-(id)addCancellationHandler:(void(^)())handler;
+-(void)removeCancellationHandler:(id)registration;
+
+/** Aggregates the phase timings of the requests made so far in this operation.
+ 
+ Only requests with network metrics are included, except for AZSRequestPhaseTotal, which includes every request.
+ The percentile is computed with the nearest-rank method, so it is always the duration of an actual request.
+ 
+ @param percentile The percentile to compute, from 0 to 100.  For example, 50 for the median, or 99.
+ @param phase The request phase to aggregate.
+ @returns The duration at the given percentile, in seconds, or 0 if no requests have timings for the phase.
+ */
+-(NSTimeInterval)percentile:(double)percentile ofRequestPhase:(AZSRequestPhase)phase;
+
 @end
 
 AZS_ASSUME_NONNULL_END
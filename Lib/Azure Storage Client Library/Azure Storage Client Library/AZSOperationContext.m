@@ -15,17 +15,21 @@
 // </copyright>
 // -----------------------------------------------------------------------------------------
 
+#import "AZSLogging.h"
 #import "AZSOperationContext.h"
+#import "AZSRequestResult.h"
 
 @implementation AZSOperationContext
 {
     aslclient _logger;
     NSCondition *_logCondition;
     NSMutableArray *_requestResults;
+    NSMutableDictionary *_cancellationHandlers;
+    BOOL _cancelled;
 }
 
 static void (^_globalLogFunction)(AZSLogLevel logLevel, NSString* logMessage);
-static AZSLogLevel _globalLogLevel;
+AZSLogLevel AZSGlobalLogLevel = AZSLogLevelNoLogging;
 static aslclient _globalLogger;
 static NSCondition *_globalLogCondition;
 
@@ -39,12 +43,12 @@ static NSCondition *_globalLogCondition;
 
 +(AZSLogLevel)globalLogLevel
 {
-    return _globalLogLevel;
+    return AZSGlobalLogLevel;
 }
 
 +(void)setGlobalLogLevel:(AZSLogLevel)globalLogLevel
 {
-    _globalLogLevel = globalLogLevel;
+    AZSGlobalLogLevel = globalLogLevel;
 }
 
 +(aslclient)globalLogger
@@ -110,7 +114,7 @@ static NSCondition *_globalLogCondition;
     NSString *finalLogString;
     
     // Static section:
-    if (logLevel <= _globalLogLevel)
+    if (logLevel <= AZSGlobalLogLevel)
     {
         if (_globalLogFunction)
         {
@@ -185,12 +189,106 @@ static NSCondition *_globalLogCondition;
 
 -(NSArray *)requestResults
 {
-    return _requestResults;
+    // Requests from parallel operations finish on different threads, so callers get a snapshot.
+    @synchronized(self)
+    {
+        return [_requestResults copy];
+    }
 }
 
 -(void)addRequestResult:(AZSRequestResult *)requestResultToAdd
 {
-    [_requestResults addObject:requestResultToAdd];
+    @synchronized(self)
+    {
+        [_requestResults addObject:requestResultToAdd];
+    }
+}
+
+-(BOOL)cancelled
+{
+    @synchronized(self)
+    {
+        return _cancelled;
+    }
+}
+
+-(void)cancel
+{
+    NSArray *handlers = nil;
+    @synchronized(self)
+    {
+        if (_cancelled)
+        {
+            return;
+        }
+        _cancelled = YES;
+        handlers = [_cancellationHandlers allValues];
+        _cancellationHandlers = nil;
+    }
+    
+    AZSLogInfo(self, @"Operation cancelled.");
+    for (void(^handler)() in handlers)
+    {
+        handler();
+    }
+}
+
+-(id)addCancellationHandler:(void(^)())handler
+{
+    NSUUID *registration = [NSUUID UUID];
+    @synchronized(self)
+    {
+        if (!_cancelled)
+        {
+            if (!_cancellationHandlers)
+            {
+                _cancellationHandlers = [NSMutableDictionary dictionary];
+            }
+            _cancellationHandlers[registration] = [handler copy];
+            return registration;
+        }
+    }
+    
+    handler();
+    return registration;
+}
+
+-(void)removeCancellationHandler:(id)registration
+{
+    @synchronized(self)
+    {
+        [_cancellationHandlers removeObjectForKey:registration];
+    }
+}
+
+-(NSTimeInterval)percentile:(double)percentile ofRequestPhase:(AZSRequestPhase)phase
+{
+    NSArray *requestResults = self.requestResults;
+    NSUInteger count = 0;
+    NSTimeInterval *durations = malloc(MAX(requestResults.count, 1) * sizeof(NSTimeInterval));
+    for (AZSRequestResult *requestResult in requestResults)
+    {
+        if (requestResult.networkMetricsAvailable || phase == AZSRequestPhaseTotal)
+        {
+            durations[count++] = [requestResult durationOfPhase:phase];
+        }
+    }
+
+    NSTimeInterval result = 0;
+    if (count > 0)
+    {
+        qsort_b(durations, count, sizeof(NSTimeInterval), ^int(const void *first, const void *second) {
+            NSTimeInterval difference = *(const NSTimeInterval *)first - *(const NSTimeInterval *)second;
+            return (difference > 0) - (difference < 0);
+        });
+
+        // Nearest rank: the smallest duration that at least percentile% of the requests are no slower than.
+        double rank = ceil(MIN(MAX(percentile, 0.0), 100.0) / 100.0 * count);
+        result = durations[(NSUInteger)MAX(rank, 1.0) - 1];
+    }
+
+    free(durations);
+    return result;
 }
 
 @end
\ No newline at end of file
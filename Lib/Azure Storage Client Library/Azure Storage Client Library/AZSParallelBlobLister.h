@@ -0,0 +1,97 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSParallelBlobLister.h" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <Foundation/Foundation.h>
+#import "AZSEnums.h"
+#import "AZSMacros.h"
+
+AZS_ASSUME_NONNULL_BEGIN
+
+@class AZSCloudBlobContainer;
+@class AZSBlobRequestOptions;
+
+/** The AZSParallelBlobLister lists all the blobs in a container using several concurrent listing streams.
+
+ A normal segmented listing is strictly serial, because each AZSContinuationToken depends on the previous page.
+ The AZSParallelBlobLister instead splits the key space into prefix partitions, each listed flat with its own chain of
+ listBlobsSegmented calls.  Listing starts with one partition for the whole prefix.  When a page comes back full and
+ fewer partitions are waiting than can be listed at once, the rest of that partition is split on the character that
+ follows its prefix: one partition for each character from the one in the page's last name up to 'z'.  Each partition
+ can split again in the same way, so names with no delimiter, or a container dominated by one directory, are split as
+ finely as the parallelism needs.  Names with a later character at that position, which includes every character
+ outside ASCII, are listed by a tail partition once the others have finished.  Up to parallelismFactor calls are
+ outstanding at once.
+
+ Each split makes one call for every character in its range, most of which usually come back empty, so a container
+ that holds only a few pages of blobs is listed faster serially.
+
+ An AZSParallelBlobLister should only be used for one listing at a time.
+ */
+@interface AZSParallelBlobLister : NSObject
+
+/** The container to list. */
+@property (strong, readonly) AZSCloudBlobContainer *container;
+
+/** Optional.  Only blobs whose names begin with this prefix will be listed. */
+@property (copy, AZSNullable) NSString *prefix;
+
+/** Any additional data that should be returned in the listing operation. */
+@property AZSBlobListingDetails blobListingDetails;
+
+/** The maximum number of results to return per listing call.  -1 uses the service maximum. */
+@property NSInteger maxResults;
+
+/** The maximum number of listing calls that may be outstanding at once.  Defaults to 8. */
+@property NSInteger parallelismFactor;
+
+/** If YES, blobs are delivered to the segment handler in the same lexicographic order as a serial flat listing.
+ Partitions that finish early are buffered until all earlier partitions have been delivered.
+ If NO (the default), blobs are delivered as soon as each page arrives, and the order across partitions is unspecified.*/
+@property BOOL orderedResults;
+
+/** Optional.  The request options to use for each listing call. */
+@property (strong, AZSNullable) AZSBlobRequestOptions *requestOptions;
+
+/** Initializes a new AZSParallelBlobLister.
+
+ @param container The container to list.
+ @return The newly allocated instance.
+ */
+-(instancetype)initWithContainer:(AZSCloudBlobContainer *)container AZS_DESIGNATED_INITIALIZER;
+
+/** Lists every blob in the container (under the prefix, if one is set).
+
+ The segment handler is never called concurrently with itself; all calls are made from a single serial queue, and the
+ completion handler is called on that same queue once every segment has been delivered.
+
+ @param segmentHandler The block of code to execute with each batch of listed blobs.
+
+ | Parameter name | Description |
+ |----------------|-------------|
+ |NSArray * | The AZSCloudBlob objects in this batch.|
+
+ @param completionHandler The block of code to execute when the listing is finished.
+
+ | Parameter name | Description |
+ |----------------|-------------|
+ |NSError * | Nil if the operation succeeded without error, error with details about the failure otherwise.|
+ */
+-(void)listBlobsWithSegmentHandler:(void (^)(NSArray *))segmentHandler completionHandler:(void (^)(NSError * __AZSNullable))completionHandler;
+
+@end
+
+AZS_ASSUME_NONNULL_END
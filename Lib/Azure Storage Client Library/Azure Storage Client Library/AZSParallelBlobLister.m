@@ -0,0 +1,410 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSParallelBlobLister.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import "AZSParallelBlobLister.h"
+#import "AZSCloudBlobContainer.h"
+#import "AZSCloudBlob.h"
+#import "AZSBlobRequestOptions.h"
+#import "AZSContinuationToken.h"
+#import "AZSResultSegment.h"
+
+// A partition splits on each character from its page's last name up to this one.  Names with a later character at that
+// position (a few ASCII punctuation marks, and everything outside ASCII) are left to the partition's tail.
+static const unichar AZSListingSplitLastCharacter = 'z';
+
+// Orders blob names the way the service lists them, by their UTF-8 bytes.  NSString comparisons work on UTF-16, which
+// orders characters outside the Basic Multilingual Plane differently.
+static NSComparisonResult AZSCompareBlobNames(NSString *first, NSString *second)
+{
+    const char *firstBytes = [first UTF8String];
+    const char *secondBytes = [second UTF8String];
+    size_t firstLength = strlen(firstBytes);
+    size_t secondLength = strlen(secondBytes);
+    int comparison = memcmp(firstBytes, secondBytes, MIN(firstLength, secondLength));
+    if (comparison == 0)
+    {
+        comparison = (firstLength < secondLength) ? -1 : ((firstLength > secondLength) ? 1 : 0);
+    }
+    return (comparison < 0) ? NSOrderedAscending : ((comparison > 0) ? NSOrderedDescending : NSOrderedSame);
+}
+
+// A contiguous slice of the key space, listed flat with its own chain of continuation tokens.
+// A partition that splits hands the rest of its key space to one child per next character and a tail, which lists
+// whatever the children do not cover once they have all finished.
+@interface AZSBlobListingPartition : NSObject
+
+@property (copy) NSString *prefix;
+@property (strong) AZSContinuationToken *startToken;
+// Names up to and including this one have already been listed by the partition that split.
+@property (copy) NSString *skipThroughName;
+@property (weak) AZSBlobListingPartition *parent;
+@property BOOL isTail;
+@property (strong) NSMutableArray *pendingBlobs;
+@property BOOL complete;
+
+// Set once the partition has split.
+@property unichar splitFirstCharacter;
+@property (strong) AZSBlobListingPartition *tail;
+@property NSUInteger unfinishedChildren;
+@property (strong) AZSContinuationToken *furthestToken;
+@property (copy) NSString *furthestTokenName;
+
+@end
+
+@implementation AZSBlobListingPartition
+@end
+
+@interface AZSParallelBlobLister()
+
+@property (strong) NSMutableArray *partitions;
+@property (strong) NSMutableArray *partitionsToStart;
+@property NSUInteger nextPartitionToDeliver;
+@property NSInteger activeRequests;
+@property BOOL listingComplete;
+@property BOOL finished;
+@property (strong) NSError *listingError;
+@property (strong) dispatch_queue_t deliveryQueue;
+@property (copy) void (^segmentHandler)(NSArray *);
+@property (copy) void (^completionHandler)(NSError *);
+
+-(instancetype)init AZS_DESIGNATED_INITIALIZER;
+
+@end
+
+@implementation AZSParallelBlobLister
+
+-(instancetype)init
+{
+    return nil;
+}
+
+-(instancetype)initWithContainer:(AZSCloudBlobContainer *)container
+{
+    self = [super init];
+    if (self)
+    {
+        _container = container;
+        _prefix = nil;
+        _blobListingDetails = AZSBlobListingDetailsNone;
+        _maxResults = -1;
+        _parallelismFactor = 8;
+        _orderedResults = NO;
+        _deliveryQueue = dispatch_queue_create("com.microsoft.azure.storage.parallelbloblister", DISPATCH_QUEUE_SERIAL);
+    }
+
+    return self;
+}
+
+-(void)listBlobsWithSegmentHandler:(void (^)(NSArray *))segmentHandler completionHandler:(void (^)(NSError *))completionHandler
+{
+    NSArray *partitionsToStart = nil;
+    @synchronized(self)
+    {
+        AZSBlobListingPartition *partition = [[AZSBlobListingPartition alloc] init];
+        partition.prefix = self.prefix ?: @"";
+        partition.pendingBlobs = [NSMutableArray arrayWithCapacity:0];
+
+        self.segmentHandler = segmentHandler;
+        self.completionHandler = completionHandler;
+        self.partitions = [NSMutableArray arrayWithObject:partition];
+        self.partitionsToStart = [NSMutableArray arrayWithObject:partition];
+        self.nextPartitionToDeliver = 0;
+        self.activeRequests = 0;
+        self.listingComplete = NO;
+        self.finished = NO;
+        self.listingError = nil;
+        partitionsToStart = [self takePartitionsToStartLocked];
+    }
+
+    for (AZSBlobListingPartition *partition in partitionsToStart)
+    {
+        [self listPartition:partition continuationToken:partition.startToken];
+    }
+}
+
+-(void)listPartition:(AZSBlobListingPartition *)partition continuationToken:(AZSContinuationToken *)token
+{
+    [self.container listBlobsSegmentedWithContinuationToken:token prefix:partition.prefix useFlatBlobListing:YES blobListingDetails:self.blobListingDetails maxResults:self.maxResults accessCondition:nil requestOptions:self.requestOptions operationContext:nil completionHandler:^(NSError *error, AZSBlobResultSegment *resultSegment) {
+        NSArray *partitionsToStart = nil;
+        BOOL continueListing = NO;
+
+        @synchronized(self)
+        {
+            BOOL partitionFinished = NO;
+            if (error)
+            {
+                self.listingError = self.listingError ?: error;
+            }
+            else
+            {
+                for (AZSCloudBlob *blob in resultSegment.blobs)
+                {
+                    if ([self partition:partition ownsBlobName:blob.blobName])
+                    {
+                        [partition.pendingBlobs addObject:blob];
+                    }
+                }
+
+                NSString *lastName = ((AZSCloudBlob *)resultSegment.blobs.lastObject).blobName;
+                if (!resultSegment.continuationToken)
+                {
+                    partitionFinished = YES;
+                }
+                else if (!self.listingError)
+                {
+                    if (lastName)
+                    {
+                        [self recordToken:resultSegment.continuationToken afterName:lastName inPartition:partition];
+                    }
+                    continueListing = !lastName || ![self splitPartitionLocked:partition afterName:lastName token:resultSegment.continuationToken];
+                }
+            }
+
+            if (!continueListing)
+            {
+                self.activeRequests--;
+                if (partitionFinished)
+                {
+                    partition.complete = YES;
+                    [self subtreeFinishedLocked:partition];
+                }
+                partitionsToStart = [self takePartitionsToStartLocked];
+            }
+
+            [self deliverLocked];
+            [self finishIfDoneLocked];
+        }
+
+        if (continueListing)
+        {
+            [self listPartition:partition continuationToken:resultSegment.continuationToken];
+        }
+
+        for (AZSBlobListingPartition *nextPartition in partitionsToStart)
+        {
+            [self listPartition:nextPartition continuationToken:nextPartition.startToken];
+        }
+    }];
+}
+
+// Must be called while synchronized on self.
+-(BOOL)partition:(AZSBlobListingPartition *)partition ownsBlobName:(NSString *)blobName
+{
+    if (partition.skipThroughName && (AZSCompareBlobNames(blobName, partition.skipThroughName) != NSOrderedDescending))
+    {
+        return NO;
+    }
+
+    if (partition.isTail)
+    {
+        // The tail lists the whole prefix, but the names whose next character is in the split range belong to the children.
+        AZSBlobListingPartition *parent = partition.parent;
+        if (blobName.length > parent.prefix.length)
+        {
+            unichar character = [blobName characterAtIndex:parent.prefix.length];
+            return (character < parent.splitFirstCharacter) || (character > AZSListingSplitLastCharacter);
+        }
+    }
+
+    return YES;
+}
+
+// Must be called while synchronized on self.
+-(void)recordToken:(AZSContinuationToken *)token afterName:(NSString *)lastName inPartition:(AZSBlobListingPartition *)partition
+{
+    for (AZSBlobListingPartition *owner = partition.parent; owner; owner = owner.parent)
+    {
+        if (AZSCompareBlobNames(lastName, owner.furthestTokenName) == NSOrderedDescending)
+        {
+            owner.furthestToken = token;
+            owner.furthestTokenName = lastName;
+        }
+    }
+}
+
+// Must be called while synchronized on self.  Splits the rest of the partition after lastName, if there is little enough
+// work waiting that more partitions would be listed sooner.  Returns YES if it split, ending the partition's own chain.
+-(BOOL)splitPartitionLocked:(AZSBlobListingPartition *)partition afterName:(NSString *)lastName token:(AZSContinuationToken *)token
+{
+    if (partition.isTail || (self.partitionsToStart.count >= (NSUInteger)MAX(self.parallelismFactor, 1)) || (lastName.length <= partition.prefix.length))
+    {
+        return NO;
+    }
+
+    // Names after lastName either share its next character, or have a later one.
+    unichar firstCharacter = [lastName characterAtIndex:partition.prefix.length];
+    if (firstCharacter > AZSListingSplitLastCharacter)
+    {
+        return NO;
+    }
+
+    // A partition may itself start inside names its parent already listed.
+    NSString *skipThroughName = lastName;
+    if (partition.skipThroughName && (AZSCompareBlobNames(partition.skipThroughName, lastName) == NSOrderedDescending))
+    {
+        skipThroughName = partition.skipThroughName;
+    }
+
+    NSMutableArray *children = [NSMutableArray arrayWithCapacity:AZSListingSplitLastCharacter - firstCharacter + 1];
+    for (unichar character = firstCharacter; character <= AZSListingSplitLastCharacter; character++)
+    {
+        AZSBlobListingPartition *child = [[AZSBlobListingPartition alloc] init];
+        child.prefix = [partition.prefix stringByAppendingString:[NSString stringWithCharacters:&character length:1]];
+        child.skipThroughName = skipThroughName;
+        child.parent = partition;
+        child.pendingBlobs = [NSMutableArray arrayWithCapacity:0];
+        [children addObject:child];
+    }
+
+    AZSBlobListingPartition *tail = [[AZSBlobListingPartition alloc] init];
+    tail.prefix = partition.prefix;
+    tail.skipThroughName = skipThroughName;
+    tail.parent = partition;
+    tail.isTail = YES;
+    tail.pendingBlobs = [NSMutableArray arrayWithCapacity:0];
+
+    partition.splitFirstCharacter = firstCharacter;
+    partition.tail = tail;
+    partition.unfinishedChildren = children.count;
+    partition.furthestToken = token;
+    partition.furthestTokenName = lastName;
+    partition.complete = YES;
+
+    // The partition list stays in key order, so that ordered delivery only needs to walk it in sequence.  The children
+    // start ahead of the partitions already waiting, which mostly sort after them, to keep ordered delivery from
+    // buffering far ahead.
+    NSUInteger index = [self.partitions indexOfObjectIdenticalTo:partition] + 1;
+    [self.partitions insertObjects:children atIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(index, children.count)]];
+    [self.partitions insertObject:tail atIndex:index + children.count];
+    [self.partitionsToStart insertObjects:children atIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, children.count)]];
+    return YES;
+}
+
+// Must be called while synchronized on self.  Called once a partition, and everything it split into, has been listed.
+-(void)subtreeFinishedLocked:(AZSBlobListingPartition *)partition
+{
+    AZSBlobListingPartition *parent = partition.parent;
+    if (!parent)
+    {
+        self.listingComplete = YES;
+        return;
+    }
+
+    if (partition == parent.tail)
+    {
+        [self subtreeFinishedLocked:parent];
+        return;
+    }
+
+    parent.unfinishedChildren--;
+    if (parent.unfinishedChildren == 0)
+    {
+        // Everything the tail lists sorts after the children, so it starts from the furthest point any listing under the
+        // parent reached.  A continuation token marks a position in the container's listing, so one from a child's
+        // listing also resumes a listing of the parent's prefix.
+        parent.tail.startToken = parent.furthestToken;
+        [self.partitionsToStart insertObject:parent.tail atIndex:0];
+    }
+}
+
+// Must be called while synchronized on self.
+-(NSArray *)takePartitionsToStartLocked
+{
+    NSMutableArray *partitionsToStart = [NSMutableArray arrayWithCapacity:0];
+    if (self.listingError)
+    {
+        return partitionsToStart;
+    }
+
+    while ((self.activeRequests < MAX(self.parallelismFactor, 1)) && (self.partitionsToStart.count > 0))
+    {
+        [partitionsToStart addObject:self.partitionsToStart[0]];
+        [self.partitionsToStart removeObjectAtIndex:0];
+        self.activeRequests++;
+    }
+
+    return partitionsToStart;
+}
+
+// Must be called while synchronized on self.
+-(void)deliverLocked
+{
+    if (!self.orderedResults)
+    {
+        for (NSUInteger i = self.nextPartitionToDeliver; i < self.partitions.count; i++)
+        {
+            [self deliverBlobsLockedFromPartition:self.partitions[i]];
+        }
+
+        while ((self.nextPartitionToDeliver < self.partitions.count) && ((AZSBlobListingPartition *)self.partitions[self.nextPartitionToDeliver]).complete)
+        {
+            self.nextPartitionToDeliver++;
+        }
+        return;
+    }
+
+    while (self.nextPartitionToDeliver < self.partitions.count)
+    {
+        AZSBlobListingPartition *partition = self.partitions[self.nextPartitionToDeliver];
+        [self deliverBlobsLockedFromPartition:partition];
+        if (!partition.complete)
+        {
+            break;
+        }
+
+        self.nextPartitionToDeliver++;
+    }
+}
+
+// Must be called while synchronized on self.
+-(void)deliverBlobsLockedFromPartition:(AZSBlobListingPartition *)partition
+{
+    if (partition.pendingBlobs.count == 0)
+    {
+        return;
+    }
+
+    NSArray *blobs = partition.pendingBlobs;
+    partition.pendingBlobs = [NSMutableArray arrayWithCapacity:0];
+    void (^segmentHandler)(NSArray *) = self.segmentHandler;
+    dispatch_async(self.deliveryQueue, ^{
+        segmentHandler(blobs);
+    });
+}
+
+// Must be called while synchronized on self.
+-(void)finishIfDoneLocked
+{
+    if (self.finished || (self.activeRequests > 0))
+    {
+        return;
+    }
+
+    if (!self.listingError && !self.listingComplete)
+    {
+        return;
+    }
+
+    self.finished = YES;
+    NSError *error = self.listingError;
+    void (^completionHandler)(NSError *) = self.completionHandler;
+    dispatch_async(self.deliveryQueue, ^{
+        completionHandler(error);
+    });
+}
+
+@end
@@ -0,0 +1,180 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSRequestGovernor.h" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+
+#import <Foundation/Foundation.h>
+#import "AZSEnums.h"
+#import "AZSMacros.h"
+
+AZS_ASSUME_NONNULL_BEGIN
+
+@class AZSRequestResult;
+
+/** An AZSRequestGovernor limits the number of requests a client has on the network at once, across every operation.
+
+ Settings such as parallelismFactor bound the concurrency within one operation, but many simultaneous operations can
+ still open more connections than the account will accept without throttling.  Assign a governor to the
+ requestGovernor property of an AZSCloudBlobClient to cap the total.  A request must be admitted by the governor
+ before it is built and sent, and gives its slot back as soon as it completes, so each retry is admitted again.
+
+ A request is admitted when both the global limit and the limit for its host allow it.  Requests that cannot be
+ admitted wait in a queue, and are admitted highest requestPriority first, in arrival order within a priority.  A
+ waiting request whose host is at its limit does not hold up requests to other hosts.
+
+ An adaptive governor (see initAdaptiveWithMinimumRequests:maximumRequests:maximumRequestsPerHost:) looks for the
+ throughput the account can sustain instead of relying on a fixed cap.  It starts at the minimum, raises the limit by
+ one request for each full limit's worth of healthy responses while the limit is in use, and multiplies it by
+ decreaseFactor when the service throttles (500 Operation Timed Out or 503 Server Busy) or the 99th percentile latency
+ rises past latencyThreshold times its running baseline.  Responses to requests sent before a decrease do not count,
+ so one burst of throttling cuts the limit once rather than once per request.
+
+ The statistics are safe to read from any thread.  The time a request spends waiting counts towards the operation's
+ maximumExecutionTime.
+ */
+@interface AZSRequestGovernor : NSObject
+
+/** The maximum number of requests in flight at once, across all hosts.  For an adaptive governor, this is the highest
+ the limit will rise.*/
+@property (readonly) NSUInteger maximumRequests;
+
+/** The lowest an adaptive governor's limit will fall.  Equal to maximumRequests for a fixed governor.*/
+@property (readonly) NSUInteger minimumRequests;
+
+/** Whether the limit adapts to the service's responses.*/
+@property (readonly, getter=isAdaptive) BOOL adaptive;
+
+/** The number of requests currently allowed in flight at once, across all hosts.*/
+@property (readonly) NSUInteger currentLimit;
+
+/** The factor an adaptive governor multiplies its limit by on throttling or rising latency.  Defaults to 0.5.*/
+@property double decreaseFactor;
+
+/** How many times its baseline the 99th percentile latency may reach before an adaptive governor cuts its limit.
+ Defaults to 2.  0 disables the latency signal, which suits workloads whose request sizes vary widely.
+
+ The latency of a request is its time to first byte when network metrics are available, otherwise its whole duration.
+ */
+@property double latencyThreshold;
+
+/** The maximum number of requests in flight at once to any one host.*/
+@property (readonly) NSUInteger maximumRequestsPerHost;
+
+/** The number of requests currently admitted.*/
+@property (readonly) NSUInteger inFlightRequests;
+
+/** The number of requests currently waiting to be admitted.*/
+@property (readonly) NSUInteger waitingRequests;
+
+/** The highest number of requests that have been in flight at once.*/
+@property (readonly) NSUInteger peakInFlightRequests;
+
+/** The highest number of requests that have been waiting at once.*/
+@property (readonly) NSUInteger peakWaitingRequests;
+
+/** The number of requests admitted, including those admitted without waiting.*/
+@property (readonly) uint64_t admittedRequests;
+
+/** The number of requests that had to wait before being admitted.*/
+@property (readonly) uint64_t delayedRequests;
+
+/** The total time requests have spent waiting, in seconds.*/
+@property (readonly) NSTimeInterval totalWaitTime;
+
+/** The longest time a single request has waited, in seconds.*/
+@property (readonly) NSTimeInterval maximumWaitTime;
+
+/** The number of times an adaptive governor has cut its limit.*/
+@property (readonly) uint64_t limitDecreases;
+
+-(instancetype)init AZS_DESIGNATED_INITIALIZER;
+
+/** Initializes a new AZSRequestGovernor.
+
+ @param maximumRequests The maximum number of requests in flight at once, across all hosts.  Must be at least 1.
+ @param maximumRequestsPerHost The maximum number of requests in flight at once to any one host.  Must be at least 1.
+ @returns The new governor.
+ */
+-(instancetype)initWithMaximumRequests:(NSUInteger)maximumRequests maximumRequestsPerHost:(NSUInteger)maximumRequestsPerHost AZS_DESIGNATED_INITIALIZER;
+
+/** Initializes a new adaptive AZSRequestGovernor, whose limit starts at minimumRequests.
+
+ @param minimumRequests The lowest the global limit will fall.  Must be at least 1.
+ @param maximumRequests The highest the global limit will rise.
+ @param maximumRequestsPerHost The maximum number of requests in flight at once to any one host.  Must be at least 1.
+ @returns The new governor.
+ */
+-(instancetype)initAdaptiveWithMinimumRequests:(NSUInteger)minimumRequests maximumRequests:(NSUInteger)maximumRequests maximumRequestsPerHost:(NSUInteger)maximumRequestsPerHost AZS_DESIGNATED_INITIALIZER;
+
+/** The number of requests currently admitted to one host.
+
+ @param host The host name, as it appears in the request URL.
+ @returns The number of requests in flight to the host.
+ */
+-(NSUInteger)inFlightRequestsForHost:(NSString *)host;
+
+/** Clears the admitted and delayed counts, the wait times, the peaks and the decrease count.  Requests in flight or
+ waiting, and the current limit, are not affected.*/
+-(void)resetStatistics;
+
+// The methods below are used by the library to admit requests.
+
+/** Admits a request to a host, or queues it until it can be admitted.
+
+ @param host The host the request will be sent to.
+ @param priority The priority of the request while it waits.
+ @param handler Called once the request is admitted.  If the request can be admitted immediately, the handler is called
+ before this method returns; otherwise, it is called later on a global dispatch queue.  Each admission must be balanced
+ by a call to releaseSlotForHost: once the request completes.
+ @returns A token identifying the waiting request, to pass to cancelWaiter:, or nil if the request was admitted
+ immediately.
+ */
+-(AZSNullable id)acquireSlotForHost:(NSString *)host priority:(AZSRequestPriority)priority handler:(void(^)())handler;
+
+/** Takes a request out of the queue, for a request whose operation was cancelled while it waited.
+ @param waiter The token returned by acquireSlotForHost:priority:handler:.
+ @returns YES if the request was still waiting, in which case its handler will never be called and the caller should
+ fail it with a cancellation error.  NO if it has already been admitted, in which case its handler will still be
+ called and its slot must still be given back.
+ */
+-(BOOL)cancelWaiter:(id)waiter;
+
+/** Admits a request to a host only if it can be admitted immediately, for optional requests that are not worth waiting
+ for.  Requests that are already waiting are never overtaken.  A YES must be balanced by a call to releaseSlotForHost:
+ once the request completes.
+
+ @param host The host the request will be sent to.
+ @returns YES if the request was admitted.
+ */
+-(BOOL)tryAcquireSlotForHost:(NSString *)host;
+
+/** Gives back a slot taken by acquireSlotForHost:priority:handler: or tryAcquireSlotForHost:, admitting waiting requests
+ if they now fit.
+
+ @param host The host the request was sent to.
+ */
+-(void)releaseSlotForHost:(NSString *)host;
+
+/** Gives back a slot, and lets an adaptive governor adjust its limit from the outcome of the request.
+
+ @param host The host the request was sent to.
+ @param result The result of the request, or nil if it was never sent.
+ */
+-(void)releaseSlotForHost:(NSString *)host result:(AZSNullable AZSRequestResult *)result;
+
+@end
+
+AZS_ASSUME_NONNULL_END
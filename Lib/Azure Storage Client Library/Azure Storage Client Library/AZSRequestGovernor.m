@@ -0,0 +1,357 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSRequestGovernor.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+
+#import "AZSRequestGovernor.h"
+#import "AZSRequestResult.h"
+
+// The number of healthy responses whose latencies make up one 99th percentile sample.
+#define AZSGovernorLatencyWindow 100
+
+// The weight of each new sample in the running latency baseline.
+static const double AZSGovernorBaselineWeight = 0.1;
+
+@interface AZSGovernorWaiter : NSObject
+
+@property (copy) NSString *host;
+@property (copy) void(^handler)();
+@property NSTimeInterval enqueueTime;
+
+@end
+
+@implementation AZSGovernorWaiter
+
+@end
+
+@interface AZSRequestGovernor()
+{
+    // The adaptive limit is fractional, so that it can grow by a fraction of a request per response.
+    double _limit;
+    NSTimeInterval _latencies[AZSGovernorLatencyWindow];
+    NSUInteger _latencyCount;
+    NSTimeInterval _baselineLatency;
+    NSTimeInterval _lastDecreaseTime;
+}
+
+// One FIFO queue per AZSRequestPriority, indexed by its value.
+@property (strong) NSArray *waiters;
+@property (strong) NSMutableDictionary *inFlightByHost;
+@property (readwrite) NSUInteger inFlightRequests;
+@property (readwrite) NSUInteger waitingRequests;
+@property (readwrite) NSUInteger peakInFlightRequests;
+@property (readwrite) NSUInteger peakWaitingRequests;
+@property (readwrite) uint64_t admittedRequests;
+@property (readwrite) uint64_t delayedRequests;
+@property (readwrite) NSTimeInterval totalWaitTime;
+@property (readwrite) NSTimeInterval maximumWaitTime;
+@property (readwrite) uint64_t limitDecreases;
+
+@end
+
+@implementation AZSRequestGovernor
+
+-(instancetype)init
+{
+    return nil;
+}
+
+-(instancetype)initWithMaximumRequests:(NSUInteger)maximumRequests maximumRequestsPerHost:(NSUInteger)maximumRequestsPerHost
+{
+    self = [super init];
+    if (self)
+    {
+        _maximumRequests = MAX(maximumRequests, (NSUInteger)1);
+        _minimumRequests = _maximumRequests;
+        _maximumRequestsPerHost = MAX(maximumRequestsPerHost, (NSUInteger)1);
+        _adaptive = NO;
+        _limit = _maximumRequests;
+        _decreaseFactor = 0.5;
+        _latencyThreshold = 2.0;
+        _waiters = @[[NSMutableArray array], [NSMutableArray array], [NSMutableArray array]];
+        _inFlightByHost = [NSMutableDictionary dictionary];
+    }
+
+    return self;
+}
+
+-(instancetype)initAdaptiveWithMinimumRequests:(NSUInteger)minimumRequests maximumRequests:(NSUInteger)maximumRequests maximumRequestsPerHost:(NSUInteger)maximumRequestsPerHost
+{
+    self = [super init];
+    if (self)
+    {
+        _minimumRequests = MAX(minimumRequests, (NSUInteger)1);
+        _maximumRequests = MAX(maximumRequests, _minimumRequests);
+        _maximumRequestsPerHost = MAX(maximumRequestsPerHost, (NSUInteger)1);
+        _adaptive = YES;
+        _limit = _minimumRequests;
+        _decreaseFactor = 0.5;
+        _latencyThreshold = 2.0;
+        _waiters = @[[NSMutableArray array], [NSMutableArray array], [NSMutableArray array]];
+        _inFlightByHost = [NSMutableDictionary dictionary];
+    }
+
+    return self;
+}
+
+-(NSUInteger)currentLimit
+{
+    @synchronized(self)
+    {
+        return (NSUInteger)_limit;
+    }
+}
+
+-(NSUInteger)inFlightRequestsForHost:(NSString *)host
+{
+    @synchronized(self)
+    {
+        return [self.inFlightByHost[host] unsignedIntegerValue];
+    }
+}
+
+-(void)resetStatistics
+{
+    @synchronized(self)
+    {
+        self.peakInFlightRequests = self.inFlightRequests;
+        self.peakWaitingRequests = self.waitingRequests;
+        self.admittedRequests = 0;
+        self.delayedRequests = 0;
+        self.totalWaitTime = 0;
+        self.maximumWaitTime = 0;
+        self.limitDecreases = 0;
+    }
+}
+
+// Must be called with the lock held.
+-(BOOL)canAdmitToHost:(NSString *)host
+{
+    return self.inFlightRequests < (NSUInteger)_limit && [self.inFlightByHost[host] unsignedIntegerValue] < self.maximumRequestsPerHost;
+}
+
+// Must be called with the lock held.
+-(void)admitToHost:(NSString *)host
+{
+    self.inFlightByHost[host] = @([self.inFlightByHost[host] unsignedIntegerValue] + 1);
+    self.inFlightRequests++;
+    self.peakInFlightRequests = MAX(self.peakInFlightRequests, self.inFlightRequests);
+    self.admittedRequests++;
+}
+
+-(BOOL)tryAcquireSlotForHost:(NSString *)host
+{
+    @synchronized(self)
+    {
+        // Requests that are already waiting go first.
+        if ((self.waitingRequests == 0) && [self canAdmitToHost:host])
+        {
+            [self admitToHost:host];
+            return YES;
+        }
+        return NO;
+    }
+}
+
+-(id)acquireSlotForHost:(NSString *)host priority:(AZSRequestPriority)priority handler:(void(^)())handler
+{
+    @synchronized(self)
+    {
+        // releaseSlotForHost: admits every waiter that fits, so a request that fits now is not overtaking anyone.
+        if ([self canAdmitToHost:host])
+        {
+            [self admitToHost:host];
+        }
+        else
+        {
+            AZSGovernorWaiter *waiter = [[AZSGovernorWaiter alloc] init];
+            waiter.host = host;
+            waiter.handler = handler;
+            waiter.enqueueTime = [NSDate timeIntervalSinceReferenceDate];
+            NSInteger queueIndex = MIN(MAX(priority, AZSRequestPriorityLow), AZSRequestPriorityHigh);
+            [self.waiters[queueIndex] addObject:waiter];
+            self.waitingRequests++;
+            self.peakWaitingRequests = MAX(self.peakWaitingRequests, self.waitingRequests);
+            return waiter;
+        }
+    }
+
+    handler();
+    return nil;
+}
+
+-(BOOL)cancelWaiter:(id)waiter
+{
+    @synchronized(self)
+    {
+        for (NSMutableArray *queue in self.waiters)
+        {
+            NSUInteger waiterIndex = [queue indexOfObjectIdenticalTo:waiter];
+            if (waiterIndex != NSNotFound)
+            {
+                [queue removeObjectAtIndex:waiterIndex];
+                self.waitingRequests--;
+                return YES;
+            }
+        }
+        return NO;
+    }
+}
+
+// Must be called with the lock held.
+-(void)decreaseLimit
+{
+    _limit = MAX(_limit * MIN(MAX(self.decreaseFactor, 0.0), 1.0), (double)self.minimumRequests);
+    _lastDecreaseTime = [NSDate timeIntervalSinceReferenceDate];
+    self.limitDecreases++;
+}
+
+// Must be called with the lock held.  Returns YES once a full window's 99th percentile has risen past the threshold.
+-(BOOL)recordLatency:(NSTimeInterval)latency
+{
+    _latencies[_latencyCount++] = latency;
+    if (_latencyCount < AZSGovernorLatencyWindow)
+    {
+        return NO;
+    }
+    _latencyCount = 0;
+
+    NSTimeInterval sorted[AZSGovernorLatencyWindow];
+    memcpy(sorted, _latencies, sizeof(sorted));
+    qsort_b(sorted, AZSGovernorLatencyWindow, sizeof(NSTimeInterval), ^int(const void *a, const void *b) {
+        NSTimeInterval x = *(const NSTimeInterval *)a;
+        NSTimeInterval y = *(const NSTimeInterval *)b;
+        return (x > y) - (x < y);
+    });
+    NSTimeInterval p99 = sorted[(AZSGovernorLatencyWindow * 99 + 99) / 100 - 1];
+
+    if (_baselineLatency == 0)
+    {
+        _baselineLatency = p99;
+        return NO;
+    }
+
+    // The baseline follows sustained changes, so a lasting shift in latency does not pin the limit at its minimum.
+    BOOL rising = p99 > _baselineLatency * self.latencyThreshold;
+    _baselineLatency += (p99 - _baselineLatency) * AZSGovernorBaselineWeight;
+    return rising;
+}
+
+// Must be called with the lock held.
+-(void)adjustLimitWithResult:(AZSRequestResult *)result inFlight:(NSUInteger)inFlight
+{
+    // A request sent before the last decrease reflects the load from before it.
+    if ([result.startTime timeIntervalSinceReferenceDate] < _lastDecreaseTime)
+    {
+        return;
+    }
+
+    NSInteger statusCode = result.response.statusCode;
+    if (statusCode == 500 || statusCode == 503)
+    {
+        [self decreaseLimit];
+        return;
+    }
+
+    // Other failures say nothing about the load on the account.
+    if (statusCode == 0 || statusCode >= 500)
+    {
+        return;
+    }
+
+    if (self.latencyThreshold > 0)
+    {
+        NSTimeInterval latency = result.networkMetricsAvailable ? result.timeToFirstByte : [result.endTime timeIntervalSinceDate:result.startTime];
+        if ([self recordLatency:latency])
+        {
+            [self decreaseLimit];
+            return;
+        }
+    }
+
+    // Only raise a limit that is actually being reached; otherwise it would grow without evidence that it is safe.
+    if (inFlight >= (NSUInteger)_limit)
+    {
+        _limit = MIN(_limit + 1.0 / _limit, (double)self.maximumRequests);
+    }
+}
+
+-(void)releaseSlotForHost:(NSString *)host
+{
+    [self releaseSlotForHost:host result:nil];
+}
+
+-(void)releaseSlotForHost:(NSString *)host result:(AZSRequestResult *)result
+{
+    NSMutableArray *admitted = [NSMutableArray array];
+    @synchronized(self)
+    {
+        NSUInteger hostCount = [self.inFlightByHost[host] unsignedIntegerValue];
+        if (hostCount == 0)
+        {
+            return;
+        }
+        if (hostCount == 1)
+        {
+            [self.inFlightByHost removeObjectForKey:host];
+        }
+        else
+        {
+            self.inFlightByHost[host] = @(hostCount - 1);
+        }
+        NSUInteger inFlight = self.inFlightRequests;
+        self.inFlightRequests--;
+
+        if (self.adaptive && result)
+        {
+            [self adjustLimitWithResult:result inFlight:inFlight];
+        }
+
+        // Admit as many waiters as now fit, highest priority first.
+        NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+        for (NSInteger queueIndex = AZSRequestPriorityHigh; queueIndex >= AZSRequestPriorityLow && self.inFlightRequests < (NSUInteger)_limit; queueIndex--)
+        {
+            NSMutableArray *queue = self.waiters[queueIndex];
+            NSUInteger waiterIndex = 0;
+            while (waiterIndex < queue.count && self.inFlightRequests < (NSUInteger)_limit)
+            {
+                AZSGovernorWaiter *waiter = queue[waiterIndex];
+                if (![self canAdmitToHost:waiter.host])
+                {
+                    waiterIndex++;
+                    continue;
+                }
+
+                [queue removeObjectAtIndex:waiterIndex];
+                self.waitingRequests--;
+                [self admitToHost:waiter.host];
+                self.delayedRequests++;
+                NSTimeInterval waitTime = now - waiter.enqueueTime;
+                self.totalWaitTime += waitTime;
+                self.maximumWaitTime = MAX(self.maximumWaitTime, waitTime);
+                [admitted addObject:waiter];
+            }
+        }
+    }
+
+    // Handlers go on to build and send their requests, so they are not run on the thread that completed this one.
+    for (AZSGovernorWaiter *waiter in admitted)
+    {
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), waiter.handler);
+    }
+}
+
+@end
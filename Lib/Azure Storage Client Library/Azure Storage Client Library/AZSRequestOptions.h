@@ -43,9 +43,20 @@ AZS_ASSUME_NONNULL_BEGIN
 @property (copy, readonly, AZSNullable) NSDate *operationExpiryTime;
 
 /** The server timeout to send with the request(s).
- If the Storage Service takes longer than this for a single request, that request will timeout.*/
+ If the Storage Service takes longer than this for a single request, that request will timeout.  A request is never
+ given longer than the time left before the operation's maximumExecutionTime runs out.*/
 @property NSTimeInterval serverTimeout;
 
+/** The longest a single request may wait for response headers, in seconds, including the time to connect and to send
+ the request body.  A request that takes longer is abandoned and may be retried.  Defaults to 0, which leaves requests
+ limited only by maximumExecutionTime.*/
+@property NSTimeInterval responseTimeout;
+
+/** The longest a single request may go without receiving any of the response body, in seconds.  A request that stalls
+ for longer is abandoned and may be retried.  Time spent waiting for a slow destination stream does not count.  Defaults
+ to 0, which leaves requests limited only by maximumExecutionTime.*/
+@property NSTimeInterval idleTimeout;
+
 /** The maximum amount of data that the library will buffer on download.  If the library is downloading data to an input stream 
  (on a DownloadBlobToStream call, for example), and the stream temporarily does not have enough space, the library will buffer up to this much data.*/
 @property NSUInteger maximumDownloadBufferSize;
@@ -71,6 +82,10 @@ AZS_ASSUME_NONNULL_BEGIN
 
 @property AZSStorageLocationMode storageLocationMode;
 
+/** The priority of this operation's requests while they wait for the client's AZSRequestGovernor.  Has no effect if the
+ client has no requestGovernor.  Defaults to AZSRequestPriorityNormal.*/
+@property AZSRequestPriority requestPriority;
+
 /** Initializes a new AZSRequestOptions object.
  Once the object is initialized, individual properties can be set.*/
 -(instancetype)init AZS_DESIGNATED_INITIALIZER;
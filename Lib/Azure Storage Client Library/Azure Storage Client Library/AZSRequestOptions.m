@@ -22,9 +22,12 @@
 {
     BOOL _runLoopForDownloadSet;
     BOOL _serverTimeoutSet;
+    BOOL _responseTimeoutSet;
+    BOOL _idleTimeoutSet;
     BOOL _maximumDownloadBufferSizeSet;
     BOOL _maximumExecutionTimeSet;
     BOOL _storageLocationModeSet;
+    BOOL _requestPrioritySet;
 }
 
 -(AZSRequestOptions *)copy;
@@ -35,10 +38,13 @@
 
 @synthesize runLoopForDownload = _runLoopForDownload;
 @synthesize serverTimeout = _serverTimeout;
+@synthesize responseTimeout = _responseTimeout;
+@synthesize idleTimeout = _idleTimeout;
 @synthesize maximumDownloadBufferSize = _maximumDownloadBufferSize;
 @synthesize maximumExecutionTime = _maximumExecutionTime;
 @synthesize operationExpiryTime = _operationExpiryTime;
 @synthesize storageLocationMode = _storageLocationMode;
+@synthesize requestPriority = _requestPriority;
 
 -(instancetype)init
 {
@@ -49,12 +55,18 @@
         _runLoopForDownloadSet = NO;
         _serverTimeout = 30;
         _serverTimeoutSet = NO;
+        _responseTimeout = 0;
+        _responseTimeoutSet = NO;
+        _idleTimeout = 0;
+        _idleTimeoutSet = NO;
         _maximumDownloadBufferSize = AZSCKilobyte * AZSCKilobyte;
         _maximumDownloadBufferSizeSet = NO;
         _maximumExecutionTime = 600.0;
         _maximumExecutionTimeSet = NO;
         _storageLocationMode = AZSStorageLocationModePrimaryOnly;
         _storageLocationModeSet = NO;
+        _requestPriority = AZSRequestPriorityNormal;
+        _requestPrioritySet = NO;
     }
     
     return self;
@@ -93,6 +105,16 @@
             self.serverTimeout = sourceOptions.serverTimeout;
         }
         
+        if (sourceOptions->_responseTimeoutSet)
+        {
+            self.responseTimeout = sourceOptions.responseTimeout;
+        }
+        
+        if (sourceOptions->_idleTimeoutSet)
+        {
+            self.idleTimeout = sourceOptions.idleTimeout;
+        }
+        
         if (sourceOptions->_maximumDownloadBufferSizeSet)
         {
             self.maximumDownloadBufferSize = sourceOptions.maximumDownloadBufferSize;
@@ -108,6 +130,11 @@
             self.storageLocationMode = sourceOptions.storageLocationMode;
         }
         
+        if (sourceOptions->_requestPrioritySet)
+        {
+            self.requestPriority = sourceOptions.requestPriority;
+        }
+        
         _operationExpiryTime = [NSDate dateWithTimeIntervalSinceNow:self.maximumExecutionTime];
     }
     
@@ -136,6 +163,28 @@
     _serverTimeoutSet = YES;
 }
 
+-(NSTimeInterval)responseTimeout
+{
+    return _responseTimeout;
+}
+
+-(void)setResponseTimeout:(NSTimeInterval)responseTimeout
+{
+    _responseTimeout = responseTimeout;
+    _responseTimeoutSet = YES;
+}
+
+-(NSTimeInterval)idleTimeout
+{
+    return _idleTimeout;
+}
+
+-(void)setIdleTimeout:(NSTimeInterval)idleTimeout
+{
+    _idleTimeout = idleTimeout;
+    _idleTimeoutSet = YES;
+}
+
 -(NSUInteger)maximumDownloadBufferSize
 {
     return _maximumDownloadBufferSize;
@@ -169,4 +218,15 @@
     _storageLocationModeSet = YES;
 }
 
+-(AZSRequestPriority)requestPriority
+{
+    return _requestPriority;
+}
+
+-(void)setRequestPriority:(AZSRequestPriority)requestPriority
+{
+    _requestPriority = requestPriority;
+    _requestPrioritySet = YES;
+}
+
 @end
\ No newline at end of file
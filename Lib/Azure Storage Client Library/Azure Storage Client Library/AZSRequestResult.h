@@ -59,6 +59,9 @@ AZS_ASSUME_NONNULL_BEGIN
  Note that this is not the MD5 calculated by the library.*/
 @property (copy, AZSNullable) NSString *contentReceivedMD5;
 
+/** The x-ms-content-crc64 header of the response, if present.*/
+@property (copy, AZSNullable) NSString *contentReceivedCRC64;
+
 /** The etag in the response, if present.*/
 @property (copy, AZSNullable) NSString *etag;
 
@@ -69,8 +72,49 @@ AZS_ASSUME_NONNULL_BEGIN
  This is unrelated to the Content-MD5 header of the request.*/
 @property (copy, AZSNullable) NSString *calculatedResponseMD5;
 
+/** The CRC64 that was calculated for the response to this request, if known.*/
+@property (copy, AZSNullable) NSString *calculatedResponseCRC64;
+
 // TODO: Should we also include the uploaded MD5?
 
+/** YES if the network phase timings below were collected for this request.
+ Timings come from NSURLSessionTaskMetrics, and are only available on iOS 10 and OS X 10.12 or later.*/
+@property BOOL networkMetricsAvailable;
+
+/** The time spent on the DNS lookup, or 0 if there was none (for example, on a reused connection).*/
+@property NSTimeInterval domainLookupDuration;
+
+/** The time spent establishing the TCP connection, not including the TLS handshake, or 0 on a reused connection.*/
+@property NSTimeInterval connectDuration;
+
+/** The time spent on the TLS handshake, or 0 for HTTP or on a reused connection.*/
+@property NSTimeInterval secureConnectionDuration;
+
+/** The time spent sending the request headers and body.*/
+@property NSTimeInterval requestSendDuration;
+
+/** The time from the end of the request to the first byte of the response; mostly time spent in the service.*/
+@property NSTimeInterval timeToFirstByte;
+
+/** The time spent receiving the response, from its first byte to its last.*/
+@property NSTimeInterval responseTransferDuration;
+
+/** Whether the request was sent on a connection left open by an earlier request.*/
+@property BOOL reusedConnection;
+
+/** The number of request body bytes sent.*/
+@property int64_t bytesSent;
+
+/** The number of response body bytes received.*/
+@property int64_t bytesReceived;
+
+/** The duration of one phase of this request.
+ 
+ @param phase The phase to return.
+ @returns The duration of the phase, in seconds.  0 if the phase did not occur or network metrics were not collected.
+ */
+-(NSTimeInterval) durationOfPhase:(AZSRequestPhase)phase;
+
 -(instancetype) initWithStartTime:(NSDate *)startTime location:(AZSStorageLocation)currentLocation AZS_DESIGNATED_INITIALIZER;
 -(instancetype) initWithStartTime:(NSDate *)startTime location:(AZSStorageLocation)currentLocation response:(NSHTTPURLResponse * __AZSNullable)response error:(NSError * __AZSNullable)error AZS_DESIGNATED_INITIALIZER;
 @end
@@ -18,6 +18,7 @@
 #include <time.h>
 #import "AZSConstants.h"
 #import "AZSRequestResult.h"
+#import "AZSUtil.h"
 
 @interface AZSRequestResult()
 
@@ -65,18 +66,39 @@
         }
         
         _contentReceivedMD5 = response.allHeaderFields[AZSCContentMd5];
+        _contentReceivedCRC64 = response.allHeaderFields[AZSCHeaderContentCrc64];
         _etag = response.allHeaderFields[AZSCXmlETag];
         
         if (response.allHeaderFields[AZSCHeaderValueDate])
         {
-            const char * dateString = [response.allHeaderFields[AZSCHeaderValueDate] UTF8String];
-            struct tm timeptr;
-            strptime(dateString, [AZSCDateFormatColloquial UTF8String], &timeptr);
-            _serviceRequestDate = [NSDate dateWithTimeIntervalSince1970:mktime(&timeptr)];
+            _serviceRequestDate = [AZSUtil dateFromHttpString:response.allHeaderFields[AZSCHeaderValueDate]];
         }
     }
     
     return self;
 }
 
+-(NSTimeInterval) durationOfPhase:(AZSRequestPhase)phase
+{
+    switch (phase)
+    {
+        case AZSRequestPhaseDomainLookup:
+            return self.domainLookupDuration;
+        case AZSRequestPhaseConnect:
+            return self.connectDuration;
+        case AZSRequestPhaseSecureConnection:
+            return self.secureConnectionDuration;
+        case AZSRequestPhaseRequestSend:
+            return self.requestSendDuration;
+        case AZSRequestPhaseTimeToFirstByte:
+            return self.timeToFirstByte;
+        case AZSRequestPhaseResponseTransfer:
+            return self.responseTransferDuration;
+        case AZSRequestPhaseTotal:
+            return [self.endTime timeIntervalSinceDate:self.startTime];
+        default:
+            return 0;
+    }
+}
+
 @end
\ No newline at end of file
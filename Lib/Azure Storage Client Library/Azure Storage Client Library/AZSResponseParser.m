@@ -19,6 +19,7 @@
 #import "AZSResponseParser.h"
 #import "AZSErrors.h"
 #import "AZSOperationContext.h"
+#import "AZSLogging.h"
 
 @implementation AZSStorageXMLParserDelegate
 
@@ -80,7 +81,7 @@
     
     parserDelegate.parseBeginElement = ^(NSXMLParser *parser, NSString *elementName,NSDictionary *attributeDict)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Beginning to parse element with name = %@", elementName];
+        AZSLogDebug(operationContext, @"Beginning to parse element with name = %@", elementName);
         [elementStack addObject:elementName];
         if ([builder length] > 0)
         {
@@ -90,7 +91,7 @@
     
     parserDelegate.parseEndElement = ^(NSXMLParser *parser, NSString *elementName)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Ending to parse element with name = %@", elementName];
+        AZSLogDebug(operationContext, @"Ending to parse element with name = %@", elementName);
         NSString *currentNode = elementStack.lastObject;
         [elementStack removeLastObject];
         
@@ -124,7 +125,7 @@
     
     parserDelegate.foundCharacters = ^(NSXMLParser *parser, NSString *characters)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Found characters = %@", characters];
+        AZSLogDebug(operationContext, @"Found characters = %@", characters);
         [builder appendString:characters];
     };
     
@@ -136,7 +137,7 @@
 
     if (!parseSuccessful)
     {
-        [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Parse unsuccessful."];
+        AZSLogDebug(operationContext, @"Parse unsuccessful.");
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEParseError userInfo:@{@"InnerError":*errorToPopulate}];
     }
     
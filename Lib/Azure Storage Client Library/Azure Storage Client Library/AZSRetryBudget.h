@@ -0,0 +1,79 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSRetryBudget.h" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+
+#import <Foundation/Foundation.h>
+#import "AZSMacros.h"
+
+AZS_ASSUME_NONNULL_BEGIN
+
+/** An AZSRetryBudget caps the retries a client makes as a fraction of its requests, so that retries cannot multiply the
+ load on a service that is already failing.
+
+ The budget is a token bucket.  Each new request (not a retry) adds retryRatio tokens, up to maximumTokens, and each
+ retry spends one.  When the bucket is empty, retries are refused, and the operation fails with the error from its
+ last attempt, however many attempts its retry policy would still allow.  Over time, retries are therefore held to
+ about retryRatio of requests, while the tokens the bucket starts with allow short bursts beyond that.
+
+ Assign a budget to the retryBudget property of an AZSCloudBlobClient.  A budget may be shared between clients, and is
+ safe to use from any thread.
+ */
+@interface AZSRetryBudget : NSObject
+
+/** The tokens each new request adds to the bucket; the long-run fraction of requests that may be retried.*/
+@property (readonly) double retryRatio;
+
+/** The most tokens the bucket holds.  The bucket starts full.*/
+@property (readonly) double maximumTokens;
+
+/** The tokens currently in the bucket.*/
+@property (readonly) double availableTokens;
+
+/** The number of retries the budget has allowed.*/
+@property (readonly) uint64_t retriesAllowed;
+
+/** The number of retries the budget has refused.*/
+@property (readonly) uint64_t retriesRefused;
+
+/** Initializes a new AZSRetryBudget that allows retries for 10% of requests, with bursts of up to 10 retries.
+
+ @return The new budget.
+ */
+-(instancetype)init;
+
+/** Initializes a new AZSRetryBudget.
+
+ @param retryRatio The tokens each new request adds; the long-run fraction of requests that may be retried.
+ @param maximumTokens The most tokens the bucket holds, and the number it starts with.
+ @return The new budget.
+ */
+-(instancetype)initWithRetryRatio:(double)retryRatio maximumTokens:(double)maximumTokens AZS_DESIGNATED_INITIALIZER;
+
+// The methods below are used by the library to account for requests.
+
+/** Records a new request, adding retryRatio tokens to the bucket.*/
+-(void)recordRequest;
+
+/** Spends a token for a retry, if one is available.
+
+ @returns YES if the retry may go ahead.
+ */
+-(BOOL)tryAcquireRetry;
+
+@end
+
+AZS_ASSUME_NONNULL_END
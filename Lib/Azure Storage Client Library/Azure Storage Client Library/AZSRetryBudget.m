@@ -0,0 +1,73 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSRetryBudget.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+
+#import "AZSRetryBudget.h"
+
+@interface AZSRetryBudget()
+
+@property (readwrite) double availableTokens;
+@property (readwrite) uint64_t retriesAllowed;
+@property (readwrite) uint64_t retriesRefused;
+
+@end
+
+@implementation AZSRetryBudget
+
+-(instancetype)init
+{
+    return [self initWithRetryRatio:0.1 maximumTokens:10];
+}
+
+-(instancetype)initWithRetryRatio:(double)retryRatio maximumTokens:(double)maximumTokens
+{
+    self = [super init];
+    if (self)
+    {
+        _retryRatio = MAX(retryRatio, 0);
+        _maximumTokens = MAX(maximumTokens, 1);
+        _availableTokens = _maximumTokens;
+    }
+
+    return self;
+}
+
+-(void)recordRequest
+{
+    @synchronized(self)
+    {
+        self.availableTokens = MIN(self.availableTokens + self.retryRatio, self.maximumTokens);
+    }
+}
+
+-(BOOL)tryAcquireRetry
+{
+    @synchronized(self)
+    {
+        if (self.availableTokens < 1)
+        {
+            self.retriesRefused++;
+            return NO;
+        }
+
+        self.availableTokens -= 1;
+        self.retriesAllowed++;
+        return YES;
+    }
+}
+
+@end
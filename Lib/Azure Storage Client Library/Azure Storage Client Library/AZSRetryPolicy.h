@@ -16,6 +16,7 @@
 // -----------------------------------------------------------------------------------------
 
 #import <Foundation/Foundation.h>
+#import "AZSEnums.h"
 #import "AZSMacros.h"
 
 AZS_ASSUME_NONNULL_BEGIN
@@ -116,4 +117,49 @@ AZS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/** A retry policy with randomized exponential backoff, which keeps many clients that fail together from retrying together.
+ 
+ AZSRetryPolicyExponential varies each wait by at most 20%, so operations that fail at the same moment retry at nearly the
+ same moment, and the service sees the same burst again.  This policy spreads the retries out instead:
+ 
+ - AZSRetryJitterModeFull waits a random time between 0 and baseDelay * 2^(retry count - 1), capped at maximumDelay.
+ - AZSRetryJitterModeDecorrelated waits a random time between baseDelay and three times the previous wait, capped at
+ maximumDelay.  Waits still grow quickly, but do not line up with the retry count.
+ 
+ Which responses are retried is decided as for the other policies.  If the response carries a Retry-After header, the
+ policy waits at least that long.
+ */
+@interface AZSRetryPolicyJittered : NSObject <AZSRetryPolicy>
+
+/** The maximum number of retries the policy will allow.*/
+@property NSInteger maxAttempts;
+
+/** The scale of the first wait.  See the class description.*/
+@property NSTimeInterval baseDelay;
+
+/** The longest the policy will wait before a retry, unless the service asks for longer with Retry-After.*/
+@property NSTimeInterval maximumDelay;
+
+/** How the wait is randomized.*/
+@property AZSRetryJitterMode jitterMode;
+
+/** Initializes a fresh instance of the jittered retry policy, with 3 attempts, full jitter, a base delay of 2 seconds and a
+ maximum delay of 120 seconds.
+ 
+ @return The newly allocated instance.
+ */
+-(instancetype)init;
+
+/** Initializes a fresh instance of the jittered retry policy.
+ 
+ @param maxAttempts The maximum number of retries the policy will allow.
+ @param baseDelay The scale of the first wait.
+ @param maximumDelay The longest the policy will wait before a retry, unless the service asks for longer.
+ @param jitterMode How the wait is randomized.
+ @return The newly allocated instance.
+ */
+-(instancetype)initWithMaxAttempts:(NSInteger)maxAttempts baseDelay:(NSTimeInterval)baseDelay maximumDelay:(NSTimeInterval)maximumDelay jitterMode:(AZSRetryJitterMode)jitterMode AZS_DESIGNATED_INITIALIZER;
+
+@end
+
 AZS_ASSUME_NONNULL_END
\ No newline at end of file
@@ -19,6 +19,8 @@
 #import "AZSRetryInfo.h"
 #import "AZSRetryContext.h"
 #import "AZSRequestResult.h"
+#import "AZSConstants.h"
+#import "AZSUtil.h"
 
 @interface AZSRetryPolicyUtil : NSObject
 
@@ -231,4 +233,103 @@
     return [[AZSRetryPolicyExponential alloc] initWithMaxAttempts:self.maxAttempts averageBackoffDelta:self.averageBackoffDelta];
 }
 
-@end
\ No newline at end of file
+@end
+
+@interface AZSRetryPolicyJittered()
+
+@property NSDate *lastPrimaryAttempt;
+@property NSDate *lastSecondaryAttempt;
+@property NSTimeInterval previousDelay;
+
+@end
+
+@implementation AZSRetryPolicyJittered
+
+-(instancetype)init
+{
+    return [self initWithMaxAttempts:3 baseDelay:2 maximumDelay:120 jitterMode:AZSRetryJitterModeFull];
+}
+
+-(instancetype)initWithMaxAttempts:(NSInteger)maxAttempts baseDelay:(NSTimeInterval)baseDelay maximumDelay:(NSTimeInterval)maximumDelay jitterMode:(AZSRetryJitterMode)jitterMode
+{
+    self = [super init];
+    if (self)
+    {
+        _maxAttempts = maxAttempts;
+        _baseDelay = baseDelay;
+        _maximumDelay = maximumDelay;
+        _jitterMode = jitterMode;
+        _previousDelay = 0;
+        _lastPrimaryAttempt = nil;
+        _lastSecondaryAttempt = nil;
+    }
+    return self;
+}
+
+// A uniformly distributed value between low and high.
+static double AZSRandomBetween(double low, double high)
+{
+    return low + (((double)arc4random()) / 0x100000000LL) * (high - low);
+}
+
+// The wait the service asked for in a Retry-After header, given either in seconds or as an HTTP date, or 0 if none.
+static NSTimeInterval AZSRetryAfterInterval(NSHTTPURLResponse *response)
+{
+    NSString *retryAfter = response.allHeaderFields[AZSCHeaderRetryAfter];
+    if (retryAfter.length == 0)
+    {
+        return 0;
+    }
+    
+    NSScanner *scanner = [NSScanner scannerWithString:retryAfter];
+    double seconds;
+    if ([scanner scanDouble:&seconds] && scanner.isAtEnd)
+    {
+        return MAX(seconds, 0);
+    }
+    
+    NSDate *retryDate = [AZSUtil dateFromHttpString:retryAfter];
+    return retryDate ? MAX([retryDate timeIntervalSinceNow], 0) : 0;
+}
+
+-(AZSRetryInfo *)evaluateRetryContext:(AZSRetryContext *)retryContext withOperationContext:(AZSOperationContext *)operationContext
+{
+    AZSRetryInfo *retryInfo = [AZSRetryPolicyUtil evaluateRetryContext:retryContext maxAttempts:self.maxAttempts lastPrimaryAttempt:&_lastPrimaryAttempt lastSecondaryAttempt:&_lastSecondaryAttempt];
+    if (retryInfo.shouldRetry)
+    {
+        NSTimeInterval delay;
+        switch (self.jitterMode)
+        {
+            case AZSRetryJitterModeDecorrelated:
+            {
+                NSTimeInterval previousDelay = MAX(self.previousDelay, self.baseDelay);
+                delay = AZSRandomBetween(self.baseDelay, previousDelay * 3);
+                break;
+            }
+            case AZSRetryJitterModeFull:
+            default:
+            {
+                // Past 2^30 the cap applies anyway.
+                double backoff = self.baseDelay * pow(2, MIN(MAX(retryContext.currentRetryCount - 1, 0), 30));
+                delay = AZSRandomBetween(0, MIN(backoff, self.maximumDelay));
+                break;
+            }
+        }
+        delay = MIN(delay, self.maximumDelay);
+        self.previousDelay = delay;
+        
+        retryInfo.retryInterval = delay;
+        [AZSRetryPolicyUtil alignRetryIntervalWithRetryInfo:retryInfo lastPrimaryAttempt:&_lastPrimaryAttempt lastSecondaryAttempt:&_lastSecondaryAttempt];
+        
+        // The service's own estimate of when it can take the request wins over the randomized wait.
+        retryInfo.retryInterval = MAX(retryInfo.retryInterval, AZSRetryAfterInterval(retryContext.lastRequestResult.response));
+    }
+    return retryInfo;
+}
+
+-(id<AZSRetryPolicy>)clone
+{
+    return [[AZSRetryPolicyJittered alloc] initWithMaxAttempts:self.maxAttempts baseDelay:self.baseDelay maximumDelay:self.maximumDelay jitterMode:self.jitterMode];
+}
+
+@end
@@ -45,4 +45,8 @@
 
 +(AZSSharedAccessPermissions)permissionsFromString:(NSString *)permissionString error:(NSError **)error;
 
+// Protocols
+
++(NSString *)stringFromProtocols:(AZSSharedAccessProtocols)protocols error:(NSError **)error;
+
 @end
\ No newline at end of file
@@ -28,6 +28,7 @@
 #import "AZSUtil.h"
 #import "AZSStorageCredentials.h"
 #import "AZSUriQueryBuilder.h"
+#import "AZSLogging.h"
 
 @implementation AZSSharedAccessSignatureHelper
 
@@ -40,7 +41,7 @@
 {
     if (!resourceType) {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-        [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Missing resourceType argument."];
+        AZSLogError([AZSUtil operationlessContext], @"Missing resourceType argument.");
         return nil;
     }
     
@@ -51,7 +52,7 @@
 {
     if (!accountName) {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-        [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Missing account name argument."];
+        AZSLogError([AZSUtil operationlessContext], @"Missing account name argument.");
         return nil;
     }
     
@@ -89,7 +90,7 @@
 {
     if (!signature) {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-        [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Missing signature argument."];
+        AZSLogError([AZSUtil operationlessContext], @"Missing signature argument.");
         return nil;
     }
     
@@ -149,11 +150,11 @@
 {
     if (!credentials) {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-        [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Client is missing credentials."];
+        AZSLogError([AZSUtil operationlessContext], @"Client is missing credentials.");
         return nil;
     }
     
-    [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelInfo withMessage:@"String To Sign:\n%@", stringToSign];
+    AZSLogInfo([AZSUtil operationlessContext], @"String To Sign:\n%@", stringToSign);
     
     /* TODO: Add AZSUtil safeDecode */;
     return [AZSUtil computeHmac256WithString:stringToSign credentials:credentials];
@@ -163,7 +164,7 @@
 {
     if (!resource) {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-        [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Missing resource argument."];
+        AZSLogError([AZSUtil operationlessContext], @"Missing resource argument.");
         return nil;
     }
     
@@ -189,7 +190,7 @@
             
         default:
             *error = (*error) ?: [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-            [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Unrecognized protocol restriction."];
+            AZSLogError([AZSUtil operationlessContext], @"Unrecognized protocol restriction.");
             return nil;
     }
 }
@@ -203,7 +204,7 @@
     
     if (services & ~AZSSharedAccessServicesAll) {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-        [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Unrecognized services argument."];
+        AZSLogError([AZSUtil operationlessContext], @"Unrecognized services argument.");
         return nil;
     }
     
@@ -233,7 +234,7 @@
     
     if (resourceTypes & ~AZSSharedAccessServicesAll) {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-        [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Unrecognized resource types argument."];
+        AZSLogError([AZSUtil operationlessContext], @"Unrecognized resource types argument.");
         return nil;
     }
     
@@ -260,7 +261,7 @@
     
     if (permissions & ~AZSSharedAccessPermissionsAll) {
         *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-        [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Unrecognized permissions argument."];
+        AZSLogError([AZSUtil operationlessContext], @"Unrecognized permissions argument.");
         return nil;
     }
     
@@ -314,7 +315,7 @@
         }
         else {
             *error = [NSError errorWithDomain:AZSErrorDomain code:AZSEInvalidArgument userInfo:nil];
-            [[AZSUtil operationlessContext] logAtLevel:AZSLogLevelError withMessage:@"Unrecognized permissions character."];
+            AZSLogError([AZSUtil operationlessContext], @"Unrecognized permissions character.");
             return NSUIntegerMax;
         }
     }
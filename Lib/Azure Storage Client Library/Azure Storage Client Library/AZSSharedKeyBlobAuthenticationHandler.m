@@ -16,7 +16,6 @@
 // -----------------------------------------------------------------------------------------
 
 #include <time.h>
-#include <xlocale.h>
 #import <CommonCrypto/CommonHMAC.h>
 #import "AZSAuthenticationHandler.h"
 #import "AZSConstants.h"
@@ -25,123 +24,355 @@
 #import "AZSEnums.h"
 #import "AZSOperationContext.h"
 #import "AZSUtil.h"
+#import "AZSLogging.h"
 
-@interface AZSSharedKeyBlobAuthenticationHandler()
+// The string to sign is built into a byte buffer that starts on the stack, so that signing a typical request
+// does not allocate.  It only moves to the heap for requests with unusually large headers or queries.
+typedef struct
+{
+    char *bytes;
+    size_t length;
+    size_t capacity;
+    char inlineStorage[2048];
+} AZSSigningBuffer;
 
--(instancetype)init AZS_DESIGNATED_INITIALIZER;
+static void AZSSigningBufferInit(AZSSigningBuffer *buffer)
+{
+    buffer->bytes = buffer->inlineStorage;
+    buffer->length = 0;
+    buffer->capacity = sizeof(buffer->inlineStorage);
+}
 
-@end
+static void AZSSigningBufferFree(AZSSigningBuffer *buffer)
+{
+    if (buffer->bytes != buffer->inlineStorage)
+    {
+        free(buffer->bytes);
+    }
+}
 
-@implementation AZSSharedKeyBlobAuthenticationHandler
+static char *AZSSigningBufferReserve(AZSSigningBuffer *buffer, size_t additionalLength)
+{
+    if (buffer->length + additionalLength > buffer->capacity)
+    {
+        size_t newCapacity = MAX(buffer->capacity * 2, buffer->length + additionalLength);
+        if (buffer->bytes == buffer->inlineStorage)
+        {
+            buffer->bytes = malloc(newCapacity);
+            memcpy(buffer->bytes, buffer->inlineStorage, buffer->length);
+        }
+        else
+        {
+            buffer->bytes = realloc(buffer->bytes, newCapacity);
+        }
+        buffer->capacity = newCapacity;
+    }
 
--(void) appendWithNewlineToString:(NSMutableString *)string stringToAppend:(NSString *)stringToAppend
+    return buffer->bytes + buffer->length;
+}
+
+static void AZSSigningBufferAppendBytes(AZSSigningBuffer *buffer, const char *bytes, size_t length)
+{
+    memcpy(AZSSigningBufferReserve(buffer, length), bytes, length);
+    buffer->length += length;
+}
+
+static inline void AZSSigningBufferAppendByte(AZSSigningBuffer *buffer, char byte)
 {
-    if (stringToAppend != nil)
+    *AZSSigningBufferReserve(buffer, 1) = byte;
+    buffer->length++;
+}
+
+static void AZSSigningBufferAppendString(AZSSigningBuffer *buffer, NSString *string)
+{
+    if (!string)
     {
-        [string appendString:stringToAppend];
+        return;
     }
-    [string appendString:@"\n"];
+
+    CFStringRef cfString = (__bridge CFStringRef)string;
+    CFIndex stringLength = CFStringGetLength(cfString);
+    CFIndex maximumLength = CFStringGetMaximumSizeForEncoding(stringLength, kCFStringEncodingUTF8);
+    CFIndex usedLength = 0;
+    CFStringGetBytes(cfString, CFRangeMake(0, stringLength), kCFStringEncodingUTF8, 0, false, (UInt8 *)AZSSigningBufferReserve(buffer, maximumLength), maximumLength, &usedLength);
+    buffer->length += usedLength;
 }
 
--(NSString *) getStringToSignWithRequest:(NSMutableURLRequest *)request operationContext:(AZSOperationContext *)operationContext
+static void AZSSigningBufferAppendLine(AZSSigningBuffer *buffer, NSString *string)
 {
-    NSMutableString *stringToSign = [[NSMutableString alloc] init];
-    
-    // VERB
-    [self appendWithNewlineToString:stringToSign stringToAppend:request.HTTPMethod];
-    
-    // Standard headers
-    [self appendWithNewlineToString:stringToSign stringToAppend:[request valueForHTTPHeaderField:AZSCContentEncoding]];
-    [self appendWithNewlineToString:stringToSign stringToAppend:[request valueForHTTPHeaderField:AZSCContentLanguage]];
-    
-    NSString *contentLengthValue = [request valueForHTTPHeaderField:AZSCContentLength];
-    if ([contentLengthValue isEqualToString:@"0"])
+    AZSSigningBufferAppendString(buffer, string);
+    AZSSigningBufferAppendByte(buffer, '\n');
+}
+
+static inline char AZSLowercaseASCII(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+}
+
+// Appends a percent-decoded copy of a query component, optionally lowercasing it.
+static void AZSSigningBufferAppendDecoded(AZSSigningBuffer *buffer, const char *bytes, size_t length, BOOL lowercase)
+{
+    char *destination = AZSSigningBufferReserve(buffer, length);
+    size_t written = AZSPercentDecode(bytes, length, (uint8_t *)destination);
+    if (lowercase)
     {
-        contentLengthValue = nil;
+        for (size_t i = 0; i < written; i++)
+        {
+            destination[i] = AZSLowercaseASCII(destination[i]);
+        }
     }
-    [self appendWithNewlineToString:stringToSign stringToAppend:contentLengthValue];
-    
-    [self appendWithNewlineToString:stringToSign stringToAppend:[request valueForHTTPHeaderField:AZSCContentMd5]];
-    [self appendWithNewlineToString:stringToSign stringToAppend:[request valueForHTTPHeaderField:AZSCContentType]];
-    [self appendWithNewlineToString:stringToSign stringToAppend:nil]; // Date header
-    [self appendWithNewlineToString:stringToSign stringToAppend:[request valueForHTTPHeaderField:AZSCHeaderValueIfModifiedSince]];
-    [self appendWithNewlineToString:stringToSign stringToAppend:[request valueForHTTPHeaderField:AZSCHeaderValueIfMatch]];
-    [self appendWithNewlineToString:stringToSign stringToAppend:[request valueForHTTPHeaderField:AZSCHeaderValueIfNoneMatch]];
-    [self appendWithNewlineToString:stringToSign stringToAppend:[request valueForHTTPHeaderField:AZSCHeaderValueIfUnmodifiedSince]];
-    [self appendWithNewlineToString:stringToSign stringToAppend:[request valueForHTTPHeaderField:AZSCXmlRange]];
-    
-    // x-ms-* headers (Canonicalized headers)
+    buffer->length += written;
+}
+
+// A canonicalized header or query parameter: the key and value are byte ranges in a scratch buffer.
+typedef struct
+{
+    size_t keyOffset;
+    size_t keyLength;
+    size_t valueOffset;
+    size_t valueLength;
+} AZSSigningEntry;
+
+static int AZSCompareSigningEntryKeys(const char *scratch, const AZSSigningEntry *first, const AZSSigningEntry *second)
+{
+    int comparison = memcmp(scratch + first->keyOffset, scratch + second->keyOffset, MIN(first->keyLength, second->keyLength));
+    if (comparison == 0)
+    {
+        comparison = (first->keyLength < second->keyLength) ? -1 : ((first->keyLength > second->keyLength) ? 1 : 0);
+    }
+    return comparison;
+}
+
+// Stable insertion sort; there are rarely more than a dozen entries.
+static void AZSSortSigningEntries(const char *scratch, AZSSigningEntry *entries, NSUInteger count)
+{
+    for (NSUInteger i = 1; i < count; i++)
+    {
+        AZSSigningEntry entry = entries[i];
+        NSUInteger j = i;
+        while (j > 0 && AZSCompareSigningEntryKeys(scratch, &entries[j - 1], &entry) > 0)
+        {
+            entries[j] = entries[j - 1];
+            j--;
+        }
+        entries[j] = entry;
+    }
+}
+
+@interface AZSSharedKeyBlobAuthenticationHandler()
+
+-(instancetype)init AZS_DESIGNATED_INITIALIZER;
+
+@end
+
+@implementation AZSSharedKeyBlobAuthenticationHandler
+
+-(void) appendCanonicalizedHeadersWithRequest:(NSURLRequest *)request toBuffer:(AZSSigningBuffer *)buffer
+{
     NSDictionary *allHeaders = [request allHTTPHeaderFields];
-    NSMutableDictionary *xmsHeaders = [[NSMutableDictionary alloc] init];
-    for (id key in allHeaders)
+    AZSSigningEntry inlineEntries[32];
+    AZSSigningEntry *entries = (allHeaders.count <= 32) ? inlineEntries : malloc(allHeaders.count * sizeof(AZSSigningEntry));
+    NSUInteger entryCount = 0;
+
+    // Keys are lowercased and values have each whitespace character replaced with a space.
+    AZSSigningBuffer scratch;
+    AZSSigningBufferInit(&scratch);
+    for (NSString *key in allHeaders)
     {
-        if ([key hasPrefix:AZSCHeaderPrefix])
+        if (![key hasPrefix:AZSCHeaderPrefix])
+        {
+            continue;
+        }
+
+        AZSSigningEntry *entry = &entries[entryCount++];
+        entry->keyOffset = scratch.length;
+        AZSSigningBufferAppendString(&scratch, key);
+        entry->keyLength = scratch.length - entry->keyOffset;
+
+        entry->valueOffset = scratch.length;
+        NSString *value = allHeaders[key];
+        AZSSigningBufferAppendString(&scratch, value);
+        entry->valueLength = scratch.length - entry->valueOffset;
+
+        for (size_t i = 0; i < entry->keyLength; i++)
+        {
+            char *c = scratch.bytes + entry->keyOffset + i;
+            *c = AZSLowercaseASCII(*c);
+            if (*c == ' ' || (*c >= '\t' && *c <= '\r'))
+            {
+                *c = ' ';
+            }
+        }
+
+        BOOL asciiValue = YES;
+        for (size_t i = 0; i < entry->valueLength; i++)
         {
-            xmsHeaders[[key lowercaseString]] = allHeaders[key];
+            char *c = scratch.bytes + entry->valueOffset + i;
+            asciiValue = asciiValue && ((unsigned char)*c < 0x80);
+            if (*c >= '\t' && *c <= '\r')
+            {
+                *c = ' ';
+            }
+        }
+
+        if (!asciiValue)
+        {
+            // Non-ASCII whitespace (such as U+00A0) has to be found with the full character set.
+            scratch.length = entry->valueOffset;
+            AZSSigningBufferAppendString(&scratch, [[value componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]] componentsJoinedByString:@" "]);
+            entry->valueLength = scratch.length - entry->valueOffset;
         }
     }
-    
-    NSArray* sortedKeys = [[xmsHeaders allKeys] sortedArrayUsingSelector:@selector(compare:)];
-    
-    for (id key in sortedKeys)
+
+    AZSSortSigningEntries(scratch.bytes, entries, entryCount);
+    for (NSUInteger i = 0; i < entryCount; i++)
     {
-        NSString *modifiedKey = [[key componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]] componentsJoinedByString:@" "];
-        [stringToSign appendString:modifiedKey];
-        [stringToSign appendString:@":"];
-        
-        NSString *modifiedValue = [[xmsHeaders[key] componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]] componentsJoinedByString:@" "];
-        [self appendWithNewlineToString:stringToSign stringToAppend:modifiedValue];
+        AZSSigningBufferAppendBytes(buffer, scratch.bytes + entries[i].keyOffset, entries[i].keyLength);
+        AZSSigningBufferAppendByte(buffer, ':');
+        AZSSigningBufferAppendBytes(buffer, scratch.bytes + entries[i].valueOffset, entries[i].valueLength);
+        AZSSigningBufferAppendByte(buffer, '\n');
     }
-    
-    // Canonicalized resource string
-    NSURLComponents *urlComponents = [NSURLComponents componentsWithURL:request.URL resolvingAgainstBaseURL:NO];
 
-    [stringToSign appendString:@"/"];
-    [stringToSign appendString:self.storageCredentials.accountName];
-    if ([urlComponents.percentEncodedPath length] == 0)
+    AZSSigningBufferFree(&scratch);
+    if (entries != inlineEntries)
     {
-        [stringToSign appendString:@"/"];
+        free(entries);
+    }
+}
+
+-(void) appendCanonicalizedResourceWithRequest:(NSURLRequest *)request toBuffer:(AZSSigningBuffer *)buffer
+{
+    CFURLRef url = (__bridge CFURLRef)request.URL;
+
+    AZSSigningBufferAppendByte(buffer, '/');
+    AZSSigningBufferAppendString(buffer, self.storageCredentials.accountName);
+    NSString *path = CFBridgingRelease(CFURLCopyPath(url));
+    if ([path length] == 0)
+    {
+        AZSSigningBufferAppendByte(buffer, '/');
     }
     else
     {
-        [stringToSign appendString:urlComponents.percentEncodedPath];
+        AZSSigningBufferAppendString(buffer, path);
     }
-    
-    // TODO: Fix when moving to iOS 8, use urlComponents.queryItems
-    NSString *fullQueryString = urlComponents.query;
-    
-    NSArray *allQueryParameters = [fullQueryString componentsSeparatedByString:@"&"];
-    NSMutableDictionary *queryParameters = [NSMutableDictionary dictionaryWithCapacity:allQueryParameters.count];
-    for (id queryParameter in allQueryParameters)
+
+    NSString *query = CFBridgingRelease(CFURLCopyQueryString(url, NULL));
+    if ([query length] == 0)
     {
-        NSUInteger firstEqualOccurrence = [queryParameter rangeOfString:@"="].location;
-        NSString *queryKey = [queryParameter substringWithRange:NSMakeRange(0, firstEqualOccurrence)];
-        NSString *queryValue = [queryParameter substringWithRange:NSMakeRange(firstEqualOccurrence + 1, [queryParameter length] - (firstEqualOccurrence + 1))];
-        
-        queryParameters[[queryKey lowercaseString]] = queryValue;
+        return;
     }
-    
-    NSArray *sortedQueryKeys = [[queryParameters allKeys] sortedArrayUsingSelector:@selector(compare:)];
-    
-    for (id queryKey in sortedQueryKeys)
+
+    // Split the still-escaped query, then decode each key and value, so that an escaped '&' or '=' can't split a parameter.
+    AZSSigningBuffer rawQuery;
+    AZSSigningBufferInit(&rawQuery);
+    AZSSigningBufferAppendString(&rawQuery, query);
+
+    NSUInteger maximumEntries = 1;
+    for (size_t i = 0; i < rawQuery.length; i++)
     {
-        [stringToSign appendString:@"\n"];
-        [stringToSign appendString:queryKey];
-        [stringToSign appendString:@":"];
-        [stringToSign appendString:queryParameters[queryKey]];
+        maximumEntries += (rawQuery.bytes[i] == '&');
     }
-    
-    [operationContext logAtLevel:AZSLogLevelInfo withMessage:@"String to sign = %@", stringToSign];
+
+    AZSSigningEntry inlineEntries[32];
+    AZSSigningEntry *entries = (maximumEntries <= 32) ? inlineEntries : malloc(maximumEntries * sizeof(AZSSigningEntry));
+    NSUInteger entryCount = 0;
+
+    AZSSigningBuffer scratch;
+    AZSSigningBufferInit(&scratch);
+    size_t parameterStart = 0;
+    while (parameterStart <= rawQuery.length)
+    {
+        const char *parameter = rawQuery.bytes + parameterStart;
+        const char *parameterEnd = memchr(parameter, '&', rawQuery.length - parameterStart);
+        size_t parameterLength = parameterEnd ? (size_t)(parameterEnd - parameter) : rawQuery.length - parameterStart;
+        if (parameterLength > 0)
+        {
+            const char *equals = memchr(parameter, '=', parameterLength);
+            size_t keyLength = equals ? (size_t)(equals - parameter) : parameterLength;
+
+            AZSSigningEntry *entry = &entries[entryCount++];
+            entry->keyOffset = scratch.length;
+            AZSSigningBufferAppendDecoded(&scratch, parameter, keyLength, YES);
+            entry->keyLength = scratch.length - entry->keyOffset;
+            entry->valueOffset = scratch.length;
+            if (equals)
+            {
+                AZSSigningBufferAppendDecoded(&scratch, equals + 1, parameterLength - keyLength - 1, NO);
+            }
+            entry->valueLength = scratch.length - entry->valueOffset;
+        }
+        parameterStart += parameterLength + 1;
+    }
+
+    // When a key is repeated, the last value wins.
+    AZSSortSigningEntries(scratch.bytes, entries, entryCount);
+    for (NSUInteger i = 0; i < entryCount; i++)
+    {
+        if (i + 1 < entryCount && AZSCompareSigningEntryKeys(scratch.bytes, &entries[i], &entries[i + 1]) == 0)
+        {
+            continue;
+        }
+
+        AZSSigningBufferAppendByte(buffer, '\n');
+        AZSSigningBufferAppendBytes(buffer, scratch.bytes + entries[i].keyOffset, entries[i].keyLength);
+        AZSSigningBufferAppendByte(buffer, ':');
+        AZSSigningBufferAppendBytes(buffer, scratch.bytes + entries[i].valueOffset, entries[i].valueLength);
+    }
+
+    AZSSigningBufferFree(&scratch);
+    AZSSigningBufferFree(&rawQuery);
+    if (entries != inlineEntries)
+    {
+        free(entries);
+    }
+}
+
+-(void) appendStringToSignWithRequest:(NSURLRequest *)request toBuffer:(AZSSigningBuffer *)buffer
+{
+    // VERB
+    AZSSigningBufferAppendLine(buffer, request.HTTPMethod);
+
+    // Standard headers
+    AZSSigningBufferAppendLine(buffer, [request valueForHTTPHeaderField:AZSCContentEncoding]);
+    AZSSigningBufferAppendLine(buffer, [request valueForHTTPHeaderField:AZSCContentLanguage]);
+
+    NSString *contentLengthValue = [request valueForHTTPHeaderField:AZSCContentLength];
+    if ([contentLengthValue isEqualToString:@"0"])
+    {
+        contentLengthValue = nil;
+    }
+    AZSSigningBufferAppendLine(buffer, contentLengthValue);
+
+    AZSSigningBufferAppendLine(buffer, [request valueForHTTPHeaderField:AZSCContentMd5]);
+    AZSSigningBufferAppendLine(buffer, [request valueForHTTPHeaderField:AZSCContentType]);
+    AZSSigningBufferAppendLine(buffer, nil); // Date header
+    AZSSigningBufferAppendLine(buffer, [request valueForHTTPHeaderField:AZSCHeaderValueIfModifiedSince]);
+    AZSSigningBufferAppendLine(buffer, [request valueForHTTPHeaderField:AZSCHeaderValueIfMatch]);
+    AZSSigningBufferAppendLine(buffer, [request valueForHTTPHeaderField:AZSCHeaderValueIfNoneMatch]);
+    AZSSigningBufferAppendLine(buffer, [request valueForHTTPHeaderField:AZSCHeaderValueIfUnmodifiedSince]);
+    AZSSigningBufferAppendLine(buffer, [request valueForHTTPHeaderField:AZSCXmlRange]);
+
+    // x-ms-* headers (Canonicalized headers)
+    [self appendCanonicalizedHeadersWithRequest:request toBuffer:buffer];
+
+    // Canonicalized resource string
+    [self appendCanonicalizedResourceWithRequest:request toBuffer:buffer];
+}
+
+-(NSString *) getStringToSignWithRequest:(NSMutableURLRequest *)request operationContext:(AZSOperationContext *)operationContext
+{
+    AZSSigningBuffer buffer;
+    AZSSigningBufferInit(&buffer);
+    [self appendStringToSignWithRequest:request toBuffer:&buffer];
+    NSString *stringToSign = [[NSString alloc] initWithBytes:buffer.bytes length:buffer.length encoding:NSUTF8StringEncoding];
+    AZSSigningBufferFree(&buffer);
     return stringToSign;
 }
 
 -(void) signRequest:(NSMutableURLRequest *)request operationContext:(AZSOperationContext *)operationContext
 {
-    char buffer[30];
-    struct tm * timeptr;
-    time_t time = (time_t) [[NSDate date] timeIntervalSince1970];
-    timeptr = gmtime(&time);
-    if (!strftime_l(buffer, 30, [AZSCDateFormatColloquial UTF8String], timeptr, NULL))
+    char dateBuffer[AZSRFC1123DateLength + 1];
+    if (!AZSFormatRFC1123Date((int64_t)[[NSDate date] timeIntervalSince1970], dateBuffer))
     {
         // TODO: Add proper error handling to signing.
         NSException* myException = [NSException
@@ -151,13 +382,21 @@
         @throw myException;
     }
     
-    [request setValue:[NSString stringWithUTF8String:buffer] forHTTPHeaderField:AZSCHeaderDate];
+    [request setValue:[[NSString alloc] initWithBytes:dateBuffer length:AZSRFC1123DateLength encoding:NSASCIIStringEncoding] forHTTPHeaderField:AZSCHeaderDate];
     
-    NSString *stringToSign = [self getStringToSignWithRequest:request operationContext:operationContext];
+    AZSSigningBuffer buffer;
+    AZSSigningBufferInit(&buffer);
+    [self appendStringToSignWithRequest:request toBuffer:&buffer];
     
-    NSString *signature = [AZSUtil computeHmac256WithString:stringToSign credentials:self.storageCredentials];
+    AZSLogInfo(operationContext, @"String to sign = %@", [[NSString alloc] initWithBytes:buffer.bytes length:buffer.length encoding:NSUTF8StringEncoding]);
     
-    [request setValue:[NSString stringWithFormat:AZSCSharedTemplateAuthorization,self.storageCredentials.accountName,signature] forHTTPHeaderField:AZSCHeaderAuthorization];
+    unsigned char signature[CC_SHA256_DIGEST_LENGTH];
+    [self.storageCredentials computeHmacSha256WithBytes:buffer.bytes length:buffer.length digest:signature];
+    AZSSigningBufferFree(&buffer);
+    
+    char encodedSignatureBuffer[AZSBase64EncodedLength(CC_SHA256_DIGEST_LENGTH)];
+    NSString *encodedSignature = [[NSString alloc] initWithBytes:encodedSignatureBuffer length:AZSBase64Encode(signature, sizeof(signature), encodedSignatureBuffer) encoding:NSASCIIStringEncoding];
+    [request setValue:[NSString stringWithFormat:AZSCSharedTemplateAuthorization,self.storageCredentials.accountName,encodedSignature] forHTTPHeaderField:AZSCHeaderAuthorization];
 }
 
 -(instancetype)init
@@ -176,4 +415,4 @@
     return self;
 }
 
-@end
\ No newline at end of file
+@end
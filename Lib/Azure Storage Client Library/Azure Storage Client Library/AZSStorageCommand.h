@@ -23,6 +23,12 @@
 @class AZSRequestResult;
 @class AZSStorageCredentials;
 @class AZSUriQueryBuilder;
+@class AZSClientMetrics;
+@class AZSRequestGovernor;
+@class AZSRetryBudget;
+@class AZSCircuitBreaker;
+@class AZSHedgingPolicy;
+@protocol AZSHttpTransport;
 
 @protocol AZSAuthenticationHandler;
 
@@ -32,6 +38,7 @@
 @property (nonatomic, strong, readonly) AZSStorageCredentials *credentials;
 @property (nonatomic, strong) AZSUriQueryBuilder *queryBuilder;
 @property BOOL calculateResponseMD5;
+@property BOOL calculateResponseCRC64;
 @property (readonly) AZSAllowedStorageLocation allowedStorageLocation;
 
 @property (copy) NSMutableURLRequest *(^buildRequest)(NSURLComponents *urlComponents, NSTimeInterval timeout, AZSOperationContext *operationContext);
@@ -41,6 +48,12 @@
 @property (copy) void(^processError)(NSOutputStream *outputStream, NSError **errorToPopulate, NSError **error);
 @property (strong, nonatomic) NSData *source;
 @property (strong, nonatomic) NSOutputStream *destinationStream;
+@property (strong, nonatomic) AZSClientMetrics *metrics;
+@property (strong, nonatomic) id<AZSHttpTransport> transport;
+@property (strong, nonatomic) AZSRequestGovernor *governor;
+@property (strong, nonatomic) AZSRetryBudget *retryBudget;
+@property (strong, nonatomic) AZSCircuitBreaker *circuitBreaker;
+@property (strong, nonatomic) AZSHedgingPolicy *hedgingPolicy;
 
 -(instancetype) initWithStorageCredentials:(AZSStorageCredentials *)credentials storageUri:(AZSStorageUri *)storageUri operationContext:(AZSOperationContext *)operationContext;
 -(instancetype) initWithStorageCredentials:(AZSStorageCredentials *)credentials storageUri:(AZSStorageUri *)storageUri calculateResponseMD5:(BOOL)calculateResponseMD5 operationContext:(AZSOperationContext *)operationContext AZS_DESIGNATED_INITIALIZER;
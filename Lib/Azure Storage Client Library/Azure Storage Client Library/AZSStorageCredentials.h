@@ -66,6 +66,17 @@ AZS_ASSUME_NONNULL_BEGIN
  */
 -(instancetype)initWithSASToken:(NSString *)sasToken accountName:(AZSNullable NSString *)accountName AZS_DESIGNATED_INITIALIZER;
 
+/** Computes the HMAC-SHA256 of the given bytes, keyed with the account key.
+ 
+ The signer comes from the AZSCrypto provider that is current when the credentials are created.  Its key schedule
+ (the inner and outer padded key state) is computed once, then, so each call only hashes the message itself.
+ 
+ @param bytes The bytes to sign.
+ @param length The number of bytes to sign.
+ @param digest A buffer of at least CC_SHA256_DIGEST_LENGTH (32) bytes to receive the signature.
+ */
+-(void) computeHmacSha256WithBytes:(const void *)bytes length:(size_t)length digest:(unsigned char *)digest;
+
 -(BOOL) isSharedKey;
 -(BOOL) isSAS;
 
@@ -20,10 +20,12 @@
 #import "AZSUriQueryBuilder.h"
 #import "AZSUtil.h"
 #import "AZSStorageUri.h"
+#import "AZSCryptoProvider.h"
 
 @interface AZSStorageCredentials()
 
 @property (strong) AZSUriQueryBuilder *queryBuilder;
+@property (strong, nonatomic) id<AZSHmacSigner> signer;
 
 -(instancetype)init AZS_DESIGNATED_INITIALIZER;
 
@@ -47,6 +49,7 @@
         _accountName = accountName;
         _accountKey = [[NSData alloc] initWithBase64EncodedString:accountKeyString options:0];
         _queryBuilder = [[AZSUriQueryBuilder alloc] init];
+        _signer = [[AZSCrypto provider] hmacSha256SignerWithKey:_accountKey];
     }
     
     return self;
@@ -72,6 +75,11 @@
     return self;
 }
 
+-(void) computeHmacSha256WithBytes:(const void *)bytes length:(size_t)length digest:(unsigned char *)digest
+{
+    [_signer signBytes:bytes length:length digest:digest];
+}
+
 -(BOOL) isSharedKey
 {
     if (self.accountKey)
@@ -0,0 +1,115 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSTracer.h" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <Foundation/Foundation.h>
+#import <mach/mach_time.h>
+#import "AZSMacros.h"
+
+@class AZSOperationContext;
+
+AZS_ASSUME_NONNULL_BEGIN
+
+/** AZSTracer records a timeline of the library's work, for viewing in chrome://tracing or Perfetto.
+
+ Tracing is off by default.  While it is on, the executor records each request and its response, data and completion
+ callbacks, response parsing and retry waits, and the upload streams record buffer fills, waits for a free upload slot,
+ transactional block hashes, block sends and the wait for outstanding blocks on close.  Each operation is shown as its
+ own process, named by the clientRequestId of its AZSOperationContext, with a track for each thread.
+
+ Events are appended to a fixed-size buffer owned by the recording thread, so recording takes no locks.  Once a
+ thread's buffer is full, further events from that thread are dropped and counted in droppedEventCount.
+ */
+@interface AZSTracer : NSObject
+
+/** Starts recording, with room for 8192 events per thread.*/
++(void)startTracing;
+
+/** Starts recording.
+
+ @param eventsPerThread The number of events each thread can record.  Threads that have already recorded keep the
+ buffer size they were given.
+ */
++(void)startTracingWithEventsPerThread:(NSUInteger)eventsPerThread;
+
+/** Stops recording.  The events recorded so far are kept.*/
++(void)stopTracing;
+
+/** Discards all recorded events.  Call this only while tracing is stopped.*/
++(void)clearTrace;
+
+/** The number of events dropped because a thread's buffer was full.*/
++(NSUInteger)droppedEventCount;
+
+/** Formats the recorded events as Chrome trace event JSON.
+
+ Can be called while tracing is running; events recorded during the call may or may not be included.
+
+ @returns The JSON data, as a {"traceEvents": [...]} object.
+ */
++(NSData *)traceEventData;
+
+/** Writes the recorded events to a file as Chrome trace event JSON.
+
+ @param path The file to write.
+ @param error Set if the file could not be written.
+ @returns YES if the file was written.
+ */
++(BOOL)writeTraceToFile:(NSString *)path error:(NSError **)error;
+
+@end
+
+// Instrumentation front end for library code.  Like the logging macros, these check whether tracing is on inline, so
+// a disabled trace point costs one load and branch.
+//
+//     uint64_t traceStart = AZSTraceTimestamp();
+//     ... work ...
+//     AZSTraceSpan("work", traceStart, operationContext);
+//
+// Event names must be string literals; they are stored by pointer.
+
+extern BOOL AZSTracingEnabled;
+
+// The current time in mach_absolute_time units, or 0 if tracing is off.
+static inline uint64_t AZSTraceTimestamp(void)
+{
+    return AZSTracingEnabled ? mach_absolute_time() : 0;
+}
+
+void AZSTraceRecordSpan(const char *name, uint64_t startTimestamp, AZSOperationContext * __AZSNullable operationContext);
+void AZSTraceRecordInstant(const char *name, AZSOperationContext * __AZSNullable operationContext);
+
+// Records a span from startTimestamp to now, unless tracing was off when startTimestamp was taken.
+#define AZSTraceSpan(name, startTimestamp, operationContext) \
+    do \
+    { \
+        uint64_t _azsTraceStart = (startTimestamp); \
+        if (_azsTraceStart) \
+        { \
+            AZSTraceRecordSpan((name), _azsTraceStart, (operationContext)); \
+        } \
+    } while (0)
+
+#define AZSTraceInstant(name, operationContext) \
+    do \
+    { \
+        if (AZSTracingEnabled) \
+        { \
+            AZSTraceRecordInstant((name), (operationContext)); \
+        } \
+    } while (0)
+
+AZS_ASSUME_NONNULL_END
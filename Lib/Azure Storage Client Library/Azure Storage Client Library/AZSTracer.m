@@ -0,0 +1,215 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSTracer.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <pthread.h>
+#import <stdatomic.h>
+#import "AZSOperationContext.h"
+#import "AZSTracer.h"
+
+#define AZSTraceDefaultEventsPerThread 8192
+
+// Long enough for the UUID the operation context generates.  Longer IDs are recorded as empty.
+#define AZSTraceClientRequestIdLength 48
+
+typedef struct
+{
+    const char *name;
+    uint64_t start;
+    uint64_t end;
+    char clientRequestId[AZSTraceClientRequestIdLength];
+} AZSTraceEvent;
+
+// Only the owning thread writes to a buffer.  Readers load count with acquire ordering and read the events before it.
+typedef struct AZSTraceBuffer
+{
+    struct AZSTraceBuffer *next;
+    uint64_t threadId;
+    size_t capacity;
+    _Atomic size_t count;
+    AZSTraceEvent events[];
+} AZSTraceBuffer;
+
+BOOL AZSTracingEnabled = NO;
+
+// Buffers are never freed, since threads keep pointers to them; they are pushed onto this list once per thread.
+static _Atomic(AZSTraceBuffer *) AZSTraceBuffers = NULL;
+static _Atomic size_t AZSTraceEventsPerThread = AZSTraceDefaultEventsPerThread;
+static _Atomic size_t AZSTraceDroppedEvents = 0;
+static pthread_key_t AZSTraceBufferKey;
+static dispatch_once_t AZSTraceBufferKeyOnce;
+
+static AZSTraceBuffer *AZSCurrentTraceBuffer(void)
+{
+    dispatch_once(&AZSTraceBufferKeyOnce, ^{
+        pthread_key_create(&AZSTraceBufferKey, NULL);
+    });
+
+    AZSTraceBuffer *buffer = pthread_getspecific(AZSTraceBufferKey);
+    if (!buffer)
+    {
+        size_t capacity = atomic_load_explicit(&AZSTraceEventsPerThread, memory_order_relaxed);
+        buffer = calloc(1, sizeof(AZSTraceBuffer) + capacity * sizeof(AZSTraceEvent));
+        if (!buffer)
+        {
+            return NULL;
+        }
+
+        buffer->capacity = capacity;
+        pthread_threadid_np(NULL, &buffer->threadId);
+        buffer->next = atomic_load_explicit(&AZSTraceBuffers, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&AZSTraceBuffers, &buffer->next, buffer, memory_order_release, memory_order_relaxed))
+        {
+        }
+        pthread_setspecific(AZSTraceBufferKey, buffer);
+    }
+    return buffer;
+}
+
+static void AZSTraceRecord(const char *name, uint64_t start, uint64_t end, AZSOperationContext *operationContext)
+{
+    AZSTraceBuffer *buffer = AZSCurrentTraceBuffer();
+    size_t index = buffer ? atomic_load_explicit(&buffer->count, memory_order_relaxed) : 0;
+    if (!buffer || index >= buffer->capacity)
+    {
+        atomic_fetch_add_explicit(&AZSTraceDroppedEvents, 1, memory_order_relaxed);
+        return;
+    }
+
+    AZSTraceEvent *event = &buffer->events[index];
+    event->name = name;
+    event->start = start;
+    event->end = end;
+    if (![operationContext.clientRequestId getCString:event->clientRequestId maxLength:AZSTraceClientRequestIdLength encoding:NSUTF8StringEncoding])
+    {
+        event->clientRequestId[0] = '\0';
+    }
+    atomic_store_explicit(&buffer->count, index + 1, memory_order_release);
+}
+
+void AZSTraceRecordSpan(const char *name, uint64_t startTimestamp, AZSOperationContext *operationContext)
+{
+    AZSTraceRecord(name, startTimestamp, mach_absolute_time(), operationContext);
+}
+
+void AZSTraceRecordInstant(const char *name, AZSOperationContext *operationContext)
+{
+    // Instants are stored with no end time.
+    AZSTraceRecord(name, mach_absolute_time(), 0, operationContext);
+}
+
+@implementation AZSTracer
+
++(void)startTracing
+{
+    [self startTracingWithEventsPerThread:AZSTraceDefaultEventsPerThread];
+}
+
++(void)startTracingWithEventsPerThread:(NSUInteger)eventsPerThread
+{
+    atomic_store_explicit(&AZSTraceEventsPerThread, MAX(eventsPerThread, (NSUInteger)1), memory_order_relaxed);
+    AZSTracingEnabled = YES;
+}
+
++(void)stopTracing
+{
+    AZSTracingEnabled = NO;
+}
+
++(void)clearTrace
+{
+    for (AZSTraceBuffer *buffer = atomic_load_explicit(&AZSTraceBuffers, memory_order_acquire); buffer; buffer = buffer->next)
+    {
+        atomic_store_explicit(&buffer->count, 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&AZSTraceDroppedEvents, 0, memory_order_relaxed);
+}
+
++(NSUInteger)droppedEventCount
+{
+    return atomic_load_explicit(&AZSTraceDroppedEvents, memory_order_relaxed);
+}
+
++(NSData *)traceEventData
+{
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    double microsecondsPerTick = (double)timebase.numer / timebase.denom / 1000.0;
+
+    // Timestamps are reported relative to the first event, and each operation gets its own process ID.  Tracing may
+    // still be running, so each buffer's count is read once and both passes cover the same events; otherwise an event
+    // recorded in between could start before the origin.
+    AZSTraceBuffer *buffers = atomic_load_explicit(&AZSTraceBuffers, memory_order_acquire);
+    NSMutableData *countData = [NSMutableData dataWithCapacity:64 * sizeof(size_t)];
+    uint64_t origin = UINT64_MAX;
+    for (AZSTraceBuffer *buffer = buffers; buffer; buffer = buffer->next)
+    {
+        size_t count = atomic_load_explicit(&buffer->count, memory_order_acquire);
+        [countData appendBytes:&count length:sizeof(count)];
+        for (size_t i = 0; i < count; i++)
+        {
+            origin = MIN(origin, buffer->events[i].start);
+        }
+    }
+
+    NSMutableArray *traceEvents = [NSMutableArray arrayWithCapacity:1024];
+    NSMutableDictionary *processIds = [NSMutableDictionary dictionaryWithCapacity:64];
+    const size_t *counts = countData.bytes;
+    size_t bufferIndex = 0;
+    for (AZSTraceBuffer *buffer = buffers; buffer; buffer = buffer->next)
+    {
+        size_t count = counts[bufferIndex++];
+        for (size_t i = 0; i < count; i++)
+        {
+            AZSTraceEvent *event = &buffer->events[i];
+            NSString *clientRequestId = [NSString stringWithUTF8String:event->clientRequestId] ?: @"";
+            NSNumber *processId = processIds[clientRequestId];
+            if (!processId)
+            {
+                processId = @(processIds.count + 1);
+                processIds[clientRequestId] = processId;
+                [traceEvents addObject:@{@"name": @"process_name", @"ph": @"M", @"pid": processId, @"args": @{@"name": (clientRequestId.length > 0) ? clientRequestId : @"(no operation)"}}];
+            }
+
+            NSMutableDictionary *traceEvent = [NSMutableDictionary dictionaryWithCapacity:8];
+            traceEvent[@"name"] = [NSString stringWithUTF8String:event->name];
+            traceEvent[@"cat"] = @"AZSClient";
+            traceEvent[@"pid"] = processId;
+            traceEvent[@"tid"] = @(buffer->threadId);
+            traceEvent[@"ts"] = @((event->start - origin) * microsecondsPerTick);
+            if (event->end)
+            {
+                traceEvent[@"ph"] = @"X";
+                traceEvent[@"dur"] = @((event->end - event->start) * microsecondsPerTick);
+            }
+            else
+            {
+                traceEvent[@"ph"] = @"i";
+                traceEvent[@"s"] = @"t";
+            }
+            [traceEvents addObject:traceEvent];
+        }
+    }
+
+    return [NSJSONSerialization dataWithJSONObject:@{@"traceEvents": traceEvents, @"displayTimeUnit": @"ms"} options:0 error:nil];
+}
+
++(BOOL)writeTraceToFile:(NSString *)path error:(NSError **)error
+{
+    return [[self traceEventData] writeToFile:path options:NSDataWritingAtomic error:error];
+}
+
+@end
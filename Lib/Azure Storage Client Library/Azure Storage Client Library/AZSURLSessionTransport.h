@@ -0,0 +1,34 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSURLSessionTransport.h" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <Foundation/Foundation.h>
+#import "AZSHttpTransport.h"
+
+AZS_ASSUME_NONNULL_BEGIN
+
+/** AZSURLSessionTransport sends requests with NSURLSession, and is the transport the library uses by default.
+
+ Each task runs in its own ephemeral session with caching disabled, so no state is shared between requests.
+ */
+@interface AZSURLSessionTransport : NSObject <AZSHttpTransport>
+
+/** The shared instance used when a client has no httpTransport set.*/
++(instancetype)defaultTransport;
+
+@end
+
+AZS_ASSUME_NONNULL_END
@@ -0,0 +1,160 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSURLSessionTransport.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import "AZSURLSessionTransport.h"
+
+@interface AZSURLSessionTransportTask : NSObject <AZSHttpTransportTask, NSURLSessionDataDelegate>
+
+@property (strong) NSURLSession *session;
+@property (strong) NSURLSessionTask *task;
+@property (strong) id<AZSHttpTransportDelegate> delegate;
+@property BOOL completed;
+
+-(instancetype)init AZS_DESIGNATED_INITIALIZER;
+-(instancetype)initWithRequest:(NSURLRequest *)request body:(NSData *)body timeout:(NSTimeInterval)timeout delegate:(id<AZSHttpTransportDelegate>)delegate AZS_DESIGNATED_INITIALIZER;
+
+@end
+
+@implementation AZSURLSessionTransportTask
+
+-(instancetype)init
+{
+    return nil;
+}
+
+-(instancetype)initWithRequest:(NSURLRequest *)request body:(NSData *)body timeout:(NSTimeInterval)timeout delegate:(id<AZSHttpTransportDelegate>)delegate
+{
+    self = [super init];
+    if (self)
+    {
+        _delegate = delegate;
+
+        NSURLSessionConfiguration *sessionConfiguration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+        sessionConfiguration.URLCache = nil;
+        sessionConfiguration.requestCachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+        sessionConfiguration.timeoutIntervalForResource = timeout;
+
+        // The session retains this object as its delegate until it is invalidated after the task completes.
+        // Passing in nil for the queue lets the session create a serial delegate queue.
+        _session = [NSURLSession sessionWithConfiguration:sessionConfiguration delegate:self delegateQueue:nil];
+        if (body != nil)
+        {
+            _task = [_session uploadTaskWithRequest:request fromData:body];
+        }
+        else
+        {
+            _task = [_session dataTaskWithRequest:request];
+        }
+    }
+
+    return self;
+}
+
+-(void)resume
+{
+    [self.task resume];
+}
+
+-(void)suspend
+{
+    [self.task suspend];
+}
+
+-(void)cancel
+{
+    [self.task cancel];
+}
+
+-(int64_t)countOfBytesSent
+{
+    return self.task.countOfBytesSent;
+}
+
+-(int64_t)countOfBytesReceived
+{
+    return self.task.countOfBytesReceived;
+}
+
+-(void)completeWithError:(NSError *)error
+{
+    if (self.completed)
+    {
+        return;
+    }
+    self.completed = YES;
+
+    [self.delegate transportTask:self didCompleteWithError:error];
+    self.delegate = nil;
+
+    // Required to release memory related to the session.
+    [self.session finishTasksAndInvalidate];
+}
+
+-(void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveResponse:(NSURLResponse *)response completionHandler:(void (^)(NSURLSessionResponseDisposition))completionHandler
+{
+    [self.delegate transportTask:self didReceiveResponse:(NSHTTPURLResponse *)response];
+    completionHandler(NSURLSessionResponseAllow);
+}
+
+-(void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data
+{
+    [self.delegate transportTask:self didReceiveData:data];
+}
+
+-(void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics
+{
+    // This is called just before didCompleteWithError, on iOS 10 and OS X 10.12 or later.
+    if ([self.delegate respondsToSelector:@selector(transportTask:didFinishCollectingMetrics:)])
+    {
+        [self.delegate transportTask:self didFinishCollectingMetrics:metrics];
+    }
+}
+
+-(void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error
+{
+    [self completeWithError:error];
+}
+
+-(void)URLSession:(NSURLSession *)session didBecomeInvalidWithError:(NSError *)error
+{
+    // This is called if/when the session becomes invalid for some reason on the client, without the task completing.
+    if (error)
+    {
+        [self completeWithError:error];
+    }
+}
+
+@end
+
+@implementation AZSURLSessionTransport
+
++(instancetype)defaultTransport
+{
+    static AZSURLSessionTransport *defaultTransport = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        defaultTransport = [[AZSURLSessionTransport alloc] init];
+    });
+    return defaultTransport;
+}
+
+-(id<AZSHttpTransportTask>)taskWithRequest:(NSURLRequest *)request body:(NSData *)body timeout:(NSTimeInterval)timeout delegate:(id<AZSHttpTransportDelegate>)delegate
+{
+    return [[AZSURLSessionTransportTask alloc] initWithRequest:request body:body timeout:timeout delegate:delegate];
+}
+
+@end
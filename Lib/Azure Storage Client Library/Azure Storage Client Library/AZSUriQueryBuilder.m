@@ -59,30 +59,18 @@
 
 -(NSString*) builderAsString
 {
-    NSString *result = AZSCEmptyString;
-    
-    BOOL first = YES;
+    NSMutableString *result = [NSMutableString stringWithCapacity:(self.parameters.count * 32)];
     
     for (NSString *key in self.parameters)
     {
-        if (first)
-        {
-            first = NO;
-            result = [result stringByAppendingString:@"?"];
-        }
-        else
-        {
-            result = [result stringByAppendingString:@"&"];
-        }
-        
-        result = [result stringByAppendingString:key];
+        [result appendString:(result.length == 0) ? @"?" : @"&"];
+        [result appendString:key];
         
         NSString *value = [self.parameters objectForKey:key];
         if (value)
         {
-            result = [result stringByAppendingString:@"="];
-            NSString *encodedvalue = [AZSUtil URLEncodedStringWithString:value];
-            result = [result stringByAppendingString:encodedvalue];
+            [result appendString:@"="];
+            [result appendString:[AZSUtil URLEncodedStringWithString:value]];
         }
     }
     
@@ -26,6 +26,51 @@
 @class AZSStorageCredentials;
 @class AZSStorageUri;
 
+// Fixed-format date kernels for the two wire formats.  These are locale-free, do not allocate, and are safe to call
+// from any thread.  Times are seconds since 1970 UTC.
+
+// RFC 1123, as used in HTTP headers and listings: "Sun, 06 Nov 1994 08:49:37 GMT".  Buffers must hold AZSRFC1123DateLength + 1 bytes.
+#define AZSRFC1123DateLength 29
+size_t AZSFormatRFC1123Date(int64_t secondsSince1970, char *buffer);
+BOOL AZSParseRFC1123Date(const char *string, size_t length, int64_t *secondsSince1970);
+
+// ISO 8601 UTC, as used in SAS tokens and access policies: "1994-11-06T08:49:37Z".  Parsing also accepts a fractional
+// second of any precision, as in the round-trip format "1994-11-06T08:49:37.1234567Z".  Buffers must hold AZSISO8601DateLength + 1 bytes.
+#define AZSISO8601DateLength 20
+size_t AZSFormatISO8601Date(int64_t secondsSince1970, char *buffer);
+BOOL AZSParseISO8601Date(const char *string, size_t length, double *secondsSince1970);
+
+// Encoding kernels.  These write into caller buffers, which they do not null-terminate, and return the number of
+// bytes written.  The ...Length macros give the buffer size needed for an input of the given length.
+
+// Escapes every byte except the RFC 3986 unreserved characters as %XX, with uppercase hex digits.
+#define AZSPercentEncodedMaxLength(length) ((length) * 3)
+size_t AZSPercentEncode(const uint8_t *bytes, size_t length, char *output);
+
+// Decodes %XX escapes.  Malformed escapes are copied through unchanged, and '+' is not treated as a space.  The
+// output is never longer than the input, so it may be decoded in place.
+size_t AZSPercentDecode(const char *string, size_t length, uint8_t *output);
+
+// Standard Base64 with padding, as NSData's base64EncodedStringWithOptions:0.  Decoding rejects anything that is not
+// a whole number of padded quads, and returns the decoded length in outputLength.
+#define AZSBase64EncodedLength(length) ((((length) + 2) / 3) * 4)
+#define AZSBase64DecodedMaxLength(length) (((length) / 4) * 3)
+size_t AZSBase64Encode(const uint8_t *bytes, size_t length, char *output);
+BOOL AZSBase64Decode(const char *string, size_t length, uint8_t *output, size_t *outputLength);
+
+// Hex, two digits per byte.  Decoding accepts either case, and writes length / 2 bytes.
+#define AZSHexEncodedLength(length) ((length) * 2)
+size_t AZSHexEncode(const uint8_t *bytes, size_t length, char *output, BOOL uppercase);
+BOOL AZSHexDecode(const char *string, size_t length, uint8_t *output);
+
+// CRC64 as used by the service's x-ms-content-crc64 header: the reflected polynomial 0x9A6C9329AC4BC9B5, with the
+// register inverted before and after.  Start from a crc of 0; passing one result into the next update continues the
+// checksum.  Combining gives the CRC of two buffers laid end to end from their separate CRCs and the length of the
+// second, so pieces of a stream can be checksummed in parallel.  On the wire the value is sent as its 8 bytes, least
+// significant first, in Base64.
+uint64_t AZSCRC64Update(uint64_t crc, const void *bytes, size_t length);
+uint64_t AZSCRC64Combine(uint64_t crc1, uint64_t crc2, uint64_t length2);
+
 @interface AZSUtil : NSObject
 
 +(void) addOptionalHeaderToRequest:(NSMutableURLRequest *)request header:(NSString *)header stringValue:(NSString *)value;
@@ -35,6 +80,8 @@
 +(NSDateFormatter *) dateFormatterWithRoundtripFormat;
 
 +(NSString *) convertDateToHttpString:(NSDate *)date;
++(NSDate *) dateFromHttpString:(NSString *)dateString;
++(NSDate *) dateFromRoundtripString:(NSString *)dateString;
 +(BOOL)streamAvailable:(NSStream *)stream;
 
 +(NSMutableDictionary *) parseQueryWithQueryString:(NSString *)query;
@@ -42,11 +89,15 @@
 +(BOOL) usePathStyleAddressing:(NSURL *)url;
 
 +(NSString *) URLEncodedStringWithString:(NSString *)stringToConvert;
++(NSString *) base64EncodedStringWithBytes:(const void *)bytes length:(size_t)length;
++(BOOL) decodeBase64String:(NSString *)string toBytes:(void *)bytes length:(size_t)length;
 +(NSString *) computeHmac256WithString:(NSString *)stringToSign credentials:(AZSStorageCredentials *)credentials;
 +(NSString *) utcTimeOrEmptyWithDate:(NSDate *)date;
 
 +(AZSOperationContext *) operationlessContext;
 
 +(NSString *)calculateMD5FromData:(NSData *)data;
++(NSString *)calculateCRC64FromData:(NSData *)data;
++(NSString *)base64StringFromCRC64:(uint64_t)crc;
 
 @end
\ No newline at end of file
@@ -16,11 +16,606 @@
 // -----------------------------------------------------------------------------------------
 
 #import <CommonCrypto/CommonHMAC.h>
+#import <libkern/OSByteOrder.h>
 #import "AZSConstants.h"
 #import "AZSErrors.h"
 #import "AZSOperationContext.h"
 #import "AZSUtil.h"
 #import "AZSStorageCredentials.h"
+#import "AZSCryptoProvider.h"
+
+static const char AZSDayNames[7][4] = {"Thu", "Fri", "Sat", "Sun", "Mon", "Tue", "Wed"};
+static const char AZSMonthNames[12][4] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+// Proleptic Gregorian calendar conversions, valid for any year representable in 64 bits.
+static int64_t AZSDaysFromCivil(int64_t year, unsigned month, unsigned day)
+{
+    year -= (month <= 2);
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yearOfEra = (unsigned)(year - era * 400);
+    unsigned dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + (int64_t)dayOfEra - 719468;
+}
+
+static void AZSCivilFromDays(int64_t days, int64_t *year, unsigned *month, unsigned *day)
+{
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned dayOfEra = (unsigned)(days - era * 146097);
+    unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    unsigned shiftedMonth = (5 * dayOfYear + 2) / 153;
+    *day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+    *month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+    *year = (int64_t)yearOfEra + era * 400 + (*month <= 2);
+}
+
+static void AZSSplitTime(int64_t secondsSince1970, int64_t *days, unsigned *secondOfDay)
+{
+    *days = secondsSince1970 / 86400;
+    int64_t remainder = secondsSince1970 % 86400;
+    if (remainder < 0)
+    {
+        remainder += 86400;
+        (*days)--;
+    }
+    *secondOfDay = (unsigned)remainder;
+}
+
+static inline void AZSWriteTwoDigits(char *buffer, unsigned value)
+{
+    buffer[0] = (char)('0' + value / 10);
+    buffer[1] = (char)('0' + value % 10);
+}
+
+static inline BOOL AZSReadDigits(const char *string, int count, unsigned *value)
+{
+    unsigned result = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (string[i] < '0' || string[i] > '9')
+        {
+            return NO;
+        }
+        result = result * 10 + (unsigned)(string[i] - '0');
+    }
+    *value = result;
+    return YES;
+}
+
+static BOOL AZSTimeFromFields(unsigned year, unsigned month, unsigned day, unsigned hour, unsigned minute, unsigned second, int64_t *secondsSince1970)
+{
+    static const unsigned daysInMonth[12] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth[month - 1] || hour > 23 || minute > 59 || second > 60)
+    {
+        return NO;
+    }
+
+    BOOL leapYear = ((year % 4 == 0) && (year % 100 != 0)) || (year % 400 == 0);
+    if (month == 2 && day == 29 && !leapYear)
+    {
+        return NO;
+    }
+
+    // A leap second is folded into the following second, as NSDate has no representation for it.
+    *secondsSince1970 = AZSDaysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    return YES;
+}
+
+size_t AZSFormatRFC1123Date(int64_t secondsSince1970, char *buffer)
+{
+    int64_t days;
+    unsigned secondOfDay;
+    AZSSplitTime(secondsSince1970, &days, &secondOfDay);
+
+    int64_t year;
+    unsigned month, day;
+    AZSCivilFromDays(days, &year, &month, &day);
+    if (year < 0 || year > 9999)
+    {
+        buffer[0] = '\0';
+        return 0;
+    }
+
+    int64_t dayOfWeek = days % 7;
+    memcpy(buffer, AZSDayNames[dayOfWeek < 0 ? dayOfWeek + 7 : dayOfWeek], 3);
+    buffer[3] = ',';
+    buffer[4] = ' ';
+    AZSWriteTwoDigits(buffer + 5, day);
+    buffer[7] = ' ';
+    memcpy(buffer + 8, AZSMonthNames[month - 1], 3);
+    buffer[11] = ' ';
+    AZSWriteTwoDigits(buffer + 12, (unsigned)(year / 100));
+    AZSWriteTwoDigits(buffer + 14, (unsigned)(year % 100));
+    buffer[16] = ' ';
+    AZSWriteTwoDigits(buffer + 17, secondOfDay / 3600);
+    buffer[19] = ':';
+    AZSWriteTwoDigits(buffer + 20, (secondOfDay / 60) % 60);
+    buffer[22] = ':';
+    AZSWriteTwoDigits(buffer + 23, secondOfDay % 60);
+    memcpy(buffer + 25, " GMT", 5);
+    return AZSRFC1123DateLength;
+}
+
+BOOL AZSParseRFC1123Date(const char *string, size_t length, int64_t *secondsSince1970)
+{
+    // The day name is not checked against the date, matching the formatter's lenient behavior.
+    if (length != AZSRFC1123DateLength || string[3] != ',' || string[4] != ' ' || string[7] != ' ' || string[11] != ' ' ||
+        string[16] != ' ' || string[19] != ':' || string[22] != ':' || memcmp(string + 25, " GMT", 4) != 0)
+    {
+        return NO;
+    }
+
+    unsigned month = 0;
+    for (unsigned i = 0; i < 12; i++)
+    {
+        if (memcmp(string + 8, AZSMonthNames[i], 3) == 0)
+        {
+            month = i + 1;
+            break;
+        }
+    }
+
+    unsigned day, year, hour, minute, second;
+    if (month == 0 || !AZSReadDigits(string + 5, 2, &day) || !AZSReadDigits(string + 12, 4, &year) ||
+        !AZSReadDigits(string + 17, 2, &hour) || !AZSReadDigits(string + 20, 2, &minute) || !AZSReadDigits(string + 23, 2, &second))
+    {
+        return NO;
+    }
+
+    return AZSTimeFromFields(year, month, day, hour, minute, second, secondsSince1970);
+}
+
+size_t AZSFormatISO8601Date(int64_t secondsSince1970, char *buffer)
+{
+    int64_t days;
+    unsigned secondOfDay;
+    AZSSplitTime(secondsSince1970, &days, &secondOfDay);
+
+    int64_t year;
+    unsigned month, day;
+    AZSCivilFromDays(days, &year, &month, &day);
+    if (year < 0 || year > 9999)
+    {
+        buffer[0] = '\0';
+        return 0;
+    }
+
+    AZSWriteTwoDigits(buffer, (unsigned)(year / 100));
+    AZSWriteTwoDigits(buffer + 2, (unsigned)(year % 100));
+    buffer[4] = '-';
+    AZSWriteTwoDigits(buffer + 5, month);
+    buffer[7] = '-';
+    AZSWriteTwoDigits(buffer + 8, day);
+    buffer[10] = 'T';
+    AZSWriteTwoDigits(buffer + 11, secondOfDay / 3600);
+    buffer[13] = ':';
+    AZSWriteTwoDigits(buffer + 14, (secondOfDay / 60) % 60);
+    buffer[16] = ':';
+    AZSWriteTwoDigits(buffer + 17, secondOfDay % 60);
+    buffer[19] = 'Z';
+    buffer[20] = '\0';
+    return AZSISO8601DateLength;
+}
+
+BOOL AZSParseISO8601Date(const char *string, size_t length, double *secondsSince1970)
+{
+    if (length < AZSISO8601DateLength || string[4] != '-' || string[7] != '-' || string[10] != 'T' || string[13] != ':' ||
+        string[16] != ':' || string[length - 1] != 'Z')
+    {
+        return NO;
+    }
+
+    unsigned year, month, day, hour, minute, second;
+    if (!AZSReadDigits(string, 4, &year) || !AZSReadDigits(string + 5, 2, &month) || !AZSReadDigits(string + 8, 2, &day) ||
+        !AZSReadDigits(string + 11, 2, &hour) || !AZSReadDigits(string + 14, 2, &minute) || !AZSReadDigits(string + 17, 2, &second))
+    {
+        return NO;
+    }
+
+    double fraction = 0;
+    if (length > AZSISO8601DateLength)
+    {
+        if (string[19] != '.' || length == AZSISO8601DateLength + 1)
+        {
+            return NO;
+        }
+
+        double scale = 0.1;
+        for (size_t i = 20; i < length - 1; i++)
+        {
+            if (string[i] < '0' || string[i] > '9')
+            {
+                return NO;
+            }
+            fraction += (string[i] - '0') * scale;
+            scale /= 10;
+        }
+    }
+
+    int64_t wholeSeconds;
+    if (!AZSTimeFromFields(year, month, day, hour, minute, second, &wholeSeconds))
+    {
+        return NO;
+    }
+
+    *secondsSince1970 = (double)wholeSeconds + fraction;
+    return YES;
+}
+
+// Lookup tables for the encoding kernels.  A table lookup per byte replaces the chains of range comparisons, and
+// keeps each loop branch-light enough for the compiler to unroll.
+static const char AZSUppercaseHexDigits[] = "0123456789ABCDEF";
+static const char AZSLowercaseHexDigits[] = "0123456789abcdef";
+static const char AZSBase64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// 1 for the RFC 3986 unreserved characters: ALPHA / DIGIT / "-" / "." / "_" / "~".
+static const uint8_t AZSUnreservedCharacters[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0,
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1,
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+// The value of each hex digit, or -1.
+static const int8_t AZSHexDigitValues[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+// The value of each Base64 digit, or -1.
+static const int8_t AZSBase64DigitValues[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+size_t AZSPercentEncode(const uint8_t *bytes, size_t length, char *output)
+{
+    char *position = output;
+    for (size_t i = 0; i < length; i++)
+    {
+        uint8_t c = bytes[i];
+        if (AZSUnreservedCharacters[c])
+        {
+            *position++ = (char)c;
+        }
+        else
+        {
+            position[0] = '%';
+            position[1] = AZSUppercaseHexDigits[c >> 4];
+            position[2] = AZSUppercaseHexDigits[c & 0x0F];
+            position += 3;
+        }
+    }
+
+    return position - output;
+}
+
+size_t AZSPercentDecode(const char *string, size_t length, uint8_t *output)
+{
+    const uint8_t *bytes = (const uint8_t *)string;
+    uint8_t *position = output;
+    for (size_t i = 0; i < length; i++)
+    {
+        if (bytes[i] == '%' && i + 2 < length)
+        {
+            int high = AZSHexDigitValues[bytes[i + 1]];
+            int low = AZSHexDigitValues[bytes[i + 2]];
+            if ((high | low) >= 0)
+            {
+                *position++ = (uint8_t)((high << 4) | low);
+                i += 2;
+                continue;
+            }
+        }
+        *position++ = bytes[i];
+    }
+
+    return position - output;
+}
+
+size_t AZSBase64Encode(const uint8_t *bytes, size_t length, char *output)
+{
+    char *position = output;
+    size_t i = 0;
+    for (; i + 3 <= length; i += 3)
+    {
+        uint32_t triple = ((uint32_t)bytes[i] << 16) | ((uint32_t)bytes[i + 1] << 8) | bytes[i + 2];
+        position[0] = AZSBase64Alphabet[(triple >> 18) & 0x3F];
+        position[1] = AZSBase64Alphabet[(triple >> 12) & 0x3F];
+        position[2] = AZSBase64Alphabet[(triple >> 6) & 0x3F];
+        position[3] = AZSBase64Alphabet[triple & 0x3F];
+        position += 4;
+    }
+
+    if (i < length)
+    {
+        uint32_t triple = ((uint32_t)bytes[i] << 16) | ((i + 1 < length) ? ((uint32_t)bytes[i + 1] << 8) : 0);
+        position[0] = AZSBase64Alphabet[(triple >> 18) & 0x3F];
+        position[1] = AZSBase64Alphabet[(triple >> 12) & 0x3F];
+        position[2] = (i + 1 < length) ? AZSBase64Alphabet[(triple >> 6) & 0x3F] : '=';
+        position[3] = '=';
+        position += 4;
+    }
+
+    return position - output;
+}
+
+BOOL AZSBase64Decode(const char *string, size_t length, uint8_t *output, size_t *outputLength)
+{
+    const uint8_t *bytes = (const uint8_t *)string;
+    if (length % 4 != 0)
+    {
+        return NO;
+    }
+
+    size_t padding = 0;
+    if (length > 0 && bytes[length - 1] == '=')
+    {
+        padding = (bytes[length - 2] == '=') ? 2 : 1;
+    }
+
+    uint8_t *position = output;
+    for (size_t i = 0; i < length; i += 4)
+    {
+        BOOL last = (i + 4 == length);
+        int a = AZSBase64DigitValues[bytes[i]];
+        int b = AZSBase64DigitValues[bytes[i + 1]];
+        int c = (last && padding == 2) ? 0 : AZSBase64DigitValues[bytes[i + 2]];
+        int d = (last && padding >= 1) ? 0 : AZSBase64DigitValues[bytes[i + 3]];
+        if ((a | b | c | d) < 0)
+        {
+            return NO;
+        }
+
+        uint32_t triple = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6) | (uint32_t)d;
+        *position++ = (uint8_t)(triple >> 16);
+        if (!last || padding < 2)
+        {
+            *position++ = (uint8_t)(triple >> 8);
+        }
+        if (!last || padding < 1)
+        {
+            *position++ = (uint8_t)triple;
+        }
+    }
+
+    *outputLength = position - output;
+    return YES;
+}
+
+size_t AZSHexEncode(const uint8_t *bytes, size_t length, char *output, BOOL uppercase)
+{
+    const char *digits = uppercase ? AZSUppercaseHexDigits : AZSLowercaseHexDigits;
+    for (size_t i = 0; i < length; i++)
+    {
+        output[2 * i] = digits[bytes[i] >> 4];
+        output[2 * i + 1] = digits[bytes[i] & 0x0F];
+    }
+
+    return 2 * length;
+}
+
+BOOL AZSHexDecode(const char *string, size_t length, uint8_t *output)
+{
+    const uint8_t *bytes = (const uint8_t *)string;
+    if (length % 2 != 0)
+    {
+        return NO;
+    }
+
+    for (size_t i = 0; i < length; i += 2)
+    {
+        int high = AZSHexDigitValues[bytes[i]];
+        int low = AZSHexDigitValues[bytes[i + 1]];
+        if ((high | low) < 0)
+        {
+            return NO;
+        }
+        output[i / 2] = (uint8_t)((high << 4) | low);
+    }
+
+    return YES;
+}
+
+// Slice-by-8: each table entry advances the CRC over one more byte, so eight bytes are folded in per step.
+static const uint64_t AZSCRC64Polynomial = 0x9A6C9329AC4BC9B5ULL;
+static uint64_t AZSCRC64Table[8][256];
+
+static void AZSCRC64InitializeTables(void)
+{
+    for (unsigned n = 0; n < 256; n++)
+    {
+        uint64_t crc = n;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 1) ? ((crc >> 1) ^ AZSCRC64Polynomial) : (crc >> 1);
+        }
+        AZSCRC64Table[0][n] = crc;
+    }
+
+    for (unsigned n = 0; n < 256; n++)
+    {
+        for (int slice = 1; slice < 8; slice++)
+        {
+            uint64_t previous = AZSCRC64Table[slice - 1][n];
+            AZSCRC64Table[slice][n] = (previous >> 8) ^ AZSCRC64Table[0][previous & 0xFF];
+        }
+    }
+}
+
+uint64_t AZSCRC64Update(uint64_t crc, const void *bytes, size_t length)
+{
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        AZSCRC64InitializeTables();
+    });
+
+    const uint8_t *position = bytes;
+    crc = ~crc;
+
+    while (length > 0 && ((uintptr_t)position & 7) != 0)
+    {
+        crc = (crc >> 8) ^ AZSCRC64Table[0][(crc ^ *position++) & 0xFF];
+        length--;
+    }
+
+    while (length >= 8)
+    {
+        uint64_t word;
+        memcpy(&word, position, 8);
+        crc ^= OSSwapLittleToHostInt64(word);
+        crc = AZSCRC64Table[7][crc & 0xFF] ^
+              AZSCRC64Table[6][(crc >> 8) & 0xFF] ^
+              AZSCRC64Table[5][(crc >> 16) & 0xFF] ^
+              AZSCRC64Table[4][(crc >> 24) & 0xFF] ^
+              AZSCRC64Table[3][(crc >> 32) & 0xFF] ^
+              AZSCRC64Table[2][(crc >> 40) & 0xFF] ^
+              AZSCRC64Table[1][(crc >> 48) & 0xFF] ^
+              AZSCRC64Table[0][crc >> 56];
+        position += 8;
+        length -= 8;
+    }
+
+    while (length > 0)
+    {
+        crc = (crc >> 8) ^ AZSCRC64Table[0][(crc ^ *position++) & 0xFF];
+        length--;
+    }
+
+    return ~crc;
+}
+
+// Multiplies a 64x64 matrix over GF(2), stored as one column per element, by a vector.
+static uint64_t AZSGF2MatrixTimes(const uint64_t *matrix, uint64_t vector)
+{
+    uint64_t sum = 0;
+    while (vector)
+    {
+        if (vector & 1)
+        {
+            sum ^= *matrix;
+        }
+        vector >>= 1;
+        matrix++;
+    }
+    return sum;
+}
+
+static void AZSGF2MatrixSquare(uint64_t *square, const uint64_t *matrix)
+{
+    for (int n = 0; n < 64; n++)
+    {
+        square[n] = AZSGF2MatrixTimes(matrix, matrix[n]);
+    }
+}
+
+uint64_t AZSCRC64Combine(uint64_t crc1, uint64_t crc2, uint64_t length2)
+{
+    // As zlib's crc32_combine: apply length2 zero bytes to crc1 by repeated squaring of the one-zero-bit operator,
+    // then add crc2.  The pre- and post-inversion cancel out.
+    if (length2 == 0)
+    {
+        return crc1;
+    }
+
+    uint64_t even[64];
+    uint64_t odd[64];
+
+    odd[0] = AZSCRC64Polynomial;
+    uint64_t row = 1;
+    for (int n = 1; n < 64; n++)
+    {
+        odd[n] = row;
+        row <<= 1;
+    }
+
+    // even is the operator for two zero bits, odd for four.
+    AZSGF2MatrixSquare(even, odd);
+    AZSGF2MatrixSquare(odd, even);
+
+    do
+    {
+        // The first square gives the operator for one zero byte.
+        AZSGF2MatrixSquare(even, odd);
+        if (length2 & 1)
+        {
+            crc1 = AZSGF2MatrixTimes(even, crc1);
+        }
+        length2 >>= 1;
+        if (length2 == 0)
+        {
+            break;
+        }
+
+        AZSGF2MatrixSquare(odd, even);
+        if (length2 & 1)
+        {
+            crc1 = AZSGF2MatrixTimes(odd, crc1);
+        }
+        length2 >>= 1;
+    } while (length2 != 0);
+
+    return crc1 ^ crc2;
+}
+
+// Returns the UTF-8 bytes of a short string without allocating, copying into the caller's buffer if needed.
+static const char *AZSShortUTF8String(NSString *string, char *buffer, size_t bufferLength, size_t *length)
+{
+    const char *bytes = CFStringGetCStringPtr((__bridge CFStringRef)string, kCFStringEncodingUTF8);
+    if (!bytes)
+    {
+        if (![string getCString:buffer maxLength:bufferLength encoding:NSUTF8StringEncoding])
+        {
+            return NULL;
+        }
+        bytes = buffer;
+    }
+
+    *length = strlen(bytes);
+    return bytes;
+}
 
 @implementation AZSUtil
 
@@ -61,7 +656,9 @@
 {
     if (date)
     {
-        return [[AZSUtil dateFormatterWithRFCFormat] stringFromDate:date];
+        char buffer[AZSRFC1123DateLength + 1];
+        size_t length = AZSFormatRFC1123Date((int64_t)floor([date timeIntervalSince1970]), buffer);
+        return length ? [[NSString alloc] initWithBytes:buffer length:length encoding:NSASCIIStringEncoding] : [[AZSUtil dateFormatterWithRFCFormat] stringFromDate:date];
     }
     else
     {
@@ -69,6 +666,45 @@
     }
 }
 
++(NSDate *) dateFromHttpString:(NSString *)dateString
+{
+    if (!dateString)
+    {
+        return nil;
+    }
+
+    char buffer[64];
+    size_t length;
+    int64_t secondsSince1970;
+    const char *bytes = AZSShortUTF8String(dateString, buffer, sizeof(buffer), &length);
+    if (bytes && AZSParseRFC1123Date(bytes, length, &secondsSince1970))
+    {
+        return [NSDate dateWithTimeIntervalSince1970:secondsSince1970];
+    }
+
+    // Fall back to the formatter for anything that isn't in the canonical form.
+    return [[AZSUtil dateFormatterWithRFCFormat] dateFromString:dateString];
+}
+
++(NSDate *) dateFromRoundtripString:(NSString *)dateString
+{
+    if (!dateString)
+    {
+        return nil;
+    }
+
+    char buffer[64];
+    size_t length;
+    double secondsSince1970;
+    const char *bytes = AZSShortUTF8String(dateString, buffer, sizeof(buffer), &length);
+    if (bytes && AZSParseISO8601Date(bytes, length, &secondsSince1970))
+    {
+        return [NSDate dateWithTimeIntervalSince1970:secondsSince1970];
+    }
+
+    return [[AZSUtil dateFormatterWithRoundtripFormat] dateFromString:dateString];
+}
+
 +(NSDateFormatter *) dateFormatterWithRFCFormat
 {
     return [AZSUtil dateFormatterWithFormat:AZSCDateFormatRFC];
@@ -85,7 +721,9 @@
         return AZSCEmptyString;
     }
     
-    return [[AZSUtil dateFormatterWithFormat: AZSCDateFormatIso8601] stringFromDate:date];
+    char buffer[AZSISO8601DateLength + 1];
+    size_t length = AZSFormatISO8601Date((int64_t)floor([date timeIntervalSince1970]), buffer);
+    return length ? [[NSString alloc] initWithBytes:buffer length:length encoding:NSASCIIStringEncoding] : [[AZSUtil dateFormatterWithFormat: AZSCDateFormatIso8601] stringFromDate:date];
 }
 
 +(BOOL)streamAvailable:(NSStream *)stream
@@ -99,27 +737,61 @@
 // It should be fine for the values in a SAS token (including the sig), which is what we're currently using it for.
 +(NSString *) URLEncodedStringWithString:(NSString *)stringToConvert
 {
-    NSMutableString *encodedString = [NSMutableString string];
-    const char *sourceUTF8 = [stringToConvert cStringUsingEncoding:NSUTF8StringEncoding];
-    unsigned long length = strlen(sourceUTF8);
-    for (int i = 0; i < length; i++)
+    char utf8Buffer[256];
+    size_t length;
+    const char *sourceUTF8 = AZSShortUTF8String(stringToConvert, utf8Buffer, sizeof(utf8Buffer), &length);
+    if (!sourceUTF8)
     {
-        const char currentChar = sourceUTF8[i];
-        if (currentChar == '.' || currentChar == '-' || currentChar == '_' || currentChar == '~' ||
-                   (currentChar >= 'a' && currentChar <= 'z') ||
-                   (currentChar >= 'A' && currentChar <= 'Z') ||
-                   (currentChar >= '0' && currentChar <= '9'))
-        {
-            [encodedString appendFormat:@"%c", currentChar];
-        }
-        else
-        {
-            [encodedString appendFormat:@"%%%02X", currentChar];
-        }
+        sourceUTF8 = [stringToConvert UTF8String];
+        length = strlen(sourceUTF8);
+    }
+
+    char encodedBuffer[768];
+    char *encoded = (AZSPercentEncodedMaxLength(length) <= sizeof(encodedBuffer)) ? encodedBuffer : malloc(AZSPercentEncodedMaxLength(length));
+    size_t encodedLength = AZSPercentEncode((const uint8_t *)sourceUTF8, length, encoded);
+    NSString *encodedString = [[NSString alloc] initWithBytes:encoded length:encodedLength encoding:NSASCIIStringEncoding];
+    if (encoded != encodedBuffer)
+    {
+        free(encoded);
+    }
+    return encodedString;
+}
+
++(NSString *) base64EncodedStringWithBytes:(const void *)bytes length:(size_t)length
+{
+    char encodedBuffer[256];
+    char *encoded = (AZSBase64EncodedLength(length) <= sizeof(encodedBuffer)) ? encodedBuffer : malloc(AZSBase64EncodedLength(length));
+    size_t encodedLength = AZSBase64Encode(bytes, length, encoded);
+    NSString *encodedString = [[NSString alloc] initWithBytes:encoded length:encodedLength encoding:NSASCIIStringEncoding];
+    if (encoded != encodedBuffer)
+    {
+        free(encoded);
     }
     return encodedString;
 }
 
++(BOOL) decodeBase64String:(NSString *)string toBytes:(void *)bytes length:(size_t)length
+{
+    char utf8Buffer[256];
+    size_t utf8Length;
+    const char *utf8 = AZSShortUTF8String(string, utf8Buffer, sizeof(utf8Buffer), &utf8Length);
+
+    // Anything longer than the padded encoding of the expected length can't decode to it.
+    uint8_t decoded[AZSBase64DecodedMaxLength(sizeof(utf8Buffer))];
+    if (!utf8 || AZSBase64DecodedMaxLength(utf8Length) > MIN(length + 2, sizeof(decoded)))
+    {
+        return NO;
+    }
+
+    size_t decodedLength;
+    if (!AZSBase64Decode(utf8, utf8Length, decoded, &decodedLength) || decodedLength != length)
+    {
+        return NO;
+    }
+
+    memcpy(bytes, decoded, length);
+    return YES;
+}
 
 +(NSMutableDictionary *) parseQueryWithQueryString:(NSString *)query
 {
@@ -210,10 +882,9 @@
 {
     const char* stringToSignChar = [stringToSign cStringUsingEncoding:NSUTF8StringEncoding];
     unsigned char cHMAC[CC_SHA256_DIGEST_LENGTH];
-    CCHmac(kCCHmacAlgSHA256, [credentials.accountKey bytes], [credentials.accountKey length], stringToSignChar, strlen(stringToSignChar), cHMAC);
+    [credentials computeHmacSha256WithBytes:stringToSignChar length:strlen(stringToSignChar) digest:cHMAC];
     
-    NSData *hmac = [[NSData alloc] initWithBytes:cHMAC length:sizeof(cHMAC)];
-    return [hmac base64EncodedStringWithOptions:0];
+    return [AZSUtil base64EncodedStringWithBytes:cHMAC length:sizeof(cHMAC)];
 }
 
 +(NSError *) createErrorFromError:(NSError *)err domain:(NSString *)domain code:(NSInteger)code userInfo:(NSDictionary*)userInfo
@@ -241,9 +912,22 @@
 
 +(NSString *)calculateMD5FromData:(NSData *)data
 {
+    id<AZSDigest> digest = [[AZSCrypto provider] md5Digest];
+    [digest updateWithBytes:data.bytes length:data.length];
     unsigned char md5Bytes[CC_MD5_DIGEST_LENGTH];
-    CC_MD5(data.bytes, (CC_LONG) data.length, md5Bytes);
-    return [[[NSData alloc] initWithBytes:md5Bytes length:CC_MD5_DIGEST_LENGTH] base64EncodedStringWithOptions:0];
+    [digest finishWithDigest:md5Bytes];
+    return [AZSUtil base64EncodedStringWithBytes:md5Bytes length:CC_MD5_DIGEST_LENGTH];
+}
+
++(NSString *)calculateCRC64FromData:(NSData *)data
+{
+    return [AZSUtil base64StringFromCRC64:AZSCRC64Update(0, data.bytes, data.length)];
+}
+
++(NSString *)base64StringFromCRC64:(uint64_t)crc
+{
+    uint64_t littleEndian = OSSwapHostToLittleInt64(crc);
+    return [AZSUtil base64EncodedStringWithBytes:&littleEndian length:sizeof(littleEndian)];
 }
 
 @end
\ No newline at end of file
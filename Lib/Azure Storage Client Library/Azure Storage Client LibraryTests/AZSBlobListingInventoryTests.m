@@ -0,0 +1,171 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSBlobListingInventoryTests.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <XCTest/XCTest.h>
+#import "AZSBlobListingInventory.h"
+#import "AZSBlobListingIndex.h"
+#import "AZSBlobProperties.h"
+#import "AZSCloudBlobContainer.h"
+#import "AZSCloudBlockBlob.h"
+
+@interface AZSBlobListingInventoryTests : XCTestCase
+
+@property (strong) AZSCloudBlobContainer *container;
+
+@end
+
+@implementation AZSBlobListingInventoryTests
+
+- (void)setUp {
+    [super setUp];
+    NSError *error = nil;
+    self.container = [[AZSCloudBlobContainer alloc] initWithUrl:[NSURL URLWithString:@"https://myaccount.blob.core.windows.net/mycontainer"] error:&error];
+    XCTAssertNil(error, @"Error creating container reference.");
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+-(void)testColumnsRoundTrip {
+    AZSBlobListingInventory *inventory = [[AZSBlobListingInventory alloc] initWithContainer:self.container];
+    NSDate *lastModified = [NSDate dateWithTimeIntervalSince1970:1444000000];
+    NSString *md5 = @"1B2M2Y8AsgTpgAmY7PhCfg==";
+
+    [inventory addBlobWithName:@"a/blob1" length:5000000000ULL lastModified:lastModified eTag:@"\"0x8D2C9167D53FC2C\"" contentMD5:md5 blobType:AZSBlobTypeBlockBlob snapshotTime:nil];
+    [inventory addBlobWithName:@"a/blob2" length:0 lastModified:nil eTag:@"not-a-service-etag" contentMD5:nil blobType:AZSBlobTypePageBlob snapshotTime:nil];
+    [inventory addBlobWithName:@"b/été" length:12 lastModified:lastModified eTag:@"0x8D2C9167D53FC2C" contentMD5:nil blobType:AZSBlobTypeAppendBlob snapshotTime:nil];
+
+    XCTAssertEqual(inventory.count, 3);
+    XCTAssertTrue(inventory.sortedByName);
+
+    XCTAssertEqualObjects([inventory nameAtIndex:0], @"a/blob1");
+    XCTAssertEqual([inventory lengthAtIndex:0], 5000000000ULL);
+    XCTAssertEqual([inventory lastModifiedAtIndex:0], 1444000000);
+    XCTAssertEqualObjects([inventory eTagAtIndex:0], @"\"0x8D2C9167D53FC2C\"");
+    XCTAssertEqualObjects([inventory contentMD5AtIndex:0], md5);
+    XCTAssertEqual([inventory blobTypeAtIndex:0], AZSBlobTypeBlockBlob);
+
+    XCTAssertEqual([inventory lastModifiedAtIndex:1], 0);
+    XCTAssertEqualObjects([inventory eTagAtIndex:1], @"not-a-service-etag");
+    XCTAssertNil([inventory contentMD5AtIndex:1]);
+    uint8_t md5Bytes[16];
+    XCTAssertFalse([inventory getContentMD5:md5Bytes atIndex:1]);
+
+    XCTAssertEqualObjects([inventory nameAtIndex:2], @"b/été");
+    XCTAssertEqualObjects([inventory eTagAtIndex:2], @"0x8D2C9167D53FC2C");
+
+    AZSCloudBlob *blob = [inventory blobAtIndex:0];
+    XCTAssertTrue([blob isKindOfClass:[AZSCloudBlockBlob class]]);
+    XCTAssertEqualObjects(blob.blobName, @"a/blob1");
+    XCTAssertEqualObjects(blob.properties.length, @5000000000ULL);
+    XCTAssertEqualObjects(blob.properties.lastModified, lastModified);
+}
+
+-(void)testLookupAndMerge {
+    AZSBlobListingInventory *inventory = [[AZSBlobListingInventory alloc] initWithContainer:self.container];
+    AZSBlobListingInventory *nextSegment = [[AZSBlobListingInventory alloc] initWithContainer:self.container];
+    for (int i = 0; i < 100; i++)
+    {
+        AZSBlobListingInventory *target = (i < 50) ? inventory : nextSegment;
+        [target addBlobWithName:[NSString stringWithFormat:@"blob%03d", i] length:i lastModified:nil eTag:nil contentMD5:nil blobType:AZSBlobTypeBlockBlob snapshotTime:nil];
+    }
+    [nextSegment addBlobWithName:@"blob099" length:99 lastModified:nil eTag:@"odd" contentMD5:nil blobType:AZSBlobTypeBlockBlob snapshotTime:@"2015-10-05T00:00:00.0000000Z"];
+
+    [inventory addEntriesFromInventory:nextSegment];
+    XCTAssertEqual(inventory.count, 101);
+    XCTAssertTrue(inventory.sortedByName);
+    XCTAssertEqual([inventory indexOfBlobWithName:@"blob000"], 0);
+    XCTAssertEqual([inventory indexOfBlobWithName:@"blob073"], 73);
+    XCTAssertEqual([inventory indexOfBlobWithName:@"blob099"], 99);
+    XCTAssertEqual([inventory indexOfBlobWithName:@"blob100"], NSNotFound);
+    XCTAssertEqual([inventory lengthAtIndex:73], 73);
+    XCTAssertEqualObjects([inventory snapshotTimeAtIndex:100], @"2015-10-05T00:00:00.0000000Z");
+    XCTAssertEqualObjects([inventory eTagAtIndex:100], @"odd");
+
+    [inventory addBlobWithName:@"aaa" length:0 lastModified:nil eTag:nil contentMD5:nil blobType:AZSBlobTypeBlockBlob snapshotTime:nil];
+    XCTAssertFalse(inventory.sortedByName);
+    XCTAssertEqual([inventory indexOfBlobWithName:@"aaa"], 101);
+}
+
+-(void)testSnapshotsKeepNameOrder {
+    // The service lists a blob's snapshots before the blob itself.
+    AZSBlobListingInventory *inventory = [[AZSBlobListingInventory alloc] initWithContainer:self.container];
+    [inventory addBlobWithName:@"blob" length:1 lastModified:nil eTag:nil contentMD5:nil blobType:AZSBlobTypeBlockBlob snapshotTime:@"2015-10-05T00:00:00.0000000Z"];
+    [inventory addBlobWithName:@"blob" length:2 lastModified:nil eTag:nil contentMD5:nil blobType:AZSBlobTypeBlockBlob snapshotTime:nil];
+    XCTAssertTrue(inventory.sortedByName);
+
+    // Segments that split a blob from its snapshots are in order too.
+    AZSBlobListingInventory *nextSegment = [[AZSBlobListingInventory alloc] initWithContainer:self.container];
+    [nextSegment addBlobWithName:@"blob" length:3 lastModified:nil eTag:nil contentMD5:nil blobType:AZSBlobTypeBlockBlob snapshotTime:@"2015-10-06T00:00:00.0000000Z"];
+    [nextSegment addBlobWithName:@"other" length:4 lastModified:nil eTag:nil contentMD5:nil blobType:AZSBlobTypeBlockBlob snapshotTime:nil];
+    [inventory addEntriesFromInventory:nextSegment];
+    XCTAssertTrue(inventory.sortedByName);
+    XCTAssertEqual([inventory indexOfBlobWithName:@"blob"], 0);
+    XCTAssertEqual([inventory indexOfBlobWithName:@"other"], 3);
+}
+
+-(void)testPrefixRanges {
+    AZSBlobListingInventory *inventory = [[AZSBlobListingInventory alloc] initWithContainer:self.container];
+    for (NSString *name in @[@"a/1", @"a/2", @"ab", @"b/1", @"b/2", @"b/3", @"c"])
+    {
+        [inventory addBlobWithName:name length:0 lastModified:nil eTag:nil contentMD5:nil blobType:AZSBlobTypeBlockBlob snapshotTime:nil];
+    }
+
+    XCTAssertTrue(NSEqualRanges([inventory rangeOfBlobsWithPrefix:@"a/"], NSMakeRange(0, 2)));
+    XCTAssertTrue(NSEqualRanges([inventory rangeOfBlobsWithPrefix:@"a"], NSMakeRange(0, 3)));
+    XCTAssertTrue(NSEqualRanges([inventory rangeOfBlobsWithPrefix:@"b/"], NSMakeRange(3, 3)));
+    XCTAssertTrue(NSEqualRanges([inventory rangeOfBlobsWithPrefix:@"bb"], NSMakeRange(6, 0)));
+    XCTAssertTrue(NSEqualRanges([inventory rangeOfBlobsWithPrefix:@""], NSMakeRange(0, 7)));
+
+    AZSBlobListingInventory *spliced = [[AZSBlobListingInventory alloc] initWithContainer:self.container];
+    [spliced addEntriesFromInventory:inventory range:NSMakeRange(2, 3)];
+    XCTAssertEqual(spliced.count, 3);
+    XCTAssertEqualObjects([spliced nameAtIndex:0], @"ab");
+    XCTAssertEqualObjects([spliced nameAtIndex:2], @"b/2");
+}
+
+-(void)testIndexPersistence {
+    AZSBlobListingIndex *index = [[AZSBlobListingIndex alloc] initWithContainer:self.container];
+    [index.inventory addBlobWithName:@"blob" length:10 lastModified:[NSDate dateWithTimeIntervalSince1970:1444000000] eTag:@"\"0x8D2C9167D53FC2C\"" contentMD5:nil blobType:AZSBlobTypeBlockBlob snapshotTime:@"2015-10-05T00:00:00.0000000Z"];
+    [index.inventory addBlobWithName:@"blob" length:20 lastModified:nil eTag:@"\"0x8D2C9167D53FC2D\"" contentMD5:nil blobType:AZSBlobTypeBlockBlob snapshotTime:nil];
+    [index.inventory addBlobWithName:@"other" length:30 lastModified:nil eTag:@"W/\"weak\"" contentMD5:nil blobType:AZSBlobTypePageBlob snapshotTime:nil];
+
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    NSError *error = nil;
+    XCTAssertTrue([index writeToFile:path error:&error], @"Error writing index: %@", error);
+
+    AZSBlobListingIndex *loadedIndex = [[AZSBlobListingIndex alloc] initWithContainer:self.container contentsOfFile:path error:&error];
+    XCTAssertNotNil(loadedIndex, @"Error loading index: %@", error);
+    XCTAssertEqual(loadedIndex.inventory.count, 3);
+    XCTAssertTrue(loadedIndex.inventory.sortedByName);
+    XCTAssertTrue([loadedIndex containsBlobWithName:@"blob" eTag:@"0x8D2C9167D53FC2D"]);
+    XCTAssertFalse([loadedIndex containsBlobWithName:@"blob" eTag:@"0x8D2C9167D53FC2C"]);
+    XCTAssertEqualObjects([loadedIndex eTagOfBlobWithName:@"other"], @"W/\"weak\"");
+    XCTAssertFalse([loadedIndex containsBlobWithName:@"missing"]);
+    XCTAssertEqualObjects([loadedIndex.inventory snapshotTimeAtIndex:0], @"2015-10-05T00:00:00.0000000Z");
+    XCTAssertEqual([loadedIndex.inventory lastModifiedAtIndex:0], 1444000000);
+
+    // Appending to a loaded inventory copies the mapped columns.
+    [loadedIndex.inventory addBlobWithName:@"zzz" length:40 lastModified:nil eTag:nil contentMD5:nil blobType:AZSBlobTypeBlockBlob snapshotTime:nil];
+    XCTAssertEqual([loadedIndex.inventory lengthAtIndex:3], 40);
+    XCTAssertEqual([loadedIndex.inventory lengthAtIndex:2], 30);
+
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+}
+
+@end
@@ -0,0 +1,151 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSBulkSharedAccessSignatureTests.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <XCTest/XCTest.h>
+#import <arpa/inet.h>
+#import "AZSBulkSharedAccessSignatureGenerator.h"
+#import "AZSCloudBlobClient.h"
+#import "AZSCloudBlobContainer.h"
+#import "AZSCloudBlockBlob.h"
+#import "AZSErrors.h"
+#import "AZSIPRange.h"
+#import "AZSSharedAccessBlobParameters.h"
+#import "AZSSharedAccessHeaders.h"
+#import "AZSStorageCredentials.h"
+#import "AZSStorageUri.h"
+#import "AZSUtil.h"
+
+static const NSUInteger AZSBulkSasBenchmarkIterations = 10000;
+
+@interface AZSBulkSharedAccessSignatureTests : XCTestCase
+
+@property (strong) AZSCloudBlobContainer *container;
+@property (strong) AZSSharedAccessBlobParameters *parameters;
+
+@end
+
+@implementation AZSBulkSharedAccessSignatureTests
+
+- (void)setUp {
+    [super setUp];
+    AZSStorageCredentials *credentials = [[AZSStorageCredentials alloc] initWithAccountName:@"myaccount" accountKey:@"dGhpcyBpcyBub3QgYSByZWFsIGFjY291bnQga2V5IQ=="];
+    AZSStorageUri *storageUri = [[AZSStorageUri alloc] initWithPrimaryUri:[NSURL URLWithString:@"https://myaccount.blob.core.windows.net"]];
+    AZSCloudBlobClient *client = [[AZSCloudBlobClient alloc] initWithStorageUri:storageUri credentials:credentials];
+    self.container = [client containerReferenceFromName:@"mycontainer"];
+
+    self.parameters = [[AZSSharedAccessBlobParameters alloc] init];
+    self.parameters.permissions = AZSSharedAccessPermissionsRead;
+    self.parameters.sharedAccessExpiryTime = [NSDate dateWithTimeIntervalSince1970:1444000000];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+-(void)checkGeneratorMatchesBlobSasWithBlobNames:(NSArray *)blobNames {
+    NSError *error = nil;
+    AZSBulkSharedAccessSignatureGenerator *generator = [[AZSBulkSharedAccessSignatureGenerator alloc] initWithContainer:self.container parameters:self.parameters error:&error];
+    XCTAssertNotNil(generator, @"Error creating generator: %@", error);
+
+    for (NSString *blobName in blobNames)
+    {
+        AZSCloudBlockBlob *blob = [self.container blockBlobReferenceFromName:blobName];
+        NSString *expectedToken = [blob createSharedAccessSignatureWithParameters:self.parameters error:&error];
+        XCTAssertNil(error);
+
+        // The parameters are emitted in a different order than the query builder's, so compare them as dictionaries.
+        NSString *token = [generator sharedAccessSignatureForBlobName:blobName];
+        XCTAssertEqualObjects([AZSUtil parseQueryWithQueryString:token], [AZSUtil parseQueryWithQueryString:expectedToken], @"SAS mismatch for %@.", blobName);
+
+        NSURL *url = [generator sharedAccessURLForBlobName:blobName];
+        XCTAssertEqualObjects(url.absoluteString, [blob.storageUri.primaryUri.absoluteString stringByAppendingString:token], @"URL mismatch for %@.", blobName);
+    }
+}
+
+-(void)testMatchesBlobSas {
+    NSArray *blobNames = @[@"blob", @"dir/my blob.txt", @"été", @"a+b=c&d", @"percent%20sign"];
+    [self checkGeneratorMatchesBlobSasWithBlobNames:blobNames];
+
+    struct in_addr ip;
+    inet_aton("192.168.0.1", &ip);
+    self.parameters.permissions = AZSSharedAccessPermissionsRead | AZSSharedAccessPermissionsWrite;
+    self.parameters.sharedAccessStartTime = [NSDate dateWithTimeIntervalSince1970:1443990000];
+    self.parameters.ipAddressOrRange = [[AZSIPRange alloc] initWithSingleIP:ip];
+    self.parameters.protocols = AZSSharedAccessProtocolHttpsOnly;
+    self.parameters.headers = [[AZSSharedAccessHeaders alloc] init];
+    self.parameters.headers.contentType = @"text/plain; charset=utf-8";
+    self.parameters.headers.contentDisposition = @"attachment";
+    [self checkGeneratorMatchesBlobSasWithBlobNames:blobNames];
+}
+
+-(void)testAppendToReusableBuffer {
+    NSError *error = nil;
+    AZSBulkSharedAccessSignatureGenerator *generator = [[AZSBulkSharedAccessSignatureGenerator alloc] initWithContainer:self.container parameters:self.parameters error:&error];
+    NSMutableData *buffer = [NSMutableData data];
+
+    NSUInteger firstLength = [generator appendSharedAccessURLForBlobName:@"first" toData:buffer];
+    NSUInteger secondLength = [generator appendSharedAccessURLForBlobName:@"second" toData:buffer];
+    XCTAssertEqual(buffer.length, firstLength + secondLength);
+
+    NSString *second = [[NSString alloc] initWithBytes:((const char *)buffer.bytes + firstLength) length:secondLength encoding:NSUTF8StringEncoding];
+    XCTAssertEqualObjects(second, [generator sharedAccessURLForBlobName:@"second"].absoluteString);
+
+    // Names too long for the stack buffer take the heap path.
+    NSString *longName = [@"" stringByPaddingToLength:1024 withString:@"é" startingAtIndex:0];
+    [self checkGeneratorMatchesBlobSasWithBlobNames:@[longName]];
+}
+
+-(void)testInvalidParameters {
+    NSError *error = nil;
+    self.parameters.permissions = 1 << 12;
+    XCTAssertNil([[AZSBulkSharedAccessSignatureGenerator alloc] initWithContainer:self.container parameters:self.parameters error:&error]);
+    XCTAssertEqual(error.code, AZSEInvalidArgument);
+
+    error = nil;
+    AZSCloudBlobContainer *anonymousContainer = [[AZSCloudBlobContainer alloc] initWithUrl:[NSURL URLWithString:@"https://myaccount.blob.core.windows.net/mycontainer"] error:&error];
+    self.parameters.permissions = AZSSharedAccessPermissionsRead;
+    XCTAssertNil([[AZSBulkSharedAccessSignatureGenerator alloc] initWithContainer:anonymousContainer parameters:self.parameters error:&error]);
+    XCTAssertEqual(error.code, AZSEInvalidArgument);
+}
+
+// Each iteration signs AZSBulkSasBenchmarkIterations URLs on one thread, so URLs/sec/core is the iteration count
+// divided by the time XCTest reports.  The per-blob test is the path the generator replaces.
+-(void)testPerformanceGenerator {
+    NSError *error = nil;
+    AZSBulkSharedAccessSignatureGenerator *generator = [[AZSBulkSharedAccessSignatureGenerator alloc] initWithContainer:self.container parameters:self.parameters error:&error];
+    NSMutableData *buffer = [NSMutableData dataWithCapacity:256];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AZSBulkSasBenchmarkIterations; i++)
+        {
+            buffer.length = 0;
+            [generator appendSharedAccessURLForBlobName:@"videos/2015/10/segment-000123.ts" toData:buffer];
+        }
+    }];
+}
+
+-(void)testPerformancePerBlobSas {
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AZSBulkSasBenchmarkIterations; i++)
+        {
+            NSError *error = nil;
+            AZSCloudBlockBlob *blob = [self.container blockBlobReferenceFromName:@"videos/2015/10/segment-000123.ts"];
+            [blob.storageUri.primaryUri.absoluteString stringByAppendingString:[blob createSharedAccessSignatureWithParameters:self.parameters error:&error]];
+        }
+    }];
+}
+
+@end
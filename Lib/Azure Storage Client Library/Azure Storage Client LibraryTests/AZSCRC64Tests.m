@@ -0,0 +1,142 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSCRC64Tests.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+
+#import <XCTest/XCTest.h>
+#import "AZSClient.h"
+#import "AZSUtil.h"
+#import "AZSMockBlobService.h"
+#import "AZSTestSemaphore.h"
+
+static const NSUInteger AZSCRC64BenchmarkBufferSize = 64 * 1024 * 1024;
+
+// One bit at a time, straight from the definition.
+static uint64_t AZSReferenceCRC64(const uint8_t *bytes, size_t length)
+{
+    uint64_t crc = ~0ULL;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 1) ? ((crc >> 1) ^ 0x9A6C9329AC4BC9B5ULL) : (crc >> 1);
+        }
+    }
+    return ~crc;
+}
+
+@interface AZSCRC64Tests : XCTestCase
+
+@property (strong) NSMutableData *data;
+
+@end
+
+@implementation AZSCRC64Tests
+
+- (void)setUp {
+    [super setUp];
+    self.data = [NSMutableData dataWithLength:10007];
+    SecRandomCopyBytes(kSecRandomDefault, self.data.length, self.data.mutableBytes);
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+-(void)testKnownValue {
+    XCTAssertEqual(AZSCRC64Update(0, "123456789", 9), 0xAE8B14860A799888ULL);
+    XCTAssertEqualObjects([AZSUtil calculateCRC64FromData:[@"123456789" dataUsingEncoding:NSUTF8StringEncoding]], @"iJh5CoYUi64=");
+    XCTAssertEqual(AZSCRC64Update(0, NULL, 0), 0ULL);
+}
+
+-(void)testMatchesReferenceAtEveryAlignment {
+    const uint8_t *bytes = self.data.bytes;
+    for (size_t offset = 0; offset < 16; offset++)
+    {
+        for (size_t length = 0; length < 64; length++)
+        {
+            XCTAssertEqual(AZSCRC64Update(0, bytes + offset, length), AZSReferenceCRC64(bytes + offset, length));
+        }
+        XCTAssertEqual(AZSCRC64Update(0, bytes + offset, self.data.length - offset), AZSReferenceCRC64(bytes + offset, self.data.length - offset));
+    }
+}
+
+-(void)testUpdateAndCombine {
+    const uint8_t *bytes = self.data.bytes;
+    uint64_t whole = AZSCRC64Update(0, bytes, self.data.length);
+    for (size_t split = 0; split <= self.data.length; split += 331)
+    {
+        uint64_t first = AZSCRC64Update(0, bytes, split);
+        uint64_t second = AZSCRC64Update(0, bytes + split, self.data.length - split);
+        XCTAssertEqual(AZSCRC64Update(first, bytes + split, self.data.length - split), whole);
+        XCTAssertEqual(AZSCRC64Combine(first, second, self.data.length - split), whole);
+    }
+}
+
+-(void)testTransactionalCRC64AgainstMockService {
+    AZSMockBlobService *service = [[AZSMockBlobService alloc] initWithAccountName:@"crctestaccount" accountKey:@"Y3JjdGVzdGFjY291bnRrZXk="];
+    NSError *error = nil;
+    XCTAssertTrue([service startWithError:&error], @"Error: %@", error);
+    AZSCloudBlobContainer *container = [[[service account] getBlobClient] containerReferenceFromName:@"crccontainer"];
+    AZSCloudBlockBlob *blob = [container blockBlobReferenceFromName:@"blob"];
+
+    AZSBlobRequestOptions *options = [[AZSBlobRequestOptions alloc] init];
+    options.useTransactionalCRC64 = YES;
+    options.blockSize = 4096;
+
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [container createContainerWithCompletionHandler:^(NSError *err) {
+        XCTAssertNil(err, @"Error: %@", err);
+        [blob uploadFromData:self.data accessCondition:nil requestOptions:options operationContext:nil completionHandler:^(NSError *err) {
+            XCTAssertNil(err, @"Error: %@", err);
+            [semaphore signal];
+        }];
+    }];
+    [semaphore wait];
+    XCTAssertEqualObjects(blob.properties.contentCRC64, [AZSUtil calculateCRC64FromData:self.data]);
+
+    blob.properties.contentCRC64 = nil;
+    [blob downloadToStream:[NSOutputStream outputStreamToMemory] accessCondition:nil requestOptions:options operationContext:nil completionHandler:^(NSError *err) {
+        XCTAssertNil(err, @"Error: %@", err);
+        [semaphore signal];
+    }];
+    [semaphore wait];
+    XCTAssertEqualObjects(blob.properties.contentCRC64, [AZSUtil calculateCRC64FromData:self.data]);
+
+    AZSOperationContext *operationContext = [[AZSOperationContext alloc] init];
+    NSOutputStream *stream = [NSOutputStream outputStreamToMemory];
+    [blob downloadToStream:stream range:NSMakeRange(100, 5000) accessCondition:nil requestOptions:options operationContext:operationContext completionHandler:^(NSError *err) {
+        XCTAssertNil(err, @"Error: %@", err);
+        [semaphore signal];
+    }];
+    [semaphore wait];
+
+    AZSRequestResult *result = operationContext.requestResults.lastObject;
+    XCTAssertNotNil(result.contentReceivedCRC64);
+    XCTAssertEqualObjects(result.calculatedResponseCRC64, result.contentReceivedCRC64);
+
+    [service stop];
+}
+
+-(void)testCRC64Throughput {
+    NSMutableData *data = [NSMutableData dataWithLength:AZSCRC64BenchmarkBufferSize];
+    [self measureBlock:^{
+        AZSCRC64Update(0, data.bytes, data.length);
+    }];
+}
+
+@end
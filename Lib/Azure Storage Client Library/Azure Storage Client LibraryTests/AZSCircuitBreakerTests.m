@@ -0,0 +1,179 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSCircuitBreakerTests.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+
+#import <XCTest/XCTest.h>
+#import "AZSClient.h"
+#import "AZSTestSemaphore.h"
+
+@interface AZSCircuitBreakerTests : XCTestCase
+
+@property (strong) AZSCircuitBreaker *circuitBreaker;
+
+@end
+
+@implementation AZSCircuitBreakerTests
+
+- (void)setUp {
+    [super setUp];
+    self.circuitBreaker = [[AZSCircuitBreaker alloc] init];
+    self.circuitBreaker.minimumRequests = 4;
+    self.circuitBreaker.failureRatio = 0.5;
+    self.circuitBreaker.openDuration = 0.1;
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+-(AZSRequestResult *)resultWithLocation:(AZSStorageLocation)location statusCode:(NSInteger)statusCode
+{
+    NSHTTPURLResponse *response = (statusCode == 0) ? nil : [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"https://account.blob.core.windows.net/container"] statusCode:statusCode HTTPVersion:@"HTTP/1.1" headerFields:@{}];
+    return [[AZSRequestResult alloc] initWithStartTime:[NSDate date] location:location response:response error:nil];
+}
+
+-(void)testLocationOpensOnFailureRatio {
+    // Client errors are healthy responses.
+    [self.circuitBreaker recordResult:[self resultWithLocation:AZSStorageLocationPrimary statusCode:404]];
+    [self.circuitBreaker recordResult:[self resultWithLocation:AZSStorageLocationPrimary statusCode:200]];
+    [self.circuitBreaker recordResult:[self resultWithLocation:AZSStorageLocationPrimary statusCode:503]];
+    XCTAssertEqual([self.circuitBreaker stateForLocation:AZSStorageLocationPrimary], AZSCircuitStateClosed);
+
+    // Two failures out of four is enough.
+    [self.circuitBreaker recordResult:[self resultWithLocation:AZSStorageLocationPrimary statusCode:0]];
+    XCTAssertEqual([self.circuitBreaker stateForLocation:AZSStorageLocationPrimary], AZSCircuitStateOpen);
+    XCTAssertFalse([self.circuitBreaker allowRequestToLocation:AZSStorageLocationPrimary]);
+    XCTAssertEqual(self.circuitBreaker.tripCount, 1);
+
+    // The locations are tracked separately.
+    XCTAssertEqual([self.circuitBreaker stateForLocation:AZSStorageLocationSecondary], AZSCircuitStateClosed);
+    XCTAssertTrue([self.circuitBreaker allowRequestToLocation:AZSStorageLocationSecondary]);
+}
+
+-(void)testHalfOpenLetsOneTrialThrough {
+    for (NSUInteger i = 0; i < 4; i++)
+    {
+        [self.circuitBreaker recordResult:[self resultWithLocation:AZSStorageLocationPrimary statusCode:500]];
+    }
+    XCTAssertEqual([self.circuitBreaker stateForLocation:AZSStorageLocationPrimary], AZSCircuitStateOpen);
+
+    [NSThread sleepForTimeInterval:0.15];
+    XCTAssertEqual([self.circuitBreaker stateForLocation:AZSStorageLocationPrimary], AZSCircuitStateHalfOpen);
+    XCTAssertTrue([self.circuitBreaker allowRequestToLocation:AZSStorageLocationPrimary]);
+    XCTAssertFalse([self.circuitBreaker allowRequestToLocation:AZSStorageLocationPrimary]);
+
+    // A failed trial opens the location again.
+    [self.circuitBreaker recordResult:[self resultWithLocation:AZSStorageLocationPrimary statusCode:503]];
+    XCTAssertEqual([self.circuitBreaker stateForLocation:AZSStorageLocationPrimary], AZSCircuitStateOpen);
+    XCTAssertEqual(self.circuitBreaker.tripCount, 2);
+
+    // A successful one closes it.
+    [NSThread sleepForTimeInterval:0.15];
+    XCTAssertTrue([self.circuitBreaker allowRequestToLocation:AZSStorageLocationPrimary]);
+    [self.circuitBreaker recordResult:[self resultWithLocation:AZSStorageLocationPrimary statusCode:200]];
+    XCTAssertEqual([self.circuitBreaker stateForLocation:AZSStorageLocationPrimary], AZSCircuitStateClosed);
+    XCTAssertTrue([self.circuitBreaker allowRequestToLocation:AZSStorageLocationPrimary]);
+}
+
+-(void)testSlowRequestsCountAsFailures {
+    self.circuitBreaker.slowRequestThreshold = 0.5;
+    for (NSUInteger i = 0; i < 4; i++)
+    {
+        NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"https://account.blob.core.windows.net/container"] statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:@{}];
+        AZSRequestResult *result = [[AZSRequestResult alloc] initWithStartTime:[NSDate dateWithTimeIntervalSinceNow:-1] location:AZSStorageLocationSecondary response:response error:nil];
+        [self.circuitBreaker recordResult:result];
+    }
+    XCTAssertEqual([self.circuitBreaker stateForLocation:AZSStorageLocationSecondary], AZSCircuitStateOpen);
+
+    [self.circuitBreaker reset];
+    XCTAssertEqual([self.circuitBreaker stateForLocation:AZSStorageLocationSecondary], AZSCircuitStateClosed);
+}
+
+-(void)testCancelledRequestsAreNotFailures {
+    // The executor hands the breaker the transport's cancellation wrapped in its own error.
+    NSError *cancelled = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+    NSError *wrapped = [NSError errorWithDomain:AZSErrorDomain code:AZSEURLSessionClientError userInfo:@{AZSInnerErrorString:cancelled}];
+    for (NSUInteger i = 0; i < 4; i++)
+    {
+        AZSRequestResult *result = [[AZSRequestResult alloc] initWithStartTime:[NSDate date] location:AZSStorageLocationPrimary response:nil error:wrapped];
+        [self.circuitBreaker recordResult:result];
+    }
+    XCTAssertEqual([self.circuitBreaker stateForLocation:AZSStorageLocationPrimary], AZSCircuitStateClosed);
+    XCTAssertEqual(self.circuitBreaker.tripCount, 0);
+}
+
+-(void)testOpenPrimarySendsReadsToSecondary {
+    NSMutableArray *hosts = [NSMutableArray array];
+    NSError *error = nil;
+    AZSCloudStorageAccount *account = [AZSCloudStorageAccount accountFromConnectionString:@"DefaultEndpointsProtocol=https;AccountName=loopbackaccount;AccountKey=bG9vcGJhY2thY2NvdW50a2V5" error:&error];
+    AZSCloudBlobClient *blobClient = [account getBlobClient];
+
+    // The primary is down; the secondary is fine.
+    blobClient.httpTransport = [[AZSLoopbackTransport alloc] initWithHandler:^(NSURLRequest *request, NSData *body, void (^respond)(NSInteger, NSDictionary *, NSData *)) {
+        @synchronized(hosts)
+        {
+            [hosts addObject:request.URL.host];
+        }
+        BOOL secondary = [request.URL.host rangeOfString:@"-secondary"].location != NSNotFound;
+        respond(secondary ? 200 : 500, @{@"ETag": @"\"0x8D2000000000001\"", @"Last-Modified": @"Mon, 05 Oct 2015 20:00:00 GMT", @"x-ms-blob-type": @"BlockBlob"}, nil);
+    }];
+    blobClient.circuitBreaker = self.circuitBreaker;
+
+    AZSBlobRequestOptions *options = [[AZSBlobRequestOptions alloc] init];
+    options.storageLocationMode = AZSStorageLocationModePrimaryThenSecondary;
+    AZSCloudBlockBlob *blob = [[blobClient containerReferenceFromName:@"container"] blockBlobReferenceFromName:@"blob"];
+
+    // Without retries, each read fails on the primary until the breaker opens it.
+    for (NSUInteger i = 0; i < self.circuitBreaker.minimumRequests; i++)
+    {
+        AZSOperationContext *operationContext = [[AZSOperationContext alloc] init];
+        operationContext.retryPolicy = [[AZSRetryPolicyNoRetry alloc] init];
+        AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+        [blob existsWithAccessCondition:nil requestOptions:options operationContext:operationContext completionHandler:^(NSError *err, BOOL exists) {
+            XCTAssertNotNil(err);
+            [semaphore signal];
+        }];
+        [semaphore wait];
+    }
+    XCTAssertEqual([self.circuitBreaker stateForLocation:AZSStorageLocationPrimary], AZSCircuitStateOpen);
+
+    // Now reads go straight to the secondary.
+    [hosts removeAllObjects];
+    AZSOperationContext *operationContext = [[AZSOperationContext alloc] init];
+    operationContext.retryPolicy = [[AZSRetryPolicyNoRetry alloc] init];
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [blob existsWithAccessCondition:nil requestOptions:options operationContext:operationContext completionHandler:^(NSError *err, BOOL exists) {
+        XCTAssertNil(err, @"Error: %@", err);
+        XCTAssertTrue(exists);
+        [semaphore signal];
+    }];
+    [semaphore wait];
+    XCTAssertEqual(hosts.count, 1);
+    XCTAssertEqualObjects(hosts[0], @"loopbackaccount-secondary.blob.core.windows.net");
+
+    // An operation that must go to the primary fails at once.
+    options.storageLocationMode = AZSStorageLocationModePrimaryOnly;
+    semaphore = [[AZSTestSemaphore alloc] init];
+    [blob existsWithAccessCondition:nil requestOptions:options operationContext:nil completionHandler:^(NSError *err, BOOL exists) {
+        XCTAssertEqual(err.code, AZSECircuitOpen);
+        [semaphore signal];
+    }];
+    [semaphore wait];
+    XCTAssertEqual(hosts.count, 1);
+}
+
+@end
@@ -0,0 +1,131 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSClientMetricsTests.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <XCTest/XCTest.h>
+#import "AZSClientMetrics.h"
+
+static const NSUInteger AZSClientMetricsBenchmarkIterations = 100000;
+
+@interface AZSClientMetricsTests : XCTestCase
+
+@property (strong) AZSClientMetrics *metrics;
+
+@end
+
+@implementation AZSClientMetricsTests
+
+- (void)setUp {
+    [super setUp];
+    self.metrics = [[AZSClientMetrics alloc] init];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+-(void)recordOperation:(NSString *)operation statusCode:(NSInteger)statusCode duration:(NSTimeInterval)duration {
+    [self.metrics requestStarted];
+    [self.metrics requestFinishedWithOperation:operation statusCode:statusCode location:AZSStorageLocationPrimary duration:duration bytesSent:100 bytesReceived:1000];
+}
+
+-(void)testCounters {
+    [self.metrics requestStarted];
+    XCTAssertEqual(self.metrics.inFlightRequests, 1);
+
+    [self.metrics requestFinishedWithOperation:@"PUT comp=block" statusCode:503 location:AZSStorageLocationPrimary duration:0.5 bytesSent:4096 bytesReceived:0];
+    [self.metrics recordRetry];
+    [self recordOperation:@"PUT comp=block" statusCode:201 duration:0.1];
+    [self recordOperation:@"GET" statusCode:0 duration:2];
+
+    XCTAssertEqual(self.metrics.inFlightRequests, 0);
+    XCTAssertEqual(self.metrics.requestCount, 3);
+    XCTAssertEqual(self.metrics.retryCount, 1);
+    XCTAssertEqual(self.metrics.throttledCount, 1);
+    XCTAssertEqual(self.metrics.bytesSent, 4296);
+    XCTAssertEqual(self.metrics.bytesReceived, 2000);
+
+    [self.metrics addBufferedBytes:4096];
+    [self.metrics addBufferedBytes:-1024];
+    XCTAssertEqual(self.metrics.bufferedBytes, 3072);
+
+    [self.metrics reset];
+    XCTAssertEqual(self.metrics.requestCount, 0);
+    XCTAssertEqual(self.metrics.retryCount, 0);
+    XCTAssertEqual(self.metrics.bufferedBytes, 3072);
+}
+
+-(void)testLatencyPercentiles {
+    XCTAssertEqual([self.metrics percentile:50 ofLatencyForOperation:@"GET"], 0);
+
+    for (NSUInteger i = 1; i <= 1000; i++)
+    {
+        [self recordOperation:@"GET" statusCode:(i % 10 == 0) ? 404 : 200 duration:(i / 1000.0)];
+    }
+
+    // Buckets are at most 1/16 wide, and percentiles report the upper bound of theirs.
+    NSTimeInterval median = [self.metrics percentile:50 ofLatencyForOperation:@"GET"];
+    XCTAssertGreaterThanOrEqual(median, 0.5);
+    XCTAssertLessThanOrEqual(median, 0.5 * 17 / 16);
+
+    NSTimeInterval p99 = [self.metrics percentile:99 ofLatencyForOperation:@"GET"];
+    XCTAssertGreaterThanOrEqual(p99, 0.99);
+    XCTAssertLessThanOrEqual(p99, 0.99 * 17 / 16);
+
+    XCTAssertEqual([self.metrics percentile:50 ofLatencyForOperation:@"PUT"], 0);
+}
+
+-(void)testTextSnapshot {
+    [self recordOperation:@"GET restype=container&comp=list" statusCode:200 duration:0.003];
+    [self recordOperation:@"GET restype=container&comp=list" statusCode:200 duration:0.2];
+    [self.metrics recordRetry];
+
+    NSString *snapshot = [self.metrics textSnapshot];
+    NSString *labels = @"operation=\"GET restype=container&comp=list\",status=\"2xx\",location=\"primary\"";
+    XCTAssertTrue([snapshot containsString:[NSString stringWithFormat:@"azs_requests_total{%@} 2\n", labels]]);
+    XCTAssertTrue([snapshot containsString:[NSString stringWithFormat:@"azs_request_duration_seconds_bucket{%@,le=\"0.0025\"} 0\n", labels]]);
+    XCTAssertTrue([snapshot containsString:[NSString stringWithFormat:@"azs_request_duration_seconds_bucket{%@,le=\"0.005\"} 1\n", labels]]);
+    XCTAssertTrue([snapshot containsString:[NSString stringWithFormat:@"azs_request_duration_seconds_bucket{%@,le=\"0.25\"} 2\n", labels]]);
+    XCTAssertTrue([snapshot containsString:[NSString stringWithFormat:@"azs_request_duration_seconds_count{%@} 2\n", labels]]);
+    XCTAssertTrue([snapshot containsString:@"azs_retries_total 1\n"]);
+    XCTAssertTrue([snapshot containsString:@"azs_in_flight_requests 0\n"]);
+}
+
+-(void)testConcurrentRecording {
+    dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+        for (NSUInteger i = 0; i < 1000; i++)
+        {
+            [self recordOperation:(thread % 2) ? @"GET" : @"PUT" statusCode:200 duration:0.01];
+        }
+    });
+
+    XCTAssertEqual(self.metrics.requestCount, 8000);
+    XCTAssertEqual(self.metrics.bytesReceived, 8000000);
+    XCTAssertEqual(self.metrics.inFlightRequests, 0);
+}
+
+-(void)testPerformanceRecordRequest {
+    AZSClientMetrics *metrics = self.metrics;
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AZSClientMetricsBenchmarkIterations; i++)
+        {
+            [metrics requestStarted];
+            [metrics requestFinishedWithOperation:@"PUT comp=block" statusCode:201 location:AZSStorageLocationPrimary duration:(i % 1000) / 1000.0 bytesSent:4194304 bytesReceived:0];
+        }
+    }];
+}
+
+@end
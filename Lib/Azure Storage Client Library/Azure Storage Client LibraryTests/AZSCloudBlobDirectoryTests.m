@@ -26,6 +26,8 @@
 #import "AZSUtil.h"
 #import "AZSTestSemaphore.h"
 #import "AZSTestHelpers.h"
+#import "AZSParallelBlobLister.h"
+#import "AZSRequestGovernor.h"
 
 @interface AZSCloudBlobDirectoryTests : AZSBlobTestBase
 
@@ -270,6 +272,99 @@
     [semaphore wait];
 }
 
+- (void)testParallelListingInContainer
+{
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    
+    AZSCloudBlobDirectory *directoryA = [self.blobContainer directoryReferenceFromName:@"a"];
+    AZSCloudBlobDirectory *directoryB = [self.blobContainer directoryReferenceFromName:@"b"];
+    AZSCloudBlobDirectory *directoryAC = [directoryA subdirectoryReferenceFromName:@"c"];
+    
+    AZSCloudBlockBlob *blobA = [directoryA blockBlobReferenceFromName:@"bloba"];
+    AZSCloudBlockBlob *blobB = [directoryB blockBlobReferenceFromName:@"blobb"];
+    AZSCloudBlockBlob *blobAC = [directoryAC blockBlobReferenceFromName:@"blobac"];
+    AZSCloudBlockBlob *blobRoot = [self.blobContainer blockBlobReferenceFromName:@"blobroot"];
+    
+    [blobA uploadFromText:@"blobatext" completionHandler:^(NSError *error) {
+        XCTAssertNil(error, @"Error in uploading blob.  Error code = %ld, error domain = %@, error userinfo = %@", (long)error.code, error.domain, error.userInfo);
+        [blobB uploadFromText:@"blobbtext" completionHandler:^(NSError *error) {
+            XCTAssertNil(error, @"Error in uploading blob.  Error code = %ld, error domain = %@, error userinfo = %@", (long)error.code, error.domain, error.userInfo);
+            [blobAC uploadFromText:@"blobactext" completionHandler:^(NSError *error) {
+                XCTAssertNil(error, @"Error in uploading blob.  Error code = %ld, error domain = %@, error userinfo = %@", (long)error.code, error.domain, error.userInfo);
+                [blobRoot uploadFromText:@"blobroottext" completionHandler:^(NSError *error) {
+                    XCTAssertNil(error, @"Error in uploading blob.  Error code = %ld, error domain = %@, error userinfo = %@", (long)error.code, error.domain, error.userInfo);
+                    
+                    // A page size of one forces every partition to follow continuation tokens.
+                    AZSParallelBlobLister *lister = [[AZSParallelBlobLister alloc] initWithContainer:self.blobContainer];
+                    lister.maxResults = 1;
+                    lister.parallelismFactor = 2;
+                    lister.orderedResults = YES;
+                    
+                    NSMutableArray *blobNames = [NSMutableArray arrayWithCapacity:4];
+                    [lister listBlobsWithSegmentHandler:^(NSArray *blobs) {
+                        for (AZSCloudBlob *blob in blobs)
+                        {
+                            [blobNames addObject:blob.blobName];
+                        }
+                    } completionHandler:^(NSError *error) {
+                        XCTAssertNil(error, @"Error in listing blobs.  Error code = %ld, error domain = %@, error userinfo = %@", (long)error.code, error.domain, error.userInfo);
+                        XCTAssertEqualObjects((@[blobA.blobName, blobAC.blobName, blobB.blobName, blobRoot.blobName]), blobNames, @"Blobs listed incorrectly.");
+                        
+                        [semaphore signal];
+                    }];
+                }];
+            }];
+        }];
+    }];
+    
+    [semaphore wait];
+}
+
+- (void)testParallelListingWithoutDelimiters
+{
+    // No name contains the delimiter, so a delimiter listing would find a single partition.
+    NSMutableArray *expectedNames = [NSMutableArray arrayWithCapacity:48];
+    for (int i = 0; i < 48; i++)
+    {
+        NSString *blobName = [NSString stringWithFormat:@"%c%02d", 'a' + (i / 6), i];
+        AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+        [[self.blobContainer blockBlobReferenceFromName:blobName] uploadFromText:blobName completionHandler:^(NSError *error) {
+            XCTAssertNil(error, @"Error in uploading blob.  Error code = %ld, error domain = %@, error userinfo = %@", (long)error.code, error.domain, error.userInfo);
+            [semaphore signal];
+        }];
+        [semaphore wait];
+        [expectedNames addObject:blobName];
+    }
+    
+    // The governor only counts the listing calls in flight; it is far above the lister's parallelism.
+    AZSRequestGovernor *governor = [[AZSRequestGovernor alloc] initWithMaximumRequests:64 maximumRequestsPerHost:64];
+    self.blobClient.requestGovernor = governor;
+    
+    AZSParallelBlobLister *lister = [[AZSParallelBlobLister alloc] initWithContainer:self.blobContainer];
+    lister.maxResults = 4;
+    lister.parallelismFactor = 4;
+    lister.orderedResults = YES;
+    
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    NSMutableArray *blobNames = [NSMutableArray arrayWithCapacity:48];
+    [lister listBlobsWithSegmentHandler:^(NSArray *blobs) {
+        for (AZSCloudBlob *blob in blobs)
+        {
+            [blobNames addObject:blob.blobName];
+        }
+    } completionHandler:^(NSError *error) {
+        XCTAssertNil(error, @"Error in listing blobs.  Error code = %ld, error domain = %@, error userinfo = %@", (long)error.code, error.domain, error.userInfo);
+        XCTAssertEqualObjects(expectedNames, blobNames, @"Blobs listed incorrectly.");
+        
+        [semaphore signal];
+    }];
+    [semaphore wait];
+    
+    self.blobClient.requestGovernor = nil;
+    XCTAssertGreaterThan(governor.peakInFlightRequests, 1, @"The listing calls were not made in parallel.");
+    XCTAssertLessThanOrEqual(governor.peakInFlightRequests, 4, @"More listing calls were made at once than the parallelism factor allows.");
+}
+
 - (void)runTestCreatingBlobsInDirectoryWithDirectory:(AZSCloudBlobDirectory *)directory
 {
     AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
@@ -0,0 +1,151 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSCryptoProviderTests.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+
+#import <XCTest/XCTest.h>
+#import <CommonCrypto/CommonDigest.h>
+#import "AZSClient.h"
+#import "AZSUtil.h"
+
+static const NSUInteger AZSCryptoBenchmarkBufferSize = 64 * 1024 * 1024;
+
+// Wraps the default provider and counts what the library asks it for.
+@interface AZSCountingCryptoProvider : NSObject <AZSCryptoProvider>
+
+@property NSUInteger md5DigestCount;
+@property NSUInteger signerCount;
+
+@end
+
+@implementation AZSCountingCryptoProvider
+
+-(id<AZSDigest>)md5Digest
+{
+    @synchronized(self)
+    {
+        self.md5DigestCount++;
+    }
+    return [[AZSCommonCryptoProvider sharedProvider] md5Digest];
+}
+
+-(id<AZSHmacSigner>)hmacSha256SignerWithKey:(NSData *)key
+{
+    @synchronized(self)
+    {
+        self.signerCount++;
+    }
+    return [[AZSCommonCryptoProvider sharedProvider] hmacSha256SignerWithKey:key];
+}
+
+@end
+
+@interface AZSCryptoProviderTests : XCTestCase
+
+@end
+
+@implementation AZSCryptoProviderTests
+
+- (void)setUp {
+    [super setUp];
+}
+
+- (void)tearDown {
+    [AZSCrypto setProvider:nil];
+    [super tearDown];
+}
+
+-(NSString *)hexStringWithBytes:(const unsigned char *)bytes length:(size_t)length
+{
+    NSMutableString *hex = [NSMutableString stringWithCapacity:length * 2];
+    for (size_t i = 0; i < length; i++)
+    {
+        [hex appendFormat:@"%02x", bytes[i]];
+    }
+    return hex;
+}
+
+-(void)testDefaultProviderKnownAnswers {
+    XCTAssertTrue([[AZSCrypto provider] isKindOfClass:[AZSCommonCryptoProvider class]]);
+
+    id<AZSDigest> md5 = [[AZSCrypto provider] md5Digest];
+    XCTAssertEqual(md5.digestLength, CC_MD5_DIGEST_LENGTH);
+    [md5 updateWithBytes:"abc" length:3];
+    unsigned char md5Bytes[CC_MD5_DIGEST_LENGTH];
+    [md5 finishWithDigest:md5Bytes];
+    XCTAssertEqualObjects([self hexStringWithBytes:md5Bytes length:sizeof(md5Bytes)], @"900150983cd24fb0d6963f7d28e17f72");
+
+    // RFC 4231, test case 2.
+    const char *message = "what do ya want for nothing?";
+    id<AZSHmacSigner> signer = [[AZSCrypto provider] hmacSha256SignerWithKey:[@"Jefe" dataUsingEncoding:NSUTF8StringEncoding]];
+    unsigned char signature[CC_SHA256_DIGEST_LENGTH];
+    [signer signBytes:message length:strlen(message) digest:signature];
+    XCTAssertEqualObjects([self hexStringWithBytes:signature length:sizeof(signature)], @"5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+}
+
+-(void)testIncrementalDigestMatchesOneShot {
+    NSMutableData *data = [NSMutableData dataWithLength:100000];
+    SecRandomCopyBytes(kSecRandomDefault, data.length, data.mutableBytes);
+
+    id<AZSDigest> md5 = [[AZSCrypto provider] md5Digest];
+    for (NSUInteger offset = 0; offset < data.length; offset += 777)
+    {
+        [md5 updateWithBytes:(const uint8_t *)data.bytes + offset length:MIN(777, data.length - offset)];
+    }
+    unsigned char md5Bytes[CC_MD5_DIGEST_LENGTH];
+    [md5 finishWithDigest:md5Bytes];
+
+    XCTAssertEqualObjects([AZSUtil base64EncodedStringWithBytes:md5Bytes length:sizeof(md5Bytes)], [AZSUtil calculateMD5FromData:data]);
+}
+
+-(void)testSignerIsSafeToShareAcrossThreads {
+    id<AZSHmacSigner> signer = [[AZSCrypto provider] hmacSha256SignerWithKey:[@"key" dataUsingEncoding:NSUTF8StringEncoding]];
+    unsigned char expected[CC_SHA256_DIGEST_LENGTH];
+    [signer signBytes:"message" length:7 digest:expected];
+    NSData *expectedData = [NSData dataWithBytes:expected length:sizeof(expected)];
+
+    dispatch_apply(1000, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        unsigned char signature[CC_SHA256_DIGEST_LENGTH];
+        [signer signBytes:"message" length:7 digest:signature];
+        XCTAssertEqualObjects([NSData dataWithBytes:signature length:sizeof(signature)], expectedData);
+    });
+}
+
+-(void)testLibraryUsesCurrentProvider {
+    AZSCountingCryptoProvider *provider = [[AZSCountingCryptoProvider alloc] init];
+    [AZSCrypto setProvider:provider];
+    XCTAssertEqual([AZSCrypto provider], provider);
+
+    AZSStorageCredentials *credentials = [[AZSStorageCredentials alloc] initWithAccountName:@"account" accountKey:@"a2V5"];
+    XCTAssertEqual(provider.signerCount, 1);
+    unsigned char signature[CC_SHA256_DIGEST_LENGTH];
+    [credentials computeHmacSha256WithBytes:"message" length:7 digest:signature];
+
+    [AZSUtil calculateMD5FromData:[@"data" dataUsingEncoding:NSUTF8StringEncoding]];
+    XCTAssertEqual(provider.md5DigestCount, 1);
+
+    [AZSCrypto setProvider:nil];
+    XCTAssertTrue([[AZSCrypto provider] isKindOfClass:[AZSCommonCryptoProvider class]]);
+}
+
+-(void)testMD5Throughput {
+    NSMutableData *data = [NSMutableData dataWithLength:AZSCryptoBenchmarkBufferSize];
+    [self measureBlock:^{
+        [AZSUtil calculateMD5FromData:data];
+    }];
+}
+
+@end
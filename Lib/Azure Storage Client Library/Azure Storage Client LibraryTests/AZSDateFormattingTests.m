@@ -0,0 +1,135 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSDateFormattingTests.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <XCTest/XCTest.h>
+#import "AZSConstants.h"
+#import "AZSUtil.h"
+
+@interface AZSUtil (Testing)
++(NSDateFormatter *) dateFormatterWithFormat:(NSString *)format;
+@end
+
+static const NSUInteger AZSDateBenchmarkIterations = 10000;
+
+@interface AZSDateFormattingTests : XCTestCase
+
+@end
+
+@implementation AZSDateFormattingTests
+
+- (void)setUp {
+    [super setUp];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+-(void)testFormatMatchesFormatter {
+    NSDateFormatter *rfcFormatter = [AZSUtil dateFormatterWithRFCFormat];
+    NSDateFormatter *isoFormatter = [AZSUtil dateFormatterWithFormat:AZSCDateFormatIso8601];
+
+    // Includes the epoch, leap days, century boundaries and the end of the four-digit range.
+    NSArray *times = @[@0, @951782400, @951868800, @1444000000, @4107542399, @253402300799, @-86400];
+    for (NSNumber *time in times)
+    {
+        NSDate *date = [NSDate dateWithTimeIntervalSince1970:time.doubleValue];
+        XCTAssertEqualObjects([AZSUtil convertDateToHttpString:date], [rfcFormatter stringFromDate:date], @"RFC 1123 format mismatch for %@.", time);
+        XCTAssertEqualObjects([AZSUtil utcTimeOrEmptyWithDate:date], [isoFormatter stringFromDate:date], @"ISO 8601 format mismatch for %@.", time);
+    }
+
+    // Fractional seconds are truncated, as the formatter does.
+    NSDate *fractionalDate = [NSDate dateWithTimeIntervalSince1970:1444000000.75];
+    XCTAssertEqualObjects([AZSUtil convertDateToHttpString:fractionalDate], @"Sun, 04 Oct 2015 23:06:40 GMT");
+    XCTAssertEqualObjects([AZSUtil utcTimeOrEmptyWithDate:fractionalDate], @"2015-10-04T23:06:40Z");
+}
+
+-(void)testParse {
+    XCTAssertEqualObjects([AZSUtil dateFromHttpString:@"Sun, 04 Oct 2015 23:06:40 GMT"], [NSDate dateWithTimeIntervalSince1970:1444000000]);
+    XCTAssertEqualObjects([AZSUtil dateFromHttpString:@"Tue, 29 Feb 2000 00:00:00 GMT"], [NSDate dateWithTimeIntervalSince1970:951782400]);
+    XCTAssertEqualObjects([AZSUtil dateFromRoundtripString:@"2015-10-04T23:06:40.5000000Z"], [NSDate dateWithTimeIntervalSince1970:1444000000.5]);
+    XCTAssertEqualObjects([AZSUtil dateFromRoundtripString:@"2015-10-04T23:06:40Z"], [NSDate dateWithTimeIntervalSince1970:1444000000]);
+
+    int64_t seconds;
+    double fractionalSeconds;
+    XCTAssertFalse(AZSParseRFC1123Date("Sun, 29 Feb 2015 00:00:00 GMT", AZSRFC1123DateLength, &seconds));
+    XCTAssertFalse(AZSParseRFC1123Date("Sun, 04 Oct 2015 24:00:00 GMT", AZSRFC1123DateLength, &seconds));
+    XCTAssertFalse(AZSParseRFC1123Date("Sun, 04 Foo 2015 23:06:40 GMT", AZSRFC1123DateLength, &seconds));
+    XCTAssertFalse(AZSParseRFC1123Date("Sun, 04 Oct 2015 23:06:40 UTC", AZSRFC1123DateLength, &seconds));
+    XCTAssertFalse(AZSParseISO8601Date("2015-13-04T23:06:40Z", AZSISO8601DateLength, &fractionalSeconds));
+    XCTAssertFalse(AZSParseISO8601Date("2015-10-04T23:06:40.Z", AZSISO8601DateLength + 1, &fractionalSeconds));
+    XCTAssertFalse(AZSParseISO8601Date("2015-10-04 23:06:40Z", AZSISO8601DateLength, &fractionalSeconds));
+}
+
+-(void)testRoundTrip {
+    char buffer[AZSRFC1123DateLength + 1];
+    for (int64_t time = -2000000000; time < 4000000000; time += 7777777)
+    {
+        int64_t parsedTime;
+        XCTAssertEqual(AZSFormatRFC1123Date(time, buffer), (size_t)AZSRFC1123DateLength);
+        XCTAssertTrue(AZSParseRFC1123Date(buffer, AZSRFC1123DateLength, &parsedTime));
+        XCTAssertEqual(time, parsedTime);
+
+        double parsedIsoTime;
+        XCTAssertEqual(AZSFormatISO8601Date(time, buffer), (size_t)AZSISO8601DateLength);
+        XCTAssertTrue(AZSParseISO8601Date(buffer, AZSISO8601DateLength, &parsedIsoTime));
+        XCTAssertEqual((double)time, parsedIsoTime);
+    }
+}
+
+// The four tests below compare the kernels with the NSDateFormatter path they replace.
+-(void)testPerformanceParseWithFormatter {
+    NSString *dateString = @"Sun, 04 Oct 2015 23:06:40 GMT";
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AZSDateBenchmarkIterations; i++)
+        {
+            [[AZSUtil dateFormatterWithRFCFormat] dateFromString:dateString];
+        }
+    }];
+}
+
+-(void)testPerformanceParseWithKernel {
+    NSString *dateString = @"Sun, 04 Oct 2015 23:06:40 GMT";
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AZSDateBenchmarkIterations; i++)
+        {
+            [AZSUtil dateFromHttpString:dateString];
+        }
+    }];
+}
+
+-(void)testPerformanceFormatWithFormatter {
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:1444000000];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AZSDateBenchmarkIterations; i++)
+        {
+            [[AZSUtil dateFormatterWithFormat:AZSCDateFormatIso8601] stringFromDate:date];
+        }
+    }];
+}
+
+-(void)testPerformanceFormatWithKernel {
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:1444000000];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AZSDateBenchmarkIterations; i++)
+        {
+            [AZSUtil utcTimeOrEmptyWithDate:date];
+        }
+    }];
+}
+
+@end
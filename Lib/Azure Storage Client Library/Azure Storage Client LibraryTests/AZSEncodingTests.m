@@ -0,0 +1,140 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSEncodingTests.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <XCTest/XCTest.h>
+#import "AZSUtil.h"
+
+static const NSUInteger AZSEncodingBenchmarkIterations = 100000;
+
+@interface AZSEncodingTests : XCTestCase
+
+@end
+
+@implementation AZSEncodingTests
+
+- (void)setUp {
+    [super setUp];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+-(void)testURLEncoding {
+    XCTAssertEqualObjects([AZSUtil URLEncodedStringWithString:@"AZaz09-._~"], @"AZaz09-._~");
+    XCTAssertEqualObjects([AZSUtil URLEncodedStringWithString:@"a b/c?d=e&f+g"], @"a%20b%2Fc%3Fd%3De%26f%2Bg");
+
+    // Bytes above 0x7F used to be sign-extended into "%FFFFFFC3".
+    XCTAssertEqualObjects([AZSUtil URLEncodedStringWithString:@"été"], @"%C3%A9t%C3%A9");
+
+    NSString *longString = [@"" stringByPaddingToLength:1000 withString:@"é " startingAtIndex:0];
+    XCTAssertEqualObjects([[AZSUtil URLEncodedStringWithString:longString] stringByRemovingPercentEncoding], longString);
+
+    uint8_t decoded[16];
+    const char *malformed = "%4x%41%2";
+    size_t decodedLength = AZSPercentDecode(malformed, strlen(malformed), decoded);
+    XCTAssertEqual(decodedLength, 6);
+    XCTAssertEqual(memcmp(decoded, "%4xA%2", 6), 0);
+}
+
+-(void)testBase64MatchesNSData {
+    uint8_t bytes[64];
+    for (size_t i = 0; i < sizeof(bytes); i++)
+    {
+        bytes[i] = (uint8_t)(i * 37 + 11);
+    }
+
+    for (size_t length = 0; length <= sizeof(bytes); length++)
+    {
+        NSString *expected = [[NSData dataWithBytes:bytes length:length] base64EncodedStringWithOptions:0];
+        XCTAssertEqualObjects([AZSUtil base64EncodedStringWithBytes:bytes length:length], expected, @"Mismatch for length %zu.", length);
+
+        uint8_t decoded[64];
+        XCTAssertTrue([AZSUtil decodeBase64String:expected toBytes:decoded length:length]);
+        XCTAssertEqual(memcmp(decoded, bytes, length), 0);
+    }
+
+    uint8_t md5[16];
+    XCTAssertTrue([AZSUtil decodeBase64String:@"1B2M2Y8AsgTpgAmY7PhCfg==" toBytes:md5 length:sizeof(md5)]);
+    XCTAssertFalse([AZSUtil decodeBase64String:@"1B2M2Y8AsgTpgAmY7PhCfg" toBytes:md5 length:sizeof(md5)]);
+    XCTAssertFalse([AZSUtil decodeBase64String:@"1B2M2Y8AsgTpgAmY7PhC" toBytes:md5 length:sizeof(md5)]);
+    XCTAssertFalse([AZSUtil decodeBase64String:@"1B2M2Y8A*gTpgAmY7PhCfg==" toBytes:md5 length:sizeof(md5)]);
+    XCTAssertFalse([AZSUtil decodeBase64String:@"1B2M=Y8AsgTpgAmY7PhCfg==" toBytes:md5 length:sizeof(md5)]);
+}
+
+-(void)testHex {
+    const uint8_t bytes[] = {0x00, 0x7F, 0x80, 0xAB, 0xFF};
+    char encoded[AZSHexEncodedLength(sizeof(bytes))];
+    XCTAssertEqual(AZSHexEncode(bytes, sizeof(bytes), encoded, YES), sizeof(encoded));
+    XCTAssertEqual(memcmp(encoded, "007F80ABFF", sizeof(encoded)), 0);
+    AZSHexEncode(bytes, sizeof(bytes), encoded, NO);
+    XCTAssertEqual(memcmp(encoded, "007f80abff", sizeof(encoded)), 0);
+
+    uint8_t decoded[sizeof(bytes)];
+    XCTAssertTrue(AZSHexDecode("007f80ABff", 10, decoded));
+    XCTAssertEqual(memcmp(decoded, bytes, sizeof(bytes)), 0);
+    XCTAssertFalse(AZSHexDecode("007", 3, decoded));
+    XCTAssertFalse(AZSHexDecode("0g", 2, decoded));
+}
+
+// The pairs of tests below compare the kernels with the Foundation paths they replace.
+-(void)testPerformanceBase64WithNSData {
+    uint8_t digest[32] = {0};
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AZSEncodingBenchmarkIterations; i++)
+        {
+            [[[NSData alloc] initWithBytes:digest length:sizeof(digest)] base64EncodedStringWithOptions:0];
+        }
+    }];
+}
+
+-(void)testPerformanceBase64WithKernel {
+    uint8_t digest[32] = {0};
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AZSEncodingBenchmarkIterations; i++)
+        {
+            [AZSUtil base64EncodedStringWithBytes:digest length:sizeof(digest)];
+        }
+    }];
+}
+
+-(void)testPerformanceURLEncodeWithFormat {
+    NSString *value = @"2015-10-04T23:06:40Z/a blob name+with=reserved&characters";
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AZSEncodingBenchmarkIterations; i++)
+        {
+            NSMutableString *encodedString = [NSMutableString string];
+            const char *sourceUTF8 = [value UTF8String];
+            for (size_t j = 0; sourceUTF8[j]; j++)
+            {
+                [encodedString appendFormat:@"%%%02X", (unsigned char)sourceUTF8[j]];
+            }
+        }
+    }];
+}
+
+-(void)testPerformanceURLEncodeWithKernel {
+    NSString *value = @"2015-10-04T23:06:40Z/a blob name+with=reserved&characters";
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AZSEncodingBenchmarkIterations; i++)
+        {
+            [AZSUtil URLEncodedStringWithString:value];
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,156 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSHedgingPolicyTests.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+
+
+#import <XCTest/XCTest.h>
+#import "AZSClient.h"
+#import "AZSTestSemaphore.h"
+
+@interface AZSHedgingPolicyTests : XCTestCase
+
+@property (strong) AZSHedgingPolicy *hedgingPolicy;
+
+@end
+
+@implementation AZSHedgingPolicyTests
+
+- (void)setUp {
+    [super setUp];
+    self.hedgingPolicy = [[AZSHedgingPolicy alloc] init];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+-(void)testDelayTracksPercentile {
+    self.hedgingPolicy.minimumSamples = 100;
+    self.hedgingPolicy.minimumDelay = 0.001;
+
+    // Not enough samples yet, so no hedging.
+    for (NSUInteger i = 1; i < 100; i++)
+    {
+        [self.hedgingPolicy recordResponseLatency:i / 1000.0];
+    }
+    XCTAssertEqual(self.hedgingPolicy.currentDelay, 0);
+
+    // 1 ms to 100 ms; the 95th percentile is about 95 ms.
+    [self.hedgingPolicy recordResponseLatency:0.1];
+    XCTAssertEqualWithAccuracy(self.hedgingPolicy.currentDelay, 0.095, 0.002);
+
+    self.hedgingPolicy.fixedDelay = 0.5;
+    XCTAssertEqual(self.hedgingPolicy.currentDelay, 0.5);
+
+    [self.hedgingPolicy recordEligibleRequest];
+    [self.hedgingPolicy recordEligibleRequest];
+    [self.hedgingPolicy recordHedge];
+    XCTAssertEqualWithAccuracy(self.hedgingPolicy.hedgeRate, 0.5, 0.0001);
+
+    [self.hedgingPolicy reset];
+    self.hedgingPolicy.fixedDelay = 0;
+    XCTAssertEqual(self.hedgingPolicy.currentDelay, 0);
+    XCTAssertEqual(self.hedgingPolicy.hedgeRate, 0);
+}
+
+-(void)runExistsWithBlob:(AZSCloudBlockBlob *)blob options:(AZSBlobRequestOptions *)options
+{
+    AZSOperationContext *operationContext = [[AZSOperationContext alloc] init];
+    operationContext.retryPolicy = [[AZSRetryPolicyNoRetry alloc] init];
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [blob existsWithAccessCondition:nil requestOptions:options operationContext:operationContext completionHandler:^(NSError *err, BOOL exists) {
+        XCTAssertNil(err, @"Error: %@", err);
+        XCTAssertTrue(exists);
+        [semaphore signal];
+    }];
+    [semaphore wait];
+}
+
+-(void)testSlowPrimaryIsHedgedToSecondary {
+    __block NSTimeInterval primaryDelay = 0.5;
+    NSError *error = nil;
+    AZSCloudStorageAccount *account = [AZSCloudStorageAccount accountFromConnectionString:@"DefaultEndpointsProtocol=https;AccountName=loopbackaccount;AccountKey=bG9vcGJhY2thY2NvdW50a2V5" error:&error];
+    AZSCloudBlobClient *blobClient = [account getBlobClient];
+    AZSLoopbackTransport *transport = [[AZSLoopbackTransport alloc] initWithHandler:^(NSURLRequest *request, NSData *body, void (^respond)(NSInteger, NSDictionary *, NSData *)) {
+        NSDictionary *headers = @{@"ETag": @"\"0x8D2000000000001\"", @"Last-Modified": @"Mon, 05 Oct 2015 20:00:00 GMT", @"x-ms-blob-type": @"BlockBlob"};
+        BOOL secondary = [request.URL.host rangeOfString:@"-secondary"].location != NSNotFound;
+        NSTimeInterval delay = secondary ? 0 : primaryDelay;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            respond(200, headers, nil);
+        });
+    }];
+    blobClient.httpTransport = transport;
+    blobClient.hedgingPolicy = self.hedgingPolicy;
+    self.hedgingPolicy.fixedDelay = 0.05;
+
+    AZSBlobRequestOptions *options = [[AZSBlobRequestOptions alloc] init];
+    options.storageLocationMode = AZSStorageLocationModePrimaryThenSecondary;
+    AZSCloudBlockBlob *blob = [[blobClient containerReferenceFromName:@"container"] blockBlobReferenceFromName:@"blob"];
+
+    // The secondary answers long before the primary.
+    NSDate *start = [NSDate date];
+    [self runExistsWithBlob:blob options:options];
+    XCTAssertLessThan([[NSDate date] timeIntervalSinceDate:start], primaryDelay);
+    XCTAssertEqual(self.hedgingPolicy.eligibleRequests, 1);
+    XCTAssertEqual(self.hedgingPolicy.hedgedRequests, 1);
+    XCTAssertEqual(self.hedgingPolicy.hedgeWins, 1);
+    XCTAssertEqual(transport.requestCount, 2);
+
+    // A primary that answers within the delay is not hedged.
+    primaryDelay = 0;
+    [self runExistsWithBlob:blob options:options];
+    XCTAssertEqual(self.hedgingPolicy.eligibleRequests, 2);
+    XCTAssertEqual(self.hedgingPolicy.hedgedRequests, 1);
+    XCTAssertEqual(transport.requestCount, 3);
+
+    // Reads that must go to the primary are never hedged.
+    primaryDelay = 0.2;
+    options.storageLocationMode = AZSStorageLocationModePrimaryOnly;
+    [self runExistsWithBlob:blob options:options];
+    XCTAssertEqual(self.hedgingPolicy.eligibleRequests, 2);
+    XCTAssertEqual(self.hedgingPolicy.hedgedRequests, 1);
+    XCTAssertEqual(transport.requestCount, 4);
+}
+
+-(void)testHedgeWinRecordsElapsedTime {
+    NSError *error = nil;
+    AZSCloudStorageAccount *account = [AZSCloudStorageAccount accountFromConnectionString:@"DefaultEndpointsProtocol=https;AccountName=loopbackaccount;AccountKey=bG9vcGJhY2thY2NvdW50a2V5" error:&error];
+    AZSCloudBlobClient *blobClient = [account getBlobClient];
+    blobClient.httpTransport = [[AZSLoopbackTransport alloc] initWithHandler:^(NSURLRequest *request, NSData *body, void (^respond)(NSInteger, NSDictionary *, NSData *)) {
+        NSDictionary *headers = @{@"ETag": @"\"0x8D2000000000001\"", @"Last-Modified": @"Mon, 05 Oct 2015 20:00:00 GMT", @"x-ms-blob-type": @"BlockBlob"};
+        BOOL secondary = [request.URL.host rangeOfString:@"-secondary"].location != NSNotFound;
+        NSTimeInterval delay = secondary ? 0 : 0.5;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            respond(200, headers, nil);
+        });
+    }];
+    blobClient.hedgingPolicy = self.hedgingPolicy;
+    self.hedgingPolicy.fixedDelay = 0.1;
+    self.hedgingPolicy.minimumSamples = 1;
+
+    AZSBlobRequestOptions *options = [[AZSBlobRequestOptions alloc] init];
+    options.storageLocationMode = AZSStorageLocationModePrimaryThenSecondary;
+    AZSCloudBlockBlob *blob = [[blobClient containerReferenceFromName:@"container"] blockBlobReferenceFromName:@"blob"];
+    [self runExistsWithBlob:blob options:options];
+    XCTAssertEqual(self.hedgingPolicy.hedgeWins, 1);
+
+    // The primary that lost ran for at least the hedge delay, and that is what the tracked delay now reflects.
+    self.hedgingPolicy.fixedDelay = 0;
+    XCTAssertGreaterThanOrEqual(self.hedgingPolicy.currentDelay, 0.1);
+}
+
+@end
@@ -0,0 +1,493 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSHttpTransportTests.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <XCTest/XCTest.h>
+#import "AZSClient.h"
+#import "AZSConstants.h"
+#import "AZSTestSemaphore.h"
+
+static const NSUInteger AZSHttpTransportBenchmarkIterations = 1000;
+static const NSUInteger AZSHttpTransportSlowDownloadSize = 256 * 1024;
+
+// Suspends its task after the first chunk, and records what arrives while it is suspended.
+@interface AZSSuspendingTransportDelegate : NSObject <AZSHttpTransportDelegate>
+
+@property (strong) AZSTestSemaphore *suspendedSemaphore;
+@property (strong) AZSTestSemaphore *completedSemaphore;
+@property NSUInteger chunksReceived;
+@property BOOL suspended;
+@property NSUInteger chunksWhileSuspended;
+
+@end
+
+@implementation AZSSuspendingTransportDelegate
+
+-(void)transportTask:(id<AZSHttpTransportTask>)task didReceiveResponse:(NSHTTPURLResponse *)response
+{
+}
+
+-(void)transportTask:(id<AZSHttpTransportTask>)task didReceiveData:(NSData *)data
+{
+    if (self.suspended)
+    {
+        self.chunksWhileSuspended++;
+    }
+    self.chunksReceived++;
+    if (self.chunksReceived == 1)
+    {
+        self.suspended = YES;
+        [task suspend];
+        [self.suspendedSemaphore signal];
+    }
+}
+
+-(void)transportTask:(id<AZSHttpTransportTask>)task didCompleteWithError:(NSError *)error
+{
+    [self.completedSemaphore signal];
+}
+
+@end
+
+// Answers with its response headers and then never sends the body, so that only cancel completes it.
+@interface AZSStalledBodyTask : NSObject <AZSHttpTransportTask>
+
+@property (copy) NSURLRequest *request;
+@property (strong) id<AZSHttpTransportDelegate> delegate;
+@property (strong) dispatch_queue_t queue;
+@property BOOL started;
+@property BOOL completed;
+@property int64_t countOfBytesSent;
+@property int64_t countOfBytesReceived;
+
+@end
+
+@implementation AZSStalledBodyTask
+
+-(void)resume
+{
+    dispatch_async(self.queue, ^{
+        if (self.started || self.completed)
+        {
+            return;
+        }
+        self.started = YES;
+        NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:self.request.URL statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:@{@"Content-Length": @"1024", @"ETag": @"\"0x8D2000000000001\"", @"Last-Modified": @"Mon, 05 Oct 2015 20:00:00 GMT"}];
+        [self.delegate transportTask:self didReceiveResponse:response];
+    });
+}
+
+-(void)suspend
+{
+}
+
+-(void)cancel
+{
+    dispatch_async(self.queue, ^{
+        if (self.completed)
+        {
+            return;
+        }
+        self.completed = YES;
+        [self.delegate transportTask:self didCompleteWithError:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]];
+        self.delegate = nil;
+    });
+}
+
+@end
+
+// Stalls the body of the first stalledRequests requests, and passes the rest to the wrapped transport.
+@interface AZSStalledBodyTransport : NSObject <AZSHttpTransport>
+
+@property (strong) id<AZSHttpTransport> transport;
+@property NSUInteger stalledRequests;
+
+@end
+
+@implementation AZSStalledBodyTransport
+
+-(id<AZSHttpTransportTask>)taskWithRequest:(NSURLRequest *)request body:(NSData *)body timeout:(NSTimeInterval)timeout delegate:(id<AZSHttpTransportDelegate>)delegate
+{
+    BOOL stall = NO;
+    @synchronized(self)
+    {
+        if (self.stalledRequests > 0)
+        {
+            self.stalledRequests--;
+            stall = YES;
+        }
+    }
+    if (!stall)
+    {
+        return [self.transport taskWithRequest:request body:body timeout:timeout delegate:delegate];
+    }
+
+    AZSStalledBodyTask *task = [[AZSStalledBodyTask alloc] init];
+    task.request = request;
+    task.delegate = delegate;
+    task.queue = dispatch_queue_create("com.microsoft.azure.storage.stalledbody", DISPATCH_QUEUE_SERIAL);
+    return task;
+}
+
+@end
+
+@interface AZSHttpTransportTests : XCTestCase
+
+@property (strong) AZSCloudBlobClient *blobClient;
+@property (strong) NSMutableArray *requests;
+@property (strong) NSMutableArray *statusCodes;
+
+@end
+
+@implementation AZSHttpTransportTests
+
+- (void)setUp {
+    [super setUp];
+
+    NSError *error = nil;
+    AZSCloudStorageAccount *account = [AZSCloudStorageAccount accountFromConnectionString:@"DefaultEndpointsProtocol=https;AccountName=loopbackaccount;AccountKey=bG9vcGJhY2thY2NvdW50a2V5" error:&error];
+    self.blobClient = [account getBlobClient];
+    self.requests = [NSMutableArray array];
+    self.statusCodes = [NSMutableArray array];
+
+    // Answers with the queued status codes, then 200.  GET requests get a small blob back.  A queued 0 never answers.
+    self.blobClient.httpTransport = [[AZSLoopbackTransport alloc] initWithHandler:^(NSURLRequest *request, NSData *body, void (^respond)(NSInteger, NSDictionary *, NSData *)) {
+        NSInteger statusCode = 200;
+        @synchronized(self)
+        {
+            [self.requests addObject:request];
+            if (self.statusCodes.count > 0)
+            {
+                statusCode = [self.statusCodes[0] integerValue];
+                [self.statusCodes removeObjectAtIndex:0];
+            }
+        }
+        if (statusCode == 0)
+        {
+            return;
+        }
+
+        NSMutableDictionary *headers = [NSMutableDictionary dictionaryWithDictionary:@{@"ETag": @"\"0x8D2000000000001\"", @"Last-Modified": @"Mon, 05 Oct 2015 20:00:00 GMT", @"x-ms-request-id": [[NSUUID UUID] UUIDString]}];
+        NSData *responseBody = nil;
+        if (statusCode == 200 && [request.HTTPMethod isEqualToString:@"GET"])
+        {
+            headers[@"x-ms-blob-type"] = @"BlockBlob";
+            responseBody = [@"loopback body" dataUsingEncoding:NSUTF8StringEncoding];
+        }
+        respond(statusCode, headers, responseBody);
+    }];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+-(void)testRequestsAreSignedAndRouted {
+    AZSCloudBlockBlob *blob = [[self.blobClient containerReferenceFromName:@"container"] blockBlobReferenceFromName:@"blob"];
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [blob downloadToTextWithCompletionHandler:^(NSError *err, NSString *text) {
+        XCTAssertNil(err, @"Error: %@", err);
+        XCTAssertEqualObjects(text, @"loopback body");
+        [semaphore signal];
+    }];
+    [semaphore wait];
+
+    XCTAssertEqual(self.requests.count, 1);
+    NSURLRequest *request = self.requests[0];
+    XCTAssertEqualObjects(request.HTTPMethod, @"GET");
+    XCTAssertTrue([[request valueForHTTPHeaderField:@"Authorization"] hasPrefix:@"SharedKey loopbackaccount:"]);
+    XCTAssertEqual(((AZSLoopbackTransport *)self.blobClient.httpTransport).requestCount, 1);
+}
+
+-(void)testServerBusyIsRetriedThroughTransport {
+    [self.statusCodes addObject:@503];
+    AZSOperationContext *operationContext = [[AZSOperationContext alloc] init];
+    operationContext.retryPolicy = [[AZSRetryPolicyLinear alloc] initWithMaxAttempts:3 waitTimeBetweenRetries:0.01];
+
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [[self.blobClient containerReferenceFromName:@"container"] existsWithAccessCondition:nil requestOptions:nil operationContext:operationContext completionHandler:^(NSError *err, BOOL exists) {
+        XCTAssertNil(err, @"Error: %@", err);
+        XCTAssertTrue(exists);
+        [semaphore signal];
+    }];
+    [semaphore wait];
+
+    XCTAssertEqual(self.requests.count, 2);
+    XCTAssertEqual(operationContext.requestResults.count, 2);
+}
+
+-(void)testResponseTimeoutAbandonsHungRequest {
+    [self.statusCodes addObject:@0];
+    AZSOperationContext *operationContext = [[AZSOperationContext alloc] init];
+    operationContext.retryPolicy = [[AZSRetryPolicyLinear alloc] initWithMaxAttempts:3 waitTimeBetweenRetries:0.01];
+    AZSBlobRequestOptions *options = [[AZSBlobRequestOptions alloc] init];
+    options.responseTimeout = 0.2;
+
+    // The first request never gets a response; it is abandoned long before the operation's deadline and retried.
+    NSDate *start = [NSDate date];
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [[self.blobClient containerReferenceFromName:@"container"] existsWithAccessCondition:nil requestOptions:options operationContext:operationContext completionHandler:^(NSError *err, BOOL exists) {
+        XCTAssertNil(err, @"Error: %@", err);
+        XCTAssertTrue(exists);
+        [semaphore signal];
+    }];
+    [semaphore wait];
+
+    XCTAssertLessThan([[NSDate date] timeIntervalSinceDate:start], 5);
+    XCTAssertEqual(self.requests.count, 2);
+    XCTAssertEqual(operationContext.requestResults.count, 2);
+    NSError *innerError = ((AZSRequestResult *)operationContext.requestResults[0]).error.userInfo[AZSInnerErrorString];
+    XCTAssertEqualObjects(innerError.domain, NSURLErrorDomain);
+    XCTAssertEqual(innerError.code, NSURLErrorTimedOut);
+}
+
+-(void)testIdleTimeoutAbandonsStalledBody {
+    AZSStalledBodyTransport *transport = [[AZSStalledBodyTransport alloc] init];
+    transport.transport = self.blobClient.httpTransport;
+    transport.stalledRequests = 1;
+    self.blobClient.httpTransport = transport;
+    AZSOperationContext *operationContext = [[AZSOperationContext alloc] init];
+    operationContext.retryPolicy = [[AZSRetryPolicyLinear alloc] initWithMaxAttempts:3 waitTimeBetweenRetries:0.01];
+    AZSBlobRequestOptions *options = [[AZSBlobRequestOptions alloc] init];
+    options.idleTimeout = 0.2;
+
+    // The first response's headers arrive, then its body stops; the attempt is abandoned and retried.
+    NSDate *start = [NSDate date];
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [[self.blobClient containerReferenceFromName:@"container"] existsWithAccessCondition:nil requestOptions:options operationContext:operationContext completionHandler:^(NSError *err, BOOL exists) {
+        XCTAssertNil(err, @"Error: %@", err);
+        XCTAssertTrue(exists);
+        [semaphore signal];
+    }];
+    [semaphore wait];
+
+    XCTAssertLessThan([[NSDate date] timeIntervalSinceDate:start], 5);
+    XCTAssertEqual(self.requests.count, 1);
+    XCTAssertEqual(operationContext.requestResults.count, 2);
+    AZSRequestResult *stalledResult = operationContext.requestResults[0];
+    XCTAssertEqual(stalledResult.response.statusCode, 200);
+    NSError *innerError = stalledResult.error.userInfo[AZSInnerErrorString];
+    XCTAssertEqualObjects(innerError.domain, NSURLErrorDomain);
+    XCTAssertEqual(innerError.code, NSURLErrorTimedOut);
+}
+
+-(void)testCancelAbandonsHungRequest {
+    [self.statusCodes addObject:@0];
+    AZSOperationContext *operationContext = [[AZSOperationContext alloc] init];
+
+    NSDate *start = [NSDate date];
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [[self.blobClient containerReferenceFromName:@"container"] existsWithAccessCondition:nil requestOptions:nil operationContext:operationContext completionHandler:^(NSError *err, BOOL exists) {
+        XCTAssertEqualObjects(err.domain, AZSErrorDomain);
+        XCTAssertEqual(err.code, AZSEOperationCancelled);
+        [semaphore signal];
+    }];
+    [NSThread sleepForTimeInterval:0.1];
+    [operationContext cancel];
+    [semaphore wait];
+
+    XCTAssertTrue(operationContext.cancelled);
+    XCTAssertLessThan([[NSDate date] timeIntervalSinceDate:start], 2);
+    XCTAssertEqual(self.requests.count, 1);
+
+    // A cancelled operation sends nothing more.
+    semaphore = [[AZSTestSemaphore alloc] init];
+    [[self.blobClient containerReferenceFromName:@"container"] existsWithAccessCondition:nil requestOptions:nil operationContext:operationContext completionHandler:^(NSError *err, BOOL exists) {
+        XCTAssertEqual(err.code, AZSEOperationCancelled);
+        [semaphore signal];
+    }];
+    [semaphore wait];
+    XCTAssertEqual(self.requests.count, 1);
+}
+
+-(void)testCancelRemovesRequestWaitingForGovernor {
+    self.blobClient.requestGovernor = [[AZSRequestGovernor alloc] initWithMaximumRequests:1 maximumRequestsPerHost:1];
+    [self.statusCodes addObject:@0];
+    AZSOperationContext *hungContext = [[AZSOperationContext alloc] init];
+    AZSTestSemaphore *hungSemaphore = [[AZSTestSemaphore alloc] init];
+    [[self.blobClient containerReferenceFromName:@"container"] existsWithAccessCondition:nil requestOptions:nil operationContext:hungContext completionHandler:^(NSError *err, BOOL exists) {
+        [hungSemaphore signal];
+    }];
+
+    // The hung request holds the only slot, so the second request waits in the governor's queue.
+    AZSOperationContext *operationContext = [[AZSOperationContext alloc] init];
+    NSDate *start = [NSDate date];
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [[self.blobClient containerReferenceFromName:@"container"] existsWithAccessCondition:nil requestOptions:nil operationContext:operationContext completionHandler:^(NSError *err, BOOL exists) {
+        XCTAssertEqualObjects(err.domain, AZSErrorDomain);
+        XCTAssertEqual(err.code, AZSEOperationCancelled);
+        [semaphore signal];
+    }];
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertEqual(self.blobClient.requestGovernor.waitingRequests, 1);
+    [operationContext cancel];
+    [semaphore wait];
+
+    XCTAssertLessThan([[NSDate date] timeIntervalSinceDate:start], 2);
+    XCTAssertEqual(self.blobClient.requestGovernor.waitingRequests, 0);
+    XCTAssertEqual(self.blobClient.requestGovernor.inFlightRequests, 1);
+    XCTAssertEqual(self.requests.count, 1);
+
+    [hungContext cancel];
+    [hungSemaphore wait];
+    XCTAssertEqual(self.blobClient.requestGovernor.inFlightRequests, 0);
+    XCTAssertEqual(self.requests.count, 1);
+}
+
+-(void)testCancelCutsRetryWaitShort {
+    [self.statusCodes addObject:@503];
+    AZSOperationContext *operationContext = [[AZSOperationContext alloc] init];
+    operationContext.retryPolicy = [[AZSRetryPolicyLinear alloc] initWithMaxAttempts:3 waitTimeBetweenRetries:30];
+
+    NSDate *start = [NSDate date];
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [[self.blobClient containerReferenceFromName:@"container"] existsWithAccessCondition:nil requestOptions:nil operationContext:operationContext completionHandler:^(NSError *err, BOOL exists) {
+        XCTAssertEqual(err.code, AZSEOperationCancelled);
+        [semaphore signal];
+    }];
+    [NSThread sleepForTimeInterval:0.2];
+    [operationContext cancel];
+    [semaphore wait];
+
+    XCTAssertLessThan([[NSDate date] timeIntervalSinceDate:start], 5);
+    XCTAssertEqual(self.requests.count, 1);
+}
+
+-(void)testRetryBudgetRefusesRetries {
+    [self.statusCodes addObjectsFromArray:@[@503, @503, @503]];
+    AZSRetryBudget *retryBudget = [[AZSRetryBudget alloc] initWithRetryRatio:0 maximumTokens:1];
+    self.blobClient.retryBudget = retryBudget;
+    AZSOperationContext *operationContext = [[AZSOperationContext alloc] init];
+    operationContext.retryPolicy = [[AZSRetryPolicyLinear alloc] initWithMaxAttempts:3 waitTimeBetweenRetries:0.01];
+
+    // The policy would allow 3 retries, but the budget only has a token for one.
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [[self.blobClient containerReferenceFromName:@"container"] existsWithAccessCondition:nil requestOptions:nil operationContext:operationContext completionHandler:^(NSError *err, BOOL exists) {
+        XCTAssertNotNil(err);
+        [semaphore signal];
+    }];
+    [semaphore wait];
+
+    XCTAssertEqual(self.requests.count, 2);
+    XCTAssertEqual(retryBudget.retriesAllowed, 1);
+    XCTAssertEqual(retryBudget.retriesRefused, 1);
+    XCTAssertEqual(retryBudget.availableTokens, 0);
+
+    // New requests refill the bucket.
+    AZSRetryBudget *refillingBudget = [[AZSRetryBudget alloc] initWithRetryRatio:0.25 maximumTokens:1];
+    XCTAssertTrue([refillingBudget tryAcquireRetry]);
+    XCTAssertFalse([refillingBudget tryAcquireRetry]);
+    for (NSUInteger i = 0; i < 4; i++)
+    {
+        [refillingBudget recordRequest];
+    }
+    XCTAssertTrue([refillingBudget tryAcquireRetry]);
+}
+
+-(void)testLoopbackTaskSuspendAndResume {
+    AZSLoopbackTransport *transport = [[AZSLoopbackTransport alloc] initWithHandler:^(NSURLRequest *request, NSData *body, void (^respond)(NSInteger, NSDictionary *, NSData *)) {
+        respond(200, nil, [NSMutableData dataWithLength:10 * 1024]);
+    }];
+    transport.chunkSize = 1024;
+
+    AZSSuspendingTransportDelegate *delegate = [[AZSSuspendingTransportDelegate alloc] init];
+    delegate.suspendedSemaphore = [[AZSTestSemaphore alloc] init];
+    delegate.completedSemaphore = [[AZSTestSemaphore alloc] init];
+    id<AZSHttpTransportTask> task = [transport taskWithRequest:[NSURLRequest requestWithURL:[NSURL URLWithString:@"https://loopbackaccount.blob.core.windows.net/container"]] body:nil timeout:30 delegate:delegate];
+    [task resume];
+
+    [delegate.suspendedSemaphore wait];
+    [NSThread sleepForTimeInterval:0.1];
+    XCTAssertEqual(delegate.chunksReceived, 1);
+
+    delegate.suspended = NO;
+    [task resume];
+    [delegate.completedSemaphore wait];
+    XCTAssertEqual(delegate.chunksReceived, 10);
+    XCTAssertEqual(delegate.chunksWhileSuspended, 0);
+    XCTAssertEqual(task.countOfBytesReceived, 10 * 1024);
+}
+
+-(void)testSlowConsumerSuspendsTransport {
+    NSMutableData *blobData = [NSMutableData dataWithLength:AZSHttpTransportSlowDownloadSize];
+    arc4random_buf(blobData.mutableBytes, blobData.length);
+    AZSLoopbackTransport *transport = [[AZSLoopbackTransport alloc] initWithHandler:^(NSURLRequest *request, NSData *body, void (^respond)(NSInteger, NSDictionary *, NSData *)) {
+        respond(200, @{@"ETag": @"\"0x8D2000000000001\"", @"Last-Modified": @"Mon, 05 Oct 2015 20:00:00 GMT", @"x-ms-blob-type": @"BlockBlob"}, blobData);
+    }];
+    transport.chunkSize = 4096;
+    self.blobClient.httpTransport = transport;
+    self.blobClient.metrics = [[AZSClientMetrics alloc] init];
+
+    AZSBlobRequestOptions *options = [[AZSBlobRequestOptions alloc] init];
+    options.maximumDownloadBufferSize = 16 * 1024;
+
+    // A bound pair with a small buffer, drained slowly from another thread, stands in for a slow consumer.
+    CFReadStreamRef readStream = NULL;
+    CFWriteStreamRef writeStream = NULL;
+    CFStreamCreateBoundPair(NULL, &readStream, &writeStream, 4096);
+    NSInputStream *inputStream = CFBridgingRelease(readStream);
+    NSOutputStream *outputStream = CFBridgingRelease(writeStream);
+    [inputStream open];
+
+    NSMutableData *consumed = [NSMutableData data];
+    __block int64_t peakBufferedBytes = 0;
+    AZSTestSemaphore *readerSemaphore = [[AZSTestSemaphore alloc] init];
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        uint8_t buffer[1024];
+        while (consumed.length < blobData.length)
+        {
+            NSInteger read = [inputStream read:buffer maxLength:sizeof(buffer)];
+            if (read <= 0)
+            {
+                break;
+            }
+            [consumed appendBytes:buffer length:read];
+            peakBufferedBytes = MAX(peakBufferedBytes, self.blobClient.metrics.bufferedBytes);
+            [NSThread sleepForTimeInterval:0.0005];
+        }
+        [readerSemaphore signal];
+    });
+
+    AZSCloudBlockBlob *blob = [[self.blobClient containerReferenceFromName:@"container"] blockBlobReferenceFromName:@"blob"];
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [blob downloadToStream:outputStream accessCondition:nil requestOptions:options operationContext:nil completionHandler:^(NSError *err) {
+        XCTAssertNil(err, @"Error: %@", err);
+        [semaphore signal];
+    }];
+    [semaphore wait];
+    [readerSemaphore wait];
+    [inputStream close];
+
+    XCTAssertEqualObjects(consumed, blobData);
+    // The buffer may overshoot by the chunks already on their way when the task is suspended.
+    XCTAssertLessThanOrEqual(peakBufferedBytes, (int64_t)(options.maximumDownloadBufferSize + 2 * transport.chunkSize));
+}
+
+-(void)testPerRequestOverhead {
+    AZSCloudBlobContainer *container = [self.blobClient containerReferenceFromName:@"container"];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AZSHttpTransportBenchmarkIterations; i++)
+        {
+            AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+            [container existsWithCompletionHandler:^(NSError *err, BOOL exists) {
+                [semaphore signal];
+            }];
+            [semaphore wait];
+        }
+    }];
+}
+
+@end
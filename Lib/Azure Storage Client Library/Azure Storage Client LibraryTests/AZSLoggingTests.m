@@ -0,0 +1,136 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSLoggingTests.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <XCTest/XCTest.h>
+#import "AZSLogging.h"
+#import "AZSOperationContext.h"
+
+static const NSUInteger AZSLoggingBenchmarkIterations = 1000000;
+
+@interface AZSLoggingTests : XCTestCase
+
+@property AZSLogLevel savedGlobalLogLevel;
+@property (strong) AZSOperationContext *operationContext;
+@property NSUInteger evaluationCount;
+
+@end
+
+@implementation AZSLoggingTests
+
+- (void)setUp {
+    [super setUp];
+    self.savedGlobalLogLevel = [AZSOperationContext globalLogLevel];
+    [AZSOperationContext setGlobalLogLevel:AZSLogLevelNoLogging];
+    self.operationContext = [[AZSOperationContext alloc] init];
+    self.evaluationCount = 0;
+}
+
+- (void)tearDown {
+    [AZSOperationContext setGlobalLogLevel:self.savedGlobalLogLevel];
+    [super tearDown];
+}
+
+-(NSString *)expensiveArgument {
+    self.evaluationCount++;
+    return @"argument";
+}
+
+-(void)testArgumentsOnlyEvaluatedWhenEnabled {
+    NSMutableArray *messages = [NSMutableArray arrayWithCapacity:1];
+    self.operationContext.logFunction = ^(AZSLogLevel logLevel, NSString *stringToLog) {
+        [messages addObject:stringToLog];
+    };
+
+    self.operationContext.logLevel = AZSLogLevelInfo;
+    AZSLogDebug(self.operationContext, @"Debug %@", [self expensiveArgument]);
+    XCTAssertEqual(self.evaluationCount, 0);
+    XCTAssertEqual(messages.count, 0);
+
+    AZSLogInfo(self.operationContext, @"Info %@", [self expensiveArgument]);
+    XCTAssertEqual(self.evaluationCount, 1);
+    XCTAssertEqualObjects(messages, @[@"Info argument"]);
+
+    // The global level enables logging for every context, including none at all.
+    [AZSOperationContext setGlobalLogLevel:AZSLogLevelDebug];
+    AZSLogDebug(nil, @"Debug %@", [self expensiveArgument]);
+    XCTAssertEqual(self.evaluationCount, 2);
+    XCTAssertTrue(AZSLogEnabled(nil, AZSLogLevelDebug));
+}
+
+// Redefining the maximum level here strips Debug statements below it, as building with -DAZS_LOG_MAX_LEVEL=6 would.
+#undef AZS_LOG_MAX_LEVEL
+#define AZS_LOG_MAX_LEVEL 6
+
+-(void)testCompiledOutDebugLogging {
+    self.operationContext.logLevel = AZSLogLevelDebug;
+    [AZSOperationContext setGlobalLogLevel:AZSLogLevelDebug];
+
+    AZSLogDebug(self.operationContext, @"Debug %@", [self expensiveArgument]);
+    XCTAssertEqual(self.evaluationCount, 0);
+    XCTAssertFalse(AZSLogEnabled(self.operationContext, AZSLogLevelDebug));
+
+    AZSLogInfo(self.operationContext, @"Info %@", [self expensiveArgument]);
+    XCTAssertEqual(self.evaluationCount, 1);
+}
+
+-(void)testPerformanceCompiledOut {
+    AZSOperationContext *operationContext = self.operationContext;
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AZSLoggingBenchmarkIterations; i++)
+        {
+            AZSLogDebug(operationContext, @"Current thread name = %@", [NSThread currentThread]);
+        }
+    }];
+}
+
+#undef AZS_LOG_MAX_LEVEL
+#define AZS_LOG_MAX_LEVEL 7
+
+// With logging off, the macro should cost about the same as the empty loop, while the direct call pays for the
+// message send, the varargs setup and evaluating the arguments.
+-(void)testPerformanceEmptyLoop {
+    AZSOperationContext *operationContext = self.operationContext;
+    __block NSUInteger count = 0;
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AZSLoggingBenchmarkIterations; i++)
+        {
+            count += (operationContext != nil);
+        }
+    }];
+}
+
+-(void)testPerformanceDisabledMacro {
+    AZSOperationContext *operationContext = self.operationContext;
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AZSLoggingBenchmarkIterations; i++)
+        {
+            AZSLogDebug(operationContext, @"Current thread name = %@", [NSThread currentThread]);
+        }
+    }];
+}
+
+-(void)testPerformanceDisabledDirectCall {
+    AZSOperationContext *operationContext = self.operationContext;
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AZSLoggingBenchmarkIterations; i++)
+        {
+            [operationContext logAtLevel:AZSLogLevelDebug withMessage:@"Current thread name = %@", [NSThread currentThread]];
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,97 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSMockBlobService.h" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <Foundation/Foundation.h>
+@class AZSCloudStorageAccount;
+
+// Faults the mock service can inject in place of a normal response.
+typedef NS_ENUM(NSInteger, AZSMockFault)
+{
+    AZSMockFaultNone,
+
+    // 503 Server Busy, as returned when the account is being throttled.
+    AZSMockFaultServerBusy,
+
+    // 500 Operation Timed Out.
+    AZSMockFaultInternalError,
+
+    // The connection is reset (RST) after the request is read, without any response.
+    AZSMockFaultConnectionReset,
+
+    // The response headers are sent, then the body is sent in small pieces with slowBodyDelay between them.
+    AZSMockFaultSlowBody
+};
+
+// AZSMockBlobService is an in-process stand-in for the Blob service, listening on a loopback port.  It keeps all data
+// in memory and implements enough of the REST API for the library's blob operations: containers (create, delete,
+// properties, metadata, ACL, leases, listing), block, page and append blobs, ranged reads, blob leases, the
+// conditional headers, and Shared Key verification.  Snapshots, copies and page range listing are not implemented
+// and return 501.
+//
+// Latency, bandwidth and faults can be configured at any time, so that tests and benchmarks can run without a network
+// and get the same results on every run.
+@interface AZSMockBlobService : NSObject
+
+@property (readonly) NSString *accountName;
+@property (readonly) NSString *accountKey;
+
+// The port the service is listening on, or 0 if it is not running.
+@property (readonly) uint16_t port;
+
+// The blob endpoint, in path style: http://127.0.0.1:port/accountName
+@property (readonly) NSURL *blobEndpoint;
+
+// A connection string for the account, with the blob endpoint set.
+@property (readonly) NSString *connectionString;
+
+// Added before each response is sent.
+@property NSTimeInterval latency;
+
+// Caps the rate at which each connection reads request bodies and writes response bodies.  0 means unlimited.
+@property NSUInteger bandwidthBytesPerSecond;
+
+// The pause between pieces of a response body under AZSMockFaultSlowBody.
+@property NSTimeInterval slowBodyDelay;
+
+// If NO, requests without a valid Shared Key signature are rejected with 403.  Defaults to YES.
+@property BOOL verifySharedKey;
+
+// The number of requests handled, including those that were faulted.
+@property (readonly) NSUInteger requestCount;
+
+// Returns the shared instance for tests, starting it on first use.
++(instancetype)sharedService;
+
+-(instancetype)initWithAccountName:(NSString *)accountName accountKey:(NSString *)accountKey;
+
+-(BOOL)startWithError:(NSError **)error;
+-(void)stop;
+
+// The account as the library sees it.
+-(AZSCloudStorageAccount *)account;
+
+// Deletes all containers and blobs, and clears latency, bandwidth caps and faults.
+-(void)reset;
+
+// Applies the fault to the next count requests.  Faults queued this way are used before random faults.
+-(void)injectFault:(AZSMockFault)fault count:(NSUInteger)count;
+
+// Applies the fault to each request with the given probability, chosen by a generator seeded with seed, so that a run
+// can be repeated exactly.  A probability of 0 turns random faults off.
+-(void)injectFault:(AZSMockFault)fault probability:(double)probability seed:(uint32_t)seed;
+
+@end
@@ -0,0 +1,1921 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSMockBlobService.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <arpa/inet.h>
+#import <fcntl.h>
+#import <netinet/in.h>
+#import <netinet/tcp.h>
+#import <sys/socket.h>
+#import <CommonCrypto/CommonHMAC.h>
+#import "AZSMockBlobService.h"
+#import "AZSCloudStorageAccount.h"
+#import "AZSUtil.h"
+
+static NSString *const AZSMockSharedAccountName = @"mockaccount";
+static NSString *const AZSMockSharedAccountKey = @"QVpTTW9ja0Jsb2JTZXJ2aWNlIHNoYXJlZCBrZXksIGZvciBsb2NhbCB0ZXN0aW5nIG9ubHkhISEhISEhISEh";
+static NSString *const AZSMockServiceVersion = @"2015-04-05";
+
+// Like the real service, the CRC64 headers are ignored on requests for older versions.
+static NSString *const AZSMockCRC64Version = @"2019-02-02";
+
+static const NSUInteger AZSMockSlowBodyPieceSize = 1024;
+static const NSUInteger AZSMockBodyPieceSize = 64 * 1024;
+static const NSUInteger AZSMockMaxBlockSize = 4 * 1024 * 1024;
+static const NSUInteger AZSMockMaxAppendBlockCount = 50000;
+
+#pragma mark - Model
+
+@interface AZSMockLease : NSObject
+@property (copy) NSString *state;
+@property (copy) NSString *leaseId;
+@property NSInteger duration;
+@property (strong) NSDate *expiry;
+@property (strong) NSDate *breakTime;
+@end
+
+@implementation AZSMockLease
+
+-(instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        _state = @"available";
+    }
+    return self;
+}
+
+// Moves a timed lease to expired, and a breaking lease to broken, once their time is up.
+-(NSString *)currentState
+{
+    NSDate *now = [NSDate date];
+    if ([self.state isEqualToString:@"leased"] && self.expiry && [now compare:self.expiry] != NSOrderedAscending)
+    {
+        self.state = @"expired";
+    }
+    else if ([self.state isEqualToString:@"breaking"] && [now compare:self.breakTime] != NSOrderedAscending)
+    {
+        self.state = @"broken";
+    }
+    return self.state;
+}
+
+-(BOOL)isActive
+{
+    NSString *state = [self currentState];
+    return [state isEqualToString:@"leased"] || [state isEqualToString:@"breaking"];
+}
+
+@end
+
+@interface AZSMockResource : NSObject
+@property (copy) NSString *etag;
+@property (strong) NSDate *lastModified;
+@property (strong) NSMutableDictionary *metadata;
+@property (strong) AZSMockLease *lease;
+-(void)touch;
+@end
+
+@implementation AZSMockResource
+
+-(instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        _metadata = [NSMutableDictionary dictionary];
+        _lease = [[AZSMockLease alloc] init];
+        [self touch];
+    }
+    return self;
+}
+
+// Callers hold the service lock, which also guards the counter.
+-(void)touch
+{
+    static uint64_t etagCounter = 0x8D2000000000000;
+    self.etag = [NSString stringWithFormat:@"\"0x%llX\"", ++etagCounter];
+
+    // Last-Modified has one second resolution on the wire.
+    self.lastModified = [NSDate dateWithTimeIntervalSince1970:floor([[NSDate date] timeIntervalSince1970])];
+}
+
+@end
+
+@interface AZSMockContainer : AZSMockResource
+@property (strong) NSMutableDictionary *blobs;
+@property (copy) NSString *publicAccess;
+@end
+
+@implementation AZSMockContainer
+
+-(instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        _blobs = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+@end
+
+@interface AZSMockBlock : NSObject
+@property (copy) NSString *blockId;
+@property (strong) NSData *data;
+@end
+
+@implementation AZSMockBlock
+@end
+
+@interface AZSMockBlob : AZSMockResource
+@property (copy) NSString *blobType;
+@property BOOL committed;
+@property (strong) NSMutableData *data;
+@property (strong) NSMutableDictionary *properties;
+@property (strong) NSArray *committedBlocks;
+@property (strong) NSMutableDictionary *uncommittedBlocks;
+@property (strong) NSMutableArray *uncommittedBlockOrder;
+@property int64_t sequenceNumber;
+@property NSUInteger appendBlockCount;
+@end
+
+@implementation AZSMockBlob
+
+-(instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        _data = [NSMutableData data];
+        _properties = [NSMutableDictionary dictionary];
+        _committedBlocks = @[];
+        _uncommittedBlocks = [NSMutableDictionary dictionary];
+        _uncommittedBlockOrder = [NSMutableArray array];
+    }
+    return self;
+}
+
+@end
+
+#pragma mark - HTTP
+
+@interface AZSMockRequest : NSObject
+@property (copy) NSString *method;
+@property (copy) NSString *rawPath;
+@property (strong) NSMutableArray *rawHeaders;
+@property (strong) NSMutableDictionary *headers;
+@property (strong) NSMutableDictionary *query;
+@property (strong) NSData *body;
+-(NSString *)header:(NSString *)name;
+@end
+
+@implementation AZSMockRequest
+
+-(instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        _rawHeaders = [NSMutableArray array];
+        _headers = [NSMutableDictionary dictionary];
+        _query = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+// Header names are matched case-insensitively; repeated headers are joined with commas.
+-(NSString *)header:(NSString *)name
+{
+    return self.headers[name.lowercaseString];
+}
+
+// Query parameter names are matched case-insensitively.  Repeated parameters are joined with commas, as in the string to sign.
+-(NSString *)queryValue:(NSString *)name
+{
+    return [self.query[name.lowercaseString] componentsJoinedByString:@","];
+}
+
+@end
+
+@interface AZSMockResponse : NSObject
+@property NSInteger statusCode;
+@property (strong) NSMutableDictionary *headers;
+@property (strong) NSData *body;
+@end
+
+@implementation AZSMockResponse
+
++(instancetype)responseWithStatusCode:(NSInteger)statusCode
+{
+    AZSMockResponse *response = [[AZSMockResponse alloc] init];
+    response.statusCode = statusCode;
+    response.headers = [NSMutableDictionary dictionary];
+    return response;
+}
+
++(instancetype)errorWithStatusCode:(NSInteger)statusCode code:(NSString *)code message:(NSString *)message
+{
+    AZSMockResponse *response = [self responseWithStatusCode:statusCode];
+    response.headers[@"Content-Type"] = @"application/xml";
+    response.body = [[NSString stringWithFormat:@"<?xml version=\"1.0\" encoding=\"utf-8\"?><Error><Code>%@</Code><Message>%@</Message></Error>", code, message] dataUsingEncoding:NSUTF8StringEncoding];
+    return response;
+}
+
++(instancetype)xmlResponseWithString:(NSString *)xml
+{
+    AZSMockResponse *response = [self responseWithStatusCode:200];
+    response.headers[@"Content-Type"] = @"application/xml";
+    response.body = [xml dataUsingEncoding:NSUTF8StringEncoding];
+    return response;
+}
+
+@end
+
+static NSString *AZSMockXmlEscape(NSString *string)
+{
+    NSMutableString *escaped = [NSMutableString stringWithString:string ?: @""];
+    [escaped replaceOccurrencesOfString:@"&" withString:@"&amp;" options:0 range:NSMakeRange(0, escaped.length)];
+    [escaped replaceOccurrencesOfString:@"<" withString:@"&lt;" options:0 range:NSMakeRange(0, escaped.length)];
+    [escaped replaceOccurrencesOfString:@">" withString:@"&gt;" options:0 range:NSMakeRange(0, escaped.length)];
+    [escaped replaceOccurrencesOfString:@"\"" withString:@"&quot;" options:0 range:NSMakeRange(0, escaped.length)];
+    return escaped;
+}
+
+// Parses "bytes=start-end" or "bytes=start-".  end is inclusive, and defaults to UINT64_MAX.
+static BOOL AZSMockParseRange(NSString *value, uint64_t *start, uint64_t *end)
+{
+    NSScanner *scanner = [NSScanner scannerWithString:value];
+    unsigned long long first = 0;
+    unsigned long long last = UINT64_MAX;
+    if (![scanner scanString:@"bytes=" intoString:NULL] || ![scanner scanUnsignedLongLong:&first] || ![scanner scanString:@"-" intoString:NULL])
+    {
+        return NO;
+    }
+    if (!scanner.isAtEnd && (![scanner scanUnsignedLongLong:&last] || !scanner.isAtEnd || last < first))
+    {
+        return NO;
+    }
+
+    *start = first;
+    *end = last;
+    return YES;
+}
+
+// Collects the entries of a Put Block List body.
+@interface AZSMockBlockListParser : NSObject <NSXMLParserDelegate>
+@property (strong) NSMutableArray *entries;
+@property (strong) NSMutableString *text;
+@end
+
+@implementation AZSMockBlockListParser
+
+-(instancetype)init
+{
+    self = [super init];
+    if (self)
+    {
+        _entries = [NSMutableArray array];
+    }
+    return self;
+}
+
+-(void)parser:(NSXMLParser *)parser didStartElement:(NSString *)elementName namespaceURI:(NSString *)namespaceURI qualifiedName:(NSString *)qName attributes:(NSDictionary *)attributeDict
+{
+    self.text = [NSMutableString string];
+}
+
+-(void)parser:(NSXMLParser *)parser foundCharacters:(NSString *)string
+{
+    [self.text appendString:string];
+}
+
+-(void)parser:(NSXMLParser *)parser didEndElement:(NSString *)elementName namespaceURI:(NSString *)namespaceURI qualifiedName:(NSString *)qName
+{
+    if ([elementName isEqualToString:@"Latest"] || [elementName isEqualToString:@"Committed"] || [elementName isEqualToString:@"Uncommitted"])
+    {
+        [self.entries addObject:@[elementName, [self.text copy]]];
+    }
+}
+
+@end
+
+#pragma mark - Service
+
+@interface AZSMockBlobService()
+{
+    dispatch_source_t _acceptSource;
+    NSData *_keyData;
+    NSMutableDictionary *_containers;
+    NSMutableArray *_queuedFaults;
+    AZSMockFault _randomFault;
+    double _randomFaultProbability;
+    uint32_t _randomState;
+}
+
+@property (readwrite) uint16_t port;
+@property (readwrite) NSUInteger requestCount;
+
+@end
+
+@implementation AZSMockBlobService
+
++(instancetype)sharedService
+{
+    static AZSMockBlobService *sharedService = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedService = [[AZSMockBlobService alloc] initWithAccountName:AZSMockSharedAccountName accountKey:AZSMockSharedAccountKey];
+        NSError *error = nil;
+        if (![sharedService startWithError:&error])
+        {
+            NSLog(@"The mock Blob service failed to start: %@", error);
+        }
+    });
+    return sharedService;
+}
+
+-(instancetype)init
+{
+    return nil;
+}
+
+-(instancetype)initWithAccountName:(NSString *)accountName accountKey:(NSString *)accountKey
+{
+    self = [super init];
+    if (self)
+    {
+        _accountName = [accountName copy];
+        _accountKey = [accountKey copy];
+        _keyData = [[NSData alloc] initWithBase64EncodedString:accountKey options:0];
+        _containers = [NSMutableDictionary dictionary];
+        _queuedFaults = [NSMutableArray array];
+        _slowBodyDelay = 0.05;
+        _verifySharedKey = YES;
+    }
+    return self;
+}
+
+-(void)dealloc
+{
+    [self stop];
+}
+
+-(NSURL *)blobEndpoint
+{
+    return [NSURL URLWithString:[NSString stringWithFormat:@"http://127.0.0.1:%u/%@", self.port, self.accountName]];
+}
+
+-(NSString *)connectionString
+{
+    return [NSString stringWithFormat:@"DefaultEndpointsProtocol=http;AccountName=%@;AccountKey=%@;BlobEndpoint=%@", self.accountName, self.accountKey, self.blobEndpoint.absoluteString];
+}
+
+-(AZSCloudStorageAccount *)account
+{
+    NSError *error = nil;
+    return [AZSCloudStorageAccount accountFromConnectionString:self.connectionString error:&error];
+}
+
+-(BOOL)startWithError:(NSError **)error
+{
+    if (_acceptSource)
+    {
+        return YES;
+    }
+
+    int listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenSocket < 0)
+    {
+        *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil];
+        return NO;
+    }
+
+    int yes = 1;
+    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_len = sizeof(address);
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t addressLength = sizeof(address);
+    if (bind(listenSocket, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listenSocket, 128) != 0 || getsockname(listenSocket, (struct sockaddr *)&address, &addressLength) != 0)
+    {
+        *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil];
+        close(listenSocket);
+        return NO;
+    }
+    fcntl(listenSocket, F_SETFL, fcntl(listenSocket, F_GETFL) | O_NONBLOCK);
+    self.port = ntohs(address.sin_port);
+
+    // Each connection is served on its own thread with blocking I/O, which keeps the latency and bandwidth simulation simple.
+    _acceptSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, listenSocket, 0, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0));
+    __weak AZSMockBlobService *weakSelf = self;
+    dispatch_source_set_event_handler(_acceptSource, ^{
+        int connection;
+        while ((connection = accept(listenSocket, NULL, NULL)) >= 0)
+        {
+            AZSMockBlobService *service = weakSelf;
+            if (!service)
+            {
+                close(connection);
+                continue;
+            }
+            [NSThread detachNewThreadSelector:@selector(serveConnection:) toTarget:service withObject:@(connection)];
+        }
+    });
+    dispatch_source_set_cancel_handler(_acceptSource, ^{
+        close(listenSocket);
+    });
+    dispatch_resume(_acceptSource);
+    return YES;
+}
+
+-(void)stop
+{
+    if (_acceptSource)
+    {
+        dispatch_source_cancel(_acceptSource);
+        _acceptSource = nil;
+        self.port = 0;
+    }
+}
+
+-(void)reset
+{
+    @synchronized(self)
+    {
+        [_containers removeAllObjects];
+        [_queuedFaults removeAllObjects];
+        _randomFaultProbability = 0;
+        self.requestCount = 0;
+    }
+    self.latency = 0;
+    self.bandwidthBytesPerSecond = 0;
+}
+
+-(void)injectFault:(AZSMockFault)fault count:(NSUInteger)count
+{
+    @synchronized(self)
+    {
+        for (NSUInteger i = 0; i < count; i++)
+        {
+            [_queuedFaults addObject:@(fault)];
+        }
+    }
+}
+
+-(void)injectFault:(AZSMockFault)fault probability:(double)probability seed:(uint32_t)seed
+{
+    @synchronized(self)
+    {
+        _randomFault = fault;
+        _randomFaultProbability = probability;
+        _randomState = seed;
+    }
+}
+
+-(AZSMockFault)nextFault
+{
+    @synchronized(self)
+    {
+        self.requestCount++;
+        if (_queuedFaults.count > 0)
+        {
+            AZSMockFault fault = [_queuedFaults[0] integerValue];
+            [_queuedFaults removeObjectAtIndex:0];
+            return fault;
+        }
+
+        if (_randomFaultProbability > 0)
+        {
+            // A linear congruential generator; only the high 24 bits are used.
+            _randomState = _randomState * 1103515245 + 12345;
+            if ((_randomState >> 8) / (double)(1 << 24) < _randomFaultProbability)
+            {
+                return _randomFault;
+            }
+        }
+    }
+    return AZSMockFaultNone;
+}
+
+#pragma mark Connections
+
+-(void)serveConnection:(NSNumber *)socketNumber
+{
+    int connection = socketNumber.intValue;
+
+    // Accepted sockets inherit O_NONBLOCK from the listening socket on BSD.
+    fcntl(connection, F_SETFL, fcntl(connection, F_GETFL) & ~O_NONBLOCK);
+    int yes = 1;
+    setsockopt(connection, SOL_SOCKET, SO_NOSIGPIPE, &yes, sizeof(yes));
+    setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    struct timeval timeout = {30, 0};
+    setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    NSMutableData *buffer = [NSMutableData data];
+    BOOL keepAlive = YES;
+    while (keepAlive)
+    {
+        @autoreleasepool
+        {
+            AZSMockRequest *request = [self readRequestFromSocket:connection buffer:buffer];
+            if (!request)
+            {
+                break;
+            }
+            keepAlive = ![[request header:@"Connection"] isEqualToString:@"close"];
+
+            AZSMockFault fault = [self nextFault];
+            NSTimeInterval latency = self.latency;
+            if (latency > 0)
+            {
+                [NSThread sleepForTimeInterval:latency];
+            }
+
+            if (fault == AZSMockFaultConnectionReset)
+            {
+                // A zero linger time makes close send RST instead of FIN.
+                struct linger linger = {1, 0};
+                setsockopt(connection, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger));
+                break;
+            }
+
+            AZSMockResponse *response;
+            if (fault == AZSMockFaultServerBusy)
+            {
+                response = [AZSMockResponse errorWithStatusCode:503 code:@"ServerBusy" message:@"The server is busy."];
+            }
+            else if (fault == AZSMockFaultInternalError)
+            {
+                response = [AZSMockResponse errorWithStatusCode:500 code:@"OperationTimedOut" message:@"The operation could not be completed within the permitted time."];
+            }
+            else
+            {
+                response = [self responseForRequest:request];
+            }
+
+            if (![self writeResponse:response forRequest:request toSocket:connection slowBody:(fault == AZSMockFaultSlowBody)])
+            {
+                break;
+            }
+        }
+    }
+    close(connection);
+}
+
+-(void)throttleBytes:(NSUInteger)count
+{
+    NSUInteger bandwidth = self.bandwidthBytesPerSecond;
+    if (bandwidth > 0)
+    {
+        [NSThread sleepForTimeInterval:(double)count / bandwidth];
+    }
+}
+
+-(BOOL)readFromSocket:(int)connection intoBuffer:(NSMutableData *)buffer
+{
+    uint8_t bytes[AZSMockBodyPieceSize];
+    ssize_t count;
+    do
+    {
+        count = recv(connection, bytes, sizeof(bytes), 0);
+    } while (count < 0 && errno == EINTR);
+
+    if (count <= 0)
+    {
+        return NO;
+    }
+    [buffer appendBytes:bytes length:count];
+    [self throttleBytes:count];
+    return YES;
+}
+
+-(NSRange)rangeOfString:(NSString *)string inBuffer:(NSMutableData *)buffer fromSocket:(int)connection
+{
+    NSData *terminator = [string dataUsingEncoding:NSASCIIStringEncoding];
+    NSRange range;
+    while ((range = [buffer rangeOfData:terminator options:0 range:NSMakeRange(0, buffer.length)]).location == NSNotFound)
+    {
+        if (![self readFromSocket:connection intoBuffer:buffer])
+        {
+            return range;
+        }
+    }
+    return range;
+}
+
+-(NSData *)takeLength:(NSUInteger)length fromBuffer:(NSMutableData *)buffer socket:(int)connection
+{
+    while (buffer.length < length)
+    {
+        if (![self readFromSocket:connection intoBuffer:buffer])
+        {
+            return nil;
+        }
+    }
+    NSData *data = [buffer subdataWithRange:NSMakeRange(0, length)];
+    [buffer replaceBytesInRange:NSMakeRange(0, length) withBytes:NULL length:0];
+    return data;
+}
+
+-(NSData *)readChunkedBodyFromBuffer:(NSMutableData *)buffer socket:(int)connection
+{
+    NSMutableData *body = [NSMutableData data];
+    while (YES)
+    {
+        NSRange lineEnd = [self rangeOfString:@"\r\n" inBuffer:buffer fromSocket:connection];
+        if (lineEnd.location == NSNotFound)
+        {
+            return nil;
+        }
+        NSString *sizeLine = [[NSString alloc] initWithData:[self takeLength:NSMaxRange(lineEnd) fromBuffer:buffer socket:connection] encoding:NSASCIIStringEncoding];
+        unsigned int chunkSize = 0;
+        if (![[NSScanner scannerWithString:sizeLine] scanHexInt:&chunkSize])
+        {
+            return nil;
+        }
+        if (chunkSize == 0)
+        {
+            // No trailers are expected; skip the final empty line.
+            return [self takeLength:2 fromBuffer:buffer socket:connection] ? body : nil;
+        }
+
+        NSData *chunk = [self takeLength:chunkSize + 2 fromBuffer:buffer socket:connection];
+        if (!chunk)
+        {
+            return nil;
+        }
+        [body appendBytes:chunk.bytes length:chunkSize];
+    }
+}
+
+-(AZSMockRequest *)readRequestFromSocket:(int)connection buffer:(NSMutableData *)buffer
+{
+    NSRange headEnd = [self rangeOfString:@"\r\n\r\n" inBuffer:buffer fromSocket:connection];
+    if (headEnd.location == NSNotFound)
+    {
+        return nil;
+    }
+    NSData *headData = [self takeLength:NSMaxRange(headEnd) fromBuffer:buffer socket:connection];
+    NSString *head = [[NSString alloc] initWithData:[headData subdataWithRange:NSMakeRange(0, headEnd.location)] encoding:NSUTF8StringEncoding]
+        ?: [[NSString alloc] initWithData:headData encoding:NSISOLatin1StringEncoding];
+    NSArray *lines = [head componentsSeparatedByString:@"\r\n"];
+    NSArray *requestLine = [lines[0] componentsSeparatedByString:@" "];
+    if (requestLine.count != 3)
+    {
+        return nil;
+    }
+
+    AZSMockRequest *request = [[AZSMockRequest alloc] init];
+    request.method = requestLine[0];
+    NSString *target = requestLine[1];
+    NSRange queryStart = [target rangeOfString:@"?"];
+    request.rawPath = (queryStart.location == NSNotFound) ? target : [target substringToIndex:queryStart.location];
+    if (queryStart.location != NSNotFound)
+    {
+        for (NSString *parameter in [[target substringFromIndex:NSMaxRange(queryStart)] componentsSeparatedByString:@"&"])
+        {
+            if (parameter.length == 0)
+            {
+                continue;
+            }
+            NSRange equals = [parameter rangeOfString:@"="];
+            NSString *name = (equals.location == NSNotFound) ? parameter : [parameter substringToIndex:equals.location];
+            NSString *value = (equals.location == NSNotFound) ? @"" : [parameter substringFromIndex:NSMaxRange(equals)];
+            name = [name stringByRemovingPercentEncoding].lowercaseString ?: name.lowercaseString;
+            value = [value stringByRemovingPercentEncoding] ?: value;
+
+            NSMutableArray *values = request.query[name];
+            if (!values)
+            {
+                values = [NSMutableArray array];
+                request.query[name] = values;
+            }
+            [values addObject:value];
+        }
+    }
+
+    for (NSUInteger i = 1; i < lines.count; i++)
+    {
+        NSRange colon = [lines[i] rangeOfString:@":"];
+        if (colon.location == NSNotFound)
+        {
+            continue;
+        }
+        NSString *name = [lines[i] substringToIndex:colon.location];
+        NSString *value = [[lines[i] substringFromIndex:NSMaxRange(colon)] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+        [request.rawHeaders addObject:@[name, value]];
+
+        NSString *existing = request.headers[name.lowercaseString];
+        request.headers[name.lowercaseString] = existing ? [NSString stringWithFormat:@"%@,%@", existing, value] : value;
+    }
+
+    if ([[request header:@"Transfer-Encoding"] caseInsensitiveCompare:@"chunked"] == NSOrderedSame)
+    {
+        request.body = [self readChunkedBodyFromBuffer:buffer socket:connection];
+    }
+    else
+    {
+        request.body = [self takeLength:(NSUInteger)[[request header:@"Content-Length"] longLongValue] fromBuffer:buffer socket:connection];
+    }
+    return request.body ? request : nil;
+}
+
+-(BOOL)sendBytes:(const uint8_t *)bytes length:(size_t)length toSocket:(int)connection
+{
+    while (length > 0)
+    {
+        ssize_t sent = send(connection, bytes, length, 0);
+        if (sent < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (sent <= 0)
+        {
+            return NO;
+        }
+        bytes += sent;
+        length -= sent;
+    }
+    return YES;
+}
+
+-(BOOL)writeResponse:(AZSMockResponse *)response forRequest:(AZSMockRequest *)request toSocket:(int)connection slowBody:(BOOL)slowBody
+{
+    NSData *body = response.body ?: [NSData data];
+    response.headers[@"Content-Length"] = [NSString stringWithFormat:@"%lu", (unsigned long)body.length];
+    response.headers[@"x-ms-request-id"] = [[NSUUID UUID] UUIDString].lowercaseString;
+    response.headers[@"x-ms-version"] = AZSMockServiceVersion;
+    response.headers[@"Date"] = [AZSUtil convertDateToHttpString:[NSDate date]];
+    response.headers[@"Server"] = @"AZSMockBlobService";
+
+    NSMutableString *head = [NSMutableString stringWithFormat:@"HTTP/1.1 %ld %@\r\n", (long)response.statusCode, [NSHTTPURLResponse localizedStringForStatusCode:response.statusCode]];
+    [response.headers enumerateKeysAndObjectsUsingBlock:^(NSString *name, NSString *value, BOOL *stop) {
+        [head appendFormat:@"%@: %@\r\n", name, value];
+    }];
+    [head appendString:@"\r\n"];
+
+    NSData *headData = [head dataUsingEncoding:NSUTF8StringEncoding];
+    if (![self sendBytes:headData.bytes length:headData.length toSocket:connection])
+    {
+        return NO;
+    }
+
+    // A HEAD response reports the length of the body it would have sent.
+    if ([request.method isEqualToString:@"HEAD"])
+    {
+        return YES;
+    }
+
+    NSUInteger pieceSize = slowBody ? AZSMockSlowBodyPieceSize : AZSMockBodyPieceSize;
+    for (NSUInteger offset = 0; offset < body.length; offset += pieceSize)
+    {
+        NSUInteger length = MIN(pieceSize, body.length - offset);
+        if (![self sendBytes:(const uint8_t *)body.bytes + offset length:length toSocket:connection])
+        {
+            return NO;
+        }
+        [self throttleBytes:length];
+        if (slowBody)
+        {
+            [NSThread sleepForTimeInterval:self.slowBodyDelay];
+        }
+    }
+    return YES;
+}
+
+#pragma mark Authentication
+
+// Builds the Shared Key string to sign from the request as received, independently of the library's signing code.
+-(NSString *)stringToSignForRequest:(AZSMockRequest *)request
+{
+    NSString *contentLength = [request header:@"Content-Length"];
+    NSMutableString *stringToSign = [NSMutableString stringWithFormat:@"%@\n%@\n%@\n%@\n", request.method, [request header:@"Content-Encoding"] ?: @"", [request header:@"Content-Language"] ?: @"", [contentLength isEqualToString:@"0"] ? @"" : (contentLength ?: @"")];
+    for (NSString *name in @[@"Content-MD5", @"Content-Type", @"Date", @"If-Modified-Since", @"If-Match", @"If-None-Match", @"If-Unmodified-Since", @"Range"])
+    {
+        [stringToSign appendFormat:@"%@\n", [request header:name] ?: @""];
+    }
+
+    NSArray *headerNames = [[request.headers.allKeys filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"SELF BEGINSWITH 'x-ms-'"]] sortedArrayUsingSelector:@selector(compare:)];
+    for (NSString *name in headerNames)
+    {
+        [stringToSign appendFormat:@"%@:%@\n", name, request.headers[name]];
+    }
+
+    [stringToSign appendFormat:@"/%@%@", self.accountName, request.rawPath];
+    for (NSString *name in [request.query.allKeys sortedArrayUsingSelector:@selector(compare:)])
+    {
+        [stringToSign appendFormat:@"\n%@:%@", name, [[request.query[name] sortedArrayUsingSelector:@selector(compare:)] componentsJoinedByString:@","]];
+    }
+    return stringToSign;
+}
+
+-(BOOL)isAuthorizedRequest:(AZSMockRequest *)request
+{
+    NSString *prefix = [NSString stringWithFormat:@"SharedKey %@:", self.accountName];
+    NSString *authorization = [request header:@"Authorization"];
+    if (![authorization hasPrefix:prefix])
+    {
+        return NO;
+    }
+
+    NSData *stringToSign = [[self stringToSignForRequest:request] dataUsingEncoding:NSUTF8StringEncoding];
+    unsigned char signature[CC_SHA256_DIGEST_LENGTH];
+    CCHmac(kCCHmacAlgSHA256, _keyData.bytes, _keyData.length, stringToSign.bytes, stringToSign.length, signature);
+    NSString *expected = [[NSData dataWithBytes:signature length:sizeof(signature)] base64EncodedStringWithOptions:0];
+    return [[authorization substringFromIndex:prefix.length] isEqualToString:expected];
+}
+
+#pragma mark Routing
+
+-(AZSMockResponse *)responseForRequest:(AZSMockRequest *)request
+{
+    // Path style: /account/container/blob, where the blob name may contain further slashes.
+    NSArray *segments = [request.rawPath componentsSeparatedByString:@"/"];
+    NSString *account = (segments.count > 1) ? [segments[1] stringByRemovingPercentEncoding] : nil;
+    NSString *containerName = (segments.count > 2) ? [segments[2] stringByRemovingPercentEncoding] : @"";
+    NSString *blobName = (segments.count > 3) ? [[[segments subarrayWithRange:NSMakeRange(3, segments.count - 3)] componentsJoinedByString:@"/"] stringByRemovingPercentEncoding] : @"";
+
+    if (![account isEqualToString:self.accountName])
+    {
+        return [AZSMockResponse errorWithStatusCode:400 code:@"InvalidUri" message:@"The requested URI does not represent any resource on the server."];
+    }
+    if (self.verifySharedKey && ![self isAuthorizedRequest:request])
+    {
+        return [AZSMockResponse errorWithStatusCode:403 code:@"AuthenticationFailed" message:@"Server failed to authenticate the request. Make sure the value of Authorization header is formed correctly including the signature."];
+    }
+
+    @synchronized(self)
+    {
+        AZSMockResponse *response;
+        if (containerName.length == 0)
+        {
+            response = [self serviceResponseForRequest:request];
+        }
+        else if (blobName.length == 0)
+        {
+            response = [self containerResponseForRequest:request containerName:containerName];
+        }
+        else
+        {
+            response = [self blobResponseForRequest:request containerName:containerName blobName:blobName];
+        }
+        return response ?: [AZSMockResponse errorWithStatusCode:501 code:@"NotImplemented" message:@"The mock service does not implement this operation."];
+    }
+}
+
+#pragma mark Shared helpers
+
+-(void)setMetadataFromRequest:(AZSMockRequest *)request onResource:(AZSMockResource *)resource
+{
+    [resource.metadata removeAllObjects];
+    for (NSArray *header in request.rawHeaders)
+    {
+        if ([[header[0] lowercaseString] hasPrefix:@"x-ms-meta-"])
+        {
+            resource.metadata[[header[0] substringFromIndex:10]] = header[1];
+        }
+    }
+}
+
+-(void)addResourceHeaders:(AZSMockResource *)resource toResponse:(AZSMockResponse *)response includeMetadata:(BOOL)includeMetadata
+{
+    response.headers[@"ETag"] = resource.etag;
+    response.headers[@"Last-Modified"] = [AZSUtil convertDateToHttpString:resource.lastModified];
+    if (includeMetadata)
+    {
+        [resource.metadata enumerateKeysAndObjectsUsingBlock:^(NSString *name, NSString *value, BOOL *stop) {
+            response.headers[[@"x-ms-meta-" stringByAppendingString:name]] = value;
+        }];
+
+        NSString *state = [resource.lease currentState];
+        BOOL locked = [resource.lease isActive];
+        response.headers[@"x-ms-lease-state"] = state;
+        response.headers[@"x-ms-lease-status"] = locked ? @"locked" : @"unlocked";
+        if ([state isEqualToString:@"leased"])
+        {
+            response.headers[@"x-ms-lease-duration"] = (resource.lease.duration < 0) ? @"infinite" : @"fixed";
+        }
+    }
+}
+
+// Checks the If-* headers.  Reads that fail If-None-Match or If-Modified-Since get 304; everything else gets 412.
+-(AZSMockResponse *)checkConditionsForRequest:(AZSMockRequest *)request resource:(AZSMockResource *)resource read:(BOOL)read
+{
+    AZSMockResponse *conditionNotMet = [AZSMockResponse errorWithStatusCode:412 code:@"ConditionNotMet" message:@"The condition specified using HTTP conditional header(s) is not met."];
+
+    NSString *ifMatch = [request header:@"If-Match"];
+    if (ifMatch && (!resource || (![ifMatch isEqualToString:@"*"] && ![ifMatch isEqualToString:resource.etag])))
+    {
+        return conditionNotMet;
+    }
+
+    NSString *ifNoneMatch = [request header:@"If-None-Match"];
+    if (ifNoneMatch && resource && ([ifNoneMatch isEqualToString:@"*"] || [ifNoneMatch isEqualToString:resource.etag]))
+    {
+        if (read)
+        {
+            return [AZSMockResponse responseWithStatusCode:304];
+        }
+        return [ifNoneMatch isEqualToString:@"*"] ? [AZSMockResponse errorWithStatusCode:409 code:@"BlobAlreadyExists" message:@"The specified blob already exists."] : conditionNotMet;
+    }
+
+    NSString *ifModifiedSince = [request header:@"If-Modified-Since"];
+    NSDate *modifiedSince = ifModifiedSince ? [AZSUtil dateFromHttpString:ifModifiedSince] : nil;
+    if (modifiedSince && resource && [resource.lastModified compare:modifiedSince] != NSOrderedDescending)
+    {
+        return read ? [AZSMockResponse responseWithStatusCode:304] : conditionNotMet;
+    }
+
+    NSString *ifUnmodifiedSince = [request header:@"If-Unmodified-Since"];
+    NSDate *unmodifiedSince = ifUnmodifiedSince ? [AZSUtil dateFromHttpString:ifUnmodifiedSince] : nil;
+    if (unmodifiedSince && resource && [resource.lastModified compare:unmodifiedSince] == NSOrderedDescending)
+    {
+        return conditionNotMet;
+    }
+    return nil;
+}
+
+// Writes to a leased resource need the lease ID; a lease ID on a read or write must match the active lease.
+-(AZSMockResponse *)checkLeaseForRequest:(AZSMockRequest *)request resource:(AZSMockResource *)resource write:(BOOL)write kind:(NSString *)kind
+{
+    NSString *leaseId = [request header:@"x-ms-lease-id"];
+    BOOL active = [resource.lease isActive];
+    if (write && active && !leaseId)
+    {
+        return [AZSMockResponse errorWithStatusCode:412 code:@"LeaseIdMissing" message:[NSString stringWithFormat:@"There is currently a lease on the %@ and no lease ID was specified in the request.", kind.lowercaseString]];
+    }
+    if (leaseId && !active)
+    {
+        return [AZSMockResponse errorWithStatusCode:412 code:[NSString stringWithFormat:@"LeaseNotPresentWith%@Operation", kind] message:[NSString stringWithFormat:@"There is currently no lease on the %@.", kind.lowercaseString]];
+    }
+    if (leaseId && ![leaseId isEqualToString:resource.lease.leaseId])
+    {
+        return [AZSMockResponse errorWithStatusCode:412 code:[NSString stringWithFormat:@"LeaseIdMismatchWith%@Operation", kind] message:@"The lease ID specified did not match the lease ID for the resource."];
+    }
+    return nil;
+}
+
+-(AZSMockResponse *)leaseResponseForRequest:(AZSMockRequest *)request resource:(AZSMockResource *)resource
+{
+    AZSMockLease *lease = resource.lease;
+    NSString *action = [[request header:@"x-ms-lease-action"] lowercaseString];
+    NSString *leaseId = [request header:@"x-ms-lease-id"];
+    NSString *proposedLeaseId = [request header:@"x-ms-proposed-lease-id"];
+    NSString *state = [lease currentState];
+    AZSMockResponse *mismatch = [AZSMockResponse errorWithStatusCode:409 code:@"LeaseIdMismatchWithLeaseOperation" message:@"The lease ID specified did not match the lease ID for the resource with the specified lease operation."];
+    AZSMockResponse *response;
+
+    if ([action isEqualToString:@"acquire"])
+    {
+        NSInteger duration = [[request header:@"x-ms-lease-duration"] integerValue];
+        if (duration != -1 && (duration < 15 || duration > 60))
+        {
+            return [AZSMockResponse errorWithStatusCode:400 code:@"InvalidHeaderValue" message:@"The value for x-ms-lease-duration is not valid."];
+        }
+        if ([state isEqualToString:@"leased"] && ![proposedLeaseId isEqualToString:lease.leaseId])
+        {
+            return [AZSMockResponse errorWithStatusCode:409 code:@"LeaseAlreadyPresent" message:@"There is already a lease present."];
+        }
+        if ([state isEqualToString:@"breaking"])
+        {
+            return [AZSMockResponse errorWithStatusCode:409 code:@"LeaseIsBreakingAndCannotBeAcquired" message:@"There is already a breaking lease present."];
+        }
+
+        lease.leaseId = proposedLeaseId ?: [[NSUUID UUID] UUIDString].lowercaseString;
+        lease.state = @"leased";
+        lease.duration = duration;
+        lease.expiry = (duration < 0) ? nil : [NSDate dateWithTimeIntervalSinceNow:duration];
+        response = [AZSMockResponse responseWithStatusCode:201];
+        response.headers[@"x-ms-lease-id"] = lease.leaseId;
+    }
+    else if ([action isEqualToString:@"renew"])
+    {
+        if (![leaseId isEqualToString:lease.leaseId] || [state isEqualToString:@"available"])
+        {
+            return mismatch;
+        }
+        if ([state isEqualToString:@"breaking"] || [state isEqualToString:@"broken"])
+        {
+            return [AZSMockResponse errorWithStatusCode:409 code:@"LeaseIsBrokenAndCannotBeRenewed" message:@"The lease has been broken explicitly and cannot be renewed."];
+        }
+
+        lease.state = @"leased";
+        lease.expiry = (lease.duration < 0) ? nil : [NSDate dateWithTimeIntervalSinceNow:lease.duration];
+        response = [AZSMockResponse responseWithStatusCode:200];
+        response.headers[@"x-ms-lease-id"] = lease.leaseId;
+    }
+    else if ([action isEqualToString:@"change"])
+    {
+        if (!proposedLeaseId)
+        {
+            return [AZSMockResponse errorWithStatusCode:400 code:@"MissingRequiredHeader" message:@"An HTTP header that's mandatory for this request is not specified."];
+        }
+        if (![state isEqualToString:@"leased"] || !([leaseId isEqualToString:lease.leaseId] || [leaseId isEqualToString:proposedLeaseId]))
+        {
+            return mismatch;
+        }
+
+        lease.leaseId = proposedLeaseId;
+        response = [AZSMockResponse responseWithStatusCode:200];
+        response.headers[@"x-ms-lease-id"] = lease.leaseId;
+    }
+    else if ([action isEqualToString:@"release"])
+    {
+        if (![leaseId isEqualToString:lease.leaseId] || [state isEqualToString:@"available"])
+        {
+            return mismatch;
+        }
+
+        lease.state = @"available";
+        lease.leaseId = nil;
+        response = [AZSMockResponse responseWithStatusCode:200];
+    }
+    else if ([action isEqualToString:@"break"])
+    {
+        if ([state isEqualToString:@"available"])
+        {
+            return [AZSMockResponse errorWithStatusCode:409 code:@"LeaseNotPresentWithLeaseOperation" message:@"There is currently no lease."];
+        }
+
+        // An infinite lease breaks immediately unless a period is given; a timed lease never outlives its remaining time.
+        NSString *breakPeriodHeader = [request header:@"x-ms-lease-break-period"];
+        NSTimeInterval breakPeriod = 0;
+        if ([state isEqualToString:@"leased"])
+        {
+            NSTimeInterval remaining = lease.expiry ? MAX([lease.expiry timeIntervalSinceNow], 0) : DBL_MAX;
+            breakPeriod = MIN(breakPeriodHeader ? [breakPeriodHeader doubleValue] : (lease.expiry ? remaining : 0), remaining);
+            lease.breakTime = [NSDate dateWithTimeIntervalSinceNow:breakPeriod];
+            lease.state = (breakPeriod > 0) ? @"breaking" : @"broken";
+        }
+        else if ([state isEqualToString:@"breaking"])
+        {
+            if (breakPeriodHeader)
+            {
+                lease.breakTime = [lease.breakTime earlierDate:[NSDate dateWithTimeIntervalSinceNow:[breakPeriodHeader doubleValue]]];
+            }
+            breakPeriod = MAX([lease.breakTime timeIntervalSinceNow], 0);
+        }
+        else
+        {
+            lease.state = @"broken";
+        }
+
+        response = [AZSMockResponse responseWithStatusCode:202];
+        response.headers[@"x-ms-lease-time"] = [NSString stringWithFormat:@"%.0f", ceil(breakPeriod)];
+    }
+    else
+    {
+        return [AZSMockResponse errorWithStatusCode:400 code:@"InvalidHeaderValue" message:@"The value for x-ms-lease-action is not valid."];
+    }
+
+    response.headers[@"ETag"] = resource.etag;
+    response.headers[@"Last-Modified"] = [AZSUtil convertDateToHttpString:resource.lastModified];
+    return response;
+}
+
+#pragma mark Service and container operations
+
+-(AZSMockResponse *)serviceResponseForRequest:(AZSMockRequest *)request
+{
+    if (![request.method isEqualToString:@"GET"] || ![[request queryValue:@"comp"] isEqualToString:@"list"])
+    {
+        return nil;
+    }
+
+    NSString *prefix = [request queryValue:@"prefix"] ?: @"";
+    NSString *marker = [request queryValue:@"marker"];
+    NSInteger maxResults = [request queryValue:@"maxresults"] ? [[request queryValue:@"maxresults"] integerValue] : 5000;
+    BOOL includeMetadata = [[request queryValue:@"include"] containsString:@"metadata"];
+
+    NSMutableString *xml = [NSMutableString stringWithFormat:@"<?xml version=\"1.0\" encoding=\"utf-8\"?><EnumerationResults ServiceEndpoint=\"%@\">", AZSMockXmlEscape(self.blobEndpoint.absoluteString)];
+    [xml appendFormat:@"<Prefix>%@</Prefix><MaxResults>%ld</MaxResults><Containers>", AZSMockXmlEscape(prefix), (long)maxResults];
+    NSString *nextMarker = @"";
+    NSInteger count = 0;
+    for (NSString *name in [_containers.allKeys sortedArrayUsingSelector:@selector(compare:)])
+    {
+        if (![name hasPrefix:prefix] || (marker && [name compare:marker] == NSOrderedAscending))
+        {
+            continue;
+        }
+        if (count++ == maxResults)
+        {
+            nextMarker = name;
+            break;
+        }
+
+        AZSMockContainer *container = _containers[name];
+        [xml appendFormat:@"<Container><Name>%@</Name><Properties><Last-Modified>%@</Last-Modified><Etag>%@</Etag><LeaseStatus>%@</LeaseStatus><LeaseState>%@</LeaseState></Properties>", AZSMockXmlEscape(name), [AZSUtil convertDateToHttpString:container.lastModified], AZSMockXmlEscape(container.etag), [container.lease isActive] ? @"locked" : @"unlocked", [container.lease currentState]];
+        if (includeMetadata)
+        {
+            [xml appendString:@"<Metadata>"];
+            [container.metadata enumerateKeysAndObjectsUsingBlock:^(NSString *key, NSString *value, BOOL *stop) {
+                [xml appendFormat:@"<%@>%@</%@>", key, AZSMockXmlEscape(value), key];
+            }];
+            [xml appendString:@"</Metadata>"];
+        }
+        [xml appendString:@"</Container>"];
+    }
+    [xml appendFormat:@"</Containers><NextMarker>%@</NextMarker></EnumerationResults>", AZSMockXmlEscape(nextMarker)];
+    return [AZSMockResponse xmlResponseWithString:xml];
+}
+
+-(AZSMockResponse *)containerResponseForRequest:(AZSMockRequest *)request containerName:(NSString *)containerName
+{
+    if (![[request queryValue:@"restype"] isEqualToString:@"container"])
+    {
+        return nil;
+    }
+
+    NSString *method = request.method;
+    NSString *comp = [request queryValue:@"comp"];
+    AZSMockContainer *container = _containers[containerName];
+
+    if ([method isEqualToString:@"PUT"] && !comp)
+    {
+        if (container)
+        {
+            return [AZSMockResponse errorWithStatusCode:409 code:@"ContainerAlreadyExists" message:@"The specified container already exists."];
+        }
+        container = [[AZSMockContainer alloc] init];
+        container.publicAccess = [request header:@"x-ms-blob-public-access"];
+        [self setMetadataFromRequest:request onResource:container];
+        _containers[containerName] = container;
+
+        AZSMockResponse *response = [AZSMockResponse responseWithStatusCode:201];
+        [self addResourceHeaders:container toResponse:response includeMetadata:NO];
+        return response;
+    }
+
+    if (!container)
+    {
+        return [AZSMockResponse errorWithStatusCode:404 code:@"ContainerNotFound" message:@"The specified container does not exist."];
+    }
+
+    BOOL read = [method isEqualToString:@"GET"] || [method isEqualToString:@"HEAD"];
+    if (!comp || [comp isEqualToString:@"metadata"] || [comp isEqualToString:@"acl"])
+    {
+        AZSMockResponse *failure = [self checkLeaseForRequest:request resource:container write:[method isEqualToString:@"DELETE"] kind:@"Container"] ?: [self checkConditionsForRequest:request resource:container read:read];
+        if (failure)
+        {
+            return failure;
+        }
+    }
+
+    if ([method isEqualToString:@"DELETE"] && !comp)
+    {
+        [_containers removeObjectForKey:containerName];
+        return [AZSMockResponse responseWithStatusCode:202];
+    }
+    if (read && (!comp || [comp isEqualToString:@"metadata"]))
+    {
+        AZSMockResponse *response = [AZSMockResponse responseWithStatusCode:200];
+        [self addResourceHeaders:container toResponse:response includeMetadata:YES];
+        if (container.publicAccess && !comp)
+        {
+            response.headers[@"x-ms-blob-public-access"] = container.publicAccess;
+        }
+        return response;
+    }
+    if ([method isEqualToString:@"PUT"] && [comp isEqualToString:@"metadata"])
+    {
+        [self setMetadataFromRequest:request onResource:container];
+        [container touch];
+        AZSMockResponse *response = [AZSMockResponse responseWithStatusCode:200];
+        [self addResourceHeaders:container toResponse:response includeMetadata:NO];
+        return response;
+    }
+    if ([comp isEqualToString:@"acl"])
+    {
+        // Stored access policies are accepted but not kept.
+        AZSMockResponse *response;
+        if (read)
+        {
+            response = [AZSMockResponse xmlResponseWithString:@"<?xml version=\"1.0\" encoding=\"utf-8\"?><SignedIdentifiers />"];
+        }
+        else
+        {
+            container.publicAccess = [request header:@"x-ms-blob-public-access"];
+            [container touch];
+            response = [AZSMockResponse responseWithStatusCode:200];
+        }
+        [self addResourceHeaders:container toResponse:response includeMetadata:NO];
+        if (container.publicAccess)
+        {
+            response.headers[@"x-ms-blob-public-access"] = container.publicAccess;
+        }
+        return response;
+    }
+    if ([method isEqualToString:@"PUT"] && [comp isEqualToString:@"lease"])
+    {
+        return [self leaseResponseForRequest:request resource:container];
+    }
+    if ([method isEqualToString:@"GET"] && [comp isEqualToString:@"list"])
+    {
+        return [self listBlobsResponseForRequest:request container:container containerName:containerName];
+    }
+    return nil;
+}
+
+-(NSString *)xmlForBlob:(AZSMockBlob *)blob name:(NSString *)name includeMetadata:(BOOL)includeMetadata
+{
+    NSMutableString *xml = [NSMutableString stringWithFormat:@"<Blob><Name>%@</Name><Properties>", AZSMockXmlEscape(name)];
+    [xml appendFormat:@"<Last-Modified>%@</Last-Modified><Etag>%@</Etag><Content-Length>%lu</Content-Length>", [AZSUtil convertDateToHttpString:blob.lastModified], AZSMockXmlEscape(blob.etag), (unsigned long)blob.data.length];
+    for (NSString *property in @[@"Content-Type", @"Content-Encoding", @"Content-Language", @"Content-MD5", @"Cache-Control", @"Content-Disposition"])
+    {
+        [xml appendFormat:@"<%@>%@</%@>", property, AZSMockXmlEscape(blob.properties[property]), property];
+    }
+    if ([blob.blobType isEqualToString:@"PageBlob"])
+    {
+        [xml appendFormat:@"<x-ms-blob-sequence-number>%lld</x-ms-blob-sequence-number>", blob.sequenceNumber];
+    }
+    [xml appendFormat:@"<BlobType>%@</BlobType><LeaseStatus>%@</LeaseStatus><LeaseState>%@</LeaseState>", blob.blobType, [blob.lease isActive] ? @"locked" : @"unlocked", [blob.lease currentState]];
+    if ([blob.lease.state isEqualToString:@"leased"])
+    {
+        [xml appendFormat:@"<LeaseDuration>%@</LeaseDuration>", (blob.lease.duration < 0) ? @"infinite" : @"fixed"];
+    }
+    [xml appendString:@"</Properties>"];
+
+    if (includeMetadata)
+    {
+        [xml appendString:@"<Metadata>"];
+        [blob.metadata enumerateKeysAndObjectsUsingBlock:^(NSString *key, NSString *value, BOOL *stop) {
+            [xml appendFormat:@"<%@>%@</%@>", key, AZSMockXmlEscape(value), key];
+        }];
+        [xml appendString:@"</Metadata>"];
+    }
+    [xml appendString:@"</Blob>"];
+    return xml;
+}
+
+-(AZSMockResponse *)listBlobsResponseForRequest:(AZSMockRequest *)request container:(AZSMockContainer *)container containerName:(NSString *)containerName
+{
+    NSString *prefix = [request queryValue:@"prefix"] ?: @"";
+    NSString *delimiter = [request queryValue:@"delimiter"];
+    NSString *marker = [request queryValue:@"marker"];
+    NSInteger maxResults = [request queryValue:@"maxresults"] ? [[request queryValue:@"maxresults"] integerValue] : 5000;
+    NSArray *include = [[request queryValue:@"include"] componentsSeparatedByString:@","];
+    BOOL includeMetadata = [include containsObject:@"metadata"];
+    BOOL includeUncommitted = [include containsObject:@"uncommittedblobs"];
+
+    NSMutableString *xml = [NSMutableString stringWithFormat:@"<?xml version=\"1.0\" encoding=\"utf-8\"?><EnumerationResults ServiceEndpoint=\"%@\" ContainerName=\"%@\">", AZSMockXmlEscape(self.blobEndpoint.absoluteString), AZSMockXmlEscape(containerName)];
+    [xml appendFormat:@"<Prefix>%@</Prefix>", AZSMockXmlEscape(prefix)];
+    if (marker)
+    {
+        [xml appendFormat:@"<Marker>%@</Marker>", AZSMockXmlEscape(marker)];
+    }
+    [xml appendFormat:@"<MaxResults>%ld</MaxResults>", (long)maxResults];
+    if (delimiter)
+    {
+        [xml appendFormat:@"<Delimiter>%@</Delimiter>", AZSMockXmlEscape(delimiter)];
+    }
+    [xml appendString:@"<Blobs>"];
+
+    // Blobs that share a prefix up to the delimiter are rolled up into one BlobPrefix entry, which counts as one result.
+    NSString *nextMarker = @"";
+    NSString *lastBlobPrefix = nil;
+    NSInteger count = 0;
+    for (NSString *name in [container.blobs.allKeys sortedArrayUsingSelector:@selector(compare:)])
+    {
+        AZSMockBlob *blob = container.blobs[name];
+        if ((!blob.committed && !includeUncommitted) || ![name hasPrefix:prefix] || (marker && [name compare:marker] == NSOrderedAscending) || (lastBlobPrefix && [name hasPrefix:lastBlobPrefix]))
+        {
+            continue;
+        }
+
+        NSString *blobPrefix = nil;
+        if (delimiter.length > 0)
+        {
+            NSRange delimiterRange = [name rangeOfString:delimiter options:0 range:NSMakeRange(prefix.length, name.length - prefix.length)];
+            if (delimiterRange.location != NSNotFound)
+            {
+                blobPrefix = [name substringToIndex:NSMaxRange(delimiterRange)];
+            }
+        }
+
+        if (count++ == maxResults)
+        {
+            nextMarker = name;
+            break;
+        }
+
+        if (blobPrefix)
+        {
+            lastBlobPrefix = blobPrefix;
+            [xml appendFormat:@"<BlobPrefix><Name>%@</Name></BlobPrefix>", AZSMockXmlEscape(blobPrefix)];
+        }
+        else
+        {
+            [xml appendString:[self xmlForBlob:blob name:name includeMetadata:includeMetadata]];
+        }
+    }
+    [xml appendFormat:@"</Blobs><NextMarker>%@</NextMarker></EnumerationResults>", AZSMockXmlEscape(nextMarker)];
+    return [AZSMockResponse xmlResponseWithString:xml];
+}
+
+#pragma mark Blob operations
+
+// Replaces the stored content properties with those in the request.  Put Blob also accepts the standard headers.
+-(void)setPropertiesFromRequest:(AZSMockRequest *)request onBlob:(AZSMockBlob *)blob acceptStandardHeaders:(BOOL)acceptStandardHeaders
+{
+    NSDictionary *propertyHeaders = @{@"Content-Type": @"x-ms-blob-content-type", @"Content-Encoding": @"x-ms-blob-content-encoding", @"Content-Language": @"x-ms-blob-content-language", @"Content-MD5": @"x-ms-blob-content-md5", @"Cache-Control": @"x-ms-blob-cache-control", @"Content-Disposition": @"x-ms-blob-content-disposition"};
+    [blob.properties removeAllObjects];
+    [propertyHeaders enumerateKeysAndObjectsUsingBlock:^(NSString *property, NSString *header, BOOL *stop) {
+        NSString *value = [request header:header];
+        if (!value && acceptStandardHeaders && ![property isEqualToString:@"Content-MD5"])
+        {
+            value = [request header:property];
+        }
+        if (value)
+        {
+            blob.properties[property] = value;
+        }
+    }];
+}
+
+-(void)addBlobHeaders:(AZSMockBlob *)blob toResponse:(AZSMockResponse *)response
+{
+    [self addResourceHeaders:blob toResponse:response includeMetadata:YES];
+    response.headers[@"x-ms-blob-type"] = blob.blobType;
+    response.headers[@"Accept-Ranges"] = @"bytes";
+    response.headers[@"Content-Type"] = @"application/octet-stream";
+    [response.headers addEntriesFromDictionary:blob.properties];
+    if ([blob.blobType isEqualToString:@"PageBlob"])
+    {
+        response.headers[@"x-ms-blob-sequence-number"] = [NSString stringWithFormat:@"%lld", blob.sequenceNumber];
+    }
+    else if ([blob.blobType isEqualToString:@"AppendBlob"])
+    {
+        response.headers[@"x-ms-blob-committed-block-count"] = [NSString stringWithFormat:@"%lu", (unsigned long)blob.appendBlockCount];
+    }
+}
+
+-(AZSMockResponse *)writeResponseForBlob:(AZSMockBlob *)blob statusCode:(NSInteger)statusCode
+{
+    AZSMockResponse *response = [AZSMockResponse responseWithStatusCode:statusCode];
+    [self addResourceHeaders:blob toResponse:response includeMetadata:NO];
+    return response;
+}
+
+-(BOOL)requestSupportsCRC64:(AZSMockRequest *)request
+{
+    NSString *version = [request header:@"x-ms-version"];
+    return version && ([version compare:AZSMockCRC64Version] != NSOrderedAscending);
+}
+
+-(AZSMockResponse *)checkContentHashesForRequest:(AZSMockRequest *)request
+{
+    NSString *contentMD5 = [request header:@"Content-MD5"];
+    if (contentMD5 && ![contentMD5 isEqualToString:[AZSUtil calculateMD5FromData:request.body]])
+    {
+        return [AZSMockResponse errorWithStatusCode:400 code:@"Md5Mismatch" message:@"The MD5 value specified in the request did not match with the MD5 value calculated by the server."];
+    }
+    NSString *contentCRC64 = [request header:@"x-ms-content-crc64"];
+    if (contentCRC64 && [self requestSupportsCRC64:request] && ![contentCRC64 isEqualToString:[AZSUtil calculateCRC64FromData:request.body]])
+    {
+        return [AZSMockResponse errorWithStatusCode:400 code:@"Crc64Mismatch" message:@"The CRC64 value specified in the request did not match with the CRC64 value calculated by the server."];
+    }
+    return nil;
+}
+
+-(AZSMockResponse *)checkSequenceNumberForRequest:(AZSMockRequest *)request blob:(AZSMockBlob *)blob
+{
+    NSString *lessOrEqual = [request header:@"x-ms-if-sequence-number-le"];
+    NSString *less = [request header:@"x-ms-if-sequence-number-lt"];
+    NSString *equal = [request header:@"x-ms-if-sequence-number-eq"];
+    if ((lessOrEqual && blob.sequenceNumber > [lessOrEqual longLongValue]) || (less && blob.sequenceNumber >= [less longLongValue]) || (equal && blob.sequenceNumber != [equal longLongValue]))
+    {
+        return [AZSMockResponse errorWithStatusCode:412 code:@"SequenceNumberConditionNotMet" message:@"The sequence number condition specified was not met."];
+    }
+    return nil;
+}
+
+-(AZSMockResponse *)blobResponseForRequest:(AZSMockRequest *)request containerName:(NSString *)containerName blobName:(NSString *)blobName
+{
+    AZSMockContainer *container = _containers[containerName];
+    if (!container)
+    {
+        return [AZSMockResponse errorWithStatusCode:404 code:@"ContainerNotFound" message:@"The specified container does not exist."];
+    }
+    if ([request queryValue:@"snapshot"] || [request header:@"x-ms-copy-source"])
+    {
+        return nil;
+    }
+
+    NSString *method = request.method;
+    NSString *comp = [request queryValue:@"comp"];
+    AZSMockBlob *blob = container.blobs[blobName];
+    AZSMockBlob *committedBlob = blob.committed ? blob : nil;
+    AZSMockResponse *blobNotFound = [AZSMockResponse errorWithStatusCode:404 code:@"BlobNotFound" message:@"The specified blob does not exist."];
+    BOOL read = [method isEqualToString:@"GET"] || [method isEqualToString:@"HEAD"];
+
+    // Checks shared by the operations that act on an existing blob.
+    AZSMockResponse *(^checkExisting)(NSString *) = ^AZSMockResponse *(NSString *requiredType) {
+        if (!committedBlob)
+        {
+            return blobNotFound;
+        }
+        if (requiredType && ![committedBlob.blobType isEqualToString:requiredType])
+        {
+            return [AZSMockResponse errorWithStatusCode:409 code:@"InvalidBlobType" message:@"The blob type is invalid for this operation."];
+        }
+        return [self checkLeaseForRequest:request resource:committedBlob write:!read kind:@"Blob"] ?: [self checkConditionsForRequest:request resource:committedBlob read:read];
+    };
+
+    if (!comp && read)
+    {
+        AZSMockResponse *failure = checkExisting(nil);
+        if (failure)
+        {
+            return failure;
+        }
+        return [self getBlobResponseForRequest:request blob:committedBlob];
+    }
+    if (!comp && [method isEqualToString:@"PUT"])
+    {
+        AZSMockResponse *failure = [self checkContentHashesForRequest:request];
+        if (!failure && committedBlob)
+        {
+            failure = [self checkLeaseForRequest:request resource:committedBlob write:YES kind:@"Blob"];
+        }
+        failure = failure ?: [self checkConditionsForRequest:request resource:committedBlob read:NO];
+        if (failure)
+        {
+            return failure;
+        }
+        return [self putBlobResponseForRequest:request container:container blobName:blobName existing:committedBlob];
+    }
+    if (!comp && [method isEqualToString:@"DELETE"])
+    {
+        AZSMockResponse *failure = checkExisting(nil);
+        if (failure)
+        {
+            return failure;
+        }
+        [container.blobs removeObjectForKey:blobName];
+        return [AZSMockResponse responseWithStatusCode:202];
+    }
+
+    if ([comp isEqualToString:@"block"] && [method isEqualToString:@"PUT"])
+    {
+        return [self putBlockResponseForRequest:request container:container blobName:blobName blob:blob];
+    }
+    if ([comp isEqualToString:@"blocklist"] && [method isEqualToString:@"PUT"])
+    {
+        if (committedBlob)
+        {
+            AZSMockResponse *failure = checkExisting(@"BlockBlob");
+            if (failure)
+            {
+                return failure;
+            }
+        }
+        else
+        {
+            AZSMockResponse *failure = [self checkConditionsForRequest:request resource:nil read:NO];
+            if (failure)
+            {
+                return failure;
+            }
+        }
+        return [self putBlockListResponseForRequest:request container:container blobName:blobName blob:blob];
+    }
+    if ([comp isEqualToString:@"blocklist"] && read)
+    {
+        if (!blob)
+        {
+            return blobNotFound;
+        }
+        return [self getBlockListResponseForRequest:request blob:blob];
+    }
+    if ([comp isEqualToString:@"page"] && [method isEqualToString:@"PUT"])
+    {
+        AZSMockResponse *failure = checkExisting(@"PageBlob") ?: [self checkSequenceNumberForRequest:request blob:committedBlob] ?: [self checkContentHashesForRequest:request];
+        if (failure)
+        {
+            return failure;
+        }
+        return [self putPageResponseForRequest:request blob:committedBlob];
+    }
+    if ([comp isEqualToString:@"appendblock"] && [method isEqualToString:@"PUT"])
+    {
+        AZSMockResponse *failure = checkExisting(@"AppendBlob") ?: [self checkContentHashesForRequest:request];
+        if (failure)
+        {
+            return failure;
+        }
+        return [self appendBlockResponseForRequest:request blob:committedBlob];
+    }
+    if ([comp isEqualToString:@"properties"] && [method isEqualToString:@"PUT"])
+    {
+        AZSMockResponse *failure = checkExisting(nil);
+        if (failure)
+        {
+            return failure;
+        }
+        return [self setBlobPropertiesResponseForRequest:request blob:committedBlob];
+    }
+    if ([comp isEqualToString:@"metadata"])
+    {
+        AZSMockResponse *failure = checkExisting(nil);
+        if (failure)
+        {
+            return failure;
+        }
+        if ([method isEqualToString:@"PUT"])
+        {
+            [self setMetadataFromRequest:request onResource:committedBlob];
+            [committedBlob touch];
+            return [self writeResponseForBlob:committedBlob statusCode:200];
+        }
+        AZSMockResponse *response = [AZSMockResponse responseWithStatusCode:200];
+        [self addResourceHeaders:committedBlob toResponse:response includeMetadata:YES];
+        return response;
+    }
+    if ([comp isEqualToString:@"lease"] && [method isEqualToString:@"PUT"])
+    {
+        if (!committedBlob)
+        {
+            return blobNotFound;
+        }
+        AZSMockResponse *failure = [self checkConditionsForRequest:request resource:committedBlob read:NO];
+        return failure ?: [self leaseResponseForRequest:request resource:committedBlob];
+    }
+    return nil;
+}
+
+-(AZSMockResponse *)getBlobResponseForRequest:(AZSMockRequest *)request blob:(AZSMockBlob *)blob
+{
+    AZSMockResponse *response = [AZSMockResponse responseWithStatusCode:200];
+    [self addBlobHeaders:blob toResponse:response];
+    response.body = [blob.data copy];
+
+    NSString *range = [request header:@"x-ms-range"] ?: [request header:@"Range"];
+    if (!range)
+    {
+        return response;
+    }
+
+    uint64_t start = 0;
+    uint64_t end = 0;
+    uint64_t length = blob.data.length;
+    if (!AZSMockParseRange(range, &start, &end))
+    {
+        return [AZSMockResponse errorWithStatusCode:400 code:@"InvalidHeaderValue" message:@"The value for the range header is not valid."];
+    }
+    if (start >= length)
+    {
+        AZSMockResponse *failure = [AZSMockResponse errorWithStatusCode:416 code:@"InvalidRange" message:@"The range specified is invalid for the current size of the resource."];
+        failure.headers[@"Content-Range"] = [NSString stringWithFormat:@"bytes */%llu", length];
+        return failure;
+    }
+
+    end = MIN(end, length - 1);
+    response.statusCode = 206;
+    response.body = [blob.data subdataWithRange:NSMakeRange((NSUInteger)start, (NSUInteger)(end - start + 1))];
+    response.headers[@"Content-Range"] = [NSString stringWithFormat:@"bytes %llu-%llu/%llu", start, end, length];
+
+    // A ranged read reports the blob's MD5 separately, and the range's MD5 only on request.
+    [response.headers removeObjectForKey:@"Content-MD5"];
+    if (blob.properties[@"Content-MD5"])
+    {
+        response.headers[@"x-ms-blob-content-md5"] = blob.properties[@"Content-MD5"];
+    }
+    if ([[request header:@"x-ms-range-get-content-md5"] isEqualToString:@"true"])
+    {
+        if (response.body.length > AZSMockMaxBlockSize)
+        {
+            return [AZSMockResponse errorWithStatusCode:400 code:@"OutOfRangeInput" message:@"One of the request inputs is out of range."];
+        }
+        response.headers[@"Content-MD5"] = [AZSUtil calculateMD5FromData:response.body];
+    }
+    if ([[request header:@"x-ms-range-get-content-crc64"] isEqualToString:@"true"] && [self requestSupportsCRC64:request])
+    {
+        if (response.body.length > AZSMockMaxBlockSize)
+        {
+            return [AZSMockResponse errorWithStatusCode:400 code:@"OutOfRangeInput" message:@"One of the request inputs is out of range."];
+        }
+        response.headers[@"x-ms-content-crc64"] = [AZSUtil calculateCRC64FromData:response.body];
+    }
+    return response;
+}
+
+-(AZSMockResponse *)putBlobResponseForRequest:(AZSMockRequest *)request container:(AZSMockContainer *)container blobName:(NSString *)blobName existing:(AZSMockBlob *)existing
+{
+    NSString *blobType = [request header:@"x-ms-blob-type"];
+    AZSMockBlob *blob = [[AZSMockBlob alloc] init];
+    blob.blobType = blobType;
+    blob.committed = YES;
+
+    // The lease survives an overwrite.
+    if (existing)
+    {
+        blob.lease = existing.lease;
+    }
+
+    if ([blobType isEqualToString:@"BlockBlob"])
+    {
+        [blob.data setData:request.body];
+    }
+    else if ([blobType isEqualToString:@"PageBlob"] || [blobType isEqualToString:@"AppendBlob"])
+    {
+        if (request.body.length > 0)
+        {
+            return [AZSMockResponse errorWithStatusCode:400 code:@"InvalidHeaderValue" message:@"Page and append blobs must be created empty."];
+        }
+        if ([blobType isEqualToString:@"PageBlob"])
+        {
+            long long contentLength = [[request header:@"x-ms-blob-content-length"] longLongValue];
+            if (![request header:@"x-ms-blob-content-length"] || contentLength < 0 || contentLength % 512 != 0)
+            {
+                return [AZSMockResponse errorWithStatusCode:400 code:@"InvalidHeaderValue" message:@"The value for x-ms-blob-content-length must be a multiple of 512."];
+            }
+            blob.data.length = (NSUInteger)contentLength;
+            blob.sequenceNumber = [[request header:@"x-ms-blob-sequence-number"] longLongValue];
+        }
+    }
+    else
+    {
+        return [AZSMockResponse errorWithStatusCode:400 code:@"InvalidHeaderValue" message:@"The value for x-ms-blob-type is not valid."];
+    }
+
+    [self setPropertiesFromRequest:request onBlob:blob acceptStandardHeaders:YES];
+    [self setMetadataFromRequest:request onResource:blob];
+    NSString *contentMD5 = [AZSUtil calculateMD5FromData:request.body];
+    if ([blobType isEqualToString:@"BlockBlob"] && !blob.properties[@"Content-MD5"])
+    {
+        blob.properties[@"Content-MD5"] = [request header:@"Content-MD5"] ?: contentMD5;
+    }
+    container.blobs[blobName] = blob;
+
+    AZSMockResponse *response = [self writeResponseForBlob:blob statusCode:201];
+    response.headers[@"Content-MD5"] = contentMD5;
+    return response;
+}
+
+-(AZSMockResponse *)putBlockResponseForRequest:(AZSMockRequest *)request container:(AZSMockContainer *)container blobName:(NSString *)blobName blob:(AZSMockBlob *)blob
+{
+    NSString *blockId = [request queryValue:@"blockid"];
+    NSData *decodedBlockId = blockId ? [[NSData alloc] initWithBase64EncodedString:blockId options:0] : nil;
+    if (decodedBlockId.length == 0 || decodedBlockId.length > 64)
+    {
+        return [AZSMockResponse errorWithStatusCode:400 code:@"InvalidQueryParameterValue" message:@"Value for one of the query parameters specified in the request URI is invalid."];
+    }
+    if (request.body.length > AZSMockMaxBlockSize)
+    {
+        return [AZSMockResponse errorWithStatusCode:413 code:@"RequestBodyTooLarge" message:@"The request body is too large and exceeds the maximum permissible limit."];
+    }
+
+    AZSMockResponse *failure = [self checkContentHashesForRequest:request];
+    if (!failure && blob.committed)
+    {
+        failure = ![blob.blobType isEqualToString:@"BlockBlob"] ? [AZSMockResponse errorWithStatusCode:409 code:@"InvalidBlobType" message:@"The blob type is invalid for this operation."] : [self checkLeaseForRequest:request resource:blob write:YES kind:@"Blob"];
+    }
+    if (failure)
+    {
+        return failure;
+    }
+
+    // An uncommitted block blob is invisible until its first block list is committed.
+    if (!blob)
+    {
+        blob = [[AZSMockBlob alloc] init];
+        blob.blobType = @"BlockBlob";
+        container.blobs[blobName] = blob;
+    }
+    if (!blob.uncommittedBlocks[blockId])
+    {
+        [blob.uncommittedBlockOrder addObject:blockId];
+    }
+    blob.uncommittedBlocks[blockId] = request.body;
+
+    AZSMockResponse *response = [AZSMockResponse responseWithStatusCode:201];
+    response.headers[@"Content-MD5"] = [AZSUtil calculateMD5FromData:request.body];
+    return response;
+}
+
+-(AZSMockResponse *)putBlockListResponseForRequest:(AZSMockRequest *)request container:(AZSMockContainer *)container blobName:(NSString *)blobName blob:(AZSMockBlob *)blob
+{
+    AZSMockBlockListParser *parserDelegate = [[AZSMockBlockListParser alloc] init];
+    NSXMLParser *parser = [[NSXMLParser alloc] initWithData:request.body];
+    parser.delegate = parserDelegate;
+    if (![parser parse])
+    {
+        return [AZSMockResponse errorWithStatusCode:400 code:@"InvalidXmlDocument" message:@"XML specified is not syntactically valid."];
+    }
+
+    NSMutableDictionary *committedById = [NSMutableDictionary dictionary];
+    for (AZSMockBlock *block in blob.committedBlocks)
+    {
+        committedById[block.blockId] = block.data;
+    }
+
+    NSMutableArray *blocks = [NSMutableArray arrayWithCapacity:parserDelegate.entries.count];
+    NSMutableData *data = [NSMutableData data];
+    for (NSArray *entry in parserDelegate.entries)
+    {
+        NSString *list = entry[0];
+        NSString *blockId = entry[1];
+        NSData *blockData = nil;
+        if ([list isEqualToString:@"Uncommitted"] || [list isEqualToString:@"Latest"])
+        {
+            blockData = blob.uncommittedBlocks[blockId];
+        }
+        if (!blockData && ([list isEqualToString:@"Committed"] || [list isEqualToString:@"Latest"]))
+        {
+            blockData = committedById[blockId];
+        }
+        if (!blockData)
+        {
+            return [AZSMockResponse errorWithStatusCode:400 code:@"InvalidBlockList" message:@"The specified block list is invalid."];
+        }
+
+        AZSMockBlock *block = [[AZSMockBlock alloc] init];
+        block.blockId = blockId;
+        block.data = blockData;
+        [blocks addObject:block];
+        [data appendData:blockData];
+    }
+
+    if (!blob)
+    {
+        blob = [[AZSMockBlob alloc] init];
+        blob.blobType = @"BlockBlob";
+        container.blobs[blobName] = blob;
+    }
+    blob.committed = YES;
+    blob.committedBlocks = blocks;
+    blob.data = data;
+    [blob.uncommittedBlocks removeAllObjects];
+    [blob.uncommittedBlockOrder removeAllObjects];
+    [self setPropertiesFromRequest:request onBlob:blob acceptStandardHeaders:NO];
+    [self setMetadataFromRequest:request onResource:blob];
+    [blob touch];
+    return [self writeResponseForBlob:blob statusCode:201];
+}
+
+-(AZSMockResponse *)getBlockListResponseForRequest:(AZSMockRequest *)request blob:(AZSMockBlob *)blob
+{
+    NSString *listType = [request queryValue:@"blocklisttype"] ?: @"committed";
+    NSMutableString *xml = [NSMutableString stringWithString:@"<?xml version=\"1.0\" encoding=\"utf-8\"?><BlockList>"];
+    if ([listType isEqualToString:@"committed"] || [listType isEqualToString:@"all"])
+    {
+        [xml appendString:@"<CommittedBlocks>"];
+        for (AZSMockBlock *block in blob.committedBlocks)
+        {
+            [xml appendFormat:@"<Block><Name>%@</Name><Size>%lu</Size></Block>", block.blockId, (unsigned long)block.data.length];
+        }
+        [xml appendString:@"</CommittedBlocks>"];
+    }
+    if ([listType isEqualToString:@"uncommitted"] || [listType isEqualToString:@"all"])
+    {
+        [xml appendString:@"<UncommittedBlocks>"];
+        for (NSString *blockId in blob.uncommittedBlockOrder)
+        {
+            [xml appendFormat:@"<Block><Name>%@</Name><Size>%lu</Size></Block>", blockId, (unsigned long)[blob.uncommittedBlocks[blockId] length]];
+        }
+        [xml appendString:@"</UncommittedBlocks>"];
+    }
+    [xml appendString:@"</BlockList>"];
+
+    AZSMockResponse *response = [AZSMockResponse xmlResponseWithString:xml];
+    if (blob.committed)
+    {
+        [self addResourceHeaders:blob toResponse:response includeMetadata:NO];
+    }
+    response.headers[@"x-ms-blob-content-length"] = [NSString stringWithFormat:@"%lu", (unsigned long)blob.data.length];
+    return response;
+}
+
+-(AZSMockResponse *)putPageResponseForRequest:(AZSMockRequest *)request blob:(AZSMockBlob *)blob
+{
+    uint64_t start = 0;
+    uint64_t end = 0;
+    NSString *range = [request header:@"x-ms-range"] ?: [request header:@"Range"];
+    if (!range || !AZSMockParseRange(range, &start, &end) || end == UINT64_MAX || start % 512 != 0 || (end + 1) % 512 != 0 || end >= blob.data.length)
+    {
+        return [AZSMockResponse errorWithStatusCode:416 code:@"InvalidPageRange" message:@"The page range specified is invalid."];
+    }
+
+    NSRange pages = NSMakeRange((NSUInteger)start, (NSUInteger)(end - start + 1));
+    NSString *pageWrite = [[request header:@"x-ms-page-write"] lowercaseString];
+    if ([pageWrite isEqualToString:@"update"])
+    {
+        if (request.body.length != pages.length)
+        {
+            return [AZSMockResponse errorWithStatusCode:400 code:@"InvalidHeaderValue" message:@"The page range does not match the length of the request body."];
+        }
+        [blob.data replaceBytesInRange:pages withBytes:request.body.bytes];
+    }
+    else if ([pageWrite isEqualToString:@"clear"])
+    {
+        [blob.data resetBytesInRange:pages];
+    }
+    else
+    {
+        return [AZSMockResponse errorWithStatusCode:400 code:@"InvalidHeaderValue" message:@"The value for x-ms-page-write is not valid."];
+    }
+
+    [blob touch];
+    AZSMockResponse *response = [self writeResponseForBlob:blob statusCode:201];
+    response.headers[@"x-ms-blob-sequence-number"] = [NSString stringWithFormat:@"%lld", blob.sequenceNumber];
+    if ([pageWrite isEqualToString:@"update"])
+    {
+        response.headers[@"Content-MD5"] = [AZSUtil calculateMD5FromData:request.body];
+    }
+    return response;
+}
+
+-(AZSMockResponse *)appendBlockResponseForRequest:(AZSMockRequest *)request blob:(AZSMockBlob *)blob
+{
+    NSString *maxSize = [request header:@"x-ms-blob-condition-maxsize"];
+    if (maxSize && blob.data.length + request.body.length > (unsigned long long)[maxSize longLongValue])
+    {
+        return [AZSMockResponse errorWithStatusCode:412 code:@"MaxBlobSizeConditionNotMet" message:@"The max blob size condition specified was not met."];
+    }
+    NSString *appendPosition = [request header:@"x-ms-blob-condition-appendpos"];
+    if (appendPosition && blob.data.length != (unsigned long long)[appendPosition longLongValue])
+    {
+        return [AZSMockResponse errorWithStatusCode:412 code:@"AppendPositionConditionNotMet" message:@"The append position condition specified was not met."];
+    }
+    if (request.body.length > AZSMockMaxBlockSize)
+    {
+        return [AZSMockResponse errorWithStatusCode:413 code:@"RequestBodyTooLarge" message:@"The request body is too large and exceeds the maximum permissible limit."];
+    }
+    if (blob.appendBlockCount >= AZSMockMaxAppendBlockCount)
+    {
+        return [AZSMockResponse errorWithStatusCode:409 code:@"BlockCountExceedsLimit" message:@"The committed block count cannot exceed the maximum limit of 50,000 blocks."];
+    }
+
+    NSUInteger offset = blob.data.length;
+    [blob.data appendData:request.body];
+    blob.appendBlockCount++;
+    [blob touch];
+
+    AZSMockResponse *response = [self writeResponseForBlob:blob statusCode:201];
+    response.headers[@"x-ms-blob-append-offset"] = [NSString stringWithFormat:@"%lu", (unsigned long)offset];
+    response.headers[@"x-ms-blob-committed-block-count"] = [NSString stringWithFormat:@"%lu", (unsigned long)blob.appendBlockCount];
+    response.headers[@"Content-MD5"] = [AZSUtil calculateMD5FromData:request.body];
+    return response;
+}
+
+-(AZSMockResponse *)setBlobPropertiesResponseForRequest:(AZSMockRequest *)request blob:(AZSMockBlob *)blob
+{
+    if ([blob.blobType isEqualToString:@"PageBlob"])
+    {
+        NSString *contentLength = [request header:@"x-ms-blob-content-length"];
+        if (contentLength)
+        {
+            if ([contentLength longLongValue] < 0 || [contentLength longLongValue] % 512 != 0)
+            {
+                return [AZSMockResponse errorWithStatusCode:400 code:@"InvalidHeaderValue" message:@"The value for x-ms-blob-content-length must be a multiple of 512."];
+            }
+            blob.data.length = (NSUInteger)[contentLength longLongValue];
+        }
+
+        NSString *action = [[request header:@"x-ms-sequence-number-action"] lowercaseString];
+        int64_t sequenceNumber = [[request header:@"x-ms-blob-sequence-number"] longLongValue];
+        if ([action isEqualToString:@"max"])
+        {
+            blob.sequenceNumber = MAX(blob.sequenceNumber, sequenceNumber);
+        }
+        else if ([action isEqualToString:@"update"])
+        {
+            blob.sequenceNumber = sequenceNumber;
+        }
+        else if ([action isEqualToString:@"increment"])
+        {
+            blob.sequenceNumber++;
+        }
+    }
+
+    [self setPropertiesFromRequest:request onBlob:blob acceptStandardHeaders:NO];
+    [blob touch];
+    AZSMockResponse *response = [self writeResponseForBlob:blob statusCode:200];
+    if ([blob.blobType isEqualToString:@"PageBlob"])
+    {
+        response.headers[@"x-ms-blob-sequence-number"] = [NSString stringWithFormat:@"%lld", blob.sequenceNumber];
+    }
+    return response;
+}
+
+@end
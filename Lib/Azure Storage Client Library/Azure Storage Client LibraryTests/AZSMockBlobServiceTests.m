@@ -0,0 +1,260 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSMockBlobServiceTests.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <XCTest/XCTest.h>
+#import "AZSClient.h"
+#import "AZSConstants.h"
+#import "AZSUtil.h"
+#import "AZSMockBlobService.h"
+#import "AZSTestSemaphore.h"
+
+static const NSUInteger AZSMockBlobServiceBenchmarkBlobSize = 4 * 1024 * 1024;
+
+@interface AZSMockBlobServiceTests : XCTestCase
+
+@property (strong) AZSMockBlobService *service;
+@property (strong) AZSCloudBlobClient *blobClient;
+@property (strong) AZSCloudBlobContainer *blobContainer;
+
+@end
+
+@implementation AZSMockBlobServiceTests
+
+- (void)setUp {
+    [super setUp];
+
+    self.service = [[AZSMockBlobService alloc] initWithAccountName:@"mocktestaccount" accountKey:@"bW9ja3Rlc3RhY2NvdW50a2V5"];
+    NSError *error = nil;
+    XCTAssertTrue([self.service startWithError:&error], @"Error: %@", error);
+
+    self.blobClient = [[self.service account] getBlobClient];
+    self.blobContainer = [self.blobClient containerReferenceFromName:@"mockcontainer"];
+
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [self.blobContainer createContainerWithCompletionHandler:^(NSError *err) {
+        XCTAssertNil(err, @"Error in container creation: %@", err);
+        [semaphore signal];
+    }];
+    [semaphore wait];
+}
+
+- (void)tearDown {
+    [self.service stop];
+    [super tearDown];
+}
+
+-(NSError *)uploadText:(NSString *)text toBlob:(AZSCloudBlockBlob *)blob accessCondition:(AZSAccessCondition *)accessCondition operationContext:(AZSOperationContext *)operationContext {
+    __block NSError *uploadError = nil;
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [blob uploadFromText:text accessCondition:accessCondition requestOptions:nil operationContext:operationContext completionHandler:^(NSError *err) {
+        uploadError = err;
+        [semaphore signal];
+    }];
+    [semaphore wait];
+    return uploadError;
+}
+
+-(NSString *)downloadTextFromBlob:(AZSCloudBlockBlob *)blob error:(NSError **)error {
+    __block NSError *downloadError = nil;
+    __block NSString *downloadedText = nil;
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [blob downloadToTextWithCompletionHandler:^(NSError *err, NSString *text) {
+        downloadError = err;
+        downloadedText = text;
+        [semaphore signal];
+    }];
+    [semaphore wait];
+    *error = downloadError;
+    return downloadedText;
+}
+
+-(void)testContainerCreateConflicts {
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [self.blobContainer createContainerWithCompletionHandler:^(NSError *err) {
+        XCTAssertNotNil(err);
+        XCTAssertEqual([err.userInfo[AZSCHttpStatusCode] integerValue], 409);
+        [semaphore signal];
+    }];
+    [semaphore wait];
+
+    [self.blobContainer existsWithCompletionHandler:^(NSError *err, BOOL exists) {
+        XCTAssertNil(err, @"Error: %@", err);
+        XCTAssertTrue(exists);
+        [semaphore signal];
+    }];
+    [semaphore wait];
+}
+
+-(void)testBlockBlobRoundTrip {
+    AZSCloudBlockBlob *blob = [self.blobContainer blockBlobReferenceFromName:@"dir/round trip.txt"];
+    XCTAssertNil([self uploadText:@"sample text" toBlob:blob accessCondition:nil operationContext:nil]);
+
+    NSError *error = nil;
+    XCTAssertEqualObjects([self downloadTextFromBlob:blob error:&error], @"sample text");
+    XCTAssertNil(error, @"Error: %@", error);
+    XCTAssertEqual(blob.properties.length.integerValue, 11);
+    XCTAssertNotNil(blob.properties.eTag);
+}
+
+-(void)testRangedDownload {
+    AZSCloudBlockBlob *blob = [self.blobContainer blockBlobReferenceFromName:@"ranged"];
+    XCTAssertNil([self uploadText:@"0123456789" toBlob:blob accessCondition:nil operationContext:nil]);
+
+    NSOutputStream *stream = [NSOutputStream outputStreamToMemory];
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [blob downloadToStream:stream range:NSMakeRange(2, 5) accessCondition:nil requestOptions:nil operationContext:nil completionHandler:^(NSError *err) {
+        XCTAssertNil(err, @"Error: %@", err);
+        [semaphore signal];
+    }];
+    [semaphore wait];
+
+    NSData *data = [stream propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
+    XCTAssertEqualObjects([[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding], @"23456");
+}
+
+-(void)testListingWithContinuationTokens {
+    for (NSUInteger i = 0; i < 7; i++)
+    {
+        AZSCloudBlockBlob *blob = [self.blobContainer blockBlobReferenceFromName:[NSString stringWithFormat:@"blob%lu", (unsigned long)i]];
+        XCTAssertNil([self uploadText:@"x" toBlob:blob accessCondition:nil operationContext:nil]);
+    }
+
+    __block NSUInteger listed = 0;
+    __block NSUInteger segments = 0;
+    __block AZSContinuationToken *token = nil;
+    do
+    {
+        AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+        [self.blobContainer listBlobsSegmentedWithContinuationToken:token prefix:@"blob" useFlatBlobListing:YES blobListingDetails:AZSBlobListingDetailsNone maxResults:3 completionHandler:^(NSError *err, AZSBlobResultSegment *results) {
+            XCTAssertNil(err, @"Error: %@", err);
+            listed += results.blobs.count;
+            segments++;
+            token = results.continuationToken;
+            [semaphore signal];
+        }];
+        [semaphore wait];
+    } while (token);
+
+    XCTAssertEqual(listed, 7);
+    XCTAssertEqual(segments, 3);
+}
+
+-(void)testLeasedBlobRejectsWritesWithoutLease {
+    AZSCloudBlockBlob *blob = [self.blobContainer blockBlobReferenceFromName:@"leased"];
+    XCTAssertNil([self uploadText:@"before" toBlob:blob accessCondition:nil operationContext:nil]);
+
+    __block NSString *leaseId = nil;
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [blob acquireLeaseWithLeaseTime:@15 proposedLeaseId:nil completionHandler:^(NSError *err, NSString *acquiredLeaseId) {
+        XCTAssertNil(err, @"Error: %@", err);
+        leaseId = acquiredLeaseId;
+        [semaphore signal];
+    }];
+    [semaphore wait];
+    XCTAssertNotNil(leaseId);
+
+    NSError *error = [self uploadText:@"no lease" toBlob:blob accessCondition:nil operationContext:nil];
+    XCTAssertEqual([error.userInfo[AZSCHttpStatusCode] integerValue], 412);
+
+    XCTAssertNil([self uploadText:@"with lease" toBlob:blob accessCondition:[[AZSAccessCondition alloc] initWithLeaseId:leaseId] operationContext:nil]);
+}
+
+-(void)testConditionalUpload {
+    AZSCloudBlockBlob *blob = [self.blobContainer blockBlobReferenceFromName:@"conditional"];
+    XCTAssertNil([self uploadText:@"first" toBlob:blob accessCondition:nil operationContext:nil]);
+    NSString *etag = blob.properties.eTag;
+
+    XCTAssertNil([self uploadText:@"second" toBlob:blob accessCondition:[[AZSAccessCondition alloc] initWithIfMatchCondition:etag] operationContext:nil]);
+
+    NSError *error = [self uploadText:@"third" toBlob:blob accessCondition:[[AZSAccessCondition alloc] initWithIfMatchCondition:etag] operationContext:nil];
+    XCTAssertEqual([error.userInfo[AZSCHttpStatusCode] integerValue], 412);
+}
+
+-(void)testWrongKeyIsRejected {
+    self.service.verifySharedKey = YES;
+    NSString *connectionString = [self.service.connectionString stringByReplacingOccurrencesOfString:self.service.accountKey withString:@"d3JvbmdrZXk="];
+    NSError *error = nil;
+    AZSCloudStorageAccount *account = [AZSCloudStorageAccount accountFromConnectionString:connectionString error:&error];
+    AZSCloudBlockBlob *blob = [[[account getBlobClient] containerReferenceFromName:@"mockcontainer"] blockBlobReferenceFromName:@"unauthorized"];
+
+    error = [self uploadText:@"text" toBlob:blob accessCondition:nil operationContext:nil];
+    XCTAssertEqual([error.userInfo[AZSCHttpStatusCode] integerValue], 403);
+}
+
+-(void)testServerBusyIsRetried {
+    AZSCloudBlockBlob *blob = [self.blobContainer blockBlobReferenceFromName:@"retried"];
+    AZSOperationContext *operationContext = [[AZSOperationContext alloc] init];
+    operationContext.retryPolicy = [[AZSRetryPolicyLinear alloc] initWithMaxAttempts:3 waitTimeBetweenRetries:0.01];
+
+    NSUInteger requestCount = self.service.requestCount;
+    [self.service injectFault:AZSMockFaultServerBusy count:2];
+    XCTAssertNil([self uploadText:@"eventually" toBlob:blob accessCondition:nil operationContext:operationContext]);
+    XCTAssertEqual(self.service.requestCount - requestCount, 3);
+    XCTAssertEqual(operationContext.requestResults.count, 3);
+}
+
+-(void)testStreamedUploadHashesEachBlock {
+    AZSCloudBlockBlob *blob = [self.blobContainer blockBlobReferenceFromName:@"hashed"];
+    NSMutableData *data = [NSMutableData dataWithLength:10 * 4096 + 100];
+    arc4random_buf(data.mutableBytes, data.length);
+
+    AZSBlobRequestOptions *options = [[AZSBlobRequestOptions alloc] init];
+    options.useTransactionalMD5 = YES;
+    options.storeBlobContentMD5 = YES;
+    options.blockSize = 4096;
+    options.parallelismFactor = 4;
+
+    // The mock service rejects blocks whose Content-MD5 does not match, so only the presence of the header is checked here.
+    __block NSUInteger blocksWithMD5 = 0;
+    AZSOperationContext *operationContext = [[AZSOperationContext alloc] init];
+    operationContext.sendingRequest = ^(NSMutableURLRequest *request, AZSOperationContext *sendingContext) {
+        if ([request.URL.query containsString:@"blockid="] && [request valueForHTTPHeaderField:AZSCContentMd5])
+        {
+            @synchronized(self)
+            {
+                blocksWithMD5++;
+            }
+        }
+    };
+
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [blob uploadFromData:data accessCondition:nil requestOptions:options operationContext:operationContext completionHandler:^(NSError *err) {
+        XCTAssertNil(err, @"Error: %@", err);
+        [semaphore signal];
+    }];
+    [semaphore wait];
+
+    XCTAssertEqual(blocksWithMD5, 11);
+    XCTAssertEqualObjects(blob.properties.contentMD5, [AZSUtil calculateMD5FromData:data]);
+}
+
+-(void)testUploadThroughput {
+    AZSCloudBlockBlob *blob = [self.blobContainer blockBlobReferenceFromName:@"throughput"];
+    NSMutableData *data = [NSMutableData dataWithLength:AZSMockBlobServiceBenchmarkBlobSize];
+    arc4random_buf(data.mutableBytes, data.length);
+
+    [self measureBlock:^{
+        AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+        [blob uploadFromData:data completionHandler:^(NSError *err) {
+            XCTAssertNil(err, @"Error: %@", err);
+            [semaphore signal];
+        }];
+        [semaphore wait];
+    }];
+}
+
+@end
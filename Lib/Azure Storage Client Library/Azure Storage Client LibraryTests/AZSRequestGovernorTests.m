@@ -0,0 +1,310 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSRequestGovernorTests.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+
+#import <XCTest/XCTest.h>
+#import "AZSClient.h"
+#import "AZSTestSemaphore.h"
+
+static const NSUInteger AZSRequestGovernorOperationCount = 40;
+static const NSUInteger AZSRequestGovernorAdaptiveOperationCount = 300;
+
+@interface AZSRequestGovernorTests : XCTestCase
+
+@end
+
+@implementation AZSRequestGovernorTests
+
+-(AZSRequestResult *)resultWithStatusCode:(NSInteger)statusCode startTime:(NSDate *)startTime
+{
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"https://host/container"] statusCode:statusCode HTTPVersion:@"HTTP/1.1" headerFields:@{}];
+    return [[AZSRequestResult alloc] initWithStartTime:startTime location:AZSStorageLocationPrimary response:response error:nil];
+}
+
+// Tops the governor up to its current limit, then completes one request, the way a saturated client would.
+-(void)completeSaturatedRequestWithGovernor:(AZSRequestGovernor *)governor statusCode:(NSInteger)statusCode startTime:(NSDate *)startTime
+{
+    while (governor.inFlightRequests < governor.currentLimit)
+    {
+        [governor acquireSlotForHost:@"host" priority:AZSRequestPriorityNormal handler:^{}];
+    }
+    [governor releaseSlotForHost:@"host" result:[self resultWithStatusCode:statusCode startTime:startTime]];
+}
+
+- (void)setUp {
+    [super setUp];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+-(void)testGlobalAndPerHostLimits {
+    AZSRequestGovernor *governor = [[AZSRequestGovernor alloc] initWithMaximumRequests:3 maximumRequestsPerHost:2];
+    __block NSUInteger admitted = 0;
+    void (^handler)() = ^{
+        @synchronized(governor)
+        {
+            admitted++;
+        }
+    };
+
+    [governor acquireSlotForHost:@"a" priority:AZSRequestPriorityNormal handler:handler];
+    [governor acquireSlotForHost:@"a" priority:AZSRequestPriorityNormal handler:handler];
+    [governor acquireSlotForHost:@"b" priority:AZSRequestPriorityNormal handler:handler];
+    XCTAssertEqual(admitted, 3);
+
+    // The third request to a is over its host limit, and the second to b is over the global limit.
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [governor acquireSlotForHost:@"a" priority:AZSRequestPriorityNormal handler:^{
+        [semaphore signal];
+    }];
+    [governor acquireSlotForHost:@"b" priority:AZSRequestPriorityNormal handler:handler];
+    XCTAssertEqual(governor.inFlightRequests, 3);
+    XCTAssertEqual(governor.waitingRequests, 2);
+    XCTAssertEqual([governor inFlightRequestsForHost:@"a"], 2);
+
+    // Freeing a slot on b admits b, not the a that arrived earlier but is still over its host limit.
+    [governor releaseSlotForHost:@"b"];
+    XCTAssertEqual([governor inFlightRequestsForHost:@"b"], 1);
+    XCTAssertEqual(governor.waitingRequests, 1);
+
+    [governor releaseSlotForHost:@"a"];
+    [semaphore wait];
+    XCTAssertEqual(governor.inFlightRequests, 3);
+    XCTAssertEqual(governor.waitingRequests, 0);
+    XCTAssertEqual(governor.admittedRequests, 5);
+    XCTAssertEqual(governor.delayedRequests, 2);
+    XCTAssertEqual(governor.peakWaitingRequests, 2);
+}
+
+-(void)testWaitersAreAdmittedByPriority {
+    AZSRequestGovernor *governor = [[AZSRequestGovernor alloc] initWithMaximumRequests:1 maximumRequestsPerHost:1];
+    [governor acquireSlotForHost:@"host" priority:AZSRequestPriorityNormal handler:^{}];
+
+    NSMutableArray *order = [NSMutableArray array];
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    void (^enqueue)(NSString *, AZSRequestPriority) = ^(NSString *name, AZSRequestPriority priority) {
+        [governor acquireSlotForHost:@"host" priority:priority handler:^{
+            @synchronized(order)
+            {
+                [order addObject:name];
+                if (order.count == 4)
+                {
+                    [semaphore signal];
+                }
+            }
+            [governor releaseSlotForHost:@"host"];
+        }];
+    };
+    enqueue(@"low", AZSRequestPriorityLow);
+    enqueue(@"normal 1", AZSRequestPriorityNormal);
+    enqueue(@"high", AZSRequestPriorityHigh);
+    enqueue(@"normal 2", AZSRequestPriorityNormal);
+
+    [governor releaseSlotForHost:@"host"];
+    [semaphore wait];
+    NSArray *expected = @[@"high", @"normal 1", @"normal 2", @"low"];
+    XCTAssertEqualObjects(order, expected);
+    XCTAssertEqual(governor.delayedRequests, 4);
+    XCTAssertGreaterThan(governor.totalWaitTime, 0);
+}
+
+-(void)testCancelledWaiterIsNeverAdmitted {
+    AZSRequestGovernor *governor = [[AZSRequestGovernor alloc] initWithMaximumRequests:1 maximumRequestsPerHost:1];
+    XCTAssertNil([governor acquireSlotForHost:@"host" priority:AZSRequestPriorityNormal handler:^{}]);
+
+    __block BOOL cancelledAdmitted = NO;
+    id cancelled = [governor acquireSlotForHost:@"host" priority:AZSRequestPriorityHigh handler:^{
+        cancelledAdmitted = YES;
+    }];
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    id waiting = [governor acquireSlotForHost:@"host" priority:AZSRequestPriorityNormal handler:^{
+        [semaphore signal];
+    }];
+    XCTAssertNotNil(cancelled);
+    XCTAssertNotNil(waiting);
+    XCTAssertEqual(governor.waitingRequests, 2);
+
+    XCTAssertTrue([governor cancelWaiter:cancelled]);
+    XCTAssertFalse([governor cancelWaiter:cancelled]);
+    XCTAssertEqual(governor.waitingRequests, 1);
+
+    // The freed slot goes to the request still waiting, not the higher priority one that was cancelled.
+    [governor releaseSlotForHost:@"host"];
+    [semaphore wait];
+    XCTAssertFalse(cancelledAdmitted);
+    XCTAssertFalse([governor cancelWaiter:waiting]);
+    XCTAssertEqual(governor.inFlightRequests, 1);
+    XCTAssertEqual(governor.waitingRequests, 0);
+}
+
+-(void)testConcurrentOperationsAreBounded {
+    __block NSUInteger concurrentRequests = 0;
+    __block NSUInteger peakConcurrentRequests = 0;
+    NSObject *lock = [[NSObject alloc] init];
+
+    NSError *error = nil;
+    AZSCloudStorageAccount *account = [AZSCloudStorageAccount accountFromConnectionString:@"DefaultEndpointsProtocol=https;AccountName=loopbackaccount;AccountKey=bG9vcGJhY2thY2NvdW50a2V5" error:&error];
+    AZSCloudBlobClient *blobClient = [account getBlobClient];
+    blobClient.httpTransport = [[AZSLoopbackTransport alloc] initWithHandler:^(NSURLRequest *request, NSData *body, void (^respond)(NSInteger, NSDictionary *, NSData *)) {
+        @synchronized(lock)
+        {
+            concurrentRequests++;
+            peakConcurrentRequests = MAX(peakConcurrentRequests, concurrentRequests);
+        }
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, 10 * NSEC_PER_MSEC), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            @synchronized(lock)
+            {
+                concurrentRequests--;
+            }
+            respond(200, @{@"ETag": @"\"0x8D2000000000001\"", @"Last-Modified": @"Mon, 05 Oct 2015 20:00:00 GMT"}, nil);
+        });
+    }];
+    blobClient.requestGovernor = [[AZSRequestGovernor alloc] initWithMaximumRequests:4 maximumRequestsPerHost:4];
+
+    AZSCloudBlobContainer *container = [blobClient containerReferenceFromName:@"container"];
+    dispatch_group_t group = dispatch_group_create();
+    for (NSUInteger i = 0; i < AZSRequestGovernorOperationCount; i++)
+    {
+        dispatch_group_enter(group);
+        [container existsWithCompletionHandler:^(NSError *err, BOOL exists) {
+            XCTAssertNil(err, @"Error: %@", err);
+            dispatch_group_leave(group);
+        }];
+    }
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+
+    AZSRequestGovernor *governor = blobClient.requestGovernor;
+    XCTAssertLessThanOrEqual(peakConcurrentRequests, 4);
+    XCTAssertEqual(governor.peakInFlightRequests, 4);
+    XCTAssertEqual(governor.admittedRequests, AZSRequestGovernorOperationCount);
+    XCTAssertGreaterThan(governor.delayedRequests, 0);
+    XCTAssertEqual(governor.inFlightRequests, 0);
+    XCTAssertEqual(governor.waitingRequests, 0);
+}
+
+-(void)testAdaptiveLimitIsAdditiveIncreaseMultiplicativeDecrease {
+    AZSRequestGovernor *governor = [[AZSRequestGovernor alloc] initAdaptiveWithMinimumRequests:2 maximumRequests:16 maximumRequestsPerHost:16];
+    governor.latencyThreshold = 0;
+    XCTAssertTrue(governor.isAdaptive);
+    XCTAssertEqual(governor.currentLimit, 2);
+
+    // Growing from 2 to 16 takes roughly the sum of the limits in between.
+    for (NSUInteger i = 0; i < 200; i++)
+    {
+        [self completeSaturatedRequestWithGovernor:governor statusCode:200 startTime:[NSDate date]];
+    }
+    XCTAssertEqual(governor.currentLimit, 16);
+
+    NSDate *beforeThrottling = [NSDate date];
+    [NSThread sleepForTimeInterval:0.01];
+    [self completeSaturatedRequestWithGovernor:governor statusCode:503 startTime:beforeThrottling];
+    XCTAssertEqual(governor.currentLimit, 8);
+    XCTAssertEqual(governor.limitDecreases, 1);
+
+    // Another request from before the cut does not cut again, but one sent after it does.
+    [self completeSaturatedRequestWithGovernor:governor statusCode:500 startTime:beforeThrottling];
+    XCTAssertEqual(governor.currentLimit, 8);
+    [NSThread sleepForTimeInterval:0.01];
+    [self completeSaturatedRequestWithGovernor:governor statusCode:500 startTime:[NSDate date]];
+    XCTAssertEqual(governor.currentLimit, 4);
+
+    // The limit never falls below the minimum.
+    for (NSUInteger i = 0; i < 3; i++)
+    {
+        [NSThread sleepForTimeInterval:0.01];
+        [self completeSaturatedRequestWithGovernor:governor statusCode:503 startTime:[NSDate date]];
+    }
+    XCTAssertEqual(governor.currentLimit, 2);
+
+    // Client errors are healthy responses, as far as load is concerned.
+    for (NSUInteger i = 0; i < 10; i++)
+    {
+        [self completeSaturatedRequestWithGovernor:governor statusCode:404 startTime:[NSDate date]];
+    }
+    XCTAssertGreaterThan(governor.currentLimit, 2);
+}
+
+-(void)testAdaptiveLimitBacksOffOnRisingLatency {
+    AZSRequestGovernor *governor = [[AZSRequestGovernor alloc] initAdaptiveWithMinimumRequests:1 maximumRequests:64 maximumRequestsPerHost:64];
+    for (NSUInteger i = 0; i < 300; i++)
+    {
+        [self completeSaturatedRequestWithGovernor:governor statusCode:200 startTime:[NSDate dateWithTimeIntervalSinceNow:-0.01]];
+    }
+    NSUInteger limit = governor.currentLimit;
+    XCTAssertEqual(governor.limitDecreases, 0);
+
+    for (NSUInteger i = 0; i < 100; i++)
+    {
+        [self completeSaturatedRequestWithGovernor:governor statusCode:200 startTime:[NSDate dateWithTimeIntervalSinceNow:-0.1]];
+    }
+    XCTAssertEqual(governor.limitDecreases, 1);
+    XCTAssertLessThan(governor.currentLimit, limit);
+}
+
+-(void)testAdaptiveLimitConvergesUnderThrottling {
+    __block NSUInteger concurrentRequests = 0;
+    __block NSUInteger throttledRequests = 0;
+    NSObject *lock = [[NSObject alloc] init];
+
+    // The account throttles whenever more than 6 requests are in flight.
+    NSError *error = nil;
+    AZSCloudStorageAccount *account = [AZSCloudStorageAccount accountFromConnectionString:@"DefaultEndpointsProtocol=https;AccountName=loopbackaccount;AccountKey=bG9vcGJhY2thY2NvdW50a2V5" error:&error];
+    AZSCloudBlobClient *blobClient = [account getBlobClient];
+    blobClient.httpTransport = [[AZSLoopbackTransport alloc] initWithHandler:^(NSURLRequest *request, NSData *body, void (^respond)(NSInteger, NSDictionary *, NSData *)) {
+        NSInteger statusCode = 200;
+        @synchronized(lock)
+        {
+            concurrentRequests++;
+            if (concurrentRequests > 6)
+            {
+                statusCode = 503;
+                throttledRequests++;
+            }
+        }
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_MSEC), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            @synchronized(lock)
+            {
+                concurrentRequests--;
+            }
+            respond(statusCode, @{@"ETag": @"\"0x8D2000000000001\"", @"Last-Modified": @"Mon, 05 Oct 2015 20:00:00 GMT"}, nil);
+        });
+    }];
+    AZSRequestGovernor *governor = [[AZSRequestGovernor alloc] initAdaptiveWithMinimumRequests:1 maximumRequests:32 maximumRequestsPerHost:32];
+    governor.latencyThreshold = 0;
+    blobClient.requestGovernor = governor;
+
+    AZSCloudBlobContainer *container = [blobClient containerReferenceFromName:@"container"];
+    dispatch_group_t group = dispatch_group_create();
+    for (NSUInteger i = 0; i < AZSRequestGovernorAdaptiveOperationCount; i++)
+    {
+        AZSOperationContext *operationContext = [[AZSOperationContext alloc] init];
+        operationContext.retryPolicy = [[AZSRetryPolicyNoRetry alloc] init];
+        dispatch_group_enter(group);
+        [container existsWithAccessCondition:nil requestOptions:nil operationContext:operationContext completionHandler:^(NSError *err, BOOL exists) {
+            dispatch_group_leave(group);
+        }];
+    }
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+
+    XCTAssertGreaterThan(governor.limitDecreases, 0);
+    XCTAssertLessThanOrEqual(governor.currentLimit, 10);
+    XCTAssertLessThan(throttledRequests, AZSRequestGovernorAdaptiveOperationCount / 4);
+}
+
+@end
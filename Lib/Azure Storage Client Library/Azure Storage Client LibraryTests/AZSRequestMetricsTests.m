@@ -0,0 +1,114 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSRequestMetricsTests.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <XCTest/XCTest.h>
+#import "AZSOperationContext.h"
+#import "AZSRequestResult.h"
+
+@interface AZSRequestMetricsTests : XCTestCase
+
+@property (strong) AZSOperationContext *operationContext;
+
+@end
+
+@implementation AZSRequestMetricsTests
+
+- (void)setUp {
+    [super setUp];
+    self.operationContext = [[AZSOperationContext alloc] init];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+-(AZSRequestResult *)addRequestResultWithTimeToFirstByte:(NSTimeInterval)timeToFirstByte total:(NSTimeInterval)total metrics:(BOOL)metrics {
+    NSDate *startTime = [NSDate dateWithTimeIntervalSince1970:1000];
+    AZSRequestResult *requestResult = [[AZSRequestResult alloc] initWithStartTime:startTime location:AZSStorageLocationPrimary];
+    requestResult.endTime = [startTime dateByAddingTimeInterval:total];
+    requestResult.networkMetricsAvailable = metrics;
+    requestResult.timeToFirstByte = timeToFirstByte;
+    [self.operationContext addRequestResult:requestResult];
+    return requestResult;
+}
+
+-(void)testDurationOfPhase {
+    AZSRequestResult *requestResult = [self addRequestResultWithTimeToFirstByte:0.25 total:1.5 metrics:YES];
+    requestResult.domainLookupDuration = 0.01;
+    requestResult.connectDuration = 0.02;
+    requestResult.secureConnectionDuration = 0.03;
+    requestResult.requestSendDuration = 0.04;
+    requestResult.responseTransferDuration = 0.05;
+
+    XCTAssertEqual([requestResult durationOfPhase:AZSRequestPhaseDomainLookup], 0.01);
+    XCTAssertEqual([requestResult durationOfPhase:AZSRequestPhaseConnect], 0.02);
+    XCTAssertEqual([requestResult durationOfPhase:AZSRequestPhaseSecureConnection], 0.03);
+    XCTAssertEqual([requestResult durationOfPhase:AZSRequestPhaseRequestSend], 0.04);
+    XCTAssertEqual([requestResult durationOfPhase:AZSRequestPhaseTimeToFirstByte], 0.25);
+    XCTAssertEqual([requestResult durationOfPhase:AZSRequestPhaseResponseTransfer], 0.05);
+    XCTAssertEqualWithAccuracy([requestResult durationOfPhase:AZSRequestPhaseTotal], 1.5, 0.000001);
+}
+
+-(void)testPercentiles {
+    XCTAssertEqual([self.operationContext percentile:50 ofRequestPhase:AZSRequestPhaseTimeToFirstByte], 0);
+
+    // Added out of order, to check that the durations are sorted.
+    for (NSUInteger i = 10; i >= 1; i--)
+    {
+        [self addRequestResultWithTimeToFirstByte:(i / 10.0) total:i metrics:YES];
+    }
+
+    // A request without metrics counts towards the total, but not towards the network phases.
+    [self addRequestResultWithTimeToFirstByte:0 total:11 metrics:NO];
+
+    XCTAssertEqual([self.operationContext percentile:0 ofRequestPhase:AZSRequestPhaseTimeToFirstByte], 0.1);
+    XCTAssertEqual([self.operationContext percentile:50 ofRequestPhase:AZSRequestPhaseTimeToFirstByte], 0.5);
+    XCTAssertEqual([self.operationContext percentile:90 ofRequestPhase:AZSRequestPhaseTimeToFirstByte], 0.9);
+    XCTAssertEqual([self.operationContext percentile:99 ofRequestPhase:AZSRequestPhaseTimeToFirstByte], 1.0);
+    XCTAssertEqual([self.operationContext percentile:100 ofRequestPhase:AZSRequestPhaseTimeToFirstByte], 1.0);
+
+    XCTAssertEqualWithAccuracy([self.operationContext percentile:100 ofRequestPhase:AZSRequestPhaseTotal], 11, 0.000001);
+    XCTAssertEqualWithAccuracy([self.operationContext percentile:50 ofRequestPhase:AZSRequestPhaseTotal], 6, 0.000001);
+}
+
+-(void)testPercentilesWhileResultsAreAdded {
+    // Parallel requests in one operation finish on different threads while the caller samples the percentiles.
+    dispatch_group_t group = dispatch_group_create();
+    for (int thread = 0; thread < 4; thread++)
+    {
+        dispatch_group_async(group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            for (int i = 1; i <= 500; i++)
+            {
+                [self addRequestResultWithTimeToFirstByte:(i / 1000.0) total:i metrics:YES];
+            }
+        });
+    }
+
+    while (dispatch_group_wait(group, DISPATCH_TIME_NOW) != 0)
+    {
+        NSTimeInterval median = [self.operationContext percentile:50 ofRequestPhase:AZSRequestPhaseTimeToFirstByte];
+        XCTAssertGreaterThanOrEqual(median, 0);
+        XCTAssertLessThanOrEqual(median, 0.5);
+        XCTAssertLessThanOrEqual(self.operationContext.requestResults.count, 2000);
+    }
+
+    XCTAssertEqual(self.operationContext.requestResults.count, 2000);
+    XCTAssertEqualWithAccuracy([self.operationContext percentile:100 ofRequestPhase:AZSRequestPhaseTimeToFirstByte], 0.5, 0.000001);
+    XCTAssertEqualWithAccuracy([self.operationContext percentile:50 ofRequestPhase:AZSRequestPhaseTotal], 250, 0.000001);
+}
+
+@end
@@ -0,0 +1,95 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSSharedKeySigningTests.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <XCTest/XCTest.h>
+#import <CommonCrypto/CommonHMAC.h>
+#import "AZSOperationContext.h"
+#import "AZSSharedKeyBlobAuthenticationHandler.h"
+#import "AZSStorageCredentials.h"
+
+@interface AZSSharedKeyBlobAuthenticationHandler (Testing)
+-(NSString *) getStringToSignWithRequest:(NSMutableURLRequest *)request operationContext:(AZSOperationContext *)operationContext;
+@end
+
+@interface AZSSharedKeySigningTests : XCTestCase
+
+@property (strong) AZSStorageCredentials *credentials;
+@property (strong) AZSSharedKeyBlobAuthenticationHandler *handler;
+
+@end
+
+@implementation AZSSharedKeySigningTests
+
+- (void)setUp {
+    [super setUp];
+    self.credentials = [[AZSStorageCredentials alloc] initWithAccountName:@"myaccount" accountKey:@"dGhpcyBpcyBub3QgYSByZWFsIGFjY291bnQga2V5IQ=="];
+    self.handler = [[AZSSharedKeyBlobAuthenticationHandler alloc] initWithStorageCredentials:self.credentials];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+-(NSMutableURLRequest *)sampleRequest {
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:@"https://myaccount.blob.core.windows.net/mycontainer/my%20blob?restype=container&Comp=list&prefix=a%26b&timeout=30"]];
+    request.HTTPMethod = @"GET";
+    [request setValue:@"0" forHTTPHeaderField:@"Content-Length"];
+    [request setValue:@"bytes=0-511" forHTTPHeaderField:@"Range"];
+    [request setValue:@"2015-04-05" forHTTPHeaderField:@"x-ms-version"];
+    [request setValue:@"value\twith tab" forHTTPHeaderField:@"x-ms-meta-Key"];
+    [request setValue:@"Sun, 04 Oct 2015 23:06:40 GMT" forHTTPHeaderField:@"x-ms-date"];
+    return request;
+}
+
+-(void)testStringToSign {
+    NSString *stringToSign = [self.handler getStringToSignWithRequest:[self sampleRequest] operationContext:[[AZSOperationContext alloc] init]];
+    NSString *expected = @"GET\n\n\n\n\n\n\n\n\n\n\nbytes=0-511\n"
+                         @"x-ms-date:Sun, 04 Oct 2015 23:06:40 GMT\nx-ms-meta-key:value with tab\nx-ms-version:2015-04-05\n"
+                         @"/myaccount/mycontainer/my%20blob\ncomp:list\nprefix:a&b\nrestype:container\ntimeout:30";
+    XCTAssertEqualObjects(stringToSign, expected);
+
+    NSMutableURLRequest *rootRequest = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:@"https://myaccount.blob.core.windows.net"]];
+    rootRequest.HTTPMethod = @"GET";
+    XCTAssertEqualObjects([self.handler getStringToSignWithRequest:rootRequest operationContext:[[AZSOperationContext alloc] init]], @"GET\n\n\n\n\n\n\n\n\n\n\n\n/myaccount/");
+}
+
+-(void)testCachedHmacMatchesDirectHmac {
+    const char *message = "The quick brown fox jumps over the lazy dog";
+    unsigned char cached[CC_SHA256_DIGEST_LENGTH];
+    unsigned char direct[CC_SHA256_DIGEST_LENGTH];
+
+    // Twice, to make sure the cached key state isn't consumed by the first call.
+    for (int i = 0; i < 2; i++)
+    {
+        [self.credentials computeHmacSha256WithBytes:message length:strlen(message) digest:cached];
+        CCHmac(kCCHmacAlgSHA256, self.credentials.accountKey.bytes, self.credentials.accountKey.length, message, strlen(message), direct);
+        XCTAssertEqual(memcmp(cached, direct, sizeof(cached)), 0);
+    }
+}
+
+-(void)testPerformanceSignRequest {
+    NSMutableURLRequest *request = [self sampleRequest];
+    AZSOperationContext *operationContext = [[AZSOperationContext alloc] init];
+    [self measureBlock:^{
+        for (int i = 0; i < 10000; i++)
+        {
+            [self.handler signRequest:request operationContext:operationContext];
+        }
+    }];
+}
+
+@end
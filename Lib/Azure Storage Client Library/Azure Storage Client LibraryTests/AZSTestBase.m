@@ -21,6 +21,7 @@
 #import "AZSConstants.h"
 #import "AZSCloudStorageAccount.h"
 #import "AZSOperationContext.h"
+#import "AZSMockBlobService.h"
 
 @interface AZSTestBase()
 {
@@ -59,9 +60,12 @@
     NSError *error;
     NSDictionary *json = (NSDictionary *)[NSJSONSerialization JSONObjectWithStream:fileStream options:0 error:&error];
     NSString *targetName = json[@"target"];
-    NSString *connectionString = (NSString *)((NSArray *)(json[@"tenants"]))[[(NSArray *)(json[@"tenants"]) indexOfObjectPassingTest:^(id object, NSUInteger idx, BOOL *stop) {
+    NSDictionary *tenant = (NSDictionary *)((NSArray *)(json[@"tenants"]))[[(NSArray *)(json[@"tenants"]) indexOfObjectPassingTest:^(id object, NSUInteger idx, BOOL *stop) {
         return [(NSString *)((NSDictionary *)object)[@"name"] isEqualToString:targetName];
-    }]][@"connection_string"];
+    }]];
+    
+    // A "mock" tenant runs the tests against the in-process mock Blob service instead of a real account.
+    NSString *connectionString = [tenant[@"type"] isEqualToString:@"mock"] ? [AZSMockBlobService sharedService].connectionString : tenant[@"connection_string"];
     
     self.account = [AZSCloudStorageAccount accountFromConnectionString:connectionString error:&error];
     
@@ -21,6 +21,7 @@
 #import "AZSTestHelpers.h"
 #import "AZSTestSemaphore.h"
 #import "AZSClient.h"
+#import "AZSUtil.h"
 
 // TODO: Figure out a way to not have to document this.  Unfortunately, it will show up in the exported documentation.
 /** A retry policy, used for testing only.  Reserved for internal use. */
@@ -215,6 +216,73 @@
 
 }
 
+- (void)testJitteredRetryPolicy
+{
+    double baseDelay = 1.0;
+    double maximumDelay = 30.0;
+    AZSRetryPolicyJittered *retryPolicy = [[AZSRetryPolicyJittered alloc] initWithMaxAttempts:10 baseDelay:baseDelay maximumDelay:maximumDelay jitterMode:AZSRetryJitterModeFull];
+    
+    // Which responses are retried is the same as for the other policies.
+    [self runRetryTestWithRetryPolicy:retryPolicy retryCount:1 statusCode:404 shouldSucceed:NO validateRetryInterval:^BOOL(double retryInterval) {
+        return YES;
+    }];
+    [self runRetryTestWithRetryPolicy:retryPolicy retryCount:1 statusCode:501 shouldSucceed:NO validateRetryInterval:^BOOL(double retryInterval) {
+        return YES;
+    }];
+    [self runRetryTestWithRetryPolicy:retryPolicy retryCount:10 statusCode:503 shouldSucceed:NO validateRetryInterval:^BOOL(double retryInterval) {
+        return YES;
+    }];
+    
+    // Full jitter: anywhere from 0 to the capped exponential backoff, and spread out rather than clustered.
+    for (NSInteger retryCount = 1; retryCount < 10; retryCount++)
+    {
+        double backoff = MIN(baseDelay * pow(2, retryCount - 1), maximumDelay);
+        double sum = 0;
+        double sumOfSquares = 0;
+        NSUInteger samples = 200;
+        for (NSUInteger i = 0; i < samples; i++)
+        {
+            AZSRetryInfo *retryInfo = [[retryPolicy clone] evaluateRetryContext:[self generateRetryContextWithCurrentRetryCount:retryCount statusCode:503] withOperationContext:nil];
+            XCTAssertTrue(retryInfo.shouldRetry);
+            XCTAssertGreaterThanOrEqual(retryInfo.retryInterval, 0);
+            XCTAssertLessThanOrEqual(retryInfo.retryInterval, backoff);
+            sum += retryInfo.retryInterval;
+            sumOfSquares += retryInfo.retryInterval * retryInfo.retryInterval;
+        }
+        
+        // A uniform distribution over [0, backoff] has a standard deviation of backoff / sqrt(12), about 0.29 * backoff.
+        double mean = sum / samples;
+        double deviation = sqrt(sumOfSquares / samples - mean * mean);
+        XCTAssertGreaterThan(deviation, 0.2 * backoff);
+    }
+    
+    // Decorrelated jitter: between the base delay and three times the previous wait, never past the cap.
+    retryPolicy = [[AZSRetryPolicyJittered alloc] initWithMaxAttempts:10 baseDelay:baseDelay maximumDelay:maximumDelay jitterMode:AZSRetryJitterModeDecorrelated];
+    double previousDelay = baseDelay;
+    for (NSInteger retryCount = 1; retryCount < 10; retryCount++)
+    {
+        AZSRetryInfo *retryInfo = [retryPolicy evaluateRetryContext:[self generateRetryContextWithCurrentRetryCount:retryCount statusCode:500] withOperationContext:nil];
+        XCTAssertTrue(retryInfo.shouldRetry);
+        XCTAssertGreaterThanOrEqual(retryInfo.retryInterval, baseDelay - 0.1);
+        XCTAssertLessThanOrEqual(retryInfo.retryInterval, MIN(previousDelay * 3, maximumDelay));
+        previousDelay = MAX(retryInfo.retryInterval, baseDelay);
+    }
+    
+    // Retry-After sets a floor, in seconds or as a date, even past the cap.
+    retryPolicy = [[AZSRetryPolicyJittered alloc] initWithMaxAttempts:10 baseDelay:0.01 maximumDelay:1 jitterMode:AZSRetryJitterModeFull];
+    NSArray *retryAfterValues = @[@"45", [AZSUtil convertDateToHttpString:[NSDate dateWithTimeIntervalSinceNow:46]]];
+    for (NSString *retryAfter in retryAfterValues)
+    {
+        NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"https://account.blob.core.windows.net/container"] statusCode:503 HTTPVersion:@"HTTP/1.1" headerFields:@{AZSCHeaderRetryAfter: retryAfter}];
+        AZSRequestResult *requestResult = [[AZSRequestResult alloc] initWithStartTime:[NSDate date] location:AZSStorageLocationPrimary response:response error:nil];
+        AZSRetryContext *retryContext = [[AZSRetryContext alloc] initWithCurrentRetryCount:1 lastRequestResult:requestResult nextLocation:AZSStorageLocationPrimary currentLocationMode:AZSStorageLocationModePrimaryOnly];
+        AZSRetryInfo *retryInfo = [[retryPolicy clone] evaluateRetryContext:retryContext withOperationContext:nil];
+        XCTAssertTrue(retryInfo.shouldRetry);
+        XCTAssertGreaterThan(retryInfo.retryInterval, 44);
+        XCTAssertLessThan(retryInfo.retryInterval, 47);
+    }
+}
+
 -(void)testRetryLogicInExecutor
 {
     AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
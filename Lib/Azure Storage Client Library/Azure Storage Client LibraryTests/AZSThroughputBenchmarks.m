@@ -0,0 +1,287 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSThroughputBenchmarks.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <XCTest/XCTest.h>
+#import <mach/mach.h>
+#import "AZSClient.h"
+#import "AZSMockBlobService.h"
+#import "AZSTestSemaphore.h"
+
+// The matrix runs only when AZS_BENCHMARK_OUTPUT names a file to write the JSON report to.  AZS_BENCHMARK_SIZES can
+// replace the default object sizes with a comma-separated list of byte counts; the mock service keeps blobs in memory,
+// so the largest sizes need a machine with room for them.
+static NSString *const AZSBenchmarkOutputVariable = @"AZS_BENCHMARK_OUTPUT";
+static NSString *const AZSBenchmarkSizesVariable = @"AZS_BENCHMARK_SIZES";
+
+// The data APIs hold the whole object in memory on the client as well, so they are skipped above this size.
+static const unsigned long long AZSBenchmarkMaxDataApiSize = 1024ULL * 1024 * 1024;
+
+static const NSTimeInterval AZSBenchmarkSampleInterval = 0.01;
+
+// Samples the process's resident size and thread count while a benchmark case runs.
+@interface AZSResourceSampler : NSObject
+@property (readonly) uint64_t peakResidentBytes;
+@property (readonly) NSUInteger peakThreadCount;
+-(void)start;
+-(void)stop;
+@end
+
+@interface AZSResourceSampler()
+{
+    dispatch_source_t _timer;
+}
+@property (readwrite) uint64_t peakResidentBytes;
+@property (readwrite) NSUInteger peakThreadCount;
+@end
+
+@implementation AZSResourceSampler
+
+-(void)sample
+{
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t infoCount = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &infoCount) == KERN_SUCCESS)
+    {
+        self.peakResidentBytes = MAX(self.peakResidentBytes, info.resident_size);
+    }
+
+    thread_act_array_t threads;
+    mach_msg_type_number_t threadCount = 0;
+    if (task_threads(mach_task_self(), &threads, &threadCount) == KERN_SUCCESS)
+    {
+        for (mach_msg_type_number_t i = 0; i < threadCount; i++)
+        {
+            mach_port_deallocate(mach_task_self(), threads[i]);
+        }
+        vm_deallocate(mach_task_self(), (vm_address_t)threads, threadCount * sizeof(thread_act_t));
+        self.peakThreadCount = MAX(self.peakThreadCount, threadCount);
+    }
+}
+
+-(void)start
+{
+    self.peakResidentBytes = 0;
+    self.peakThreadCount = 0;
+    [self sample];
+
+    _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0));
+    dispatch_source_set_timer(_timer, DISPATCH_TIME_NOW, AZSBenchmarkSampleInterval * NSEC_PER_SEC, AZSBenchmarkSampleInterval * NSEC_PER_SEC / 10);
+    __weak AZSResourceSampler *weakSelf = self;
+    dispatch_source_set_event_handler(_timer, ^{
+        [weakSelf sample];
+    });
+    dispatch_resume(_timer);
+}
+
+-(void)stop
+{
+    dispatch_source_cancel(_timer);
+    _timer = nil;
+    [self sample];
+}
+
+@end
+
+@interface AZSThroughputBenchmarks : XCTestCase
+
+@property (strong) AZSMockBlobService *service;
+@property (strong) AZSCloudBlobContainer *blobContainer;
+@property (strong) NSString *scratchDirectory;
+
+@end
+
+@implementation AZSThroughputBenchmarks
+
+- (void)setUp {
+    [super setUp];
+
+    self.service = [[AZSMockBlobService alloc] initWithAccountName:@"benchmarkaccount" accountKey:@"YmVuY2htYXJrYWNjb3VudGtleQ=="];
+    NSError *error = nil;
+    XCTAssertTrue([self.service startWithError:&error], @"Error: %@", error);
+
+    self.blobContainer = [[[self.service account] getBlobClient] containerReferenceFromName:@"benchmarks"];
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    [self.blobContainer createContainerWithCompletionHandler:^(NSError *err) {
+        XCTAssertNil(err, @"Error in container creation: %@", err);
+        [semaphore signal];
+    }];
+    [semaphore wait];
+
+    self.scratchDirectory = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    [[NSFileManager defaultManager] createDirectoryAtPath:self.scratchDirectory withIntermediateDirectories:YES attributes:nil error:nil];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtPath:self.scratchDirectory error:nil];
+    [self.service stop];
+    [super tearDown];
+}
+
+-(NSArray *)objectSizes {
+    NSString *sizes = [[NSProcessInfo processInfo] environment][AZSBenchmarkSizesVariable];
+    if (sizes.length == 0)
+    {
+        return @[@1024, @(1024 * 1024), @(16 * 1024 * 1024), @(128 * 1024 * 1024)];
+    }
+
+    NSMutableArray *objectSizes = [NSMutableArray array];
+    for (NSString *size in [sizes componentsSeparatedByString:@","])
+    {
+        [objectSizes addObject:@(strtoull(size.UTF8String, NULL, 10))];
+    }
+    return objectSizes;
+}
+
+// Writes a file of random bytes, one megabyte at a time, so that sizes larger than memory can be uploaded from disk.
+-(NSString *)sourceFileWithSize:(unsigned long long)size {
+    NSString *path = [self.scratchDirectory stringByAppendingPathComponent:[NSString stringWithFormat:@"source-%llu", size]];
+    if (![[NSFileManager defaultManager] fileExistsAtPath:path])
+    {
+        [[NSFileManager defaultManager] createFileAtPath:path contents:nil attributes:nil];
+        NSFileHandle *file = [NSFileHandle fileHandleForWritingAtPath:path];
+        NSMutableData *chunk = [NSMutableData dataWithLength:1024 * 1024];
+        for (unsigned long long written = 0; written < size; written += chunk.length)
+        {
+            arc4random_buf(chunk.mutableBytes, chunk.length);
+            [file writeData:(size - written < chunk.length) ? [chunk subdataWithRange:NSMakeRange(0, (NSUInteger)(size - written))] : chunk];
+        }
+        [file closeFile];
+    }
+    return path;
+}
+
+-(NSDictionary *)runCaseWithParameters:(NSDictionary *)parameters size:(unsigned long long)size operationContext:(AZSOperationContext *)operationContext operation:(void (^)(void (^)(NSError *)))operation {
+    AZSResourceSampler *sampler = [[AZSResourceSampler alloc] init];
+    AZSTestSemaphore *semaphore = [[AZSTestSemaphore alloc] init];
+    __block NSError *error = nil;
+
+    [sampler start];
+    NSDate *start = [NSDate date];
+    operation(^(NSError *err) {
+        error = err;
+        [semaphore signal];
+    });
+    [semaphore wait];
+    NSTimeInterval seconds = -[start timeIntervalSinceNow];
+    [sampler stop];
+    XCTAssertNil(error, @"Error in %@: %@", parameters, error);
+
+    NSMutableDictionary *result = [parameters mutableCopy];
+    result[@"sizeBytes"] = @(size);
+    result[@"seconds"] = @(seconds);
+    result[@"megabytesPerSecond"] = @(size / (1024.0 * 1024.0) / seconds);
+    result[@"requests"] = @(operationContext.requestResults.count);
+    result[@"requestsPerSecond"] = @(operationContext.requestResults.count / seconds);
+    result[@"p50LatencyMs"] = @([operationContext percentile:50 ofRequestPhase:AZSRequestPhaseTotal] * 1000);
+    result[@"p99LatencyMs"] = @([operationContext percentile:99 ofRequestPhase:AZSRequestPhaseTotal] * 1000);
+    result[@"peakResidentBytes"] = @(sampler.peakResidentBytes);
+    result[@"peakThreadCount"] = @(sampler.peakThreadCount);
+    result[@"succeeded"] = @(error == nil);
+    return result;
+}
+
+-(void)testThroughputMatrix {
+    NSString *outputPath = [[NSProcessInfo processInfo] environment][AZSBenchmarkOutputVariable];
+    if (outputPath.length == 0)
+    {
+        return;
+    }
+
+    NSArray *apis = @[@"stream", @"file", @"data"];
+    NSArray *parallelismFactors = @[@1, @3, @8];
+    NSArray *blockSizes = @[@(1024 * 1024), @(4 * 1024 * 1024)];
+    NSArray *downloadBufferSizes = @[@(1024 * 1024), @(4 * 1024 * 1024)];
+    NSMutableArray *results = [NSMutableArray array];
+
+    for (NSNumber *objectSize in [self objectSizes])
+    {
+        unsigned long long size = objectSize.unsignedLongLongValue;
+        NSString *sourcePath = [self sourceFileWithSize:size];
+        NSData *sourceData = (size <= AZSBenchmarkMaxDataApiSize) ? [NSData dataWithContentsOfFile:sourcePath options:NSDataReadingMappedIfSafe error:nil] : nil;
+        AZSCloudBlockBlob *blob = [self.blobContainer blockBlobReferenceFromName:[NSString stringWithFormat:@"blob-%llu", size]];
+
+        for (NSString *api in apis)
+        {
+            if ([api isEqualToString:@"data"] && !sourceData)
+            {
+                continue;
+            }
+
+            for (NSNumber *parallelismFactor in parallelismFactors)
+            {
+                for (NSNumber *blockSize in blockSizes)
+                {
+                    AZSBlobRequestOptions *options = [[AZSBlobRequestOptions alloc] init];
+                    options.parallelismFactor = parallelismFactor.integerValue;
+                    options.blockSize = blockSize.unsignedIntegerValue;
+                    AZSOperationContext *operationContext = [[AZSOperationContext alloc] init];
+                    NSDictionary *parameters = @{@"direction": @"upload", @"api": api, @"parallelismFactor": parallelismFactor, @"blockSize": blockSize};
+
+                    [results addObject:[self runCaseWithParameters:parameters size:size operationContext:operationContext operation:^(void (^done)(NSError *)) {
+                        if ([api isEqualToString:@"stream"])
+                        {
+                            [blob uploadFromStream:[NSInputStream inputStreamWithFileAtPath:sourcePath] accessCondition:nil requestOptions:options operationContext:operationContext completionHandler:done];
+                        }
+                        else if ([api isEqualToString:@"file"])
+                        {
+                            [blob uploadFromFileWithPath:sourcePath accessCondition:nil requestOptions:options operationContext:operationContext completionHandler:done];
+                        }
+                        else
+                        {
+                            [blob uploadFromData:sourceData accessCondition:nil requestOptions:options operationContext:operationContext completionHandler:done];
+                        }
+                    }]];
+                }
+            }
+
+            for (NSNumber *downloadBufferSize in downloadBufferSizes)
+            {
+                AZSBlobRequestOptions *options = [[AZSBlobRequestOptions alloc] init];
+                options.maximumDownloadBufferSize = downloadBufferSize.unsignedIntegerValue;
+                AZSOperationContext *operationContext = [[AZSOperationContext alloc] init];
+                NSString *targetPath = [self.scratchDirectory stringByAppendingPathComponent:@"target"];
+                NSDictionary *parameters = @{@"direction": @"download", @"api": api, @"maximumDownloadBufferSize": downloadBufferSize};
+
+                [results addObject:[self runCaseWithParameters:parameters size:size operationContext:operationContext operation:^(void (^done)(NSError *)) {
+                    if ([api isEqualToString:@"stream"])
+                    {
+                        [blob downloadToStream:[NSOutputStream outputStreamToFileAtPath:@"/dev/null" append:NO] accessCondition:nil requestOptions:options operationContext:operationContext completionHandler:done];
+                    }
+                    else if ([api isEqualToString:@"file"])
+                    {
+                        [blob downloadToFileWithPath:targetPath append:NO accessCondition:nil requestOptions:options operationContext:operationContext completionHandler:done];
+                    }
+                    else
+                    {
+                        [blob downloadToDataWithAccessCondition:nil requestOptions:options operationContext:operationContext completionHandler:^(NSError *err, NSData *data) {
+                            done(err);
+                        }];
+                    }
+                }]];
+                [[NSFileManager defaultManager] removeItemAtPath:targetPath error:nil];
+            }
+        }
+        [[NSFileManager defaultManager] removeItemAtPath:sourcePath error:nil];
+    }
+
+    NSDictionary *report = @{@"date": [[NSISO8601DateFormatter new] stringFromDate:[NSDate date]], @"host": [[NSProcessInfo processInfo] hostName], @"results": results};
+    NSData *json = [NSJSONSerialization dataWithJSONObject:report options:NSJSONWritingPrettyPrinted error:nil];
+    NSError *error = nil;
+    XCTAssertTrue([json writeToFile:outputPath options:NSDataWritingAtomic error:&error], @"Error writing the report: %@", error);
+}
+
+@end
@@ -0,0 +1,159 @@
+// -----------------------------------------------------------------------------------------
+// <copyright file="AZSTracerTests.m" company="Microsoft">
+//    Copyright 2015 Microsoft Corporation
+//
+//    Licensed under the MIT License;
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+//      http://spdx.org/licenses/MIT
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+// </copyright>
+// -----------------------------------------------------------------------------------------
+
+#import <XCTest/XCTest.h>
+#import "AZSOperationContext.h"
+#import "AZSTracer.h"
+
+static const NSUInteger AZSTracerBenchmarkIterations = 1000000;
+static const NSUInteger AZSTracerEnabledBenchmarkIterations = 8000;
+
+@interface AZSTracerTests : XCTestCase
+
+@property (strong) AZSOperationContext *operationContext;
+@property (strong) dispatch_semaphore_t threadSemaphore;
+
+@end
+
+@implementation AZSTracerTests
+
+- (void)setUp {
+    [super setUp];
+    [AZSTracer stopTracing];
+    [AZSTracer clearTrace];
+    self.operationContext = [[AZSOperationContext alloc] init];
+}
+
+- (void)tearDown {
+    [AZSTracer stopTracing];
+    [AZSTracer clearTrace];
+    [super tearDown];
+}
+
+-(NSArray *)traceEvents {
+    NSDictionary *trace = [NSJSONSerialization JSONObjectWithData:[AZSTracer traceEventData] options:0 error:nil];
+    return trace[@"traceEvents"];
+}
+
+-(NSArray *)traceEventsNamed:(NSString *)name {
+    return [[self traceEvents] filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"name == %@", name]];
+}
+
+-(void)testDisabledRecordsNothing {
+    uint64_t traceStart = AZSTraceTimestamp();
+    XCTAssertEqual(traceStart, 0);
+    AZSTraceSpan("span", traceStart, self.operationContext);
+    AZSTraceInstant("instant", self.operationContext);
+    XCTAssertEqual([self traceEvents].count, 0);
+}
+
+-(void)testSpansAndInstants {
+    [AZSTracer startTracing];
+    AZSOperationContext *otherContext = [[AZSOperationContext alloc] init];
+
+    uint64_t traceStart = AZSTraceTimestamp();
+    [NSThread sleepForTimeInterval:0.01];
+    AZSTraceSpan("span", traceStart, self.operationContext);
+    AZSTraceInstant("instant", self.operationContext);
+    AZSTraceInstant("instant", otherContext);
+    AZSTraceInstant("instant", nil);
+
+    NSArray *spans = [self traceEventsNamed:@"span"];
+    XCTAssertEqual(spans.count, 1);
+    XCTAssertEqualObjects(spans[0][@"ph"], @"X");
+    XCTAssertGreaterThanOrEqual([spans[0][@"dur"] doubleValue], 10000);
+
+    NSArray *instants = [self traceEventsNamed:@"instant"];
+    XCTAssertEqual(instants.count, 3);
+    XCTAssertEqualObjects(instants[0][@"ph"], @"i");
+
+    // Each operation is a separate process, named by its client request ID.
+    NSArray *processNames = [self traceEventsNamed:@"process_name"];
+    XCTAssertEqual(processNames.count, 3);
+    NSArray *names = [processNames valueForKeyPath:@"args.name"];
+    XCTAssertTrue([names containsObject:self.operationContext.clientRequestId]);
+    XCTAssertTrue([names containsObject:otherContext.clientRequestId]);
+    XCTAssertTrue([names containsObject:@"(no operation)"]);
+    XCTAssertEqualObjects(spans[0][@"pid"], instants[0][@"pid"]);
+    XCTAssertNotEqualObjects(instants[0][@"pid"], instants[1][@"pid"]);
+
+    [AZSTracer stopTracing];
+    AZSTraceInstant("instant", self.operationContext);
+    XCTAssertEqual([self traceEventsNamed:@"instant"].count, 3);
+
+    [AZSTracer clearTrace];
+    XCTAssertEqual([self traceEvents].count, 0);
+}
+
+-(void)testConcurrentThreads {
+    [AZSTracer startTracing];
+    dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t iteration) {
+        for (NSUInteger i = 0; i < 100; i++)
+        {
+            AZSTraceSpan("work", AZSTraceTimestamp(), self.operationContext);
+        }
+    });
+
+    XCTAssertEqual([self traceEventsNamed:@"work"].count, 800);
+    XCTAssertEqual([AZSTracer droppedEventCount], 0);
+}
+
+-(void)recordOnNewThread {
+    for (NSUInteger i = 0; i < 10; i++)
+    {
+        AZSTraceInstant("bounded", self.operationContext);
+    }
+    dispatch_semaphore_signal(self.threadSemaphore);
+}
+
+-(void)testFullBufferDropsEvents {
+    // The capacity only applies to threads that have not recorded yet, so record on a new one.
+    [AZSTracer startTracingWithEventsPerThread:4];
+    self.threadSemaphore = dispatch_semaphore_create(0);
+    [NSThread detachNewThreadSelector:@selector(recordOnNewThread) toTarget:self withObject:nil];
+    dispatch_semaphore_wait(self.threadSemaphore, DISPATCH_TIME_FOREVER);
+
+    XCTAssertEqual([self traceEventsNamed:@"bounded"].count, 4);
+    XCTAssertEqual([AZSTracer droppedEventCount], 6);
+}
+
+-(void)testPerformanceDisabledTracePoint {
+    AZSOperationContext *operationContext = self.operationContext;
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AZSTracerBenchmarkIterations; i++)
+        {
+            AZSTraceSpan("work", AZSTraceTimestamp(), operationContext);
+        }
+    }];
+}
+
+// Stays within the default per-thread capacity, which the test thread's buffer may already have been created with.
+-(void)testPerformanceEnabledTracePoint {
+    AZSOperationContext *operationContext = self.operationContext;
+    [AZSTracer startTracing];
+    [self measureBlock:^{
+        [AZSTracer stopTracing];
+        [AZSTracer clearTrace];
+        [AZSTracer startTracing];
+        for (NSUInteger i = 0; i < AZSTracerEnabledBenchmarkIterations; i++)
+        {
+            AZSTraceSpan("work", AZSTraceTimestamp(), operationContext);
+        }
+    }];
+}
+
+@end